@@ -0,0 +1,586 @@
+// Fits the per-level enemy formulas in Content/enemies.txt to target win-rate and
+// fight-length curves, and the EXP/coin rewards to a target progression.
+//
+// Every enemy type gets its own separable CMA-ES search over base and per-level
+// HP/ATK/DEF. A candidate is scored by simulating fights (BattleSim) at every
+// player level; all types' candidates of a generation are scored in parallel on
+// every core. Scoring runs in stages of 1/8, 1/4, 1/2 and all of the fights, and
+// a candidate that is already far worse than the previous generation's parents
+// is abandoned early. All candidates of a generation fight with the same random
+// numbers, so they are compared on equal luck.
+//
+// With --exact, candidates are scored by BattleOdds instead: the win rate and
+// fight length a candidate would show over infinitely many fights, with no
+// noise to average away. --odds-cache keeps those answers between runs.
+//
+// Usage: BalanceOptimizer <content dir> [--out FILE] [--levels N] [--fights N]
+//        [--generations N] [--threads N] [--seed N] [--win FROM TO]
+//        [--turns FROM TO] [--wins-per-level N] [--coins FROM TO]
+//        [--exact] [--odds-cache FILE]
+//
+// The result is printed (or written with --out) in the enemies.txt format.
+#include "BattleSim.h"
+#include "ContentCompiler.h"
+#include "ContentFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int DIMS = 6;
+
+// Search box for hp, hp/lvl, atk, atk/lvl, def, def/lvl
+struct ParamRange {
+    int min;
+    int max;
+};
+const ParamRange RANGES[DIMS] = { { 10, 400 }, { 0, 40 }, { 1, 60 }, { 0, 10 }, { 0, 40 }, { 0, 10 } };
+
+// Errors of this size cost 1 point of loss per level
+const double WIN_RATE_TOLERANCE = 0.05;
+const double TURNS_TOLERANCE = 1.0;
+
+const int STAGES = 4;
+// A candidate is dropped once its partial loss passes cutoff * factor + slack
+const double ABANDON_FACTOR = 1.5;
+const double ABANDON_SLACK = 1.0;
+
+struct Options {
+    std::string contentDir;
+    std::string outPath;
+    int levels = 20;
+    int fights = 2000;
+    int generations = 60;
+    int threads = 0;
+    uint64_t seed = 1;
+    double winFrom = 0.85, winTo = 0.65;
+    double turnsFrom = 4.0, turnsTo = 10.0;
+    double winsPerLevel = 3.0;
+    double coinsFrom = 10.0, coinsTo = 40.0;
+    bool exact = false;
+    std::string oddsCachePath;
+};
+
+struct Coefficients {
+    int v[DIMS];
+};
+
+// Exact scoring fills in one "fight" holding the expected wins and turns
+struct LevelOutcome {
+    int fights = 0;
+    double wins = 0.0;
+    double turns = 0.0;
+
+    double WinRate() const { return fights ? (double)wins / fights : 0.0; }
+    double MeanTurns() const { return fights ? (double)turns / fights : 0.0; }
+};
+
+struct Score {
+    double loss = 0.0;
+    bool abandoned = false;
+};
+
+uint64_t Mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+double Lerp(double from, double to, int level, int levels) {
+    return levels > 1 ? from + (to - from) * (level - 1) / (levels - 1) : from;
+}
+
+SimStats EnemyStatsAt(const Coefficients& c, int level) {
+    return { std::max(1, c.v[0] + level * c.v[1]), c.v[2] + level * c.v[3], c.v[4] + level * c.v[5] };
+}
+
+// Search space is the unit cube; the mapping to whole numbers happens here
+Coefficients Decode(const std::vector<double>& x) {
+    Coefficients c;
+    for (int d = 0; d < DIMS; ++d) {
+        double u = std::min(1.0, std::max(0.0, x[d]));
+        c.v[d] = (int)std::lround(RANGES[d].min + u * (RANGES[d].max - RANGES[d].min));
+    }
+    return c;
+}
+
+std::vector<double> Encode(const Coefficients& c) {
+    std::vector<double> x(DIMS);
+    for (int d = 0; d < DIMS; ++d) {
+        x[d] = (double)(c.v[d] - RANGES[d].min) / (RANGES[d].max - RANGES[d].min);
+    }
+    return x;
+}
+
+// Keeps the search inside the box without making the edges flat
+double BoundaryPenalty(const std::vector<double>& x) {
+    double penalty = 0.0;
+    for (double u : x) {
+        double outside = u < 0.0 ? -u : (u > 1.0 ? u - 1.0 : 0.0);
+        penalty += 100.0 * outside * outside;
+    }
+    return penalty;
+}
+
+double Loss(const std::vector<LevelOutcome>& outcomes, const Options& o) {
+    double loss = 0.0;
+    for (int level = 1; level <= o.levels; ++level) {
+        const LevelOutcome& out = outcomes[level - 1];
+        double winError = (out.WinRate() - Lerp(o.winFrom, o.winTo, level, o.levels)) / WIN_RATE_TOLERANCE;
+        double turnError = (out.MeanTurns() - Lerp(o.turnsFrom, o.turnsTo, level, o.levels)) / TURNS_TOLERANCE;
+        loss += winError * winError + turnError * turnError;
+    }
+    return loss / o.levels;
+}
+
+// Fights fightsPerLevel battles at every player level. Fight i at a level uses
+// the same random numbers for every candidate scored with this seed.
+Score Evaluate(const Coefficients& c, SimEnemyKind kind, const Options& o, int fightsPerLevel, uint64_t seed,
+    double cutoff, std::vector<LevelOutcome>* outcomesOut = nullptr) {
+    std::vector<LevelOutcome> outcomes(o.levels);
+    Score score;
+    for (int stage = 0; stage < STAGES; ++stage) {
+        int stageFights = std::max(1, fightsPerLevel >> (STAGES - 1 - stage));
+        for (int level = 1; level <= o.levels; ++level) {
+            LevelOutcome& out = outcomes[level - 1];
+            SimStats player = PlayerStatsAtLevel(level);
+            for (int i = out.fights; i < stageFights; ++i) {
+                SimRng rng(Mix(seed ^ ((uint64_t)level << 40) ^ (uint64_t)i));
+                SimStats enemy = EnemyStatsAt(c, RollEnemyLevel(level, rng));
+                SimResult result = SimulateBattle(player, enemy, kind, rng);
+                out.fights++;
+                out.wins += result.playerWon ? 1.0 : 0.0;
+                out.turns += result.turns;
+            }
+        }
+        score.loss = Loss(outcomes, o);
+        if (stage + 1 < STAGES && score.loss > cutoff) {
+            score.abandoned = true;
+            break;
+        }
+    }
+    if (outcomesOut) *outcomesOut = outcomes;
+    return score;
+}
+
+// What Evaluate converges to as the fights go to infinity
+Score EvaluateExact(const Coefficients& c, SimEnemyKind kind, const Options& o, BattleOdds& odds,
+    std::vector<LevelOutcome>* outcomesOut = nullptr) {
+    std::vector<LevelOutcome> outcomes(o.levels);
+    for (int level = 1; level <= o.levels; ++level) {
+        LevelOutcome& out = outcomes[level - 1];
+        SimStats player = PlayerStatsAtLevel(level);
+        for (int roll = 0; roll < ENEMY_LEVEL_ROLLS; ++roll) {
+            SimMatchup matchup = { player, EnemyStatsAt(c, EnemyLevelForRoll(level, roll)), kind, SimSkill::None };
+            SimOdds result = odds.Solve(matchup);
+            out.wins += result.winChance / ENEMY_LEVEL_ROLLS;
+            out.turns += result.expectedTurns / ENEMY_LEVEL_ROLLS;
+        }
+        out.fights = 1;
+    }
+    Score score;
+    score.loss = Loss(outcomes, o);
+    if (outcomesOut) *outcomesOut = outcomes;
+    return score;
+}
+
+// Separable CMA-ES (Ros & Hansen 2008): a diagonal covariance is plenty for six
+// loosely coupled parameters and needs no eigendecomposition.
+class SepCmaEs {
+public:
+    SepCmaEs(const std::vector<double>& start, double sigma0, uint64_t seed)
+        : n((int)start.size()), mean(start), sigma(sigma0), diagC(n, 1.0), ps(n, 0.0), pc(n, 0.0), rng(seed) {
+        lambda = 4 + (int)(3.0 * std::log((double)n));
+        mu = lambda / 2;
+        double sum = 0.0;
+        for (int i = 0; i < mu; ++i) {
+            weights.push_back(std::log(mu + 0.5) - std::log(i + 1.0));
+            sum += weights.back();
+        }
+        double sumSq = 0.0;
+        for (double& w : weights) {
+            w /= sum;
+            sumSq += w * w;
+        }
+        mueff = 1.0 / sumSq;
+
+        cs = (mueff + 2.0) / (n + mueff + 5.0);
+        ds = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (n + 1.0)) - 1.0) + cs;
+        cc = (4.0 + mueff / n) / (n + 4.0 + 2.0 * mueff / n);
+        // The sep variant can learn faster since it only adapts n variances
+        double sepBoost = (n + 2.0) / 3.0;
+        c1 = std::min(1.0, sepBoost * 2.0 / ((n + 1.3) * (n + 1.3) + mueff));
+        cmu = std::min(1.0 - c1, sepBoost * 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((n + 2.0) * (n + 2.0) + mueff));
+        chiN = std::sqrt((double)n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+    }
+
+    int Lambda() const { return lambda; }
+    int Mu() const { return mu; }
+    double Sigma() const { return sigma; }
+    const std::vector<double>& Mean() const { return mean; }
+
+    // Fills candidates with lambda points around the mean
+    void Sample(std::vector<std::vector<double>>& candidates) {
+        std::normal_distribution<double> normal;
+        steps.assign(lambda, std::vector<double>(n));
+        candidates.assign(lambda, std::vector<double>(n));
+        for (int k = 0; k < lambda; ++k) {
+            for (int d = 0; d < n; ++d) {
+                steps[k][d] = std::sqrt(diagC[d]) * normal(rng);
+                candidates[k][d] = mean[d] + sigma * steps[k][d];
+            }
+        }
+    }
+
+    // losses are for the candidates of the last Sample call
+    void Update(const std::vector<double>& losses) {
+        std::vector<int> order(lambda);
+        for (int k = 0; k < lambda; ++k) order[k] = k;
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return losses[a] < losses[b]; });
+
+        std::vector<double> yw(n, 0.0);
+        for (int i = 0; i < mu; ++i) {
+            for (int d = 0; d < n; ++d) yw[d] += weights[i] * steps[order[i]][d];
+        }
+        for (int d = 0; d < n; ++d) mean[d] += sigma * yw[d];
+
+        double psNorm = 0.0;
+        for (int d = 0; d < n; ++d) {
+            ps[d] = (1.0 - cs) * ps[d] + std::sqrt(cs * (2.0 - cs) * mueff) * yw[d] / std::sqrt(diagC[d]);
+            psNorm += ps[d] * ps[d];
+        }
+        psNorm = std::sqrt(psNorm);
+        generation++;
+        bool hsig = psNorm / std::sqrt(1.0 - std::pow(1.0 - cs, 2.0 * generation)) < (1.4 + 2.0 / (n + 1.0)) * chiN;
+
+        for (int d = 0; d < n; ++d) {
+            pc[d] = (1.0 - cc) * pc[d] + (hsig ? std::sqrt(cc * (2.0 - cc) * mueff) * yw[d] : 0.0);
+            double rankMu = 0.0;
+            for (int i = 0; i < mu; ++i) rankMu += weights[i] * steps[order[i]][d] * steps[order[i]][d];
+            diagC[d] = (1.0 - c1 - cmu) * diagC[d] +
+                c1 * (pc[d] * pc[d] + (hsig ? 0.0 : cc * (2.0 - cc) * diagC[d])) + cmu * rankMu;
+        }
+        sigma *= std::exp((cs / ds) * (psNorm / chiN - 1.0));
+        sigma = std::min(sigma, 1.0);
+    }
+
+private:
+    int n;
+    int lambda;
+    int mu;
+    std::vector<double> weights;
+    double mueff, cs, ds, cc, c1, cmu, chiN;
+    std::vector<double> mean;
+    double sigma;
+    std::vector<double> diagC, ps, pc;
+    std::vector<std::vector<double>> steps;
+    int generation = 0;
+    std::mt19937_64 rng;
+};
+
+struct Search {
+    Search(SimEnemyKind kind, const char* name, const Coefficients& current, uint64_t seed)
+        : kind(kind), name(name), current(current), cma(Encode(current), 0.15, seed), best(current) {}
+
+    SimEnemyKind kind;
+    const char* name;
+    Coefficients current;
+    SepCmaEs cma;
+    std::vector<std::vector<double>> candidates;
+    std::vector<double> losses;
+    std::vector<char> abandonedFlags;
+    double cutoff = std::numeric_limits<double>::infinity();
+    Coefficients best;
+    double bestLoss = std::numeric_limits<double>::infinity();
+    int abandoned = 0;
+    int scored = 0;
+};
+
+// Runs body(i, worker) for i in [0, count) on threads workers numbered from 0
+template <typename Body>
+void ParallelFor(int count, int threads, const Body& body) {
+    std::atomic<int> next{ 0 };
+    auto worker = [&](int w) {
+        for (int i = next++; i < count; i = next++) body(i, w);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& t : pool) t.join();
+}
+
+// Fits a + b * level through target(level) for level 1..levels, minimising the
+// relative error so the small early values are not sacrificed to the late ones
+template <typename Target>
+void FitLine(int levels, const Target& target, int& base, int& perLevel) {
+    double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int level = 1; level <= levels; ++level) {
+        double y = target(level);
+        double w = y != 0.0 ? 1.0 / (y * y) : 1.0;
+        sw += w;
+        sx += w * level;
+        sy += w * y;
+        sxx += w * level * level;
+        sxy += w * level * y;
+    }
+    double denom = sw * sxx - sx * sx;
+    double slope = denom != 0.0 ? (sw * sxy - sx * sy) / denom : 0.0;
+    base = std::max(0, (int)std::lround((sy - slope * sx) / sw));
+    perLevel = std::max(0, (int)std::lround(slope));
+}
+
+bool ParseOptions(int argc, char** argv, Options& o) {
+    if (argc < 2) return false;
+    o.contentDir = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasOne = i + 1 < argc;
+        bool hasTwo = i + 2 < argc;
+        if (arg == "--out" && hasOne) o.outPath = argv[++i];
+        else if (arg == "--levels" && hasOne) o.levels = std::atoi(argv[++i]);
+        else if (arg == "--fights" && hasOne) o.fights = std::atoi(argv[++i]);
+        else if (arg == "--generations" && hasOne) o.generations = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasOne) o.threads = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasOne) o.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--wins-per-level" && hasOne) o.winsPerLevel = std::atof(argv[++i]);
+        else if (arg == "--exact") o.exact = true;
+        else if (arg == "--odds-cache" && hasOne) {
+            o.oddsCachePath = argv[++i];
+            o.exact = true;
+        }
+        else if (arg == "--win" && hasTwo) {
+            o.winFrom = std::atof(argv[++i]);
+            o.winTo = std::atof(argv[++i]);
+        }
+        else if (arg == "--turns" && hasTwo) {
+            o.turnsFrom = std::atof(argv[++i]);
+            o.turnsTo = std::atof(argv[++i]);
+        }
+        else if (arg == "--coins" && hasTwo) {
+            o.coinsFrom = std::atof(argv[++i]);
+            o.coinsTo = std::atof(argv[++i]);
+        }
+        else return false;
+    }
+    return o.levels > 0 && o.fights >= 8 && o.generations > 0 && o.winsPerLevel > 0.0;
+}
+
+bool KindFromName(const char* name, SimEnemyKind& kind) {
+    const char* names[] = { "Archer", "Warrior", "Paladin", "Witch" };
+    for (int k = 0; k < (int)SimEnemyKind::Count; ++k) {
+        if (std::strcmp(name, names[k]) == 0) {
+            kind = (SimEnemyKind)k;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!ParseOptions(argc, argv, o)) {
+        std::cerr << "Usage: BalanceOptimizer <content dir> [--out FILE] [--levels N] [--fights N] [--generations N]\n"
+                     "       [--threads N] [--seed N] [--win FROM TO] [--turns FROM TO]\n"
+                     "       [--wins-per-level N] [--coins FROM TO] [--exact] [--odds-cache FILE]" << std::endl;
+        return 2;
+    }
+    int threads = o.threads > 0 ? o.threads : std::max(1, (int)std::thread::hardware_concurrency());
+
+    // Start from the current table
+    std::vector<uint32_t> blob;
+    std::string error;
+    if (!CompileContent(o.contentDir, blob, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    const char* base = reinterpret_cast<const char*>(blob.data());
+    const ContentHeader* header = reinterpret_cast<const ContentHeader*>(base);
+    std::vector<EnemyDef> enemies(reinterpret_cast<const EnemyDef*>(base + header->enemyOffset),
+        reinterpret_cast<const EnemyDef*>(base + header->enemyOffset) + header->enemyCount);
+
+    std::vector<Search> searches;
+    for (const EnemyDef& def : enemies) {
+        SimEnemyKind kind;
+        if (!KindFromName(def.name, kind)) {
+            std::cerr << def.name << ": no battle model, kept as is" << std::endl;
+            continue;
+        }
+        Coefficients current = { { def.baseHP, def.hpPerLevel, def.baseAttack, def.attackPerLevel, def.baseDefense, def.defensePerLevel } };
+        searches.emplace_back(kind, def.name, current, Mix(o.seed ^ (uint64_t)kind));
+    }
+    if (searches.empty()) {
+        std::cerr << "No enemies to fit" << std::endl;
+        return 1;
+    }
+
+    // BattleOdds isn't thread-safe, so every worker gets its own
+    std::vector<BattleOdds> odds(threads);
+    if (!o.oddsCachePath.empty()) {
+        for (BattleOdds& cache : odds) cache.Load(o.oddsCachePath);
+    }
+
+    if (o.exact) {
+        std::printf("Fitting %zu enemy types over levels 1-%d, exact odds, %d threads\n",
+            searches.size(), o.levels, threads);
+    }
+    else {
+        std::printf("Fitting %zu enemy types over levels 1-%d, %d fights per level, %d threads\n",
+            searches.size(), o.levels, o.fights, threads);
+    }
+
+    for (int gen = 0; gen < o.generations; ++gen) {
+        struct Job {
+            Search* search;
+            int candidate;
+        };
+        std::vector<Job> jobs;
+        for (Search& s : searches) {
+            s.cma.Sample(s.candidates);
+            s.losses.assign(s.candidates.size(), 0.0);
+            s.abandonedFlags.assign(s.candidates.size(), 0);
+            for (int k = 0; k < (int)s.candidates.size(); ++k) jobs.push_back({ &s, k });
+        }
+
+        uint64_t genSeed = Mix(o.seed + 0x1000 + (uint64_t)gen);
+        ParallelFor((int)jobs.size(), threads, [&](int j, int worker) {
+            Search& s = *jobs[j].search;
+            const std::vector<double>& x = s.candidates[jobs[j].candidate];
+            Score score = o.exact ? EvaluateExact(Decode(x), s.kind, o, odds[worker])
+                : Evaluate(Decode(x), s.kind, o, o.fights, genSeed, s.cutoff * ABANDON_FACTOR + ABANDON_SLACK);
+            // Each job owns its slot, so no locking
+            s.losses[jobs[j].candidate] = score.loss + BoundaryPenalty(x);
+            s.abandonedFlags[jobs[j].candidate] = score.abandoned;
+        });
+
+        for (Search& s : searches) {
+            std::vector<double> sorted = s.losses;
+            std::sort(sorted.begin(), sorted.end());
+            s.cutoff = sorted[s.cma.Mu() - 1];
+            for (int k = 0; k < (int)s.losses.size(); ++k) {
+                if (s.losses[k] < s.bestLoss) {
+                    s.bestLoss = s.losses[k];
+                    s.best = Decode(s.candidates[k]);
+                }
+            }
+            s.cma.Update(s.losses);
+            s.scored += (int)s.losses.size();
+            s.abandoned += (int)std::count(s.abandonedFlags.begin(), s.abandonedFlags.end(), 1);
+        }
+
+        if ((gen + 1) % 10 == 0 || gen + 1 == o.generations) {
+            std::printf("generation %3d:", gen + 1);
+            for (const Search& s : searches) {
+                std::printf("  %s %.3f (sigma %.3f)", s.name, s.bestLoss, s.cma.Sigma());
+            }
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+    }
+
+    // Losses above came from different luck every generation; settle the winner
+    // between the final mean and the best candidate on a fresh, larger sample
+    uint64_t finalSeed = Mix(o.seed ^ 0xF17A1ull);
+    int finalFights = o.fights * 4;
+    const double noCutoff = std::numeric_limits<double>::infinity();
+    std::vector<Coefficients> fitted(searches.size());
+    std::vector<std::vector<LevelOutcome>> before(searches.size()), after(searches.size());
+    ParallelFor((int)searches.size(), threads, [&](int i, int worker) {
+        Search& s = searches[i];
+        auto score = [&](const Coefficients& c, std::vector<LevelOutcome>* out) {
+            return o.exact ? EvaluateExact(c, s.kind, o, odds[worker], out).loss
+                : Evaluate(c, s.kind, o, finalFights, finalSeed, noCutoff, out).loss;
+        };
+        std::vector<LevelOutcome> meanOut, bestOut;
+        Coefficients meanCoeffs = Decode(s.cma.Mean());
+        double meanLoss = score(meanCoeffs, &meanOut);
+        double bestLoss = score(s.best, &bestOut);
+        fitted[i] = meanLoss <= bestLoss ? meanCoeffs : s.best;
+        after[i] = meanLoss <= bestLoss ? meanOut : bestOut;
+        score(s.current, &before[i]);
+    });
+
+    if (!o.oddsCachePath.empty()) {
+        size_t solved = 0;
+        for (BattleOdds& cache : odds) {
+            solved += cache.StatesSolved();
+            if (&cache != &odds[0]) odds[0].Merge(cache);
+        }
+        if (!odds[0].Save(o.oddsCachePath)) {
+            std::cerr << o.oddsCachePath << ": cannot write" << std::endl;
+        }
+        std::printf("Odds cache: %zu matchups in %s, %zu fight states solved this run\n",
+            odds[0].MatchupCount(), o.oddsCachePath.c_str(), solved);
+    }
+
+    for (size_t i = 0; i < searches.size(); ++i) {
+        std::printf("\n%s: loss %.3f -> %.3f, %d of %d candidates abandoned early\n", searches[i].name,
+            Loss(before[i], o), Loss(after[i], o), searches[i].abandoned, searches[i].scored);
+        std::printf("%6s %8s %8s %8s %8s %8s %8s\n", "level", "target", "before", "after", "turns", "before", "after");
+        int step = std::max(1, o.levels / 10);
+        for (int level = 1; level <= o.levels; level += step) {
+            const LevelOutcome& b = before[i][level - 1];
+            const LevelOutcome& a = after[i][level - 1];
+            std::printf("%6d %7.0f%% %7.1f%% %7.1f%% %8.1f %8.1f %8.1f\n", level,
+                Lerp(o.winFrom, o.winTo, level, o.levels) * 100.0, b.WinRate() * 100.0, a.WinRate() * 100.0,
+                Lerp(o.turnsFrom, o.turnsTo, level, o.levels), b.MeanTurns(), a.MeanTurns());
+        }
+    }
+
+    // Rewards: an enemy of level L pays 1/winsPerLevel of the EXP for that level
+    int baseExp, expPerLevel, baseCoins, coinsPerLevel;
+    FitLine(o.levels, [&](int level) { return ExpToNextLevel(level) / o.winsPerLevel; }, baseExp, expPerLevel);
+    FitLine(o.levels, [&](int level) { return Lerp(o.coinsFrom, o.coinsTo, level, o.levels); }, baseCoins, coinsPerLevel);
+
+    std::printf("\nRewards per win (target -> fitted):");
+    for (int level = 1; level <= o.levels; level += std::max(1, o.levels / 4)) {
+        std::printf("  L%d %.0f exp -> %d, %.0f coins -> %d", level, ExpToNextLevel(level) / o.winsPerLevel,
+            baseExp + level * expPerLevel, Lerp(o.coinsFrom, o.coinsTo, level, o.levels), baseCoins + level * coinsPerLevel);
+    }
+    std::printf("\n");
+
+    std::ostringstream table;
+    table << "# Enemy stats per level: value = base + level * perLevel.\n";
+    table << "# Fitted by BalanceOptimizer for levels 1-" << o.levels << ": win rate "
+          << (int)std::lround(o.winFrom * 100) << "% -> " << (int)std::lround(o.winTo * 100) << "%, "
+          << o.turnsFrom << " -> " << o.turnsTo << " turns, " << o.winsPerLevel << " wins per level.\n";
+    table << "# name | hp | hp/lvl | atk | atk/lvl | def | def/lvl | exp | exp/lvl | coins | coins/lvl\n";
+    for (const EnemyDef& def : enemies) {
+        int v[DIMS] = { def.baseHP, def.hpPerLevel, def.baseAttack, def.attackPerLevel, def.baseDefense, def.defensePerLevel };
+        for (size_t i = 0; i < searches.size(); ++i) {
+            if (std::strcmp(searches[i].name, def.name) == 0) std::copy(fitted[i].v, fitted[i].v + DIMS, v);
+        }
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-7s | %3d | %2d | %2d | %2d | %2d | %2d | %3d | %2d | %2d | %2d\n",
+            def.name, v[0], v[1], v[2], v[3], v[4], v[5], baseExp, expPerLevel, baseCoins, coinsPerLevel);
+        table << line;
+    }
+
+    if (o.outPath.empty()) {
+        std::printf("\n%s", table.str().c_str());
+    }
+    else {
+        std::ofstream out(o.outPath);
+        out << table.str();
+        if (!out) {
+            std::cerr << o.outPath << ": cannot write" << std::endl;
+            return 1;
+        }
+        std::printf("\nWrote %s\n", o.outPath.c_str());
+    }
+    return 0;
+}
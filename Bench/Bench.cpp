@@ -0,0 +1,222 @@
+#include "Bench.h"
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+namespace {
+
+double NowNs() {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double Median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    return values[mid];
+}
+
+// Allocations amortized over many calls (a vector doubling now and then, a
+// log trimmed every so often) come out fractional and move with the calibrated
+// call count, so only whole allocations per op are compared, plus any at all
+// where there were none
+bool AllocsRegressed(double baseline, double current) {
+    const double epsilon = 1e-6;
+    if (baseline < epsilon) return current >= 0.01;
+    return std::floor(current + epsilon) > std::floor(baseline + epsilon);
+}
+
+struct BaselineEntry {
+    double nsPerOp;
+    double spreadPct;
+    double allocsPerOp;  // -1 when the baseline did not record it
+};
+
+// Reads results back out of a file written by WriteJson
+std::map<std::string, BaselineEntry> ReadBaseline(const std::string& path) {
+    std::map<std::string, BaselineEntry> baseline;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t namePos = line.find("\"name\": \"");
+        size_t nsPos = line.find("\"ns_per_op\": ");
+        size_t spreadPos = line.find("\"spread_pct\": ");
+        size_t allocsPos = line.find("\"allocs_per_op\": ");
+        if (namePos == std::string::npos || nsPos == std::string::npos) continue;
+        namePos += 9;
+        size_t nameEnd = line.find('"', namePos);
+        if (nameEnd == std::string::npos) continue;
+        BaselineEntry entry;
+        entry.nsPerOp = std::atof(line.c_str() + nsPos + 13);
+        entry.spreadPct = spreadPos != std::string::npos ? std::atof(line.c_str() + spreadPos + 14) : 0.0;
+        entry.allocsPerOp = allocsPos != std::string::npos ? std::atof(line.c_str() + allocsPos + 17) : -1.0;
+        baseline[line.substr(namePos, nameEnd - namePos)] = entry;
+    }
+    return baseline;
+}
+
+} // namespace
+
+void BenchRunner::Run(const std::string& name, const std::function<void()>& body, uint64_t opsPerCall) {
+    Measure(name, body, opsPerCall, false);
+}
+
+void BenchRunner::RunNoAlloc(const std::string& name, const std::function<void()>& body, uint64_t opsPerCall) {
+    Measure(name, body, opsPerCall, true);
+}
+
+void BenchRunner::Measure(const std::string& name, const std::function<void()>& body, uint64_t opsPerCall,
+    bool noAllocs) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+
+    // Warm up, then grow the call count until one sample takes long enough to time
+    body();
+    uint64_t calls = 1;
+    for (;;) {
+        double start = NowNs();
+        for (uint64_t i = 0; i < calls; ++i) body();
+        double elapsedMs = (NowNs() - start) / 1e6;
+        if (elapsedMs >= options.sampleMs || calls >= (1ull << 30)) break;
+        calls = elapsedMs <= 0.0 ? calls * 10 : std::max(calls + 1, (uint64_t)(calls * options.sampleMs * 1.2 / elapsedMs));
+    }
+
+    // Warm-up and calibration are left out, so what allocates only the first
+    // time round is not counted
+    std::vector<double> perOp;
+    perOp.reserve(options.samples);
+    uint64_t allocsBefore = MemoryTracker::AllocationCount();
+    for (int s = 0; s < options.samples; ++s) {
+        double start = NowNs();
+        for (uint64_t i = 0; i < calls; ++i) body();
+        perOp.push_back((NowNs() - start) / (double)(calls * opsPerCall));
+    }
+    uint64_t allocs = MemoryTracker::AllocationCount() - allocsBefore;
+
+    BenchResult result;
+    result.name = name;
+    result.nsPerOp = Median(perOp);
+    std::vector<double> deviations;
+    for (double v : perOp) deviations.push_back(std::fabs(v - result.nsPerOp));
+    result.spreadPct = result.nsPerOp > 0.0 ? Median(deviations) / result.nsPerOp * 100.0 : 0.0;
+    result.allocsPerOp = (double)allocs / (double)(calls * opsPerCall * options.samples);
+    result.noAllocs = noAllocs;
+    result.opsPerSample = calls * opsPerCall;
+    result.samples = options.samples;
+    results.push_back(result);
+
+    std::printf("%-40s %12.1f ns/op %14.0f ops/s  +-%4.1f%%  %8.2f allocs/op%s\n", name.c_str(),
+        result.nsPerOp, result.nsPerOp > 0.0 ? 1e9 / result.nsPerOp : 0.0, result.spreadPct, result.allocsPerOp,
+        noAllocs && allocs > 0 ? "  ALLOCATES" : "");
+    std::fflush(stdout);
+}
+
+void BenchRunner::Skip(const std::string& name, const char* reason) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+    BenchResult result;
+    result.name = name;
+    result.skipped = true;
+    results.push_back(result);
+    std::printf("%-40s skipped (%s)\n", name.c_str(), reason);
+}
+
+bool BenchRunner::WriteJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    // One benchmark per line so ReadBaseline can stay a line scanner
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        if (r.skipped) {
+            out << "    {\"name\": \"" << r.name << "\", \"skipped\": true}";
+        }
+        else {
+            out << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.nsPerOp
+                << ", \"ops_per_sec\": " << (r.nsPerOp > 0.0 ? 1e9 / r.nsPerOp : 0.0)
+                << ", \"spread_pct\": " << r.spreadPct
+                << ", \"allocs_per_op\": " << r.allocsPerOp
+                << ", \"ops_per_sample\": " << r.opsPerSample
+                << ", \"samples\": " << r.samples << "}";
+        }
+        out << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return true;
+}
+
+bool BenchRunner::CheckNoAllocs() const {
+    bool ok = true;
+    for (const BenchResult& r : results) {
+        if (r.skipped || !r.noAllocs || r.allocsPerOp <= 0.0) continue;
+        if (ok) std::printf("\nExpected no allocations:\n");
+        std::printf("  %-40s %8.4f allocs/op\n", r.name.c_str(), r.allocsPerOp);
+        ok = false;
+    }
+    return ok;
+}
+
+bool BenchRunner::CompareWithBaseline(const std::string& path) const {
+    std::map<std::string, BaselineEntry> baseline = ReadBaseline(path);
+    if (baseline.empty()) {
+        std::cerr << path << ": no baseline results found" << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::printf("\n%-40s %12s %12s %8s\n", "benchmark", "baseline", "current", "change");
+    for (const BenchResult& r : results) {
+        auto it = baseline.find(r.name);
+        if (r.skipped || it == baseline.end() || it->second.nsPerOp <= 0.0) continue;
+
+        double base = it->second.nsPerOp;
+        double changePct = (r.nsPerOp - base) / base * 100.0;
+        // Runs this noisy can't show a smaller change; widen the bar for them
+        double noisePct = std::max(r.spreadPct, it->second.spreadPct) * 3.0;
+        double allowedPct = std::max(options.thresholdPct, noisePct);
+        const char* verdict = "";
+        if (changePct > allowedPct) {
+            verdict = "  REGRESSION";
+            ok = false;
+        }
+        else if (changePct < -allowedPct) {
+            verdict = "  faster";
+        }
+        std::printf("%-40s %12.1f %12.1f %+7.1f%%%s\n", r.name.c_str(), base, r.nsPerOp, changePct, verdict);
+
+        double baseAllocs = it->second.allocsPerOp;
+        if (baseAllocs >= 0.0 && AllocsRegressed(baseAllocs, r.allocsPerOp)) {
+            std::printf("%-40s %12.2f %12.2f %8s  REGRESSION (allocs/op)\n", "", baseAllocs, r.allocsPerOp, "");
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool ParseBenchOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--filter") == 0 && hasValue) options.filter = argv[++i];
+        else if (std::strcmp(arg, "--json") == 0 && hasValue) options.jsonPath = argv[++i];
+        else if (std::strcmp(arg, "--baseline") == 0 && hasValue) options.baselinePath = argv[++i];
+        else if (std::strcmp(arg, "--threshold") == 0 && hasValue) options.thresholdPct = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--samples") == 0 && hasValue) options.samples = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--sample-ms") == 0 && hasValue) options.sampleMs = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--no-window") == 0) options.noWindow = true;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter text] [--json out.json] [--baseline old.json]"
+                " [--threshold percent] [--samples n] [--sample-ms ms] [--no-window]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
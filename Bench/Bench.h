@@ -0,0 +1,60 @@
+// Bench.h
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal benchmark runner. Each benchmark body performs opsPerCall operations;
+// the runner calibrates how many calls fill a sample and reports the median.
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp = 0.0;    // median over samples
+    double spreadPct = 0.0;  // median absolute deviation, % of the median
+    double allocsPerOp = 0.0;
+    bool noAllocs = false;   // run with RunNoAlloc: any allocation fails the run
+    uint64_t opsPerSample = 0;
+    int samples = 0;
+    bool skipped = false;
+};
+
+struct BenchOptions {
+    std::string filter;          // substring, empty runs everything
+    std::string jsonPath;        // write results here
+    std::string baselinePath;    // compare against this earlier JSON output
+    double thresholdPct = 10.0;  // minimum slowdown reported as a regression
+    int samples = 15;
+    double sampleMs = 20.0;
+    bool noWindow = false;       // measure text with the null renderer instead of raylib
+};
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options) : options(options) {}
+
+    void Run(const std::string& name, const std::function<void()>& body, uint64_t opsPerCall = 1);
+    // For paths promised not to allocate once warmed up
+    void RunNoAlloc(const std::string& name, const std::function<void()>& body, uint64_t opsPerCall = 1);
+    void Skip(const std::string& name, const char* reason);
+
+    const std::vector<BenchResult>& Results() const { return results; }
+
+    bool WriteJson(const std::string& path) const;
+
+    // Lists RunNoAlloc benchmarks that allocated; returns false if there were any
+    bool CheckNoAllocs() const;
+
+    // Prints a comparison table; returns false if anything got slower or
+    // allocates more than it did
+    bool CompareWithBaseline(const std::string& path) const;
+
+private:
+    void Measure(const std::string& name, const std::function<void()>& body, uint64_t opsPerCall, bool noAllocs);
+
+    BenchOptions options;
+    std::vector<BenchResult> results;
+};
+
+// Parses command line flags; returns false (after printing usage) on bad input
+bool ParseBenchOptions(int argc, char** argv, BenchOptions& options);
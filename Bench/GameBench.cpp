@@ -0,0 +1,630 @@
+// Benchmarks for the game code that runs between frames.
+// Usage: rpg_bench [--json results.json] [--baseline previous.json] [--threshold 10]
+#include "Bench.h"
+#include "Game.h"
+#include "BattleStats.h"
+#include "BattleStatus.h"
+#include "Combatants.h"
+#include "Content.h"
+#include "Encounters.h"
+#include "FlightRecorder.h"
+#include "FrameArena.h"
+#include "Initiative.h"
+#include "NullRenderer.h"
+#include "RenderQueue.h"
+#include "ArcherFactory.h"
+#include "PaladinFactory.h"
+#include "WarriorFactory.h"
+#include "WitchFactory.h"
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+namespace {
+
+// Swallows the [Notification] lines the game prints on every action
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+volatile int sink = 0;
+
+} // namespace
+
+// Friend of Game so the benchmarks can drive battle and save code directly
+class GameBench {
+public:
+    static void RunAll(BenchRunner& runner, bool haveWindow);
+    // Steps the animation clock by hand and checks what the pool shows; false on a mismatch
+    static bool CheckAnimations();
+
+private:
+    static void FillInventory(Game& game, int count, const std::string& lastItem);
+    static void BattleBenchmarks(BenchRunner& runner, Game& game);
+    static void EcsBenchmarks(BenchRunner& runner);
+    static void StatusBenchmarks(BenchRunner& runner);
+    static void InitiativeBenchmarks(BenchRunner& runner);
+    static void StatsBenchmarks(BenchRunner& runner);
+    static void FlightBenchmarks(BenchRunner& runner);
+    static void AnimationBenchmarks(BenchRunner& runner);
+    static void SaveBenchmarks(BenchRunner& runner, Game& game);
+    static void ItemBenchmarks(BenchRunner& runner, Game& game);
+    static void LayoutBenchmarks(BenchRunner& runner, Game& game, const std::string& suffix);
+};
+
+void GameBench::FillInventory(Game& game, int count, const std::string& lastItem) {
+    game.inventory.clear();
+    for (int i = 0; i < count - 1; ++i) {
+        game.inventory.push_back({ "Bench Item " + std::to_string(i), "Filler item for benchmarks", 5 });
+    }
+    game.inventory.push_back({ lastItem, "Benchmark target", 5 });
+}
+
+void GameBench::BattleBenchmarks(BenchRunner& runner, Game& game) {
+    game.state = GameState::Battle;
+    game.InitEnemy();
+    game.ResetInitiative();
+    game.BeginBattleEvents();
+
+    // One player attack plus the enemy reply; fighters are revived instead of ending the battle
+    runner.Run("battle/turn", [&]() {
+        game.PerformPlayerAction(0);
+        game.EnemyAttack();
+        if (game.player.currentHP <= 0 || game.enemy.currentHP <= 0) {
+            game.player.currentHP = game.player.maxHP;
+            game.enemy.currentHP = game.enemy.maxHP;
+            game.statuses.Remove(game.playerEntity, StatusKind::Poison);
+            game.BeginBattleEvents();
+        }
+    });
+
+    // A copy into space set aside when the battle began, plus folding it in
+    const BattleEvent hit = { BattleEventKind::Damage, BattleSide::Enemy, StatusKind::Count, 0, 0 };
+    runner.RunNoAlloc("battle/append_event", [&]() {
+        game.battleEvents.Append(hit);
+    });
+
+    // What undo and looking back at a turn cost in a long battle
+    game.BeginBattleEvents();
+    for (int turn = 1; turn <= 100; ++turn) {
+        game.battleEvents.Append({ BattleEventKind::TurnStarted, BattleSide::Player, StatusKind::Count, turn, 0 });
+        game.battleEvents.Append({ BattleEventKind::Damage, BattleSide::Enemy, StatusKind::Count, 1, 0 });
+        game.battleEvents.Append({ BattleEventKind::EnemyActed, BattleSide::Enemy, StatusKind::Count, 0, 0 });
+        game.battleEvents.Append({ BattleEventKind::Damage, BattleSide::Player, StatusKind::Count, 1, 0 });
+        game.battleEvents.Append({ BattleEventKind::TurnEnded, BattleSide::Player, StatusKind::Count, 0, 0 });
+    }
+    runner.RunNoAlloc("battle/state_at_turn_100", [&]() {
+        BattleState state;
+        game.battleEvents.StateAtTurn(100, state);
+        sink = state.hp[0];
+    });
+
+    // Quicksave, quickload and the per-turn ring push; restore with nothing to
+    // change in the status engine and with a block and a cooldown to put back
+    game.BeginBattleEvents();
+    BattleSnapshot snapshot;
+    runner.RunNoAlloc("snapshot/take", [&]() {
+        game.TakeSnapshot(snapshot);
+        sink = snapshot.state.hp[0];
+    });
+    runner.RunNoAlloc("snapshot/ring_push", [&]() {
+        game.turnSnapshots.Push(snapshot);
+    });
+    runner.Run("snapshot/restore", [&]() {
+        game.RestoreSnapshot(snapshot);
+    });
+    runner.Run("snapshot/restore_statuses", [&]() {
+        game.statuses.Apply(game.playerEntity, StatusKind::Blocking, 1);
+        game.statuses.Apply(game.enemyEntity, StatusKind::SkillCooldown, 3);
+        game.RestoreSnapshot(snapshot);
+    });
+
+    const EnemyType types[] = { EnemyType::Archer, EnemyType::Warrior, EnemyType::Paladin, EnemyType::Witch };
+    const int decisions = 1000;
+    runner.Run("ai/choose_enemy_action", [&]() {
+        int total = 0;
+        for (int i = 0; i < decisions; ++i) {
+            game.enemyType = types[i & 3];
+            game.enemy.currentHP = 1 + (i * 7) % game.enemy.maxHP;
+            if ((i >> 2) % 3 == 0) game.statuses.Apply(game.enemyEntity, StatusKind::SkillCooldown, 1);
+            else game.statuses.Remove(game.enemyEntity, StatusKind::SkillCooldown);
+            total += static_cast<int>(game.ChooseEnemyAction());
+        }
+        sink = total;
+    }, decisions);
+
+    runner.Run("spawn/init_enemy", [&]() {
+        game.InitEnemy();
+    });
+
+    ArcherFactory archer;
+    WarriorFactory warrior;
+    PaladinFactory paladin;
+    WitchFactory witch;
+    const EnemyFactory* factories[] = { &archer, &warrior, &paladin, &witch };
+    runner.Run("spawn/factory_create_enemy", [&]() {
+        int total = 0;
+        for (const EnemyFactory* factory : factories) {
+            Enemy* enemy = factory->CreateEnemy(5);
+            total += enemy->GetMaxHP() + enemy->GetAttack() + enemy->GetExpReward();
+            delete enemy;
+        }
+        sink = total;
+    }, 4);
+
+    // Encounter tables are meant to hold hundreds of archetypes without making
+    // battle start any slower
+    std::vector<int32_t> weights;
+    for (int i = 0; i < 500; ++i) weights.push_back(1 + (i * 37) % 100);
+    AliasTable alias;
+    runner.Run("spawn/alias_build_500", [&]() {
+        alias.Build(weights);
+    });
+    const int picks = 1000;
+    runner.Run("spawn/alias_pick_500", [&]() {
+        uint32_t state = 12345;
+        int total = 0;
+        for (int i = 0; i < picks; ++i) {
+            state = state * 1664525u + 1013904223u;
+            total += alias.Pick((int)((state >> 8) % 500), (int)(state >> 17));
+        }
+        sink = total;
+    }, picks);
+
+    // A 500 against 500 group battle fought to the end, both sides on AI
+    CombatantPool pool;
+    runner.Run("battle/group_1000", [&]() {
+        pool.Clear();
+        pool.Reserve(1000);
+        for (int i = 0; i < 1000; ++i) {
+            Team side = i < 500 ? Team::Allies : Team::Enemies;
+            uint8_t kind = side == Team::Allies ? COMBATANT_HERO : static_cast<uint8_t>(i & 3);
+            pool.Add(side, kind, { 60 + i % 40, 12 + i % 7, 3 + i % 4 }, 5);
+        }
+        SimRng rng(42);
+        int rounds = 0;
+        sink = static_cast<int>(SimulateGroupBattle(pool, rng, 200, &rounds)) + rounds;
+    });
+
+    game.battleLog.clear();
+    game.state = GameState::TownSquare;
+}
+
+// 10k fighters spread over a dozen archetypes, far more than any battle has
+void GameBench::EcsBenchmarks(BenchRunner& runner) {
+    const int count = 10000;
+    std::vector<Character> characters(count, Character{ "Bench", 100, 100, 12, 4, 1, 0, 100 });
+    World world;
+    std::vector<Entity> entities;
+    int poisoned = 0;
+    for (int i = 0; i < count; ++i) {
+        Entity e = world.Create();
+        world.Add(e, Fighter{ &characters[i] });
+        if (i % 4 == 0) {
+            world.Add(e, Poisoned{ 5 });
+            poisoned++;
+        }
+        if (i % 3 == 0) world.Add(e, Blocking{});
+        if (i % 5 == 0) world.Add(e, SkillCooldown{});
+        if (i % 8 == 0) world.Add(e, AttackBuff{ 5, 1 });
+        entities.push_back(e);
+    }
+
+    runner.Run("ecs/each_fighter_10k", [&]() {
+        int total = 0;
+        world.Each<Fighter>([&](Entity, Fighter& fighter) { total += fighter.character->attack; });
+        sink = total;
+    }, count);
+
+    runner.Run("ecs/each_fighter_poisoned_10k", [&]() {
+        int total = 0;
+        world.Each<Fighter, Poisoned>([&](Entity, Fighter&, Poisoned& poison) { total += poison.damage; });
+        sink = total;
+    }, poisoned);
+
+    // The archetype move a block or a poison costs, both ways
+    Entity target = entities[count / 2 + 1];
+    runner.Run("ecs/add_remove_status", [&]() {
+        world.Add(target, Poisoned{ 3 });
+        world.Remove<Poisoned>(target);
+    });
+}
+
+void GameBench::StatusBenchmarks(BenchRunner& runner) {
+    const int count = 10000;
+    std::vector<Character> characters(count, Character{ "Bench", 100, 100, 12, 4, 1, 0, 100 });
+    World world;
+    StatusEngine statuses(world);
+    std::vector<Entity> entities;
+    std::vector<StatusEvent> events;
+    for (int i = 0; i < count; ++i) {
+        entities.push_back(world.Create());
+        world.Add(entities.back(), Fighter{ &characters[i] });
+    }
+
+    // A poison that never runs out ticks every turn, so each iteration does the same work
+    int poisoned = 0;
+    for (int i = 0; i < count; i += 4, ++poisoned) statuses.Apply(entities[i], StatusKind::Poison, 1 << 30);
+    runner.Run("status/end_turn_poison_2500", [&]() {
+        events.clear();
+        statuses.EndTurn(events);
+        sink = static_cast<int>(events.size());
+    }, poisoned);
+    for (int i = 0; i < count; i += 4) statuses.Remove(entities[i], StatusKind::Poison);
+
+    // Long buffs sit on the battle clock, so a turn ending doesn't look at them
+    for (int i = 0; i < 300; ++i) statuses.Apply(entities[0], StatusKind::AttackUp, 1 << 20, 1);
+    runner.Run("status/end_turn_300_idle_buffs", [&]() {
+        events.clear();
+        statuses.EndTurn(events);
+        sink = static_cast<int>(events.size());
+    });
+    statuses.Remove(entities[0], StatusKind::AttackUp);
+
+    // 300 one-turn blocks applied and worn off again
+    runner.Run("status/apply_expire_300", [&]() {
+        for (int i = 0; i < 300; ++i) statuses.Apply(entities[i], StatusKind::Blocking, 1);
+        events.clear();
+        statuses.EndTurn(events);
+        sink = static_cast<int>(statuses.ActiveCount());
+    }, 300);
+}
+
+// A turn order far longer than any battle's: it should cost log n, not n
+void GameBench::InitiativeBenchmarks(BenchRunner& runner) {
+    const int count = 10000;
+    Initiative initiative;
+    initiative.Reserve(count);
+    for (int i = 0; i < count; ++i) initiative.Add(MIN_SPEED + (i * 37) % 200);
+
+    runner.Run("initiative/turn_10k", [&]() {
+        initiative.Act(RANK_NORMAL);
+        sink = initiative.Next();
+    });
+    int actor = 0;
+    runner.Run("initiative/set_speed_10k", [&]() {
+        actor = (actor + 7919) % count;
+        initiative.SetSpeed(actor, MIN_SPEED + (actor * 53 + initiative.Now()) % 200);
+    });
+    int order[8];
+    runner.Run("initiative/preview_8_of_10k", [&]() {
+        sink = initiative.Preview(order, 8, RANK_QUICK);
+    });
+}
+
+// Far more battles than anyone plays, over the queries the Battle Records page makes
+void GameBench::StatsBenchmarks(BenchRunner& runner) {
+    const int rows = 1000000;
+    const char* enemies[] = { "Archer", "Warrior", "Paladin", "Witch", "Survival" };
+    uint64_t random = 12345;
+    auto next = [&](int range) {
+        random = random * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<int>((random >> 33) % range);
+    };
+    BattleStats stats;
+    BattleRecord record;
+    record.time = 1700000000;
+    for (int i = 0; i < rows; ++i) {
+        record.time += 30 + next(600);
+        record.playerLevel = 1 + i / 20000;
+        record.enemy = enemies[next(5)];
+        record.enemyLevel = std::max(1, record.playerLevel + next(5) - 2);
+        record.outcome = static_cast<BattleOutcome>(next(10) < 7 ? 0 : 1 + next(2));
+        record.turns = 1 + next(12);
+        record.attacks = next(record.turns + 1);
+        record.skills = next(record.turns - record.attacks + 1);
+        record.blocks = record.turns - record.attacks - record.skills;
+        record.items = next(3);
+        record.coins = record.outcome == BattleOutcome::Won ? 5 + next(20) : 0;
+        record.exp = record.outcome == BattleOutcome::Won ? 10 + next(40) : 0;
+        stats.Append(record);
+    }
+
+    StatsQuery byEnemy;
+    byEnemy.groupBy = StatColumn::Enemy;
+    byEnemy.sum = StatColumn::Turns;
+    runner.Run("stats/group_by_enemy_1m", [&]() {
+        sink = static_cast<int>(stats.Query(byEnemy).size());
+    });
+
+    StatsQuery byLevel;
+    int witch = stats.EnemyId("Witch");
+    byLevel.Where(StatColumn::Enemy, witch, witch);
+    byLevel.groupBy = StatColumn::PlayerLevel;
+    runner.Run("stats/win_rate_by_level_1m", [&]() {
+        sink = static_cast<int>(stats.Query(byLevel).size());
+    });
+
+    // The last 30 days sit in the newest blocks: the zone maps skip the rest
+    StatsQuery lastMonth = byEnemy;
+    lastMonth.Where(StatColumn::Time, record.time - 30 * 24 * 60 * 60, record.time);
+    runner.Run("stats/last_30_days_1m", [&]() {
+        sink = static_cast<int>(stats.Query(lastMonth).size());
+    });
+
+    StatsQuery coinsByWeek;
+    coinsByWeek.Where(StatColumn::Outcome, 0, 0);
+    coinsByWeek.groupBy = StatColumn::Time;
+    coinsByWeek.bucket = 7 * 24 * 60 * 60;
+    coinsByWeek.sum = StatColumn::Coins;
+    runner.Run("stats/coins_by_week_1m", [&]() {
+        sink = static_cast<int>(stats.Query(coinsByWeek).size());
+    });
+
+    BattleStats appended;
+    runner.Run("stats/append_in_memory", [&]() {
+        record.time++;
+        appended.Append(record);
+    });
+}
+
+// What every frame and battle action pays for the flight recorder
+void GameBench::FlightBenchmarks(BenchRunner& runner) {
+    int frame = 0;
+    runner.RunNoAlloc("flight/record", [&]() {
+        FlightRecorder::Record(FlightEvent::Frame, ++frame);
+    });
+    runner.RunNoAlloc("flight/record_text", [&]() {
+        FlightRecorder::Record(FlightEvent::Action, ++frame, 0, "Attack");
+    });
+}
+
+bool GameBench::CheckAnimations() {
+    bool ok = true;
+    auto expect = [&](const char* what, double actual, double expected) {
+        if (std::fabs(actual - expected) < 1e-4) return;
+        std::cerr << "anim check: " << what << " is " << actual << ", expected " << expected << std::endl;
+        ok = false;
+    };
+
+    // Paused, Advance does nothing and Step still moves; scaled, Advance moves by the scaled time
+    GameClock clock;
+    clock.Advance(0.25);
+    expect("clock after Advance", clock.Now(), 0.25);
+    clock.SetPaused(true);
+    clock.Advance(1.0);
+    expect("clock after a paused Advance", clock.Now(), 0.25);
+    clock.Step(0.25);
+    expect("clock after a paused Step", clock.Now(), 0.5);
+    clock.SetPaused(false);
+    clock.SetScale(2.0);
+    clock.Advance(0.25);
+    expect("clock after Advance at scale 2", clock.Now(), 1.0);
+    clock.SetScale(1.0);
+
+    // A bar easing linearly from 1 to 0 over half a second
+    AnimationPool pool;
+    const uint16_t bar = 7;
+    pool.EaseTo(bar, 1.0f, 0.5f, clock.Now(), Ease::Linear);
+    expect("bar on its first EaseTo", pool.Value(bar, -1.0f), 1.0);
+    pool.EaseTo(bar, 0.0f, 0.5f, clock.Now(), Ease::Linear);
+    clock.Advance(0.25);
+    pool.Update(clock.Now());
+    expect("bar halfway", pool.Value(bar, -1.0f), 0.5);
+    clock.SetPaused(true);
+    clock.Advance(10.0);
+    pool.Update(clock.Now());
+    expect("bar while paused", pool.Value(bar, -1.0f), 0.5);
+    clock.SetPaused(false);
+    clock.SetScale(0.5);
+    clock.Advance(0.25);
+    pool.Update(clock.Now());
+    expect("bar after Advance at scale 0.5", pool.Value(bar, -1.0f), 0.25);
+    clock.SetScale(1.0);
+    clock.Advance(0.5);
+    pool.Update(clock.Now());
+    expect("bar once done", pool.Value(bar, -1.0f), 0.0);
+
+    // A damage number queued a quarter second ahead plays, then is dropped
+    pool.Text("-5", Vector2{ 0.0f, 0.0f }, 20, RED, clock.Now() + 0.25, 0.5f, 40.0f, Ease::Linear);
+    pool.Update(clock.Now());
+    expect("texts queued", pool.Playing(), 1);
+    clock.Advance(0.5);
+    pool.Update(clock.Now());
+    expect("texts halfway", pool.Playing(), 1);
+    clock.Advance(0.25);
+    pool.Update(clock.Now());
+    expect("texts once done", pool.Playing(), 0);
+    expect("animations left", pool.Count(), 1);
+    return ok;
+}
+
+void GameBench::AnimationBenchmarks(BenchRunner& runner) {
+    // A full Survival wave's HP bars plus a turn's worth of numbers, on a
+    // clock stepped at 60 fps so every run sees the same frames
+    AnimationPool pool;
+    GameClock clock;
+    const int bars = 60;
+    int frame = 0;
+    for (int i = 0; i < bars; ++i) pool.EaseTo(static_cast<uint16_t>(i), 1.0f, 0.4f, clock.Now());
+    runner.RunNoAlloc("anim/update_60_bars", [&]() {
+        clock.Step(1.0 / 60.0);
+        if (++frame % 30 == 0) {
+            for (int i = 0; i < bars; ++i) pool.EaseTo(static_cast<uint16_t>(i), (frame / 30 % 10) / 10.0f, 0.4f, clock.Now());
+            for (int i = 0; i < 8; ++i) pool.Text("-12", Vector2{ 100.0f + i * 40.0f, 100.0f }, 30, RED, clock.Now() + i * 0.05, 0.8f, 40.0f);
+            pool.Flash(RED, 0.3f, clock.Now(), 0.3f);
+        }
+        pool.Update(clock.Now());
+        sink = pool.Count();
+    });
+}
+
+void GameBench::SaveBenchmarks(BenchRunner& runner, Game& game) {
+    // A played-through save is around a dozen stacks; the large one stresses the format
+    for (int count : { 12, 10000 }) {
+        FillInventory(game, count, "Potion");
+        std::string suffix = "/items_" + std::to_string(count);
+        runner.Run("save/save_game" + suffix, [&]() {
+            game.SaveGame();
+        });
+        runner.Run("save/load_game" + suffix, [&]() {
+            game.LoadGame();
+        });
+        runner.Run("save/round_trip" + suffix, [&]() {
+            game.SaveGame();
+            game.LoadGame();
+        });
+    }
+}
+
+void GameBench::ItemBenchmarks(BenchRunner& runner, Game& game) {
+    // Magic Water is the last name UseItem compares against
+    for (int count : { 12, 1000 }) {
+        FillInventory(game, count, "Magic Water");
+        size_t index = game.inventory.size() - 1;
+        runner.Run("items/use_item/items_" + std::to_string(count), [&]() {
+            game.statuses.Apply(game.playerEntity, StatusKind::SkillCooldown, 3);
+            game.inventory[index].quantity = 5;
+            game.UseItem(index);
+        });
+    }
+}
+
+void GameBench::LayoutBenchmarks(BenchRunner& runner, Game& game, const std::string& suffix) {
+    runner.RunNoAlloc("ui/format_battle_hud", [&]() {
+        int total = 0;
+        total += FrameText(game.player.name, " - Lvl ", game.player.level)[0];
+        total += FrameText("HP: ", game.player.currentHP, "/", game.player.maxHP)[0];
+        total += FrameText("EXP: ", game.player.exp, "/", game.player.expToLevel)[0];
+        total += FrameText(game.enemy.name, " Lvl ", game.enemy.level)[0];
+        total += FrameText("HP: ", game.enemy.currentHP, "/", game.enemy.maxHP)[0];
+        FrameArena::Reset();
+        sink = total;
+    });
+
+    // Same text and measurement ShowShop does for one page of five rows
+    runner.RunNoAlloc("ui/measure_shop_page" + suffix, [&]() {
+        int total = 0;
+        int rows = std::min(5, Content().ShopItemCount());
+        for (int i = 0; i < rows; ++i) {
+            const ShopItemDef& item = Content().ShopItem(i);
+            total += Gfx().MeasureText(FrameText(item.name, " (", item.price, " coins) - ", item.description), 20);
+        }
+        FrameArena::Reset();
+        sink = total;
+    });
+
+    // The hit-test rectangles UpdateBattle and DrawBattle build every frame
+    const char* actions[5] = { "Attack", "Skill", "Block", "Item", "Run" };
+    Vector2 mouse = { 40.0f, (float)(game.screenHeight - 120) };
+    runner.RunNoAlloc("ui/layout_battle_actions" + suffix, [&]() {
+        int hovered = -1;
+        for (int i = 0; i < 5; i++) {
+            Rectangle rect = { 20.0f, (float)(game.screenHeight - 150 + i * 30), (float)Gfx().MeasureText(actions[i], 20), 30.0f };
+            if (CheckCollisionPointRec(mouse, rect)) hovered = i;
+        }
+        sink = hovered + Gfx().MeasureText("Skill", 20);
+    });
+
+    // One battle on screen: most frames only composite the cached layers
+    game.state = GameState::Battle;
+    game.InitEnemy();
+    game.battleLog.assign(Game::BATTLE_LOG_MAX_LINES, "Bench hits Warrior for 12 damage!");
+    runner.RunNoAlloc("ui/draw_battle" + suffix, [&]() {
+        game.DrawBattle();
+        GfxQueue().Flush();
+        FrameArena::Reset();
+    });
+    // Every layer drawn again, as each frame did before they were cached
+    runner.RunNoAlloc("ui/draw_battle_uncached" + suffix, [&]() {
+        game.battleLayers.Invalidate();
+        game.DrawBattle();
+        GfxQueue().Flush();
+        FrameArena::Reset();
+    });
+
+    // Survival Mode's biggest wave on screen
+    game.InitEnemyForSurvival(Game::SURVIVAL_MAX_ENEMIES);
+    // Sorted and sent on by the render queue, as at the end of a frame
+    runner.RunNoAlloc("ui/draw_group_battle_60" + suffix, [&]() {
+        game.DrawGroupBattle();
+        GfxQueue().Flush();
+        FrameArena::Reset();
+    });
+    // The same draws sent in the order they were made
+    GfxQueue().SetBypass(true);
+    runner.RunNoAlloc("ui/draw_group_battle_60_unsorted" + suffix, [&]() {
+        game.DrawGroupBattle();
+        FrameArena::Reset();
+    });
+    GfxQueue().SetBypass(false);
+    game.battleLog.clear();
+    game.state = GameState::TownSquare;
+}
+
+void GameBench::RunAll(BenchRunner& runner, bool haveWindow) {
+    // Without a window the game draws and measures through the null renderer;
+    // its bitmap font metrics differ from raylib's, so those results get their own names
+    NullRenderer nullRenderer(800, 450);
+    if (!haveWindow) SetRenderer(&nullRenderer);
+
+    Game game(800, 450);
+    game.player.name = "Bench";
+
+    std::streambuf* previous = std::cout.rdbuf();
+    NullBuffer nullBuffer;
+    std::cout.rdbuf(&nullBuffer);
+
+    BattleBenchmarks(runner, game);
+    EcsBenchmarks(runner);
+    StatusBenchmarks(runner);
+    InitiativeBenchmarks(runner);
+    StatsBenchmarks(runner);
+    FlightBenchmarks(runner);
+    AnimationBenchmarks(runner);
+    ItemBenchmarks(runner, game);
+    SaveBenchmarks(runner, game);
+    LayoutBenchmarks(runner, game, haveWindow ? "" : "/null_renderer");
+
+    std::cout.rdbuf(previous);
+    game.Unload();
+    SetRenderer(nullptr);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseBenchOptions(argc, argv, options)) return 2;
+
+    // Resolve output paths before moving into the scratch directory
+    namespace fs = std::filesystem;
+    if (!options.jsonPath.empty()) options.jsonPath = fs::absolute(options.jsonPath).string();
+    if (!options.baselinePath.empty()) options.baselinePath = fs::absolute(options.baselinePath).string();
+
+    SetTraceLogLevel(LOG_ERROR);
+    bool haveWindow = false;
+    if (!options.noWindow) {
+        // raylib's MeasureText needs the default font, which only exists once a window is open
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        InitWindow(800, 450, "rpg_bench");
+        haveWindow = IsWindowReady();
+    }
+
+    // Saves and the journal are written to the working directory; keep them out of the player's
+    fs::path scratch = fs::temp_directory_path() / "rpg_bench";
+    fs::remove_all(scratch);
+    fs::create_directories(scratch);
+    fs::path original = fs::current_path();
+    fs::current_path(scratch);
+
+    BenchRunner runner(options);
+    GameBench::RunAll(runner, haveWindow);
+
+    fs::current_path(original);
+    fs::remove_all(scratch);
+    if (haveWindow) CloseWindow();
+
+    bool ok = true;
+    if (!options.jsonPath.empty() && !runner.WriteJson(options.jsonPath)) {
+        std::cerr << options.jsonPath << ": cannot write results" << std::endl;
+        ok = false;
+    }
+    if (!GameBench::CheckAnimations()) ok = false;
+    if (!runner.CheckNoAllocs()) ok = false;
+    if (!options.baselinePath.empty() && !runner.CompareWithBaseline(options.baselinePath)) {
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+// Compiles the human-editable content tables into the binary blob the game loads.
+// Usage: ContentCompiler <Content dir> <output content.bin>
+#include "ContentCompiler.h"
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: ContentCompiler <content dir> <output file>" << std::endl;
+        return 2;
+    }
+
+    std::vector<uint32_t> blob;
+    std::string error;
+    if (!CompileContent(argv[1], blob, error)) {
+        // Same format as compiler errors so Visual Studio links it to the file
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (!WriteContentBlob(argv[2], blob)) {
+        std::cerr << argv[2] << ": cannot write content blob" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << argv[2] << " (" << blob.size() * sizeof(uint32_t) << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,246 @@
+// Plays PvP duels (Netplay.h) between two sessions in one process, over real
+// UDP sockets on 127.0.0.1, with latency, jitter and packet loss put in on
+// the sending side, and checks that both peers finish every duel with the
+// same confirmed state.
+//
+// Time is virtual: a step is one millisecond, so a run with seconds of lag
+// takes no wall time. Each side is a bot that thinks for a random while
+// before every action, so the two run ahead of each other by turns and the
+// prediction and rollback get exercised.
+//
+// With --desync-at, one side's state is changed behind the checksums' back
+// once that many turns are confirmed, and the run passes only if the desync
+// is caught.
+//
+// Usage: DuelHarness [--duels N] [--latency MS] [--jitter MS] [--loss PERCENT]
+//        [--think MS] [--seed N] [--desync-at TURN]
+//
+// Exits with 1 when a duel ends differently on the two sides or stalls, or
+// when an injected desync goes unnoticed.
+#include "Netplay.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int duels = 100;
+    int latencyMs = 60;
+    int jitterMs = 40;
+    int lossPercent = 10;
+    int thinkMs = 400;
+    uint64_t seed = 1;
+    int desyncAt = -1;
+};
+
+// Holds every packet for the latency plus up to the jitter, so they can
+// arrive out of order, and drops lossPercent of them
+class ImpairedLink : public DatagramLink {
+public:
+    ImpairedLink(DatagramLink& inner, const Options& options, uint64_t seed)
+        : inner(inner), options(options), rng(seed) {}
+
+    void Send(const uint8_t* data, int size) override {
+        if (rng.Range(1, 100) <= options.lossPercent) return;
+        Delayed packet;
+        packet.due = now + options.latencyMs + rng.Range(0, options.jitterMs);
+        packet.bytes.assign(data, data + size);
+        queue.push_back(packet);
+    }
+
+    int Receive(uint8_t* data, int capacity) override {
+        return inner.Receive(data, capacity);
+    }
+
+    // Hands the packets that are due to the socket
+    void Flush(uint32_t nowMs) {
+        now = nowMs;
+        for (size_t i = 0; i < queue.size();) {
+            if (queue[i].due > now) {
+                ++i;
+                continue;
+            }
+            inner.Send(queue[i].bytes.data(), static_cast<int>(queue[i].bytes.size()));
+            queue[i] = queue.back();
+            queue.pop_back();
+        }
+    }
+
+private:
+    struct Delayed {
+        uint32_t due;
+        std::vector<uint8_t> bytes;
+    };
+
+    DatagramLink& inner;
+    const Options& options;
+    SimRng rng;
+    uint32_t now = 0;
+    std::vector<Delayed> queue;
+};
+
+struct Bot {
+    SimRng rng;
+    uint32_t nextActMs;
+
+    CombatAction Choose(const DuelFighter& self) {
+        int roll = rng.Range(0, 9);
+        if (self.skillCooldown == 0 && roll < 3) return CombatAction::Skill;
+        if (roll < 6) return CombatAction::Block;
+        return CombatAction::Attack;
+    }
+};
+
+struct Totals {
+    int finished = 0;
+    int mismatched = 0;
+    int stalled = 0;
+    int desyncsInjected = 0;
+    int desyncsCaught = 0;
+    int unexpectedDesyncs = 0;
+    long long turns = 0;
+    long long rollbacks = 0;
+    long long resimulatedTurns = 0;
+    long long packets = 0;
+    long long bytes = 0;
+    long long virtualMs = 0;
+};
+
+const uint32_t STALL_MS = 10 * 60 * 1000;
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--duels" && hasValue) options.duels = std::atoi(argv[++i]);
+        else if (arg == "--latency" && hasValue) options.latencyMs = std::atoi(argv[++i]);
+        else if (arg == "--jitter" && hasValue) options.jitterMs = std::atoi(argv[++i]);
+        else if (arg == "--loss" && hasValue) options.lossPercent = std::atoi(argv[++i]);
+        else if (arg == "--think" && hasValue) options.thinkMs = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) options.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--desync-at" && hasValue) options.desyncAt = std::atoi(argv[++i]);
+        else return false;
+    }
+    return options.duels > 0 && options.latencyMs >= 0 && options.jitterMs >= 0 &&
+        options.lossPercent >= 0 && options.lossPercent < 100 && options.thinkMs >= 0;
+}
+
+// One duel; false if the sockets couldn't be opened
+bool PlayDuel(const Options& options, int index, Totals& totals) {
+    UdpLink hostSocket;
+    UdpLink guestSocket;
+    if (!hostSocket.Host(0) || !guestSocket.Join({ LOOPBACK_IP, hostSocket.LocalPort() })) return false;
+
+    uint64_t seed = options.seed * 1000003ULL + static_cast<uint64_t>(index);
+    ImpairedLink links[2] = { { hostSocket, options, seed * 4 + 1 }, { guestSocket, options, seed * 4 + 2 } };
+    Bot bots[2] = { { SimRng(seed * 4 + 3), 0 }, { SimRng(seed * 4 + 4), 0 } };
+
+    // Different builds of hero, so seat order matters
+    SimRng statsRng(seed);
+    int hostLevel = statsRng.Range(1, 10);
+    int guestLevel = statsRng.Range(1, 10);
+    DuelSession sessions[2];
+    sessions[0].Start(links[0], 0, PlayerStatsAtLevel(hostLevel), 0);
+    sessions[1].Start(links[1], 1, PlayerStatsAtLevel(guestLevel), 0);
+
+    bool injected = false;
+    uint32_t now = 0;
+    for (;; ++now) {
+        for (int side = 0; side < 2; ++side) {
+            links[side].Flush(now);
+            sessions[side].Update(now);
+            DuelSession& session = sessions[side];
+            if (session.CanAct() && now >= bots[side].nextActMs) {
+                session.Act(bots[side].Choose(session.Shown().fighters[side]), now);
+                bots[side].nextActMs = now + static_cast<uint32_t>(bots[side].rng.Range(0, options.thinkMs));
+            }
+        }
+        if (!injected && options.desyncAt >= 0 && sessions[1].Phase() == NetplayPhase::Playing &&
+            sessions[1].ConfirmedTurns() == options.desyncAt) {
+            sessions[1].InjectDesync();
+            injected = true;
+        }
+
+        NetplayPhase phases[2] = { sessions[0].Phase(), sessions[1].Phase() };
+        if (phases[0] == NetplayPhase::Desynced || phases[1] == NetplayPhase::Desynced) break;
+        if (phases[0] == NetplayPhase::Disconnected || phases[1] == NetplayPhase::Disconnected) break;
+        if (phases[0] == NetplayPhase::Finished && phases[1] == NetplayPhase::Finished &&
+            sessions[0].PeerCaughtUp() && sessions[1].PeerCaughtUp()) break;
+        if (now >= STALL_MS) break;
+    }
+
+    bool desynced = sessions[0].Phase() == NetplayPhase::Desynced || sessions[1].Phase() == NetplayPhase::Desynced;
+    if (injected) {
+        totals.desyncsInjected++;
+        if (desynced) totals.desyncsCaught++;
+        else std::printf("duel %d: desync injected at turn %d went unnoticed\n", index, options.desyncAt);
+    }
+    else if (desynced) {
+        totals.unexpectedDesyncs++;
+        std::printf("duel %d: desync at turn %d\n", index,
+            std::max(sessions[0].DesyncTurn(), sessions[1].DesyncTurn()));
+    }
+    else if (sessions[0].Phase() != NetplayPhase::Finished || sessions[1].Phase() != NetplayPhase::Finished) {
+        totals.stalled++;
+        std::printf("duel %d: stalled at turns %d/%d\n", index, sessions[0].ConfirmedTurns(), sessions[1].ConfirmedTurns());
+    }
+    else if (DuelChecksum(sessions[0].Confirmed()) != DuelChecksum(sessions[1].Confirmed())) {
+        totals.mismatched++;
+        std::printf("duel %d: the peers finished in different states\n", index);
+    }
+    else {
+        totals.finished++;
+    }
+    totals.turns += sessions[0].ConfirmedTurns();
+
+    for (const DuelSession& session : sessions) {
+        totals.rollbacks += session.Stats().rollbacks;
+        totals.resimulatedTurns += session.Stats().resimulatedTurns;
+        totals.packets += session.Stats().packetsSent;
+        totals.bytes += session.Stats().bytesSent;
+    }
+    totals.virtualMs += now;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s [--duels N] [--latency MS] [--jitter MS] [--loss PERCENT]\n"
+            "       [--think MS] [--seed N] [--desync-at TURN]\n", argv[0]);
+        return 2;
+    }
+
+    Totals totals;
+    for (int i = 0; i < options.duels; ++i) {
+        if (!PlayDuel(options, i, totals)) {
+            std::fprintf(stderr, "Could not open UDP sockets on loopback\n");
+            return 2;
+        }
+    }
+
+    std::printf("%d duels, %d ms latency + up to %d ms jitter, %d%% loss\n",
+        options.duels, options.latencyMs, options.jitterMs, options.lossPercent);
+    std::printf("  %lld turns; finished alike: %d, different: %d, stalled: %d\n",
+        totals.turns, totals.finished, totals.mismatched, totals.stalled);
+    if (options.desyncAt >= 0) {
+        std::printf("  injected desyncs caught: %d of %d\n", totals.desyncsCaught, totals.desyncsInjected);
+    }
+    if (totals.unexpectedDesyncs > 0) std::printf("  desyncs: %d\n", totals.unexpectedDesyncs);
+    long long allTurns = std::max(1LL, totals.turns);
+    std::printf("  rollbacks: %lld (%lld turns played again)\n", totals.rollbacks, totals.resimulatedTurns);
+    std::printf("  sent: %lld packets, %lld bytes, %.1f bytes/packet, %.1f bytes/turn per side\n",
+        totals.packets, totals.bytes, totals.packets ? static_cast<double>(totals.bytes) / totals.packets : 0.0,
+        static_cast<double>(totals.bytes) / 2.0 / allTurns);
+    std::printf("  virtual time: %.1f s\n", totals.virtualMs / 1000.0);
+
+    bool ok = totals.mismatched == 0 && totals.stalled == 0 && totals.unexpectedDesyncs == 0 &&
+        totals.desyncsCaught == totals.desyncsInjected;
+    return ok ? 0 : 1;
+}
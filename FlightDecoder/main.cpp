@@ -0,0 +1,176 @@
+// Prints a flight recorder dump (FlightRecorder.h) as a timeline: when each
+// event happened since the game started and how long before the dump, oldest
+// first. Runs of Frame events are folded into one line with their count,
+// average and worst frame time; a Hitch or anything else ends the run.
+//
+// Usage: FlightDecoder DUMP [--frames] [--last N]
+//   --frames   one line per frame instead of folded runs
+//   --last N   only the N newest events
+//
+// Exits with 1 when the file is not a flight dump this build understands.
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string path;
+    bool frames = false;
+    size_t last = 0;  // 0: everything
+};
+
+struct Event {
+    uint32_t sequence;
+    double seconds;  // since Install
+    uint8_t kind;
+    uint8_t thread;
+    int32_t a;
+    int32_t b;
+    std::string text;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--frames") == 0) options.frames = true;
+        else if (std::strcmp(argv[i], "--last") == 0 && i + 1 < argc) options.last = std::strtoul(argv[++i], nullptr, 10);
+        else if (argv[i][0] != '-' && options.path.empty()) options.path = argv[i];
+        else return false;
+    }
+    return !options.path.empty();
+}
+
+std::string Details(const Event& e) {
+    char line[96];
+    switch (static_cast<FlightEvent>(e.kind)) {
+    case FlightEvent::Start: std::snprintf(line, sizeof(line), "hitch threshold %d ms", e.a); break;
+    case FlightEvent::Action: std::snprintf(line, sizeof(line), "%s (%d)", e.text.c_str(), e.a); break;
+    case FlightEvent::Frame: std::snprintf(line, sizeof(line), "%.2f ms", e.a / 1000.0); break;
+    case FlightEvent::Hitch: std::snprintf(line, sizeof(line), "%.2f ms, threshold %d ms", e.a / 1000.0, e.b); break;
+    case FlightEvent::Save:
+    case FlightEvent::Load:
+        std::snprintf(line, sizeof(line), "%s %.2f ms%s", e.text.c_str(), e.a / 1000.0, e.b ? "" : " FAILED");
+        break;
+    case FlightEvent::Crash: std::snprintf(line, sizeof(line), "code %d (0x%08x)", e.a, static_cast<uint32_t>(e.a)); break;
+    default: std::snprintf(line, sizeof(line), "%s", e.text.c_str()); break;
+    }
+    return line;
+}
+
+void PrintLine(double seconds, double dumpSeconds, uint8_t thread, const char* name, const std::string& details) {
+    std::printf("%10.3f %10.3f %3d  %-12s %s\n", seconds, seconds - dumpSeconds, thread, name, details.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: %s DUMP [--frames] [--last N]\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream in(options.path, std::ios::binary);
+    FlightDumpHeader header = {};
+    if (!in || !in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        std::fprintf(stderr, "Can't read %s\n", options.path.c_str());
+        return 1;
+    }
+    if (header.magic != FLIGHT_MAGIC || header.version != FLIGHT_VERSION ||
+        header.recordSize != sizeof(FlightRecord) || header.capacity == 0 ||
+        (header.capacity & (header.capacity - 1)) != 0) {
+        std::fprintf(stderr, "%s is not a version %u flight dump\n", options.path.c_str(), FLIGHT_VERSION);
+        return 1;
+    }
+    std::vector<FlightRecord> ring(header.capacity);
+    if (!in.read(reinterpret_cast<char*>(ring.data()), static_cast<std::streamsize>(ring.size() * sizeof(FlightRecord)))) {
+        std::fprintf(stderr, "%s is cut short\n", options.path.c_str());
+        return 1;
+    }
+
+    // Ticks to seconds from the two clock pairs; without a second one they are nanoseconds
+    double nsPerTick = header.dumpTicks > header.startTicks
+        ? double(header.dumpNs - header.startNs) / double(header.dumpTicks - header.startTicks) : 1.0;
+    auto secondsAt = [&](uint64_t ticks) {
+        return (double(int64_t(ticks - header.startTicks)) * nsPerTick) / 1e9;
+    };
+    double dumpSeconds = double(header.dumpNs - header.startNs) / 1e9;
+
+    std::vector<Event> events;
+    for (const FlightRecord& record : ring) {
+        uint32_t sequence = record.sequence.load(std::memory_order_relaxed);
+        if (sequence == 0 || header.next - sequence >= header.capacity) continue;
+        Event e;
+        e.sequence = sequence;
+        e.seconds = secondsAt(record.ticks);
+        e.kind = record.kind;
+        e.thread = record.thread;
+        e.a = record.a;
+        e.b = record.b;
+        e.text.assign(record.text, std::find(record.text, record.text + FLIGHT_TEXT, '\0'));
+        events.push_back(e);
+    }
+    // Oldest first: by age, so a wrapped sequence still sorts right
+    std::sort(events.begin(), events.end(), [&](const Event& x, const Event& y) {
+        return header.next - x.sequence > header.next - y.sequence;
+    });
+    if (options.last > 0 && events.size() > options.last) {
+        events.erase(events.begin(), events.end() - options.last);
+    }
+
+    char started[32] = "?";
+    std::time_t startTime = static_cast<std::time_t>(header.startTime);
+    if (const std::tm* local = std::localtime(&startTime)) std::strftime(started, sizeof(started), "%Y-%m-%d %H:%M:%S", local);
+    if (header.crash != 0) std::printf("%s: crash, code %d", options.path.c_str(), header.crash);
+    else std::printf("%s: hitch", options.path.c_str());
+    std::printf(", %.3f s after a start at %s, %zu of %u events kept\n\n",
+        dumpSeconds, started, events.size(), header.next);
+
+    int counts[static_cast<int>(FlightEvent::Count) + 1] = {};
+    std::printf("%10s %10s %3s  %-12s %s\n", "since s", "before s", "thr", "event", "details");
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& e = events[i];
+        int kind = std::min<int>(e.kind, static_cast<int>(FlightEvent::Count));
+        counts[kind]++;
+        const char* name = FlightEventName(static_cast<FlightEvent>(e.kind));
+        if (options.frames || static_cast<FlightEvent>(e.kind) != FlightEvent::Frame) {
+            PrintLine(e.seconds, dumpSeconds, e.thread, name, Details(e));
+            continue;
+        }
+        // Fold the run of frames from the same thread starting here
+        size_t end = i;
+        int64_t totalUs = 0;
+        int32_t worstUs = 0;
+        while (end < events.size() && static_cast<FlightEvent>(events[end].kind) == FlightEvent::Frame &&
+               events[end].thread == e.thread) {
+            totalUs += events[end].a;
+            worstUs = std::max(worstUs, events[end].a);
+            ++end;
+        }
+        size_t run = end - i;
+        counts[kind] += static_cast<int>(run - 1);
+        if (run == 1) {
+            PrintLine(e.seconds, dumpSeconds, e.thread, name, Details(e));
+        }
+        else {
+            char details[96];
+            std::snprintf(details, sizeof(details), "x%zu, avg %.2f ms, max %.2f ms",
+                run, totalUs / 1000.0 / run, worstUs / 1000.0);
+            PrintLine(e.seconds, dumpSeconds, e.thread, name, details);
+        }
+        i = end - 1;
+    }
+
+    std::printf("\n");
+    for (int kind = 0; kind <= static_cast<int>(FlightEvent::Count); ++kind) {
+        if (counts[kind] == 0) continue;
+        std::printf("%-12s %d\n", FlightEventName(static_cast<FlightEvent>(kind)), counts[kind]);
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include "Animation.h"
+#include "Renderer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+void GameClock::Advance(double seconds) {
+    if (!paused) now += seconds * scale;
+}
+
+void GameClock::Step(double seconds) {
+    now += seconds;
+}
+
+float ApplyEase(Ease ease, float t) {
+    switch (ease) {
+    case Ease::OutCubic: {
+        float u = 1.0f - t;
+        return 1.0f - u * u * u;
+    }
+    case Ease::InOutQuad:
+        return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * (1.0f - t) * (1.0f - t);
+    default:
+        return t;
+    }
+}
+
+Animation* AnimationPool::Add() {
+    if (count == CAPACITY) return nullptr;
+    Animation* item = &items[count++];
+    *item = Animation();
+    return item;
+}
+
+void AnimationPool::EaseTo(uint16_t key, float target, float duration, double now, Ease ease) {
+    for (int i = 0; i < count; ++i) {
+        Animation& item = items[i];
+        if (item.kind != AnimKind::Value || item.key != key) continue;
+        if (item.to == target) return;
+        item.from = item.value;
+        item.to = target;
+        item.start = now;
+        item.duration = duration;
+        item.ease = ease;
+        item.progress = 0.0f;
+        return;
+    }
+    Animation* item = Add();
+    if (!item) return;
+    item->kind = AnimKind::Value;
+    item->key = key;
+    item->ease = ease;
+    item->start = now;
+    item->from = item->to = item->value = target;
+    item->progress = 1.0f;
+    item->started = true;
+}
+
+float AnimationPool::Value(uint16_t key, float fallback) const {
+    for (int i = 0; i < count; ++i) {
+        if (items[i].kind == AnimKind::Value && items[i].key == key) return items[i].value;
+    }
+    return fallback;
+}
+
+bool AnimationPool::Text(const char* text, Vector2 position, int fontSize, Color color, double start, float duration,
+    float rise, Ease ease) {
+    Animation* item = Add();
+    if (!item) return false;
+    item->kind = AnimKind::Text;
+    item->ease = ease;
+    item->start = start;
+    item->duration = duration;
+    item->to = rise;
+    item->position = position;
+    item->fontSize = fontSize;
+    item->color = color;
+    // Longer text keeps its start: damage numbers and short words fit
+    std::strncpy(item->text, text, sizeof(item->text) - 1);
+    return true;
+}
+
+bool AnimationPool::Flash(Color color, float alpha, double start, float duration) {
+    Animation* item = Add();
+    if (!item) return false;
+    item->kind = AnimKind::Flash;
+    item->ease = Ease::Linear;
+    item->start = start;
+    item->duration = duration;
+    item->from = item->value = alpha;
+    item->color = color;
+    return true;
+}
+
+void AnimationPool::Update(double now) {
+    PROFILE_ZONE("AnimationPool::Update");
+    // Finished ones are dropped by moving the rest down, so the draw order holds
+    int kept = 0;
+    for (int i = 0; i < count; ++i) {
+        Animation& item = items[i];
+        double elapsed = now - item.start;
+        item.started = elapsed >= 0.0;
+        if (item.started) {
+            item.progress = item.duration > 0.0f ? std::min(1.0f, static_cast<float>(elapsed / item.duration)) : 1.0f;
+            item.value = item.from + (item.to - item.from) * ApplyEase(item.ease, item.progress);
+        }
+        bool finished = item.started && item.progress >= 1.0f && item.kind != AnimKind::Value;
+        if (finished) continue;
+        if (kept != i) items[kept] = item;
+        kept++;
+    }
+    count = kept;
+}
+
+void AnimationPool::Draw(int screenWidth, int screenHeight) const {
+    for (int i = 0; i < count; ++i) {
+        const Animation& item = items[i];
+        if (!item.started) continue;
+        switch (item.kind) {
+        case AnimKind::Flash:
+            Gfx().DrawRectangle(0, 0, screenWidth, screenHeight, Fade(item.color, item.value));
+            break;
+        case AnimKind::Text:
+            Gfx().DrawText(item.text, (int)item.position.x, (int)(item.position.y - item.value), item.fontSize,
+                Fade(item.color, 1.0f - item.progress));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int AnimationPool::Playing() const {
+    int playing = 0;
+    for (int i = 0; i < count; ++i) {
+        if (items[i].kind != AnimKind::Value) playing++;
+    }
+    return playing;
+}
@@ -0,0 +1,101 @@
+// Animation.h
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+
+// Clock animations run on, in seconds. Screens advance it with each frame's
+// time, so it follows the input provider's clock and replays come out the
+// same. Paused it stands still, scaled it runs fast or slow, and Step moves it
+// by an exact amount for benchmarks and deterministic runs.
+class GameClock {
+public:
+    // Frame time; ignored while paused
+    void Advance(double seconds);
+    // Exactly seconds, paused or not
+    void Step(double seconds);
+
+    void SetPaused(bool on) { paused = on; }
+    bool Paused() const { return paused; }
+    void SetScale(double factor) { scale = factor; }
+    double Scale() const { return scale; }
+
+    double Now() const { return now; }
+
+private:
+    double now = 0.0;
+    double scale = 1.0;
+    bool paused = false;
+};
+
+enum class Ease : uint8_t { Linear, OutCubic, InOutQuad };
+
+// t in 0..1
+float ApplyEase(Ease ease, float t);
+
+enum class AnimKind : uint8_t {
+    Value,  // a number that eases to wherever it was last sent, e.g. an HP bar; never ends
+    Text,   // rises and fades out, e.g. a damage number
+    Flash,  // a full-screen color fading out
+};
+
+// One tween: from -> to over duration, starting at start. A start later than
+// now queues it behind others, which is how timelines are built.
+struct Animation {
+    AnimKind kind;
+    Ease ease;
+    uint16_t key;        // Value: what it eases
+    double start;
+    float duration;
+    float from;          // Value: the value; Text: pixels risen; Flash: alpha
+    float to;
+    float value;         // at the clock time of the last Update
+    float progress;      // 0..1, before easing
+    bool started;
+    Vector2 position;    // Text
+    int fontSize;        // Text
+    Color color;
+    char text[16];       // Text
+};
+
+// Every running animation in one fixed array, updated in one pass and drawn
+// in the order they were added. Nothing is allocated after construction;
+// when the pool is full new texts and flashes are dropped.
+//
+//   pool.Text("-12", where, 30, RED, clock.Now(), 0.8f, 40.0f);
+//   pool.Flash(RED, 0.35f, clock.Now() + 0.25, 0.3f);   // a quarter second later
+//   pool.EaseTo(HP_BAR, hp, 0.4f, clock.Now());
+//   ...
+//   pool.Update(clock.Now());
+//   float shown = pool.Value(HP_BAR, hp);
+//   pool.Draw(width, height);
+class AnimationPool {
+public:
+    static const int CAPACITY = 128;
+
+    void Clear() { count = 0; }
+
+    // Eases key's value toward target, from wherever it is now. The first
+    // call for a key starts it at target.
+    void EaseTo(uint16_t key, float target, float duration, double now, Ease ease = Ease::OutCubic);
+    float Value(uint16_t key, float fallback) const;
+
+    bool Text(const char* text, Vector2 position, int fontSize, Color color, double start, float duration,
+        float rise, Ease ease = Ease::OutCubic);
+    bool Flash(Color color, float alpha, double start, float duration);
+
+    // Moves everything to now and drops what has finished
+    void Update(double now);
+
+    // Texts and flashes that have started, over whatever is on screen
+    void Draw(int screenWidth, int screenHeight) const;
+
+    int Count() const { return count; }
+    // Texts and flashes still running, queued ones included
+    int Playing() const;
+
+private:
+    Animation* Add();
+
+    Animation items[CAPACITY];
+    int count = 0;
+};
@@ -1,13 +1,17 @@
 // ArcherEnemy.h
 #pragma once
 #include "Enemy.h"
+#include "Content.h"
 
 class ArcherEnemy : public Enemy {
     int level;
+    const EnemyDef& stats;
 public:
-    ArcherEnemy(int lvl) : level(lvl) {}
+    ArcherEnemy(int lvl) : level(lvl), stats(Content().FindEnemy("Archer")) {}
     std::string GetName() const override { return "Archer"; }
-    int GetMaxHP() const override { return 50 + (level * 10); }
-    int GetAttack() const override { return 10 + (level * 2); }
-    int GetDefense() const override { return 2 + (level * 1); }
+    int GetMaxHP() const override { return stats.baseHP + (level * stats.hpPerLevel); }
+    int GetAttack() const override { return stats.baseAttack + (level * stats.attackPerLevel); }
+    int GetDefense() const override { return stats.baseDefense + (level * stats.defensePerLevel); }
+    int GetExpReward() const override { return stats.baseExp + (level * stats.expPerLevel); }
+    int GetCoinReward() const override { return stats.baseCoins + (level * stats.coinsPerLevel); }
 };
@@ -0,0 +1,102 @@
+#include "BattleEvents.h"
+#include <algorithm>
+
+void ApplyBattleEvent(BattleState& state, const BattleEvent& event) {
+    int side = static_cast<int>(event.side);
+    int status = static_cast<int>(event.status);
+    switch (event.kind) {
+    case BattleEventKind::TurnStarted:
+        state.turn = event.amount;
+        break;
+    case BattleEventKind::Damage:
+        state.hp[side] = std::max(0, state.hp[side] - event.amount);
+        break;
+    case BattleEventKind::Heal:
+        state.hp[side] = std::min(state.maxHP[side], state.hp[side] + event.amount);
+        break;
+    case BattleEventKind::StatusApplied:
+        // Refreshing keeps the longer duration, and Remaining reports the longest stack
+        state.statusLeft[side][status] = std::max(state.statusLeft[side][status], event.duration);
+        break;
+    case BattleEventKind::StatusRemoved:
+        state.statusLeft[side][status] = 0;
+        break;
+    case BattleEventKind::TurnEnded:
+        for (int s = 0; s < 2; ++s) {
+            for (int k = 0; k < STATUS_KIND_COUNT; ++k) {
+                if (!CountsBattles(static_cast<StatusKind>(k)) && state.statusLeft[s][k] > 0) state.statusLeft[s][k]--;
+            }
+        }
+        break;
+    case BattleEventKind::EnemyActed:
+        state.lastEnemyAction = static_cast<uint8_t>(event.amount);
+        break;
+    case BattleEventKind::ItemUsed:
+        break;
+    case BattleEventKind::Scheduled:
+        state.nextAction[side] = event.amount;
+        break;
+    }
+}
+
+void BattleEventStore::Begin(const BattleState& start) {
+    base = start;
+    current = start;
+    events.clear();
+    folded = 0;
+}
+
+void BattleEventStore::Append(const BattleEvent& event) {
+    if (events.size() == CAPACITY) {
+        size_t half = CAPACITY / 2;
+        base = StateAt(half);
+        events.erase(events.begin(), events.begin() + half);
+        folded += half;
+    }
+    events.push_back(event);
+    ApplyBattleEvent(current, event);
+}
+
+BattleState BattleEventStore::StateAt(size_t count) const {
+    BattleState state = base;
+    count = std::min(count, events.size());
+    for (size_t i = 0; i < count; ++i) ApplyBattleEvent(state, events[i]);
+    return state;
+}
+
+bool BattleEventStore::StateAtTurn(int turn, BattleState& out) const {
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i].kind == BattleEventKind::TurnStarted && events[i].amount == turn) {
+            out = StateAt(i + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t BattleEventStore::UndoPoint() const {
+    bool inCurrentTurn = true;
+    for (size_t i = events.size(); i-- > 0;) {
+        if (events[i].kind == BattleEventKind::ItemUsed) return NO_UNDO;
+        if (events[i].kind != BattleEventKind::TurnStarted) continue;
+        if (!inCurrentTurn) return i + 1;
+        inCurrentTurn = false;
+    }
+    return NO_UNDO;
+}
+
+void BattleEventStore::Truncate(size_t count) {
+    if (count >= events.size()) return;
+    events.resize(count);
+    current = StateAt(count);
+}
+
+void BattleEventStore::Rewind(size_t total, const BattleState& state) {
+    if (total < folded || total > Total()) {
+        Begin(state);
+        folded = total;
+        return;
+    }
+    events.resize(total - folded);
+    current = state;
+}
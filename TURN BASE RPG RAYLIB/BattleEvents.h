@@ -0,0 +1,91 @@
+// BattleEvents.h
+#pragma once
+#include "BattleStatus.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A battle as a list of events. Everything that changes HP or a turn-counted
+// status during a battle is appended here first, and Game copies the folded
+// state back onto its Characters, so the list says exactly how the battle
+// went. Earlier turns can be rebuilt from it and practice battles undo by
+// cutting it short. Events are plain data, small enough to save or send as is.
+
+enum class BattleSide : uint8_t {
+    Player,
+    Enemy
+};
+
+enum class BattleEventKind : uint8_t {
+    TurnStarted,    // the player's turn; amount is the turn number, from 1
+    Damage,         // amount HP lost, down to 0
+    Heal,           // amount HP gained, up to max
+    StatusApplied,  // status for duration, with amount for boosts
+    StatusRemoved,  // every instance of status
+    TurnEnded,      // turn-counted statuses count down
+    EnemyActed,     // amount is the EnemyAction
+    ItemUsed,       // the inventory isn't battle state, so undo stops here
+    Scheduled       // side acts next at amount on the initiative timeline
+};
+
+struct BattleEvent {
+    BattleEventKind kind;
+    BattleSide side;
+    StatusKind status;
+    int32_t amount;
+    int32_t duration;
+};
+
+// What the events fold into; indexed by BattleSide
+struct BattleState {
+    int32_t hp[2];
+    int32_t maxHP[2];
+    int32_t turn;
+    uint8_t lastEnemyAction;
+    int32_t statusLeft[2][STATUS_KIND_COUNT];  // as StatusEngine::Remaining
+    int32_t nextAction[2];                     // as Initiative::TimeOf
+};
+
+void ApplyBattleEvent(BattleState& state, const BattleEvent& event);
+
+// Room for a few hundred turns is set aside once, so appending never
+// allocates. When it fills up the older half is folded into the base state
+// and can't be rebuilt or undone any more.
+class BattleEventStore {
+public:
+    static constexpr size_t CAPACITY = 4096;
+    static constexpr size_t NO_UNDO = ~size_t(0);
+
+    BattleEventStore() { events.reserve(CAPACITY); }
+
+    void Begin(const BattleState& start);
+    void Append(const BattleEvent& event);
+
+    const BattleState& State() const { return current; }
+    // The state the kept events start from
+    const BattleState& Base() const { return base; }
+    const BattleEvent* Events() const { return events.data(); }
+    size_t Count() const { return events.size(); }
+    // Every event since Begin, including the ones folded away; doesn't shift
+    // when the store compacts, so it can mark a point to come back to
+    size_t Total() const { return folded + events.size(); }
+
+    // After the first count kept events
+    BattleState StateAt(size_t count) const;
+    // At the start of turn; false if it was folded away or hasn't happened
+    bool StateAtTurn(int turn, BattleState& out) const;
+
+    // Event count at the start of the turn before the current one, or
+    // NO_UNDO if there is none or an item was used since
+    size_t UndoPoint() const;
+    void Truncate(size_t count);
+    // Back to when Total() was total and the state was state, without
+    // refolding. If that point was folded away the store starts over there.
+    void Rewind(size_t total, const BattleState& state);
+
+private:
+    size_t folded = 0;
+    BattleState base = {};
+    BattleState current = {};
+    std::vector<BattleEvent> events;
+};
@@ -0,0 +1,446 @@
+#include "BattleSim.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+SimRng::SimRng(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+
+uint32_t SimRng::Next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (uint32_t)((state * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+int SimRng::Range(int min, int max) {
+    return min + (int)(Next() % (uint32_t)(max - min + 1));
+}
+
+SimStats PlayerStatsAtLevel(int level) {
+    int gained = std::max(0, level - 1);
+    return { 100 + gained * 10, 15 + gained * 2, 5 + gained };
+}
+
+int EnemyLevelForRoll(int playerLevel, int roll) {
+    return std::max(1, playerLevel - 1 + roll);
+}
+
+int RollEnemyLevel(int playerLevel, SimRng& rng) {
+    return EnemyLevelForRoll(playerLevel, rng.Range(0, ENEMY_LEVEL_ROLLS - 1));
+}
+
+int ExpToNextLevel(int level) {
+    int exp = 100;
+    for (int i = 1; i < level; ++i) {
+        exp = static_cast<int>(exp * 1.2f);
+    }
+    return exp;
+}
+
+namespace {
+
+enum class SimAction { Attack, Block, Skill };
+
+struct Fight {
+    SimStats player;
+    SimStats enemy;
+    SimEnemyKind kind;
+    int playerHP;
+    int enemyHP;
+    int playerBlockTurns = 0;
+    int enemyBlockTurns = 0;
+    SimAction lastEnemyAction = SimAction::Attack;
+    int enemySkillCooldown = 0;
+    bool playerPoisoned = false;
+    int poisonTurns = 0;
+    int playerSkillCooldown = 0;
+    int enemyWait = 0;  // initiative ticks from the player's turn to the enemy's
+};
+
+// Game::ChooseEnemyAction, drawing the same random numbers in the same order
+template <typename Rng>
+SimAction ChooseEnemyAction(const Fight& f, Rng& rng) {
+    float enemyHpPercent = static_cast<float>(f.enemyHP) / f.enemy.maxHP;
+    float playerHpPercent = static_cast<float>(f.playerHP) / f.player.maxHP;
+
+    int scoreAttack = 10;
+    int scoreBlock = 5;
+    int scoreSkill = 0;
+
+    if (enemyHpPercent < 0.5f) scoreBlock += 2;
+    if (enemyHpPercent < 0.3f) scoreBlock += 3;
+    if (playerHpPercent < 0.3f) scoreAttack += 5;
+    if (playerHpPercent > 0.8f) scoreSkill += 2;
+    if (f.lastEnemyAction == SimAction::Block) scoreBlock -= 6;
+
+    if (f.enemySkillCooldown > 0) {
+        scoreSkill = -100;
+    }
+    else {
+        switch (f.kind) {
+        case SimEnemyKind::Archer:
+            scoreSkill += 8 + rng.Range(0, 2);
+            break;
+        case SimEnemyKind::Warrior:
+            if (enemyHpPercent < 0.6f) scoreSkill += 10;
+            break;
+        case SimEnemyKind::Paladin:
+            if (f.lastEnemyAction == SimAction::Block) scoreSkill += 12;
+            break;
+        default:
+            if (!f.playerPoisoned) scoreSkill += 15;
+            break;
+        }
+    }
+
+    scoreAttack += rng.Range(0, 2);
+    scoreBlock += rng.Range(0, 2);
+    scoreSkill += rng.Range(0, 2);
+
+    if (scoreSkill >= scoreAttack && scoreSkill >= scoreBlock) return SimAction::Skill;
+    if (scoreAttack >= scoreBlock) return SimAction::Attack;
+    return SimAction::Block;
+}
+
+// Damage the enemy takes from a hit of this strength
+int HitEnemy(const Fight& f, int damage) {
+    if (f.enemyBlockTurns > 0) damage /= 4;
+    return std::max(1, damage);
+}
+
+// PerformPlayerAction: PlayerAttack or UseEquippedSkill. Returns the
+// action's initiative rank, as Game::ActionRank.
+int PlayerTurn(Fight& f, SimSkill skill) {
+    if (skill == SimSkill::None || f.playerSkillCooldown > 0) {
+        f.enemyHP -= HitEnemy(f, f.player.attack - f.enemy.defense);
+        return RANK_NORMAL;
+    }
+
+    f.playerSkillCooldown = 3;
+    switch (skill) {
+    case SimSkill::BlazingStrike:
+        f.enemyHP -= HitEnemy(f, (f.player.attack * 2) - f.enemy.defense + 5);
+        break;
+    case SimSkill::FrostGuard:
+        f.playerBlockTurns = std::max(f.playerBlockTurns, 2);
+        break;
+    case SimSkill::ThunderDash:
+        f.enemyHP -= HitEnemy(f, (int)((f.player.attack * 1.5) - f.enemy.defense + 3));
+        return RANK_QUICK;
+    default:
+        f.enemyHP -= HitEnemy(f, (f.player.attack * 2) - f.enemy.defense);
+        break;
+    }
+    return RANK_NORMAL;
+}
+
+// Game::EnemyAttack once the AI has picked
+void EnemyTurn(Fight& f, SimAction action) {
+    switch (action) {
+    case SimAction::Attack: {
+        int damage = f.enemy.attack - f.player.defense;
+        if (f.playerBlockTurns > 0) damage /= 4;
+        f.playerHP -= std::max(1, damage);
+        break;
+    }
+    case SimAction::Block:
+        // Through the end of the next turn, so it meets the player's next attack
+        f.enemyBlockTurns = 2;
+        break;
+    case SimAction::Skill:
+        f.enemySkillCooldown = 3;
+        if (f.kind == SimEnemyKind::Paladin) {
+            f.playerHP -= std::max(1, (int)((f.enemy.attack * 1.5) - f.player.defense));
+        }
+        else if (f.kind == SimEnemyKind::Witch) {
+            f.playerPoisoned = true;
+            f.poisonTurns = 3;
+        }
+        else {
+            f.playerHP -= std::max(1, (f.enemy.attack * 2) - f.player.defense);
+        }
+        break;
+    }
+    f.lastEnemyAction = action;
+}
+
+// StatusEngine::EndTurn after the enemy has acted: poison ticks, the rest counts down
+void EndRound(Fight& f) {
+    if (f.playerPoisoned) {
+        f.playerHP -= std::max(1, f.player.maxHP * 5 / 100);
+        if (--f.poisonTurns <= 0) f.playerPoisoned = false;
+    }
+    if (f.playerSkillCooldown > 0) f.playerSkillCooldown--;
+    if (f.enemySkillCooldown > 0) f.enemySkillCooldown--;
+    if (f.playerBlockTurns > 0) f.playerBlockTurns--;
+    if (f.enemyBlockTurns > 0) f.enemyBlockTurns--;
+}
+
+// Stand-in for SimRng that walks every jitter outcome: draw k returns digit k
+// of the combination in base 3. ChooseEnemyAction draws at most four numbers.
+class JitterEnumerator {
+public:
+    explicit JitterEnumerator(int combination) : rest(combination) {}
+
+    int Range(int min, int max) {
+        int span = max - min + 1;
+        int value = min + rest % span;
+        rest /= span;
+        return value;
+    }
+
+private:
+    int rest;
+};
+
+const int JITTER_COMBINATIONS = 3 * 3 * 3 * 3;
+
+// State packing for the memo: 20 bits per HP, then the small counters and
+// the enemy's wait, which is under one enemy delay (at most 480 ticks)
+const int HP_BITS = 20;
+const int WAIT_SHIFT = 11;
+const uint64_t WAIT_MASK = 511;
+const uint64_t HP_MASK = (1ull << HP_BITS) - 1;
+
+uint64_t PackState(const Fight& f) {
+    uint64_t key = (uint64_t)f.playerHP | ((uint64_t)f.enemyHP << HP_BITS);
+    uint64_t small = (uint64_t)f.playerBlockTurns
+        | ((uint64_t)f.enemyBlockTurns << 2)
+        | ((uint64_t)(f.lastEnemyAction == SimAction::Block) << 4)
+        | ((uint64_t)f.enemySkillCooldown << 5)
+        | ((uint64_t)(f.playerPoisoned ? f.poisonTurns : 0) << 7)
+        | ((uint64_t)f.playerSkillCooldown << 9)
+        | ((uint64_t)f.enemyWait << WAIT_SHIFT);
+    return key | (small << (2 * HP_BITS));
+}
+
+void UnpackState(uint64_t key, Fight& f) {
+    f.playerHP = (int)(key & HP_MASK);
+    f.enemyHP = (int)((key >> HP_BITS) & HP_MASK);
+    uint64_t small = key >> (2 * HP_BITS);
+    f.playerBlockTurns = (int)(small & 3);
+    f.enemyBlockTurns = (int)((small >> 2) & 3);
+    f.lastEnemyAction = (small & 16) ? SimAction::Block : SimAction::Attack;
+    f.enemySkillCooldown = (int)((small >> 5) & 3);
+    f.poisonTurns = (int)((small >> 7) & 3);
+    f.playerPoisoned = f.poisonTurns > 0;
+    f.playerSkillCooldown = (int)((small >> 9) & 3);
+    f.enemyWait = (int)((small >> WAIT_SHIFT) & WAIT_MASK);
+}
+
+Fight StartFight(const SimMatchup& m, const SimBattleState& s) {
+    Fight f;
+    f.player = m.player;
+    f.enemy = m.enemy;
+    f.kind = m.kind;
+    f.playerHP = s.playerHP;
+    f.enemyHP = s.enemyHP;
+    f.playerBlockTurns = std::min(2, std::max(0, s.playerBlockTurns));
+    f.enemyBlockTurns = std::min(2, std::max(0, s.enemyBlockTurns));
+    f.lastEnemyAction = s.enemyBlockedLast ? SimAction::Block : SimAction::Attack;
+    f.enemySkillCooldown = std::min(3, std::max(0, s.enemySkillCooldown));
+    f.poisonTurns = std::min(3, std::max(0, s.poisonTurns));
+    f.playerPoisoned = f.poisonTurns > 0;
+    f.playerSkillCooldown = std::min(3, std::max(0, s.playerSkillCooldown));
+    f.enemyWait = std::min((int)WAIT_MASK, std::max(0, s.enemyWait));
+    return f;
+}
+
+const uint32_t ODDS_CACHE_MAGIC = 0x4F475052; // "RPGO"
+const uint32_t ODDS_CACHE_VERSION = 3; // 2: blocks and Frost Guard wear off; 3: speeds
+
+struct OddsCacheEntry {
+    int32_t key[10];
+    double winChance;
+    double expectedTurns;
+};
+
+} // namespace
+
+SimResult SimulateBattle(const SimStats& player, const SimStats& enemy, SimEnemyKind kind, SimRng& rng, int maxTurns) {
+    Fight f;
+    f.player = player;
+    f.enemy = enemy;
+    f.kind = kind;
+    f.playerHP = player.maxHP;
+    f.enemyHP = enemy.maxHP;
+
+    for (int turn = 1; turn <= maxTurns; ++turn) {
+        int rank = PlayerTurn(f, SimSkill::None);
+
+        // CheckBattleResult looks at the player first
+        if (f.playerHP <= 0) return { false, turn, false };
+        if (f.enemyHP <= 0) return { true, turn, false };
+
+        // The enemy goes until the player is next again; ties are the player's
+        f.enemyWait -= ActionDelay(f.player.speed, rank);
+        while (f.enemyWait < 0) {
+            EnemyTurn(f, ChooseEnemyAction(f, rng));
+            if (f.playerHP <= 0) return { false, turn, false };
+
+            EndRound(f);
+            if (f.playerHP <= 0) return { false, turn, false };
+            f.enemyWait += ActionDelay(f.enemy.speed, RANK_NORMAL);
+        }
+    }
+    return { false, maxTurns, true };
+}
+
+SimBattleState FreshBattleState(const SimStats& player, const SimStats& enemy) {
+    SimBattleState state = {};
+    state.playerHP = player.maxHP;
+    state.enemyHP = enemy.maxHP;
+    return state;
+}
+
+BattleOdds::MatchupKey BattleOdds::KeyOf(const SimMatchup& m) {
+    return { { m.player.maxHP, m.player.attack, m.player.defense, m.enemy.maxHP, m.enemy.attack, m.enemy.defense,
+        (int32_t)m.kind, (int32_t)m.skill, m.player.speed, m.enemy.speed } };
+}
+
+SimOdds BattleOdds::Solve(const SimMatchup& matchup) {
+    MatchupKey key = KeyOf(matchup);
+    auto it = fresh.find(key);
+    if (it != fresh.end()) return it->second;
+
+    SimOdds odds = Solve(matchup, FreshBattleState(matchup.player, matchup.enemy));
+    fresh[key] = odds;
+    return odds;
+}
+
+SimOdds BattleOdds::Solve(const SimMatchup& matchup, const SimBattleState& state) {
+    // Already decided, or stats the packing can't hold
+    if (state.playerHP <= 0) return { 0.0, 0.0 };
+    if (state.enemyHP <= 0) return { 1.0, 0.0 };
+    if ((uint64_t)state.playerHP > HP_MASK || (uint64_t)state.enemyHP > HP_MASK) return { 0.0, 0.0 };
+
+    MatchupKey key = KeyOf(matchup);
+    auto tableIt = tables.find(key);
+    if (tableIt == tables.end()) {
+        if (tables.size() >= MAX_TABLES) tables.clear();
+        tableIt = tables.emplace(key, StateTable()).first;
+    }
+    StateTable& memo = tableIt->second;
+
+    Fight start = StartFight(matchup, state);
+    uint64_t startKey = PackState(start);
+    auto found = memo.find(startKey);
+    if (found != memo.end()) return found->second;
+
+    // Depth-first over the player's turns. It has no cycles: every turn either
+    // hits the enemy or spends the skill, which can't be used again until the
+    // enemy has acted three times, and the enemy can't block twice running.
+    // A state is finished once everything it leads to is, so it may be looked
+    // at twice.
+    Fight f = start;
+    std::vector<uint64_t> pending(1, startKey);
+    std::vector<std::pair<Fight, double>> enemyMoves;
+    while (!pending.empty()) {
+        uint64_t stateKey = pending.back();
+        if (memo.count(stateKey)) {
+            pending.pop_back();
+            continue;
+        }
+        UnpackState(stateKey, f);
+
+        Fight afterPlayer = f;
+        int rank = PlayerTurn(afterPlayer, matchup.skill);
+        if (afterPlayer.playerHP <= 0 || afterPlayer.enemyHP <= 0) {
+            memo[stateKey] = { afterPlayer.playerHP > 0 ? 1.0 : 0.0, 1.0 };
+            pending.pop_back();
+            statesSolved++;
+            continue;
+        }
+        afterPlayer.enemyWait -= ActionDelay(afterPlayer.player.speed, rank);
+
+        // Every way the enemy's turns go until the player is next again: one
+        // at equal speeds, none after a quick skill, more against a fast enemy
+        SimOdds odds = { 0.0, 1.0 };
+        bool ready = true;
+        enemyMoves.assign(1, { afterPlayer, 1.0 });
+        while (!enemyMoves.empty()) {
+            Fight at = enemyMoves.back().first;
+            double p = enemyMoves.back().second;
+            enemyMoves.pop_back();
+
+            if (at.enemyWait >= 0) {
+                uint64_t nextKey = PackState(at);
+                auto nextIt = memo.find(nextKey);
+                if (nextIt == memo.end()) {
+                    pending.push_back(nextKey);
+                    ready = false;
+                    continue;
+                }
+                odds.winChance += p * nextIt->second.winChance;
+                odds.expectedTurns += p * nextIt->second.expectedTurns;
+                continue;
+            }
+
+            int counts[3] = { 0, 0, 0 };
+            for (int combination = 0; combination < JITTER_COMBINATIONS; ++combination) {
+                JitterEnumerator jitter(combination);
+                counts[(int)ChooseEnemyAction(at, jitter)]++;
+            }
+            for (int action = 0; action < 3; ++action) {
+                if (counts[action] == 0) continue;
+                Fight next = at;
+                EnemyTurn(next, (SimAction)action);
+                if (next.playerHP <= 0) continue;
+                EndRound(next);
+                if (next.playerHP <= 0) continue;
+                next.enemyWait += ActionDelay(next.enemy.speed, RANK_NORMAL);
+                enemyMoves.push_back({ next, p * counts[action] / JITTER_COMBINATIONS });
+            }
+        }
+        if (ready) {
+            memo[stateKey] = odds;
+            pending.pop_back();
+            statesSolved++;
+        }
+    }
+    return memo[startKey];
+}
+
+bool BattleOdds::Load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    uint32_t header[3];
+    if (bytes.size() < sizeof(header)) return false;
+    std::memcpy(header, bytes.data(), sizeof(header));
+    if (header[0] != ODDS_CACHE_MAGIC || header[1] != ODDS_CACHE_VERSION) return false;
+    if ((bytes.size() - sizeof(header)) / sizeof(OddsCacheEntry) < header[2]) return false;
+
+    for (uint32_t i = 0; i < header[2]; ++i) {
+        OddsCacheEntry entry;
+        std::memcpy(&entry, bytes.data() + sizeof(header) + i * sizeof(entry), sizeof(entry));
+        MatchupKey key;
+        std::copy(entry.key, entry.key + 10, key.begin());
+        fresh[key] = { entry.winChance, entry.expectedTurns };
+    }
+    return true;
+}
+
+bool BattleOdds::Save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    uint32_t header[3] = { ODDS_CACHE_MAGIC, ODDS_CACHE_VERSION, (uint32_t)fresh.size() };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const auto& kv : fresh) {
+        OddsCacheEntry entry;
+        std::copy(kv.first.begin(), kv.first.end(), entry.key);
+        entry.winChance = kv.second.winChance;
+        entry.expectedTurns = kv.second.expectedTurns;
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    return (bool)out;
+}
+
+void BattleOdds::Merge(const BattleOdds& other) {
+    fresh.insert(other.fresh.begin(), other.fresh.end());
+}
@@ -0,0 +1,145 @@
+// BattleSim.h
+#pragma once
+#include "Initiative.h"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// Headless model of one Quick Battle for tools that need millions of fights
+// (BalanceOptimizer). It follows Game's turn rules: PerformPlayerAction and
+// PlayerAttack, then EnemyAttack with ChooseEnemyAction, then the status
+// effects that end with the turn (BattleStatus.cpp and the durations Game
+// applies them with), in the order Initiative gives from both speeds. Change
+// both together.
+//
+// The simulated player attacks every turn and never uses skills or items.
+// Every fight starts fresh, whereas Game's player stays poisoned from the
+// previous battle.
+//
+// BattleOdds answers the same question exactly: the chance of winning from any
+// point of a fight, with every outcome of ChooseEnemyAction's jitter weighed
+// instead of sampled.
+
+// Same order as EnemyType in Game.h, which drags in raylib
+enum class SimEnemyKind : uint8_t {
+    Archer,
+    Warrior,
+    Paladin,
+    Witch,
+    Count
+};
+
+struct SimStats {
+    int maxHP;
+    int attack;
+    int defense;
+    int speed = NORMAL_SPEED;
+};
+
+struct SimResult {
+    bool playerWon;
+    int turns;      // player actions taken
+    bool timedOut;  // nobody won within maxTurns; counted as a loss
+};
+
+// xorshift64*; cheap enough to own one per worker thread
+class SimRng {
+public:
+    explicit SimRng(uint64_t seed);
+
+    uint32_t Next();
+    // Inclusive on both ends, like Game::GetRandom
+    int Range(int min, int max);
+
+private:
+    uint64_t state;
+};
+
+// InitPlayer stats plus the gains from every level-up in CheckBattleResult
+SimStats PlayerStatsAtLevel(int level);
+
+// Enemy level InitEnemy picks for a player of this level: one of
+// ENEMY_LEVEL_ROLLS equally likely outcomes
+const int ENEMY_LEVEL_ROLLS = 3;
+int EnemyLevelForRoll(int playerLevel, int roll);
+int RollEnemyLevel(int playerLevel, SimRng& rng);
+
+// EXP needed to go from level to level + 1
+int ExpToNextLevel(int level);
+
+SimResult SimulateBattle(const SimStats& player, const SimStats& enemy, SimEnemyKind kind, SimRng& rng, int maxTurns = 200);
+
+// The player's equipped skill, as Game::UseEquippedSkill tells them apart
+enum class SimSkill : uint8_t {
+    None,           // attack every turn
+    Strike,         // any other skill: attack * 2
+    BlazingStrike,
+    FrostGuard,
+    ThunderDash
+};
+
+// Player stats, enemy stats and how the player fights. The player uses the
+// skill whenever it is ready and attacks otherwise.
+struct SimMatchup {
+    SimStats player;
+    SimStats enemy;
+    SimEnemyKind kind;
+    SimSkill skill;
+};
+
+// Everything that changes during a fight
+struct SimBattleState {
+    int playerHP;
+    int enemyHP;
+    int playerBlockTurns;     // turn ends left on Blocking, 0-2
+    int enemyBlockTurns;
+    bool enemyBlockedLast;    // lastEnemyAction == Block
+    int enemySkillCooldown;   // 0-3
+    int poisonTurns;          // 0 when not poisoned
+    int playerSkillCooldown;  // 0 when the skill is ready
+    int enemyWait;            // initiative ticks from the player's turn to the enemy's, 0 or more
+};
+
+// Full HP and nothing else going on, like SimulateBattle
+SimBattleState FreshBattleState(const SimStats& player, const SimStats& enemy);
+
+struct SimOdds {
+    double winChance;
+    double expectedTurns;  // player actions until somebody falls
+};
+
+// Exact win chance by dynamic programming over fight states. Every state that
+// gets solved is remembered for its matchup, so asking again later in the same
+// fight (or the next fight against the same stats) is a lookup. Answers from a
+// fresh start survive Save/Load for tools that go through thousands of them.
+class BattleOdds {
+public:
+    // From the start of a fight
+    SimOdds Solve(const SimMatchup& matchup);
+    SimOdds Solve(const SimMatchup& matchup, const SimBattleState& state);
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+    // Takes other's fresh-start answers, e.g. from another worker thread
+    void Merge(const BattleOdds& other);
+
+    size_t MatchupCount() const { return fresh.size(); }
+    // States worked out so far, for reports
+    size_t StatesSolved() const { return statesSolved; }
+
+private:
+    using MatchupKey = std::array<int32_t, 10>;
+    using StateTable = std::unordered_map<uint64_t, SimOdds>;
+
+    // State tables grow with HP squared; beyond this many matchups the old
+    // ones are dropped
+    static const size_t MAX_TABLES = 8;
+
+    static MatchupKey KeyOf(const SimMatchup& matchup);
+
+    std::map<MatchupKey, StateTable> tables;
+    std::map<MatchupKey, SimOdds> fresh;
+    size_t statesSolved = 0;
+};
@@ -0,0 +1,61 @@
+#include "BattleSnapshot.h"
+#include "SaveJournal.h"
+#include "FlightRecorder.h"
+#include <fstream>
+#include <string>
+
+namespace {
+
+const uint32_t SNAPSHOT_MAGIC = 0x54424752; // "RGBT"
+const uint32_t SNAPSHOT_VERSION = 2; // 2: initiative times
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;  // sizeof(BattleSnapshot)
+    uint32_t crc;   // of the snapshot bytes
+};
+
+} // namespace
+
+void SnapshotRing::Push(const BattleSnapshot& snapshot) {
+    slots[top] = snapshot;
+    top = (top + 1) % SIZE;
+    if (count < SIZE) count++;
+}
+
+const BattleSnapshot* SnapshotRing::Peek(int depth) const {
+    if (depth < 0 || depth >= count) return nullptr;
+    return &slots[(top - 1 - depth + SIZE) % SIZE];
+}
+
+bool WriteBattleSnapshot(const char* path, const BattleSnapshot& snapshot) {
+    FlightFileScope flight(FlightEvent::Save, path);
+    SnapshotHeader header = { SNAPSHOT_MAGIC, SNAPSHOT_VERSION, sizeof(BattleSnapshot), Crc32(&snapshot, sizeof(snapshot)) };
+    {
+        std::ofstream out(std::string(path) + ".tmp", std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&snapshot), sizeof(snapshot));
+        out.flush();
+        if (!out) return false;
+    }
+    return flight.ok = CommitTempFile(path);
+}
+
+bool ReadBattleSnapshot(const char* path, BattleSnapshot& snapshot) {
+    RecoverTempFile(path);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    FlightFileScope flight(FlightEvent::Load, path);
+    SnapshotHeader header;
+    BattleSnapshot read;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    in.read(reinterpret_cast<char*>(&read), sizeof(read));
+    if (!in || header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.size != sizeof(BattleSnapshot) || header.crc != Crc32(&read, sizeof(read))) {
+        return false;
+    }
+    snapshot = read;
+    return flight.ok = true;
+}
@@ -0,0 +1,66 @@
+// BattleSnapshot.h
+#pragma once
+#include "BattleEvents.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Everything a battle in progress depends on, as plain data: taking or
+// restoring one is a copy, not a walk over Game's containers. Game fills it
+// in and puts it back (TakeSnapshot/RestoreSnapshot); the town side of the
+// game, inventory and skills included, is saved by save.dat and the journal.
+
+const char* const BATTLE_PATH = "battle.sav";
+
+struct BattleSnapshot {
+    // Player fields a battle changes; the name doesn't
+    int32_t playerMaxHP;
+    int32_t playerAttack;
+    int32_t playerDefense;
+    int32_t playerLevel;
+    int32_t playerExp;
+    int32_t playerExpToLevel;
+
+    char enemyName[32];
+    int32_t enemyMaxHP;
+    int32_t enemyAttack;
+    int32_t enemyDefense;
+    int32_t enemyLevel;
+    uint8_t enemyType;
+    int32_t nextEnemyLevel;  // Game::enemyLevel
+    int32_t expReward;
+    int32_t coinReward;
+
+    uint8_t isPlayerTurn;
+
+    // HP, turn, last enemy action, how long every status has left and when
+    // each side acts next
+    BattleState state;
+    int32_t attackBoost[2];  // by BattleSide
+    int32_t defenseBoost[2];
+    size_t eventTotal;       // BattleEventStore::Total() when taken
+};
+static_assert(std::is_trivially_copyable<BattleSnapshot>::value, "BattleSnapshot must stay plain data");
+
+// The last SIZE snapshots pushed, newest on top
+class SnapshotRing {
+public:
+    static constexpr int SIZE = 64;
+
+    void Push(const BattleSnapshot& snapshot);
+    void Pop() { if (count > 0) count--; }
+    // nullptr if empty; depth 0 is the newest
+    const BattleSnapshot* Peek(int depth = 0) const;
+    void Clear() { count = 0; }
+    int Count() const { return count; }
+
+private:
+    BattleSnapshot slots[SIZE];
+    int top = 0;  // where the next push goes
+    int count = 0;
+};
+
+// A header with the layout's size, then the struct as is, so a file from a
+// build where the layout changed is refused rather than misread
+bool WriteBattleSnapshot(const char* path, const BattleSnapshot& snapshot);
+bool ReadBattleSnapshot(const char* path, BattleSnapshot& snapshot);
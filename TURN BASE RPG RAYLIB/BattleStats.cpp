@@ -0,0 +1,451 @@
+#include "BattleStats.h"
+#include "SaveJournal.h"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <map>
+#include <utility>
+
+namespace {
+
+// Chunks are kind, payload size (32-bit), payload, then a CRC of all of it
+const uint8_t CHUNK_NAME = 'N';   // the next enemy id's name
+const uint8_t CHUNK_ROW = 'R';    // one tail row, every column as 64-bit
+const uint8_t CHUNK_BLOCK = 'B';  // a sealed block, standing in for its rows
+const size_t CHUNK_HEADER = 5;
+const size_t CHUNK_TRAILER = 4;
+
+// Dense group arrays up to this many keys, a map past it
+const int64_t DENSE_GROUPS = 1 << 16;
+
+void Put32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(value >> (i * 8)));
+}
+
+void Put64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(value >> (i * 8)));
+}
+
+uint32_t Get32(const unsigned char* in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+uint64_t Get64(const unsigned char* in) {
+    return Get32(in) | (static_cast<uint64_t>(Get32(in + 4)) << 32);
+}
+
+void WriteChunk(std::ostream& out, uint8_t kind, const std::string& payload) {
+    std::string chunk;
+    chunk.reserve(CHUNK_HEADER + payload.size() + CHUNK_TRAILER);
+    chunk.push_back(static_cast<char>(kind));
+    Put32(chunk, static_cast<uint32_t>(payload.size()));
+    chunk += payload;
+    Put32(chunk, Crc32(chunk.data(), chunk.size()));
+    out.write(chunk.data(), chunk.size());
+}
+
+int BitsFor(uint64_t range) {
+    int bits = 0;
+    while (range) {
+        bits++;
+        range >>= 1;
+    }
+    return bits;
+}
+
+// One per width, so the shifts and masks are constants and widths that divide
+// 64 never straddle two words
+template <int Bits>
+void UnpackBits(const uint64_t* words, int rows, int64_t base, int64_t* out) {
+    const uint64_t mask = Bits == 64 ? ~0ull : (1ull << Bits) - 1;
+    for (int i = 0; i < rows; ++i) {
+        size_t bit = static_cast<size_t>(i) * Bits;
+        size_t word = bit / 64;
+        int shift = static_cast<int>(bit % 64);
+        uint64_t offset = words[word] >> shift;
+        if (shift + Bits > 64) offset |= words[word + 1] << (64 - shift);
+        out[i] = static_cast<int64_t>((offset & mask) + static_cast<uint64_t>(base));
+    }
+}
+
+using Unpacker = void (*)(const uint64_t*, int, int64_t, int64_t*);
+
+template <size_t... Bits>
+std::array<Unpacker, sizeof...(Bits)> MakeUnpackers(std::index_sequence<Bits...>) {
+    return { { &UnpackBits<static_cast<int>(Bits)>... } };
+}
+
+const std::array<Unpacker, 65> UNPACKERS = MakeUnpackers(std::make_index_sequence<65>());
+
+int64_t FloorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+} // namespace
+
+bool BattleStats::Open(const std::string& filePath) {
+    Close();
+    *this = BattleStats();
+    path = filePath;
+    RecoverTempFile(path);
+    if (!ReadFile()) Rewrite();
+    out.open(path, std::ios::binary | std::ios::app);
+    return out.is_open();
+}
+
+void BattleStats::Close() {
+    if (out.is_open()) out.close();
+}
+
+void BattleStats::Append(const BattleRecord& record) {
+    size_t names = enemyNames.size();
+    int64_t row[STAT_COLUMNS];
+    row[static_cast<int>(StatColumn::Time)] = record.time;
+    row[static_cast<int>(StatColumn::PlayerLevel)] = record.playerLevel;
+    row[static_cast<int>(StatColumn::Enemy)] = InternEnemy(record.enemy);
+    row[static_cast<int>(StatColumn::EnemyLevel)] = record.enemyLevel;
+    row[static_cast<int>(StatColumn::Outcome)] = static_cast<int64_t>(record.outcome);
+    row[static_cast<int>(StatColumn::Turns)] = record.turns;
+    row[static_cast<int>(StatColumn::Attacks)] = record.attacks;
+    row[static_cast<int>(StatColumn::Skills)] = record.skills;
+    row[static_cast<int>(StatColumn::Blocks)] = record.blocks;
+    row[static_cast<int>(StatColumn::Items)] = record.items;
+    row[static_cast<int>(StatColumn::Coins)] = record.coins;
+    row[static_cast<int>(StatColumn::Exp)] = record.exp;
+    bool sealedTail = AppendRow(row);
+    if (!out.is_open()) return;
+
+    // A sealed block replaces its rows in the file, written whole once per block
+    if (sealedTail) {
+        Rewrite();
+        out.open(path, std::ios::binary | std::ios::app);
+        return;
+    }
+    if (enemyNames.size() > names) WriteChunk(out, CHUNK_NAME, enemyNames.back());
+    std::string payload;
+    for (int64_t value : row) Put64(payload, static_cast<uint64_t>(value));
+    WriteChunk(out, CHUNK_ROW, payload);
+    out.flush();
+}
+
+int BattleStats::EnemyId(const std::string& name) const {
+    auto it = std::find(enemyNames.begin(), enemyNames.end(), name);
+    return it == enemyNames.end() ? -1 : static_cast<int>(it - enemyNames.begin());
+}
+
+int BattleStats::InternEnemy(const std::string& name) {
+    int id = EnemyId(name);
+    if (id >= 0) return id;
+    enemyNames.push_back(name);
+    return static_cast<int>(enemyNames.size()) - 1;
+}
+
+bool BattleStats::AppendRow(const int64_t* row) {
+    for (int c = 0; c < STAT_COLUMNS; ++c) {
+        if (tail.rows == 0 || row[c] < tail.min[c]) tail.min[c] = row[c];
+        if (tail.rows == 0 || row[c] > tail.max[c]) tail.max[c] = row[c];
+        tail.columns[c].push_back(row[c]);
+    }
+    tail.rows++;
+    if (tail.rows < STATS_BLOCK_ROWS) return false;
+    SealTail();
+    return true;
+}
+
+void BattleStats::SealTail() {
+    SealedBlock block;
+    block.rows = tail.rows;
+    for (int c = 0; c < STAT_COLUMNS; ++c) {
+        Pack(static_cast<StatColumn>(c), tail.columns[c].data(), tail.rows, block.columns[c]);
+    }
+    sealed.push_back(std::move(block));
+    sealedRows += tail.rows;
+    tail = TailBlock();
+}
+
+void BattleStats::Pack(StatColumn column, const int64_t* values, int rows, PackedColumn& out) {
+    out = PackedColumn();
+    if (rows == 0) return;
+    out.min = *std::min_element(values, values + rows);
+    out.max = *std::max_element(values, values + rows);
+
+    // Times only go up by small steps, so the steps pack far smaller than the times
+    std::vector<int64_t> deltas;
+    if (column == StatColumn::Time) {
+        out.first = values[0];
+        deltas.resize(rows - 1);
+        for (int i = 1; i < rows; ++i) deltas[i - 1] = values[i] - values[i - 1];
+        values = deltas.data();
+        rows--;
+        if (rows == 0) return;
+    }
+
+    int64_t low = *std::min_element(values, values + rows);
+    int64_t high = *std::max_element(values, values + rows);
+    out.base = low;
+    out.bits = static_cast<uint8_t>(BitsFor(static_cast<uint64_t>(high) - static_cast<uint64_t>(low)));
+    if (out.bits == 0) return;
+    out.words.assign((static_cast<size_t>(rows) * out.bits + 63) / 64, 0);
+    for (int i = 0; i < rows; ++i) {
+        uint64_t offset = static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(out.base);
+        size_t bit = static_cast<size_t>(i) * out.bits;
+        size_t word = bit / 64;
+        int shift = static_cast<int>(bit % 64);
+        out.words[word] |= offset << shift;
+        if (shift + out.bits > 64) out.words[word + 1] |= offset >> (64 - shift);
+    }
+}
+
+void BattleStats::Unpack(StatColumn column, const PackedColumn& packed, int rows, int64_t* out) {
+    bool time = column == StatColumn::Time;
+    int64_t* values = out;
+    if (time) {
+        out[0] = packed.first;
+        values = out + 1;
+        rows--;
+    }
+
+    if (packed.bits == 0) std::fill(values, values + rows, packed.base);
+    else UNPACKERS[packed.bits](packed.words.data(), rows, packed.base, values);
+
+    if (time) {
+        for (int i = 1; i <= rows; ++i) out[i] += out[i - 1];
+    }
+}
+
+std::vector<StatGroup> BattleStats::Query(const StatsQuery& query, StatsScan* scan) const {
+    StatsScan counts;
+    const bool grouped = query.groupBy != StatColumn::Count;
+    const bool summed = query.sum != StatColumn::Count;
+    const int64_t bucket = std::max<int64_t>(1, query.bucket);
+    const int outcome = static_cast<int>(StatColumn::Outcome);
+
+    // Blocks whose zone maps overlap every filter, and the keys they can produce
+    struct Candidate {
+        const SealedBlock* block;  // null for the tail
+        int rows;
+        const int64_t* min;
+        const int64_t* max;
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(sealed.size() + 1);
+    int64_t keyMin = 0;
+    int64_t keyMax = 0;
+    auto consider = [&](const SealedBlock* block, int rows, const int64_t* min, const int64_t* max) {
+        if (rows == 0) return;
+        for (const StatFilter& filter : query.filters) {
+            int c = static_cast<int>(filter.column);
+            if (max[c] < filter.min || min[c] > filter.max) {
+                counts.blocksSkipped++;
+                return;
+            }
+        }
+        if (grouped) {
+            int c = static_cast<int>(query.groupBy);
+            int64_t low = FloorDiv(min[c], bucket);
+            int64_t high = FloorDiv(max[c], bucket);
+            if (candidates.empty() || low < keyMin) keyMin = low;
+            if (candidates.empty() || high > keyMax) keyMax = high;
+        }
+        candidates.push_back({ block, rows, min, max });
+    };
+    int64_t blockMin[STAT_COLUMNS];
+    int64_t blockMax[STAT_COLUMNS];
+    std::vector<int64_t> zones(sealed.size() * STAT_COLUMNS * 2);
+    for (size_t b = 0; b < sealed.size(); ++b) {
+        int64_t* min = &zones[b * STAT_COLUMNS * 2];
+        int64_t* max = min + STAT_COLUMNS;
+        for (int c = 0; c < STAT_COLUMNS; ++c) {
+            min[c] = sealed[b].columns[c].min;
+            max[c] = sealed[b].columns[c].max;
+        }
+        consider(&sealed[b], sealed[b].rows, min, max);
+    }
+    std::copy(std::begin(tail.min), std::end(tail.min), blockMin);
+    std::copy(std::begin(tail.max), std::end(tail.max), blockMax);
+    consider(nullptr, tail.rows, blockMin, blockMax);
+
+    std::vector<StatGroup> dense;
+    std::map<int64_t, StatGroup> sparse;
+    bool useDense = keyMax - keyMin < DENSE_GROUPS;
+    if (useDense) dense.assign(static_cast<size_t>(keyMax - keyMin + 1), StatGroup{ 0, 0, 0, 0 });
+
+    // Unpacked only when a block needs the column; the tail is read in place
+    std::vector<int64_t> scratch[STAT_COLUMNS];
+    const int64_t* columns[STAT_COLUMNS];
+    std::vector<uint16_t> selected(STATS_BLOCK_ROWS);
+    static_assert(STATS_BLOCK_ROWS <= 65536, "selected rows are 16-bit");
+
+    for (const Candidate& candidate : candidates) {
+        counts.blocksScanned++;
+        std::fill(std::begin(columns), std::end(columns), nullptr);
+        auto column = [&](int c) {
+            if (!columns[c]) {
+                if (candidate.block) {
+                    scratch[c].resize(STATS_BLOCK_ROWS);
+                    Unpack(static_cast<StatColumn>(c), candidate.block->columns[c], candidate.rows, scratch[c].data());
+                    columns[c] = scratch[c].data();
+                }
+                else {
+                    columns[c] = tail.columns[c].data();
+                }
+            }
+            return columns[c];
+        };
+
+        int count = candidate.rows;
+        for (int i = 0; i < count; ++i) selected[i] = static_cast<uint16_t>(i);
+        for (const StatFilter& filter : query.filters) {
+            int c = static_cast<int>(filter.column);
+            // The zone map already vouches for every row
+            if (candidate.min[c] >= filter.min && candidate.max[c] <= filter.max) continue;
+            const int64_t* values = column(c);
+            int kept = 0;
+            for (int i = 0; i < count; ++i) {
+                int64_t value = values[selected[i]];
+                selected[kept] = selected[i];
+                kept += value >= filter.min && value <= filter.max;
+            }
+            count = kept;
+        }
+        if (count == 0) continue;
+        counts.rowsMatched += count;
+
+        const int64_t* outcomes = column(outcome);
+        const int64_t* keys = grouped ? column(static_cast<int>(query.groupBy)) : nullptr;
+        const int64_t* sums = summed ? column(static_cast<int>(query.sum)) : nullptr;
+        // Neighbouring rows mostly share a bucket (times always do), so divide only on leaving it
+        int64_t key = 0;
+        int64_t bucketLow = 1;
+        int64_t bucketHigh = 0;
+        for (int i = 0; i < count; ++i) {
+            int row = selected[i];
+            if (keys && bucket == 1) {
+                key = keys[row];
+            }
+            else if (keys && (keys[row] < bucketLow || keys[row] > bucketHigh)) {
+                key = FloorDiv(keys[row], bucket);
+                bucketLow = key * bucket;
+                bucketHigh = bucketLow + bucket - 1;
+            }
+            StatGroup& group = useDense ? dense[static_cast<size_t>(key - keyMin)] : sparse[key];
+            group.battles++;
+            group.wins += outcomes[row] == static_cast<int64_t>(BattleOutcome::Won);
+            if (sums) group.sum += sums[row];
+        }
+    }
+
+    std::vector<StatGroup> groups;
+    if (useDense) {
+        for (size_t i = 0; i < dense.size(); ++i) {
+            if (dense[i].battles == 0) continue;
+            dense[i].key = keyMin + static_cast<int64_t>(i);
+            groups.push_back(dense[i]);
+        }
+    }
+    else {
+        for (auto& entry : sparse) {
+            entry.second.key = entry.first;
+            groups.push_back(entry.second);
+        }
+    }
+    if (scan) *scan = counts;
+    return groups;
+}
+
+size_t BattleStats::MemoryBytes() const {
+    size_t bytes = sealed.capacity() * sizeof(SealedBlock) + sizeof(TailBlock);
+    for (const SealedBlock& block : sealed) {
+        for (const PackedColumn& column : block.columns) bytes += column.words.capacity() * sizeof(uint64_t);
+    }
+    for (const std::vector<int64_t>& column : tail.columns) bytes += column.capacity() * sizeof(int64_t);
+    for (const std::string& name : enemyNames) bytes += name.capacity();
+    return bytes;
+}
+
+bool BattleStats::ReadFile() {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return true;
+    std::string file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(file.data());
+
+    bool intact = true;
+    size_t at = 0;
+    while (at < file.size()) {
+        if (file.size() - at < CHUNK_HEADER + CHUNK_TRAILER) return false;
+        uint8_t kind = data[at];
+        size_t size = Get32(data + at + 1);
+        if (size > file.size() - at - CHUNK_HEADER - CHUNK_TRAILER) return false;
+        if (Get32(data + at + CHUNK_HEADER + size) != Crc32(data + at, CHUNK_HEADER + size)) return false;
+        const unsigned char* payload = data + at + CHUNK_HEADER;
+        at += CHUNK_HEADER + size + CHUNK_TRAILER;
+
+        if (kind == CHUNK_NAME) {
+            enemyNames.emplace_back(reinterpret_cast<const char*>(payload), size);
+        }
+        else if (kind == CHUNK_ROW && size == STAT_COLUMNS * 8) {
+            int64_t row[STAT_COLUMNS];
+            for (int c = 0; c < STAT_COLUMNS; ++c) row[c] = static_cast<int64_t>(Get64(payload + c * 8));
+            if (AppendRow(row)) intact = false;
+        }
+        else if (kind == CHUNK_BLOCK && size >= 4 && tail.rows == 0) {
+            SealedBlock block;
+            block.rows = static_cast<int>(Get32(payload));
+            if (block.rows <= 0 || block.rows > STATS_BLOCK_ROWS) return false;
+            size_t offset = 4;
+            for (int c = 0; c < STAT_COLUMNS; ++c) {
+                PackedColumn& column = block.columns[c];
+                if (size - offset < 37) return false;
+                column.min = static_cast<int64_t>(Get64(payload + offset));
+                column.max = static_cast<int64_t>(Get64(payload + offset + 8));
+                column.base = static_cast<int64_t>(Get64(payload + offset + 16));
+                column.first = static_cast<int64_t>(Get64(payload + offset + 24));
+                column.bits = payload[offset + 32];
+                size_t words = Get32(payload + offset + 33);
+                offset += 37;
+                size_t packedRows = block.rows - (c == static_cast<int>(StatColumn::Time) ? 1 : 0);
+                if (column.bits > 64 || words > (size - offset) / 8 || words * 64 < packedRows * column.bits) return false;
+                column.words.resize(words);
+                for (size_t w = 0; w < words; ++w) column.words[w] = Get64(payload + offset + w * 8);
+                offset += words * 8;
+            }
+            sealedRows += block.rows;
+            sealed.push_back(std::move(block));
+        }
+        else {
+            // Written by a newer version, or out of place
+            return false;
+        }
+    }
+    return intact;
+}
+
+void BattleStats::Rewrite() {
+    Close();
+    {
+        std::ofstream tmp(path + ".tmp", std::ios::binary | std::ios::trunc);
+        for (const std::string& name : enemyNames) WriteChunk(tmp, CHUNK_NAME, name);
+        for (const SealedBlock& block : sealed) {
+            std::string payload;
+            Put32(payload, static_cast<uint32_t>(block.rows));
+            for (const PackedColumn& column : block.columns) {
+                Put64(payload, static_cast<uint64_t>(column.min));
+                Put64(payload, static_cast<uint64_t>(column.max));
+                Put64(payload, static_cast<uint64_t>(column.base));
+                Put64(payload, static_cast<uint64_t>(column.first));
+                payload.push_back(static_cast<char>(column.bits));
+                Put32(payload, static_cast<uint32_t>(column.words.size()));
+                for (uint64_t word : column.words) Put64(payload, word);
+            }
+            WriteChunk(tmp, CHUNK_BLOCK, payload);
+        }
+        for (int r = 0; r < tail.rows; ++r) {
+            std::string payload;
+            for (int c = 0; c < STAT_COLUMNS; ++c) Put64(payload, static_cast<uint64_t>(tail.columns[c][r]));
+            WriteChunk(tmp, CHUNK_ROW, payload);
+        }
+        if (!tmp.good()) return;
+    }
+    CommitTempFile(path);
+}
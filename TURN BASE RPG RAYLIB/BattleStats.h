@@ -0,0 +1,150 @@
+// BattleStats.h
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Every finished battle as one row of an append-only columnar store, read by
+// the Battle Records page in the Cottage.
+//
+// Rows collect in an open tail block. Every STATS_BLOCK_ROWS rows the tail is
+// sealed: each column is packed on its own at the fewest bits that cover its
+// range in the block (frame of reference), times as deltas from the row
+// before, enemies as ids into a dictionary of names. Each sealed column keeps
+// its min and max, so a query skips blocks its filters rule out and only
+// unpacks the columns it reads.
+
+enum class BattleOutcome : uint8_t {
+    Won,
+    Lost,
+    Fled
+};
+
+struct BattleRecord {
+    int64_t time = 0;  // seconds since the epoch
+    int playerLevel = 0;
+    std::string enemy;   // Archer, Warrior, ... or "Survival" for a survival wave
+    int enemyLevel = 0;  // for a survival wave, the wave number
+    BattleOutcome outcome = BattleOutcome::Won;
+    int turns = 0;
+    int attacks = 0;
+    int skills = 0;
+    int blocks = 0;
+    int items = 0;
+    int coins = 0;  // gained, negative after a defeat
+    int exp = 0;
+};
+
+enum class StatColumn : uint8_t {
+    Time,
+    PlayerLevel,
+    Enemy,  // dictionary id, see BattleStats::EnemyId
+    EnemyLevel,
+    Outcome,
+    Turns,
+    Attacks,
+    Skills,
+    Blocks,
+    Items,
+    Coins,
+    Exp,
+    Count  // also "no column" in StatsQuery
+};
+
+const int STAT_COLUMNS = static_cast<int>(StatColumn::Count);
+const int STATS_BLOCK_ROWS = 4096;
+
+struct StatFilter {
+    StatColumn column;
+    int64_t min;  // inclusive
+    int64_t max;
+};
+
+// Rows passing every filter, grouped by one column (value / bucket), with
+// an optional column summed per group
+struct StatsQuery {
+    std::vector<StatFilter> filters;
+    StatColumn groupBy = StatColumn::Count;  // Count: everything in one group
+    int64_t bucket = 1;
+    StatColumn sum = StatColumn::Count;      // Count: nothing summed
+
+    StatsQuery& Where(StatColumn column, int64_t min, int64_t max) {
+        filters.push_back({ column, min, max });
+        return *this;
+    }
+};
+
+struct StatGroup {
+    int64_t key;  // groupBy value / bucket, 0 without a groupBy
+    int64_t battles;
+    int64_t wins;
+    int64_t sum;
+};
+
+// What a query touched, for the benchmark
+struct StatsScan {
+    int blocksScanned = 0;
+    int blocksSkipped = 0;
+    int64_t rowsMatched = 0;
+};
+
+class BattleStats {
+public:
+    // Loads the file (missing is empty), drops a torn tail and keeps it open
+    // so Append writes through. Without Open the store lives in memory only.
+    bool Open(const std::string& path);
+    void Close();
+
+    void Append(const BattleRecord& record);
+
+    size_t RowCount() const { return sealedRows + tail.rows; }
+    int EnemyId(const std::string& name) const;  // -1 if never recorded
+    const std::string& EnemyName(int id) const { return enemyNames[id]; }
+    int EnemyCount() const { return static_cast<int>(enemyNames.size()); }
+
+    // Groups sorted by key, empty ones left out
+    std::vector<StatGroup> Query(const StatsQuery& query, StatsScan* scan = nullptr) const;
+
+    // Packed and tail columns plus the dictionary
+    size_t MemoryBytes() const;
+
+private:
+    struct PackedColumn {
+        int64_t min = 0;
+        int64_t max = 0;
+        int64_t base = 0;    // what the packed values are offsets from
+        int64_t first = 0;   // Time only: the first row, the rest are deltas
+        uint8_t bits = 0;
+        std::vector<uint64_t> words;
+    };
+    struct SealedBlock {
+        int rows = 0;
+        PackedColumn columns[STAT_COLUMNS];
+    };
+    struct TailBlock {
+        int rows = 0;
+        int64_t min[STAT_COLUMNS] = {};
+        int64_t max[STAT_COLUMNS] = {};
+        std::vector<int64_t> columns[STAT_COLUMNS];
+    };
+
+    bool AppendRow(const int64_t* row);  // true if it sealed the tail
+    void SealTail();
+    int InternEnemy(const std::string& name);
+    static void Pack(StatColumn column, const int64_t* values, int rows, PackedColumn& out);
+    static void Unpack(StatColumn column, const PackedColumn& packed, int rows, int64_t* out);
+
+    // False if the file has to be written again: a torn tail, or rows that
+    // were sealed while loading
+    bool ReadFile();
+    void Rewrite();
+
+    std::vector<SealedBlock> sealed;
+    size_t sealedRows = 0;
+    TailBlock tail;
+    std::vector<std::string> enemyNames;
+
+    std::string path;
+    std::ofstream out;
+};
@@ -0,0 +1,234 @@
+#include "BattleStatus.h"
+#include "Game.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+enum class StackRule : uint8_t {
+    Refresh,
+    Stack
+};
+
+// How each kind behaves. apply and expire keep the components in step with
+// the effects; expire gets no events when the effect was removed early.
+struct StatusRules {
+    StackRule stacking;
+    bool battles;  // duration counts battles instead of turns
+    bool ticks;    // tick runs at the end of every turn the effect is active
+    void (*apply)(World& world, Entity e, int32_t amount);
+    void (*tick)(World& world, Entity e, std::vector<StatusEvent>& events);
+    void (*expire)(World& world, Entity e, int32_t amount, std::vector<StatusEvent>* events);
+};
+
+template <typename Tag>
+void AddTag(World& world, Entity e, int32_t) {
+    world.Add(e, Tag{});
+}
+
+template <typename Tag>
+void RemoveTag(World& world, Entity e, int32_t, std::vector<StatusEvent>*) {
+    world.Remove<Tag>(e);
+}
+
+void ApplyPoison(World& world, Entity e, int32_t) {
+    const Fighter* fighter = world.Get<Fighter>(e);
+    world.Add(e, Poisoned{ fighter ? std::max(1, fighter->character->maxHP * 5 / 100) : 1 });
+}
+
+// Game takes the HP off when it reports the event, so it goes through the battle's event store
+void TickPoison(World& world, Entity e, std::vector<StatusEvent>& events) {
+    const Poisoned* poison = world.Get<Poisoned>(e);
+    if (!poison) return;
+    events.push_back({ e, StatusEventKind::PoisonDamage, poison->damage });
+}
+
+void CurePoison(World& world, Entity e, int32_t, std::vector<StatusEvent>* events) {
+    world.Remove<Poisoned>(e);
+    if (events) events->push_back({ e, StatusEventKind::PoisonCured, 0 });
+}
+
+void EndCooldown(World& world, Entity e, int32_t, std::vector<StatusEvent>* events) {
+    world.Remove<SkillCooldown>(e);
+    if (events) events->push_back({ e, StatusEventKind::SkillReady, 0 });
+}
+
+template <typename Buff>
+void AddBuff(World& world, Entity e, int32_t amount) {
+    Buff* buff = world.Get<Buff>(e);
+    if (!buff) buff = world.Add(e, Buff{ 0, 0 });
+    if (!buff) return;
+    buff->amount += amount;
+    buff->stacks++;
+}
+
+template <typename Buff>
+void DropBuff(World& world, Entity e, int32_t amount, std::vector<StatusEvent>* events) {
+    Buff* buff = world.Get<Buff>(e);
+    if (!buff) return;
+    buff->amount -= amount;
+    if (--buff->stacks <= 0) world.Remove<Buff>(e);
+    if (events) events->push_back({ e, StatusEventKind::BuffExpired, amount });
+}
+
+// Same order as StatusKind
+const StatusRules RULES[STATUS_KIND_COUNT] = {
+    { StackRule::Refresh, false, false, AddTag<Blocking>, nullptr, RemoveTag<Blocking> },
+    { StackRule::Refresh, false, true, ApplyPoison, TickPoison, CurePoison },
+    { StackRule::Refresh, false, false, AddTag<SkillCooldown>, nullptr, EndCooldown },
+    { StackRule::Stack, true, false, AddBuff<AttackBuff>, nullptr, DropBuff<AttackBuff> },
+    { StackRule::Stack, true, false, AddBuff<DefenseBuff>, nullptr, DropBuff<DefenseBuff> },
+    { StackRule::Refresh, true, false, AddTag<Hasted>, nullptr, RemoveTag<Hasted> },
+};
+
+const StatusRules& RulesOf(StatusKind kind) {
+    return RULES[static_cast<int>(kind)];
+}
+
+} // namespace
+
+bool CountsBattles(StatusKind kind) {
+    return RulesOf(kind).battles;
+}
+
+TimerWheel& StatusEngine::ClockOf(StatusKind kind) {
+    return RulesOf(kind).battles ? battles : turns;
+}
+
+const TimerWheel& StatusEngine::ClockOf(StatusKind kind) const {
+    return RulesOf(kind).battles ? battles : turns;
+}
+
+uint32_t& StatusEngine::SlotOf(Entity target, StatusKind kind) {
+    Slots* slots = world.Get<Slots>(target);
+    if (!slots) {
+        Slots empty;
+        std::fill(std::begin(empty.effect), std::end(empty.effect), TimerWheel::NONE);
+        slots = world.Add(target, empty);
+    }
+    return slots->effect[static_cast<int>(kind)];
+}
+
+void StatusEngine::Apply(Entity target, StatusKind kind, int duration, int amount) {
+    if (!world.IsAlive(target) || duration <= 0) return;
+    const StatusRules& rules = RulesOf(kind);
+    TimerWheel& clock = ClockOf(kind);
+    uint32_t expiresAt = clock.Now() + static_cast<uint32_t>(duration);
+
+    if (rules.stacking == StackRule::Refresh) {
+        uint32_t existing = SlotOf(target, kind);
+        if (existing != TimerWheel::NONE) {
+            Effect& effect = effects[existing];
+            effect.amount = amount;
+            if (expiresAt > effect.expiresAt) {
+                effect.expiresAt = expiresAt;
+                // A ticking effect checks expiresAt on every tick instead
+                if (!rules.ticks && effect.timer != TimerWheel::NONE) {
+                    clock.Cancel(effect.timer);
+                    effect.timer = clock.Schedule(expiresAt, existing);
+                }
+            }
+            rules.apply(world, target, amount);
+            return;
+        }
+    }
+
+    uint32_t id;
+    if (!freeEffects.empty()) {
+        id = freeEffects.back();
+        freeEffects.pop_back();
+    }
+    else {
+        id = static_cast<uint32_t>(effects.size());
+        effects.push_back({});
+    }
+    uint32_t timer = clock.Schedule(rules.ticks ? clock.Now() + 1 : expiresAt, id);
+    effects[id] = { target, kind, true, amount, expiresAt, timer };
+    if (rules.stacking == StackRule::Refresh) SlotOf(target, kind) = id;
+    rules.apply(world, target, amount);
+}
+
+void StatusEngine::Remove(Entity target, StatusKind kind) {
+    if (!world.IsAlive(target)) return;
+    if (RulesOf(kind).stacking == StackRule::Refresh) {
+        const Slots* slots = world.Get<Slots>(target);
+        if (slots && slots->effect[static_cast<int>(kind)] != TimerWheel::NONE) {
+            End(slots->effect[static_cast<int>(kind)], nullptr);
+        }
+        return;
+    }
+    // Stacks aren't indexed; this is for items and battle resets, not every turn
+    for (uint32_t id = 0; id < effects.size(); ++id) {
+        if (effects[id].live && effects[id].kind == kind && effects[id].target == target) End(id, nullptr);
+    }
+}
+
+int StatusEngine::Remaining(Entity target, StatusKind kind) const {
+    uint32_t now = ClockOf(kind).Now();
+    if (RulesOf(kind).stacking == StackRule::Refresh) {
+        const Slots* slots = world.Get<Slots>(target);
+        if (!slots || slots->effect[static_cast<int>(kind)] == TimerWheel::NONE) return 0;
+        return static_cast<int>(effects[slots->effect[static_cast<int>(kind)]].expiresAt - now);
+    }
+    uint32_t latest = now;
+    for (const Effect& effect : effects) {
+        if (effect.live && effect.kind == kind && effect.target == target) latest = std::max(latest, effect.expiresAt);
+    }
+    return static_cast<int>(latest - now);
+}
+
+void StatusEngine::EndTurn(std::vector<StatusEvent>& events) {
+    PROFILE_ZONE("StatusEndTurn");
+    turns.Step([&](uint32_t id) { Fire(id, events); });
+}
+
+void StatusEngine::EndBattle(std::vector<StatusEvent>& events) {
+    PROFILE_ZONE("StatusEndBattle");
+    battles.Step([&](uint32_t id) { Fire(id, events); });
+}
+
+void StatusEngine::Fire(uint32_t id, std::vector<StatusEvent>& events) {
+    effects[id].timer = TimerWheel::NONE;
+    const StatusRules& rules = RulesOf(effects[id].kind);
+    if (rules.ticks && world.IsAlive(effects[id].target)) {
+        rules.tick(world, effects[id].target, events);
+        TimerWheel& clock = ClockOf(effects[id].kind);
+        if (clock.Now() < effects[id].expiresAt) {
+            effects[id].timer = clock.Schedule(clock.Now() + 1, id);
+            return;
+        }
+    }
+    End(id, &events);
+}
+
+// Frees the effect; the expire hook runs unless the entity is gone, components and all
+void StatusEngine::End(uint32_t id, std::vector<StatusEvent>* events) {
+    Effect effect = effects[id];
+    effects[id].live = false;
+    freeEffects.push_back(id);
+    if (effect.timer != TimerWheel::NONE) ClockOf(effect.kind).Cancel(effect.timer);
+    if (!world.IsAlive(effect.target)) return;
+
+    const StatusRules& rules = RulesOf(effect.kind);
+    if (rules.stacking == StackRule::Refresh) SlotOf(effect.target, effect.kind) = TimerWheel::NONE;
+    rules.expire(world, effect.target, effect.amount, events);
+}
+
+int EffectiveAttack(const World& world, Entity e) {
+    const Fighter* fighter = world.Get<Fighter>(e);
+    const AttackBuff* buff = world.Get<AttackBuff>(e);
+    return (fighter ? fighter->character->attack : 0) + (buff ? buff->amount : 0);
+}
+
+int EffectiveDefense(const World& world, Entity e) {
+    const Fighter* fighter = world.Get<Fighter>(e);
+    const DefenseBuff* buff = world.Get<DefenseBuff>(e);
+    return (fighter ? fighter->character->defense : 0) + (buff ? buff->amount : 0);
+}
+
+int EffectiveSpeed(const World& world, Entity e) {
+    const Fighter* fighter = world.Get<Fighter>(e);
+    int speed = fighter ? fighter->character->speed : NORMAL_SPEED;
+    return world.Has<Hasted>(e) ? speed * 3 / 2 : speed;
+}
@@ -0,0 +1,122 @@
+// BattleStatus.h
+#pragma once
+#include "Ecs.h"
+#include "TimerWheel.h"
+#include <cstdint>
+#include <vector>
+
+// Timed status effects on battle entities. StatusEngine owns every effect and
+// its timer; the components below are what the rest of the game reads, kept
+// up to date by each kind's apply and expire hooks (BattleStatus.cpp). HP and
+// base stats stay on Game's Character structs; Fighter points there.
+
+struct Character;
+
+enum class StatusKind : uint8_t {
+    Blocking,       // incoming attacks quartered (skills get through)
+    Poison,         // 5% of max HP at the end of every turn
+    SkillCooldown,  // skill unusable
+    AttackUp,       // + amount attack
+    DefenseUp,      // + amount defense
+    Haste,          // half again as fast in the next battle
+    Count
+};
+
+const int STATUS_KIND_COUNT = static_cast<int>(StatusKind::Count);
+
+struct Fighter {
+    Character* character;
+};
+
+struct Blocking {};
+
+struct Poisoned {
+    int32_t damage;  // per turn
+};
+
+struct SkillCooldown {};
+
+struct AttackBuff {
+    int32_t amount;  // all stacks together
+    int32_t stacks;
+};
+
+struct DefenseBuff {
+    int32_t amount;
+    int32_t stacks;
+};
+
+struct Hasted {};
+
+// Durations of these count battles, the rest turns
+bool CountsBattles(StatusKind kind);
+
+enum class StatusEventKind : uint8_t {
+    PoisonDamage,   // not taken off yet; the caller does that
+    PoisonCured,
+    SkillReady,
+    BuffExpired
+};
+
+// What an effect did, for Game to put in the battle log
+struct StatusEvent {
+    Entity entity;
+    StatusEventKind kind;
+    int32_t amount;
+};
+
+// Applying a kind the entity already has either refreshes the one instance
+// (the longer duration wins, the new amount replaces the old) or stacks a
+// separate instance with its own timer. Durations count turns, which end
+// each time the enemy has acted, or battles. Only effects with something due are
+// touched when a turn or battle ends.
+class StatusEngine {
+public:
+    explicit StatusEngine(World& world) : world(world) {}
+
+    // duration is in the kind's unit; amount is what AttackUp and DefenseUp add
+    void Apply(Entity target, StatusKind kind, int duration, int amount = 0);
+    // Every instance, without the expiry events
+    void Remove(Entity target, StatusKind kind);
+    // Turns or battles left on the longest instance; 0 if none
+    int Remaining(Entity target, StatusKind kind) const;
+
+    void EndTurn(std::vector<StatusEvent>& events);
+    void EndBattle(std::vector<StatusEvent>& events);
+
+    size_t ActiveCount() const { return effects.size() - freeEffects.size(); }
+
+private:
+    struct Effect {
+        Entity target;
+        StatusKind kind;
+        bool live;
+        int32_t amount;
+        uint32_t expiresAt;  // on the clock of the kind's unit
+        uint32_t timer;      // TimerWheel::NONE while the timer is firing
+    };
+
+    // The one instance of each refreshing kind, so Apply finds it without a search
+    struct Slots {
+        uint32_t effect[STATUS_KIND_COUNT];
+    };
+
+    TimerWheel& ClockOf(StatusKind kind);
+    const TimerWheel& ClockOf(StatusKind kind) const;
+    // target must be alive
+    uint32_t& SlotOf(Entity target, StatusKind kind);
+    void Fire(uint32_t id, std::vector<StatusEvent>& events);
+    void End(uint32_t id, std::vector<StatusEvent>* events);
+
+    World& world;
+    std::vector<Effect> effects;
+    std::vector<uint32_t> freeEffects;
+    TimerWheel turns;
+    TimerWheel battles;
+};
+
+// Base stat plus any buff
+int EffectiveAttack(const World& world, Entity e);
+int EffectiveDefense(const World& world, Entity e);
+// Initiative speed: base, half again while Hasted
+int EffectiveSpeed(const World& world, Entity e);
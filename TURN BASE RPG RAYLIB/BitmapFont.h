@@ -0,0 +1,18 @@
+// BitmapFont.h
+#pragma once
+#include <cstdint>
+
+// Built-in 5x7 ASCII font for the headless renderers. Sized like raylib's
+// default font (10px base) so layouts come out roughly the same.
+namespace BitmapFont {
+    const int GLYPH_WIDTH = 5;
+    const int GLYPH_HEIGHT = 7;
+    const int BASE_SIZE = 10;
+    const int ADVANCE = GLYPH_WIDTH + 1; // at base size
+
+    // GLYPH_WIDTH column bytes, bit 0 is the top row. Unknown characters get '?'.
+    const uint8_t* Glyph(char c);
+
+    float Scale(int fontSize);
+    int MeasureText(const char* text, int fontSize);
+}
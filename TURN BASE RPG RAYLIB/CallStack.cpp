@@ -0,0 +1,73 @@
+#include "CallStack.h"
+#include <cstdio>
+
+// Kept apart from the raylib code: windows.h clashes with raylib.h names
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <dbghelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#elif defined(__linux__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+
+int CaptureCallStack(void** frames, int maxFrames, int skip) {
+#if defined(_WIN32)
+    return RtlCaptureStackBackTrace(static_cast<DWORD>(skip + 1), static_cast<DWORD>(maxFrames), frames, nullptr);
+#elif defined(__linux__) || defined(__APPLE__)
+    void* buffer[64];
+    int wanted = skip + 1 + maxFrames;
+    if (wanted > 64) wanted = 64;
+    int count = backtrace(buffer, wanted);
+    int copied = 0;
+    for (int i = skip + 1; i < count && copied < maxFrames; ++i) {
+        frames[copied++] = buffer[i];
+    }
+    return copied;
+#else
+    (void)frames; (void)maxFrames; (void)skip;
+    return 0;
+#endif
+}
+
+void PrintCallStack(void* const* frames, int count) {
+#if defined(_WIN32)
+    static bool symbolsReady = false;
+    HANDLE process = GetCurrentProcess();
+    if (!symbolsReady) {
+        SymSetOptions(SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
+        SymInitialize(process, nullptr, TRUE);
+        symbolsReady = true;
+    }
+
+    char buffer[sizeof(SYMBOL_INFO) + 256];
+    SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+    for (int i = 0; i < count; ++i) {
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen = 255;
+        DWORD64 address = reinterpret_cast<DWORD64>(frames[i]);
+        IMAGEHLP_LINE64 line = {};
+        line.SizeOfStruct = sizeof(line);
+        DWORD lineOffset = 0;
+        if (SymFromAddr(process, address, nullptr, symbol)) {
+            if (SymGetLineFromAddr64(process, address, &lineOffset, &line)) {
+                printf("    %s (%s:%lu)\n", symbol->Name, line.FileName, line.LineNumber);
+            }
+            else {
+                printf("    %s\n", symbol->Name);
+            }
+        }
+        else {
+            printf("    %p\n", frames[i]);
+        }
+    }
+#elif defined(__linux__) || defined(__APPLE__)
+    fflush(stdout);
+    // backtrace_symbols_fd writes straight to the fd without calling malloc
+    backtrace_symbols_fd(const_cast<void**>(frames), count, STDOUT_FILENO);
+#else
+    for (int i = 0; i < count; ++i) printf("    %p\n", frames[i]);
+#endif
+}
@@ -0,0 +1,9 @@
+// CallStack.h
+#pragma once
+
+// Return addresses of the current call stack, skipping the innermost `skip` frames.
+// Does not allocate, so it is safe to call from operator new.
+int CaptureCallStack(void** frames, int maxFrames, int skip);
+
+// Prints one frame per line, with symbol names where the platform can resolve them
+void PrintCallStack(void* const* frames, int count);
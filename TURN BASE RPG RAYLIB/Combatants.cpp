@@ -0,0 +1,241 @@
+#include "Combatants.h"
+#include <algorithm>
+
+namespace {
+
+Team Opponents(Team side) {
+    return side == Team::Allies ? Team::Enemies : Team::Allies;
+}
+
+} // namespace
+
+void CombatantPool::Clear() {
+    hp.clear();
+    maxHp.clear();
+    attack.clear();
+    defense.clear();
+    level.clear();
+    team.clear();
+    kind.clear();
+    status.clear();
+    poisonTurns.clear();
+    skillCooldown.clear();
+}
+
+void CombatantPool::Reserve(int count) {
+    hp.reserve(count);
+    maxHp.reserve(count);
+    attack.reserve(count);
+    defense.reserve(count);
+    level.reserve(count);
+    team.reserve(count);
+    kind.reserve(count);
+    status.reserve(count);
+    poisonTurns.reserve(count);
+    skillCooldown.reserve(count);
+    plannedAction.reserve(count);
+}
+
+int CombatantPool::Add(Team side, uint8_t combatantKind, const SimStats& stats, int combatantLevel) {
+    hp.push_back(stats.maxHP);
+    maxHp.push_back(stats.maxHP);
+    attack.push_back(stats.attack);
+    defense.push_back(stats.defense);
+    level.push_back(combatantLevel);
+    team.push_back(static_cast<uint8_t>(side));
+    kind.push_back(combatantKind);
+    status.push_back(0);
+    poisonTurns.push_back(0);
+    skillCooldown.push_back(0);
+    return Count() - 1;
+}
+
+int CombatantPool::LivingCount(Team side) const {
+    int living = 0;
+    for (int i = 0; i < Count(); ++i) {
+        living += (team[i] == static_cast<uint8_t>(side) && hp[i] > 0) ? 1 : 0;
+    }
+    return living;
+}
+
+int CombatantPool::NextLiving(Team side, int from, int step) const {
+    int n = Count();
+    for (int k = 1; k <= n; ++k) {
+        int i = ((from + k * step) % n + n) % n;
+        if (team[i] == static_cast<uint8_t>(side) && hp[i] > 0) return i;
+    }
+    return -1;
+}
+
+int CombatantPool::WeakestLiving(Team side) const {
+    int weakest = -1;
+    float weakestShare = 2.0f;
+    for (int i = 0; i < Count(); ++i) {
+        if (team[i] != static_cast<uint8_t>(side) || hp[i] <= 0) continue;
+        float share = static_cast<float>(hp[i]) / maxHp[i];
+        if (share < weakestShare) {
+            weakestShare = share;
+            weakest = i;
+        }
+    }
+    return weakest;
+}
+
+// Game::ChooseEnemyAction with "player" read as the target
+CombatAction CombatantPool::ChooseAction(int actor, int target, SimRng& rng) const {
+    float selfHpPercent = static_cast<float>(hp[actor]) / maxHp[actor];
+    float targetHpPercent = static_cast<float>(hp[target]) / maxHp[target];
+    bool blockedLast = (status[actor] & STATUS_BLOCKED_LAST) != 0;
+
+    int scoreAttack = 10;
+    int scoreBlock = 5;
+    int scoreSkill = 0;
+
+    if (selfHpPercent < 0.5f) scoreBlock += 2;
+    if (selfHpPercent < 0.3f) scoreBlock += 3;
+    if (targetHpPercent < 0.3f) scoreAttack += 5;
+    if (targetHpPercent > 0.8f) scoreSkill += 2;
+    if (blockedLast) scoreBlock -= 6;
+
+    if (skillCooldown[actor] > 0) {
+        scoreSkill = -100;
+    }
+    else {
+        switch (static_cast<SimEnemyKind>(kind[actor])) {
+        case SimEnemyKind::Archer:
+            scoreSkill += 8 + rng.Range(0, 2);
+            break;
+        case SimEnemyKind::Warrior:
+            if (selfHpPercent < 0.6f) scoreSkill += 10;
+            break;
+        case SimEnemyKind::Paladin:
+            if (blockedLast) scoreSkill += 12;
+            break;
+        case SimEnemyKind::Witch:
+            if (!(status[target] & STATUS_POISONED)) scoreSkill += 15;
+            break;
+        default:
+            // Heroes sweep whenever the skill is back
+            scoreSkill += 12;
+            break;
+        }
+    }
+
+    scoreAttack += rng.Range(0, 2);
+    scoreBlock += rng.Range(0, 2);
+    scoreSkill += rng.Range(0, 2);
+
+    if (scoreSkill >= scoreAttack && scoreSkill >= scoreBlock) return CombatAction::Skill;
+    if (scoreAttack >= scoreBlock) return CombatAction::Attack;
+    return CombatAction::Block;
+}
+
+int CombatantPool::Hit(int target, int damage, bool blockable) {
+    if (blockable && (status[target] & STATUS_BLOCKING)) damage /= 4;
+    damage = std::max(1, damage);
+    hp[target] = std::max(0, hp[target] - damage);
+    return damage;
+}
+
+bool CombatantPool::StartTurn(int actor) {
+    status[actor] &= ~STATUS_BLOCKING;
+    if (status[actor] & STATUS_POISONED) {
+        hp[actor] = std::max(0, hp[actor] - std::max(1, maxHp[actor] * 5 / 100));
+        if (--poisonTurns[actor] == 0) status[actor] &= ~STATUS_POISONED;
+    }
+    return hp[actor] > 0;
+}
+
+CombatEvent CombatantPool::Attack(int actor, int target) {
+    status[actor] &= ~STATUS_BLOCKED_LAST;
+    return { actor, target, CombatAction::Attack, Hit(target, attack[actor] - defense[target], true) };
+}
+
+CombatEvent CombatantPool::Block(int actor) {
+    status[actor] |= STATUS_BLOCKING | STATUS_BLOCKED_LAST;
+    return { actor, -1, CombatAction::Block, 0 };
+}
+
+// Game::EnemyAttack's skills for the enemy types; heroes hit every opponent
+CombatEvent CombatantPool::Skill(int actor, int target) {
+    status[actor] &= ~STATUS_BLOCKED_LAST;
+    skillCooldown[actor] = 3;
+    CombatEvent event = { actor, target, CombatAction::Skill, 0 };
+    switch (static_cast<SimEnemyKind>(kind[actor])) {
+    case SimEnemyKind::Archer:
+    case SimEnemyKind::Warrior:
+        event.damage = Hit(target, (attack[actor] * 2) - defense[target], false);
+        break;
+    case SimEnemyKind::Paladin:
+        event.damage = Hit(target, static_cast<int>((attack[actor] * 1.5) - defense[target]), false);
+        break;
+    case SimEnemyKind::Witch:
+        status[target] |= STATUS_POISONED;
+        poisonTurns[target] = 3;
+        break;
+    default: {
+        event.target = -1;
+        uint8_t opponents = static_cast<uint8_t>(Opponents(static_cast<Team>(team[actor])));
+        for (int i = 0; i < Count(); ++i) {
+            if (team[i] == opponents && hp[i] > 0) event.damage += Hit(i, attack[actor] - defense[i], true);
+        }
+        break;
+    }
+    }
+    return event;
+}
+
+void CombatantPool::TeamTurn(Team side, SimRng& rng, int skip, std::vector<CombatEvent>* events) {
+    Team opponents = Opponents(side);
+    int target = WeakestLiving(opponents);
+    if (target < 0) return;
+
+    // Everyone decides against the same picture of the battle...
+    plannedAction.resize(Count());
+    for (int i = 0; i < Count(); ++i) {
+        if (team[i] != static_cast<uint8_t>(side) || hp[i] <= 0 || i == skip) continue;
+        plannedAction[i] = ChooseAction(i, target, rng);
+    }
+
+    // ...then acts on the battle as it is by then
+    for (int i = 0; i < Count(); ++i) {
+        if (team[i] != static_cast<uint8_t>(side) || hp[i] <= 0 || i == skip) continue;
+        if (!StartTurn(i)) continue;
+        if (hp[target] <= 0) {
+            target = WeakestLiving(opponents);
+            if (target < 0) return;
+        }
+
+        CombatEvent event;
+        switch (plannedAction[i]) {
+        case CombatAction::Attack: event = Attack(i, target); break;
+        case CombatAction::Block: event = Block(i); break;
+        case CombatAction::Skill: event = Skill(i, target); break;
+        }
+        if (events) events->push_back(event);
+    }
+}
+
+void CombatantPool::EndRound() {
+    for (uint8_t& cooldown : skillCooldown) {
+        if (cooldown > 0) cooldown--;
+    }
+}
+
+Team SimulateGroupBattle(CombatantPool& pool, SimRng& rng, int maxRounds, int* roundsOut) {
+    int round = 0;
+    Team winner = Team::Enemies;
+    while (round < maxRounds) {
+        round++;
+        pool.TeamTurn(Team::Allies, rng);
+        if (pool.WeakestLiving(Team::Enemies) < 0) {
+            winner = Team::Allies;
+            break;
+        }
+        pool.TeamTurn(Team::Enemies, rng);
+        if (pool.WeakestLiving(Team::Allies) < 0) break;
+        pool.EndRound();
+    }
+    if (roundsOut) *roundsOut = round;
+    return winner;
+}
@@ -0,0 +1,90 @@
+// Combatants.h
+#pragma once
+#include "BattleSim.h"
+#include <cstdint>
+#include <vector>
+
+// Group battles (Survival Mode): any number of allies against any number of
+// enemies. The rules follow the one-on-one battle in Game with two changes:
+// a block lasts until the blocker's next turn instead of the whole fight, and
+// hero skills hit every opponent.
+
+enum class Team : uint8_t {
+    Allies,
+    Enemies
+};
+
+enum class CombatAction : uint8_t {
+    Attack,
+    Block,
+    Skill
+};
+
+// Kind for combatants that aren't one of the enemy types (the player)
+const uint8_t COMBATANT_HERO = static_cast<uint8_t>(SimEnemyKind::Count);
+
+// Status bits
+const uint8_t STATUS_BLOCKING = 1;      // incoming attacks quartered until its next turn
+const uint8_t STATUS_POISONED = 2;
+const uint8_t STATUS_BLOCKED_LAST = 4;  // the AI won't block twice in a row
+
+// One action, for the battle log
+struct CombatEvent {
+    int32_t actor;
+    int32_t target;  // -1 for blocks and area skills
+    CombatAction action;
+    int32_t damage;  // summed over every target
+};
+
+// Everyone in the battle, one array per field, so a pass over the AI inputs
+// or the HP column reads nothing else. A combatant's index is its id for the
+// whole battle; the fallen stay where they are with hp 0.
+class CombatantPool {
+public:
+    void Clear();
+    void Reserve(int count);
+    int Add(Team side, uint8_t kind, const SimStats& stats, int level);
+
+    int Count() const { return static_cast<int>(hp.size()); }
+    bool Alive(int i) const { return hp[i] > 0; }
+    int LivingCount(Team side) const;
+
+    // Next living member of side after from, going by step (+1/-1) and wrapping; -1 if none
+    int NextLiving(Team side, int from, int step) const;
+    // Living member of side with the lowest HP share; -1 if none
+    int WeakestLiving(Team side) const;
+
+    // Poison ticks and the last block wears off; false if that killed the actor
+    bool StartTurn(int actor);
+    CombatEvent Attack(int actor, int target);
+    CombatEvent Skill(int actor, int target);
+    CombatEvent Block(int actor);
+
+    // Every living member of side except skip picks an action, then they act
+    // in index order. Events are appended to events when given.
+    void TeamTurn(Team side, SimRng& rng, int skip = -1, std::vector<CombatEvent>* events = nullptr);
+    // Cooldowns, once both sides have acted
+    void EndRound();
+
+    std::vector<int32_t> hp;
+    std::vector<int32_t> maxHp;
+    std::vector<int32_t> attack;
+    std::vector<int32_t> defense;
+    std::vector<int32_t> level;
+    std::vector<uint8_t> team;
+    std::vector<uint8_t> kind;
+    std::vector<uint8_t> status;
+    std::vector<uint8_t> poisonTurns;
+    std::vector<uint8_t> skillCooldown;
+
+private:
+    CombatAction ChooseAction(int actor, int target, SimRng& rng) const;
+    int Hit(int target, int damage, bool blockable);
+
+    // TeamTurn's plan, kept to avoid allocating every turn
+    std::vector<CombatAction> plannedAction;
+};
+
+// Fights it out with both sides on AI; returns the side left standing, or
+// Enemies if nobody won within maxRounds
+Team SimulateGroupBattle(CombatantPool& pool, SimRng& rng, int maxRounds, int* roundsOut = nullptr);
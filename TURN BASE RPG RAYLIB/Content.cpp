@@ -0,0 +1,229 @@
+#include "Content.h"
+#include "ContentCompiler.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "FlightRecorder.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+
+#if defined(CONTENT_HOT_RELOAD) && defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Used when assets/content.bin has not been built yet
+static const ShopItemDef defaultShopItems[] = {
+    { "Potion", "Restores 20 HP", 10 },
+    { "Hi-Potion", "Restores 50 HP", 25 },
+    { "Elixir", "Fully restores HP", 50 },
+    { "Antidote", "Cures poison", 15 },
+    { "Attack Up", "Boosts attack for next battle", 30 },
+    { "Defense Up", "Boosts defense for next battle", 30 },
+    { "Revive", "Revives you with 50% HP if defeated", 60 },
+    { "Speed Boots", "Increases speed for next battle", 35 },
+    { "Magic Water", "Restores skill cooldown instantly", 40 }
+};
+
+static const SkillDef defaultSkills[] = {
+    { "Blazing Strike", "A powerful fire attack.)", 50 },
+    { "Frost Guard", "Reduces damage for 2 turns.", 40 },
+    { "Thunder Dash", "Quick attack, always goes first.", 60 }
+};
+
+static const EnemyDef defaultEnemies[] = {
+    { "Archer", 50, 10, 10, 2, 2, 1, 20, 5, 5, 2 },
+    { "Warrior", 70, 12, 12, 2, 4, 1, 20, 5, 5, 2 },
+    { "Paladin", 90, 15, 8, 1, 6, 2, 20, 5, 5, 2 },
+    { "Witch", 60, 8, 9, 2, 3, 1, 20, 5, 5, 2 }
+};
+
+// Same rows as Content/encounters.txt
+static const EncounterDef defaultEncounters[] = {
+    { "Colosseum", "Archer", 1, 4, -1, 4, 0 },
+    { "Colosseum", "Archer", 1, 4, 0, 4, 0 },
+    { "Colosseum", "Warrior", 1, 4, -1, 4, 0 },
+    { "Colosseum", "Warrior", 1, 4, 0, 4, 0 },
+    { "Colosseum", "Paladin", 1, 4, 0, 2, 0 },
+    { "Colosseum", "Witch", 1, 4, 0, 2, ENCOUNTER_NO_REPEAT },
+    { "Colosseum", "Archer", 5, 999, -1, 1, 0 },
+    { "Colosseum", "Archer", 5, 999, 0, 1, 0 },
+    { "Colosseum", "Archer", 5, 999, 1, 1, 0 },
+    { "Colosseum", "Warrior", 5, 999, -1, 1, 0 },
+    { "Colosseum", "Warrior", 5, 999, 0, 1, 0 },
+    { "Colosseum", "Warrior", 5, 999, 1, 1, 0 },
+    { "Colosseum", "Paladin", 5, 999, -1, 1, 0 },
+    { "Colosseum", "Paladin", 5, 999, 0, 1, 0 },
+    { "Colosseum", "Paladin", 5, 999, 1, 1, 0 },
+    { "Colosseum", "Witch", 5, 999, -1, 1, ENCOUNTER_NO_REPEAT },
+    { "Colosseum", "Witch", 5, 999, 0, 1, ENCOUNTER_NO_REPEAT },
+    { "Colosseum", "Witch", 5, 999, 1, 1, ENCOUNTER_NO_REPEAT }
+};
+
+static const char* SOURCE_FILES[] = { "shop.txt", "skills.txt", "enemies.txt", "encounters.txt" };
+
+ContentDatabase& Content() {
+    static ContentDatabase database;
+    return database;
+}
+
+ContentDatabase::ContentDatabase() {
+    UseDefaults();
+}
+
+void ContentDatabase::UseDefaults() {
+    storage.clear();
+    shopItems = defaultShopItems;
+    shopItemCount = sizeof(defaultShopItems) / sizeof(defaultShopItems[0]);
+    skills = defaultSkills;
+    skillCount = sizeof(defaultSkills) / sizeof(defaultSkills[0]);
+    enemies = defaultEnemies;
+    enemyCount = sizeof(defaultEnemies) / sizeof(defaultEnemies[0]);
+    encounters = defaultEncounters;
+    encounterCount = sizeof(defaultEncounters) / sizeof(defaultEncounters[0]);
+}
+
+bool ContentDatabase::Adopt(std::vector<uint32_t>&& blob) {
+    size_t size = blob.size() * sizeof(uint32_t);
+    if (size < sizeof(ContentHeader)) return false;
+
+    const ContentHeader* header = reinterpret_cast<const ContentHeader*>(blob.data());
+    if (header->magic != CONTENT_MAGIC || header->version != CONTENT_VERSION) return false;
+    if (header->shopItemOffset + (size_t)header->shopItemCount * sizeof(ShopItemDef) > size ||
+        header->skillOffset + (size_t)header->skillCount * sizeof(SkillDef) > size ||
+        header->enemyOffset + (size_t)header->enemyCount * sizeof(EnemyDef) > size ||
+        header->encounterOffset + (size_t)header->encounterCount * sizeof(EncounterDef) > size) {
+        return false;
+    }
+
+    storage = std::move(blob);
+    const char* base = reinterpret_cast<const char*>(storage.data());
+    header = reinterpret_cast<const ContentHeader*>(base);
+    shopItems = reinterpret_cast<const ShopItemDef*>(base + header->shopItemOffset);
+    shopItemCount = static_cast<int>(header->shopItemCount);
+    skills = reinterpret_cast<const SkillDef*>(base + header->skillOffset);
+    skillCount = static_cast<int>(header->skillCount);
+    enemies = reinterpret_cast<const EnemyDef*>(base + header->enemyOffset);
+    enemyCount = static_cast<int>(header->enemyCount);
+    encounters = reinterpret_cast<const EncounterDef*>(base + header->encounterOffset);
+    encounterCount = static_cast<int>(header->encounterCount);
+    generation++;
+    return true;
+}
+
+bool ContentDatabase::Load(const std::string& path) {
+    MEMORY_SCOPE(Assets);
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+
+    std::streamsize size = in.tellg();
+    if (size <= 0 || size % sizeof(uint32_t) != 0) return false;
+    in.seekg(0);
+
+    std::vector<uint32_t> blob(static_cast<size_t>(size) / sizeof(uint32_t));
+    if (!in.read(reinterpret_cast<char*>(blob.data()), size)) return false;
+
+    if (!Adopt(std::move(blob))) {
+        std::cout << "[Content] " << path << " is not a valid content blob, using defaults" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const ShopItemDef* ContentDatabase::FindShopItem(const std::string& name) const {
+    for (int i = 0; i < shopItemCount; ++i) {
+        if (name == shopItems[i].name) return &shopItems[i];
+    }
+    return nullptr;
+}
+
+const EnemyDef& ContentDatabase::FindEnemy(const char* name) const {
+    for (int i = 0; i < enemyCount; ++i) {
+        if (std::strcmp(enemies[i].name, name) == 0) return enemies[i];
+    }
+    for (const EnemyDef& def : defaultEnemies) {
+        if (std::strcmp(def.name, name) == 0) return def;
+    }
+    return defaultEnemies[0];
+}
+
+void ContentDatabase::WatchSources(const std::string& dir, const std::string& blob) {
+#ifdef CONTENT_HOT_RELOAD
+    sourceDir = dir;
+    blobPath = blob;
+    sourcePaths.clear();
+    for (const char* file : SOURCE_FILES) {
+        sourcePaths.push_back(std::filesystem::path(dir) / file);
+    }
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0 && inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+    SourcesChanged(); // remember the current timestamps
+#else
+    (void)dir;
+    (void)blob;
+#endif
+}
+
+bool ContentDatabase::SourcesChanged() {
+#ifdef CONTENT_HOT_RELOAD
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        alignas(inotify_event) char buffer[4096];
+        bool changed = false;
+        ssize_t len;
+        while ((len = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + len;) {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                if (ev->len > 0 && std::strstr(ev->name, ".txt") != nullptr) changed = true;
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+        return changed;
+    }
+#endif
+    // No inotify (Windows): poll modification times twice a second
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (now < nextPollTime) return false;
+    nextPollTime = now + 0.5;
+
+    long long stamp = 0;
+    for (const std::filesystem::path& file : sourcePaths) {
+        std::error_code ec;
+        auto time = std::filesystem::last_write_time(file, ec);
+        if (!ec) stamp += time.time_since_epoch().count();
+    }
+    bool changed = lastSourceStamp != 0 && stamp != lastSourceStamp;
+    lastSourceStamp = stamp;
+    return changed;
+#else
+    return false;
+#endif
+}
+
+void ContentDatabase::PollHotReload() {
+#ifdef CONTENT_HOT_RELOAD
+    if (sourceDir.empty() || !SourcesChanged()) return;
+
+    PROFILE_ZONE("ContentHotReload");
+    FlightRecorder::Record(FlightEvent::AssetLoad, 0, 0, sourceDir.c_str());
+    MEMORY_SCOPE(Assets);
+    std::vector<uint32_t> blob;
+    std::string error;
+    if (!CompileContent(sourceDir, blob, error)) {
+        // Keep playing with the old tables until the file is fixed
+        std::cout << "[Content] " << error << std::endl;
+        return;
+    }
+    WriteContentBlob(blobPath, blob);
+    if (Adopt(std::move(blob))) {
+        std::cout << "[Content] Reloaded " << sourceDir << std::endl;
+    }
+#endif
+}
@@ -0,0 +1,66 @@
+// Content.h
+#pragma once
+#include "ContentFormat.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Hot reload of Content/*.txt is only compiled into debug builds
+#ifndef NDEBUG
+#define CONTENT_HOT_RELOAD 1
+#endif
+
+// Shop, skill, enemy and encounter tables. Starts with the built-in defaults and is
+// replaced by assets/content.bin when that file is present.
+class ContentDatabase {
+public:
+    ContentDatabase();
+
+    // Loads a compiled blob. Keeps the current tables if the file is missing or invalid.
+    bool Load(const std::string& blobPath);
+
+    // Debug builds: recompile and swap tables when the text sources change
+    void WatchSources(const std::string& sourceDir, const std::string& blobPath);
+    void PollHotReload();
+
+    int ShopItemCount() const { return shopItemCount; }
+    const ShopItemDef& ShopItem(int index) const { return shopItems[index]; }
+    const ShopItemDef* FindShopItem(const std::string& name) const;
+
+    int SkillCount() const { return skillCount; }
+    const SkillDef& Skill(int index) const { return skills[index]; }
+
+    // Falls back to the built-in row if a designer removed the enemy
+    const EnemyDef& FindEnemy(const char* name) const;
+
+    int EncounterCount() const { return encounterCount; }
+    const EncounterDef& Encounter(int index) const { return encounters[index]; }
+
+    // Bumped every time the tables are swapped
+    unsigned Generation() const { return generation; }
+
+private:
+    bool Adopt(std::vector<uint32_t>&& blob);
+    void UseDefaults();
+    bool SourcesChanged();
+
+    std::vector<uint32_t> storage;
+    const ShopItemDef* shopItems = nullptr;
+    int shopItemCount = 0;
+    const SkillDef* skills = nullptr;
+    int skillCount = 0;
+    const EnemyDef* enemies = nullptr;
+    int enemyCount = 0;
+    const EncounterDef* encounters = nullptr;
+    int encounterCount = 0;
+    unsigned generation = 0;
+
+    std::string sourceDir;
+    std::vector<std::filesystem::path> sourcePaths; // built once so polling does not allocate
+    std::string blobPath;
+    int inotifyFd = -1;
+    long long lastSourceStamp = 0;
+    double nextPollTime = 0.0;
+};
+
+ContentDatabase& Content();
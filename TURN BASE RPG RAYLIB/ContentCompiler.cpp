@@ -0,0 +1,208 @@
+#include "ContentCompiler.h"
+#include "ContentFormat.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+struct Row {
+    int line;
+    std::vector<std::string> fields;
+};
+
+std::string Trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\r");
+    if (start == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(start, end - start + 1);
+}
+
+// Reads "a | b | c" rows, skipping blank lines and # comments
+bool ReadRows(const std::string& path, size_t fieldCount, std::vector<Row>& rows, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = path + ": cannot open file";
+        return false;
+    }
+
+    std::string text;
+    int lineNo = 0;
+    while (std::getline(in, text)) {
+        lineNo++;
+        text = Trim(text);
+        if (text.empty() || text[0] == '#') continue;
+
+        Row row;
+        row.line = lineNo;
+        size_t pos = 0;
+        while (true) {
+            size_t bar = text.find('|', pos);
+            row.fields.push_back(Trim(text.substr(pos, bar == std::string::npos ? std::string::npos : bar - pos)));
+            if (bar == std::string::npos) break;
+            pos = bar + 1;
+        }
+
+        if (row.fields.size() != fieldCount) {
+            error = path + ":" + std::to_string(lineNo) + ": expected " + std::to_string(fieldCount) +
+                " fields, got " + std::to_string(row.fields.size());
+            return false;
+        }
+        rows.push_back(row);
+    }
+    return true;
+}
+
+bool CopyText(char* dst, size_t dstSize, const std::string& value, const std::string& path, int line, std::string& error) {
+    if (value.empty() || value.size() >= dstSize) {
+        error = path + ":" + std::to_string(line) + ": text must be 1-" + std::to_string(dstSize - 1) + " characters";
+        return false;
+    }
+    std::memset(dst, 0, dstSize);
+    std::memcpy(dst, value.c_str(), value.size());
+    return true;
+}
+
+bool ParseInt(int32_t& dst, const std::string& value, const std::string& path, int line, std::string& error) {
+    char* end = nullptr;
+    long parsed = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0') {
+        error = path + ":" + std::to_string(line) + ": '" + value + "' is not a number";
+        return false;
+    }
+    dst = static_cast<int32_t>(parsed);
+    return true;
+}
+
+template <typename T>
+void AppendTable(std::vector<uint32_t>& blob, const std::vector<T>& table) {
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "content records must be 4-byte sized");
+    size_t start = blob.size();
+    blob.resize(start + table.size() * sizeof(T) / sizeof(uint32_t));
+    if (!table.empty()) std::memcpy(&blob[start], table.data(), table.size() * sizeof(T));
+}
+
+} // namespace
+
+bool CompileContent(const std::string& sourceDir, std::vector<uint32_t>& blob, std::string& error) {
+    std::vector<ShopItemDef> shopItems;
+    std::vector<SkillDef> skills;
+    std::vector<EnemyDef> enemies;
+    std::vector<EncounterDef> encounters;
+
+    std::string shopPath = sourceDir + "/shop.txt";
+    std::vector<Row> rows;
+    if (!ReadRows(shopPath, 3, rows, error)) return false;
+    for (const Row& row : rows) {
+        ShopItemDef def;
+        if (!CopyText(def.name, sizeof(def.name), row.fields[0], shopPath, row.line, error) ||
+            !CopyText(def.description, sizeof(def.description), row.fields[1], shopPath, row.line, error) ||
+            !ParseInt(def.price, row.fields[2], shopPath, row.line, error)) {
+            return false;
+        }
+        shopItems.push_back(def);
+    }
+
+    std::string skillPath = sourceDir + "/skills.txt";
+    rows.clear();
+    if (!ReadRows(skillPath, 3, rows, error)) return false;
+    for (const Row& row : rows) {
+        SkillDef def;
+        if (!CopyText(def.name, sizeof(def.name), row.fields[0], skillPath, row.line, error) ||
+            !CopyText(def.description, sizeof(def.description), row.fields[1], skillPath, row.line, error) ||
+            !ParseInt(def.price, row.fields[2], skillPath, row.line, error)) {
+            return false;
+        }
+        skills.push_back(def);
+    }
+
+    std::string enemyPath = sourceDir + "/enemies.txt";
+    rows.clear();
+    if (!ReadRows(enemyPath, 11, rows, error)) return false;
+    for (const Row& row : rows) {
+        EnemyDef def;
+        int32_t* stats[10] = {
+            &def.baseHP, &def.hpPerLevel, &def.baseAttack, &def.attackPerLevel,
+            &def.baseDefense, &def.defensePerLevel, &def.baseExp, &def.expPerLevel,
+            &def.baseCoins, &def.coinsPerLevel
+        };
+        if (!CopyText(def.name, sizeof(def.name), row.fields[0], enemyPath, row.line, error)) return false;
+        for (int i = 0; i < 10; ++i) {
+            if (!ParseInt(*stats[i], row.fields[i + 1], enemyPath, row.line, error)) return false;
+        }
+        enemies.push_back(def);
+    }
+
+    std::string encounterPath = sourceDir + "/encounters.txt";
+    rows.clear();
+    if (!ReadRows(encounterPath, 7, rows, error)) return false;
+    for (const Row& row : rows) {
+        EncounterDef def;
+        if (!CopyText(def.area, sizeof(def.area), row.fields[0], encounterPath, row.line, error) ||
+            !ParseInt(def.minPlayerLevel, row.fields[1], encounterPath, row.line, error) ||
+            !ParseInt(def.maxPlayerLevel, row.fields[2], encounterPath, row.line, error) ||
+            !CopyText(def.enemy, sizeof(def.enemy), row.fields[3], encounterPath, row.line, error) ||
+            !ParseInt(def.levelOffset, row.fields[4], encounterPath, row.line, error) ||
+            !ParseInt(def.weight, row.fields[5], encounterPath, row.line, error)) {
+            return false;
+        }
+        std::string where = encounterPath + ":" + std::to_string(row.line) + ": ";
+        if (row.fields[6] != "yes" && row.fields[6] != "no") {
+            error = where + "repeat must be yes or no";
+            return false;
+        }
+        def.flags = row.fields[6] == "no" ? ENCOUNTER_NO_REPEAT : 0;
+        if (def.minPlayerLevel < 1 || def.maxPlayerLevel < def.minPlayerLevel) {
+            error = where + "bad level band " + row.fields[1] + "-" + row.fields[2];
+            return false;
+        }
+        if (def.weight <= 0) {
+            error = where + "weight must be positive";
+            return false;
+        }
+        bool known = false;
+        for (const EnemyDef& enemy : enemies) known = known || std::strcmp(enemy.name, def.enemy) == 0;
+        if (!known) {
+            error = where + "'" + row.fields[3] + "' is not in enemies.txt";
+            return false;
+        }
+        // A level may fall in one band per area, or the table to use is ambiguous
+        for (const EncounterDef& other : encounters) {
+            bool sameBand = other.minPlayerLevel == def.minPlayerLevel && other.maxPlayerLevel == def.maxPlayerLevel;
+            if (std::strcmp(other.area, def.area) == 0 && !sameBand &&
+                other.minPlayerLevel <= def.maxPlayerLevel && def.minPlayerLevel <= other.maxPlayerLevel) {
+                error = where + "band overlaps " + std::to_string(other.minPlayerLevel) + "-" +
+                    std::to_string(other.maxPlayerLevel) + " in " + other.area;
+                return false;
+            }
+        }
+        encounters.push_back(def);
+    }
+
+    ContentHeader header;
+    header.magic = CONTENT_MAGIC;
+    header.version = CONTENT_VERSION;
+    header.shopItemCount = static_cast<uint32_t>(shopItems.size());
+    header.skillCount = static_cast<uint32_t>(skills.size());
+    header.enemyCount = static_cast<uint32_t>(enemies.size());
+    header.encounterCount = static_cast<uint32_t>(encounters.size());
+    header.shopItemOffset = sizeof(ContentHeader);
+    header.skillOffset = header.shopItemOffset + header.shopItemCount * sizeof(ShopItemDef);
+    header.enemyOffset = header.skillOffset + header.skillCount * sizeof(SkillDef);
+    header.encounterOffset = header.enemyOffset + header.enemyCount * sizeof(EnemyDef);
+
+    blob.assign(sizeof(ContentHeader) / sizeof(uint32_t), 0);
+    std::memcpy(blob.data(), &header, sizeof(header));
+    AppendTable(blob, shopItems);
+    AppendTable(blob, skills);
+    AppendTable(blob, enemies);
+    AppendTable(blob, encounters);
+    return true;
+}
+
+bool WriteContentBlob(const std::string& path, const std::vector<uint32_t>& blob) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(blob.data()), blob.size() * sizeof(uint32_t));
+    return static_cast<bool>(out);
+}
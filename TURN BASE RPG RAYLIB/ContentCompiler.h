@@ -0,0 +1,12 @@
+// ContentCompiler.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Builds the content.bin image from Content/shop.txt, skills.txt, enemies.txt
+// and encounters.txt.
+// On bad input returns false and sets error to "file:line: message".
+bool CompileContent(const std::string& sourceDir, std::vector<uint32_t>& blob, std::string& error);
+
+bool WriteContentBlob(const std::string& path, const std::vector<uint32_t>& blob);
@@ -0,0 +1,65 @@
+// ContentFormat.h
+#pragma once
+#include <cstdint>
+
+// Layout of assets/content.bin, produced by ContentCompiler from the text
+// files in Content/. Every table is a flat array of fixed-size records so the
+// game can use the file as-is after reading it into memory.
+
+const uint32_t CONTENT_MAGIC = 0x43475052; // "RPGC"
+const uint32_t CONTENT_VERSION = 2;
+
+struct ContentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t shopItemCount;
+    uint32_t shopItemOffset;
+    uint32_t skillCount;
+    uint32_t skillOffset;
+    uint32_t enemyCount;
+    uint32_t enemyOffset;
+    uint32_t encounterCount;
+    uint32_t encounterOffset;
+};
+
+struct ShopItemDef {
+    char name[32];
+    char description[64];
+    int32_t price;
+};
+
+struct SkillDef {
+    char name[32];
+    char description[64];
+    int32_t price;
+};
+
+// Stat = base + level * perLevel
+struct EnemyDef {
+    char name[32];
+    int32_t baseHP;
+    int32_t hpPerLevel;
+    int32_t baseAttack;
+    int32_t attackPerLevel;
+    int32_t baseDefense;
+    int32_t defensePerLevel;
+    int32_t baseExp;
+    int32_t expPerLevel;
+    int32_t baseCoins;
+    int32_t coinsPerLevel;
+};
+
+// Row flag: the table never hands out this row's enemy twice in a row
+const int32_t ENCOUNTER_NO_REPEAT = 1;
+
+// Rows with the same area and player level band make up one encounter table.
+// A battle picks a row with probability weight / total weight of its table.
+struct EncounterDef {
+    char area[32];
+    char enemy[32];
+    int32_t minPlayerLevel;
+    int32_t maxPlayerLevel;
+    int32_t levelOffset;  // enemy level = player level + offset, at least 1
+    int32_t weight;
+    int32_t flags;
+};
@@ -0,0 +1,89 @@
+#include "Duel.h"
+#include <algorithm>
+
+namespace {
+
+int DuelDamage(const DuelFighter& actor, const DuelFighter& target, CombatAction action, CombatAction targetAction) {
+    switch (action) {
+    case CombatAction::Attack: {
+        int damage = actor.attack - target.defense;
+        if (targetAction == CombatAction::Block) damage /= 4;
+        return std::max(1, damage);
+    }
+    case CombatAction::Skill:
+        return std::max(1, actor.attack * 2 - target.defense);
+    default:
+        return 0;
+    }
+}
+
+// FNV-1a, a field at a time so padding never gets in
+struct Fnv {
+    uint32_t hash = 2166136261u;
+    void Add(uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 16777619u;
+        }
+    }
+};
+
+} // namespace
+
+DuelState StartDuel(const SimStats& first, const SimStats& second) {
+    DuelState state = {};
+    const SimStats* stats[2] = { &first, &second };
+    for (int seat = 0; seat < 2; ++seat) {
+        DuelFighter& fighter = state.fighters[seat];
+        fighter.hp = stats[seat]->maxHP;
+        fighter.maxHp = stats[seat]->maxHP;
+        fighter.attack = stats[seat]->attack;
+        fighter.defense = stats[seat]->defense;
+        fighter.lastAction = static_cast<uint8_t>(CombatAction::Block);
+    }
+    return state;
+}
+
+void StepDuel(DuelState& state, CombatAction first, CombatAction second) {
+    if (state.result != DuelResult::Ongoing) return;
+    CombatAction actions[2] = { first, second };
+    for (int seat = 0; seat < 2; ++seat) {
+        if (actions[seat] == CombatAction::Skill && state.fighters[seat].skillCooldown > 0) actions[seat] = CombatAction::Attack;
+    }
+
+    int damage[2];
+    for (int seat = 0; seat < 2; ++seat) {
+        damage[seat] = DuelDamage(state.fighters[seat], state.fighters[1 - seat], actions[seat], actions[1 - seat]);
+    }
+    for (int seat = 0; seat < 2; ++seat) {
+        DuelFighter& fighter = state.fighters[seat];
+        fighter.hp = std::max(0, fighter.hp - damage[1 - seat]);
+        fighter.lastAction = static_cast<uint8_t>(actions[seat]);
+        fighter.lastDamage = damage[seat];
+        if (fighter.skillCooldown > 0) fighter.skillCooldown--;
+        if (actions[seat] == CombatAction::Skill) fighter.skillCooldown = DUEL_SKILL_COOLDOWN;
+    }
+    state.turn++;
+
+    bool firstDown = state.fighters[0].hp == 0;
+    bool secondDown = state.fighters[1].hp == 0;
+    if (firstDown && secondDown) state.result = DuelResult::Draw;
+    else if (secondDown) state.result = DuelResult::FirstWon;
+    else if (firstDown) state.result = DuelResult::SecondWon;
+    else if (state.turn >= DUEL_MAX_TURNS) state.result = DuelResult::Draw;
+}
+
+uint32_t DuelChecksum(const DuelState& state) {
+    Fnv fnv;
+    for (const DuelFighter& fighter : state.fighters) {
+        fnv.Add(static_cast<uint32_t>(fighter.hp));
+        fnv.Add(static_cast<uint32_t>(fighter.maxHp));
+        fnv.Add(static_cast<uint32_t>(fighter.attack));
+        fnv.Add(static_cast<uint32_t>(fighter.defense));
+        fnv.Add(fighter.skillCooldown | (fighter.lastAction << 8));
+        fnv.Add(static_cast<uint32_t>(fighter.lastDamage));
+    }
+    fnv.Add(static_cast<uint32_t>(state.turn));
+    fnv.Add(static_cast<uint32_t>(state.result));
+    return fnv.hash;
+}
@@ -0,0 +1,48 @@
+// Duel.h
+#pragma once
+#include "Combatants.h"
+#include <cstdint>
+
+// PvP duels in the Colosseum: two players each pick an action every turn
+// without seeing the other's, and both land at once. The rules are the group
+// battle's (Combatants.h) reduced to one hero a side, with the hero skill
+// hitting its one target for double damage past blocks.
+//
+// The state is plain integers and StepDuel does integer math only, so two
+// machines that start from the same stats and feed in the same actions stay
+// bit for bit the same. Netplay.h relies on that: only the actions travel.
+
+enum class DuelResult : uint8_t {
+    Ongoing,
+    FirstWon,   // seat 0, the host
+    SecondWon,  // seat 1
+    Draw        // both fell on the same turn, or DUEL_MAX_TURNS ran out
+};
+
+const int DUEL_MAX_TURNS = 200;
+const int DUEL_SKILL_COOLDOWN = 3;
+
+struct DuelFighter {
+    int32_t hp;
+    int32_t maxHp;
+    int32_t attack;
+    int32_t defense;
+    uint8_t skillCooldown;
+    uint8_t lastAction;  // CombatAction of the turn just played
+    int32_t lastDamage;  // dealt in the turn just played
+};
+
+struct DuelState {
+    DuelFighter fighters[2];
+    int32_t turn;  // turns played
+    DuelResult result;
+};
+
+DuelState StartDuel(const SimStats& first, const SimStats& second);
+
+// One turn: blocks go up, then both actions hit against the stats the turn
+// started with. A skill still on cooldown is played as an attack.
+void StepDuel(DuelState& state, CombatAction first, CombatAction second);
+
+// Of every field, for comparing peers
+uint32_t DuelChecksum(const DuelState& state);
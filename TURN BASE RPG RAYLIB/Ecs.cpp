@@ -0,0 +1,158 @@
+#include "Ecs.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace EcsDetail {
+
+static std::vector<uint32_t>& Sizes() {
+    static std::vector<uint32_t> sizes;
+    return sizes;
+}
+
+int RegisterComponent(uint32_t size) {
+    std::vector<uint32_t>& sizes = Sizes();
+    // Ids are bit positions in a ComponentMask; past the last bit every mask
+    // test would be wrong, so stop in release builds too
+    if (sizes.size() >= MAX_COMPONENT_TYPES) {
+        std::fprintf(stderr, "[Ecs] More than %d component types, raise MAX_COMPONENT_TYPES\n", MAX_COMPONENT_TYPES);
+        std::abort();
+    }
+    sizes.push_back(size);
+    return static_cast<int>(sizes.size()) - 1;
+}
+
+uint32_t ComponentSize(int id) {
+    return Sizes()[id];
+}
+
+} // namespace EcsDetail
+
+World::World() {
+    FindOrCreateArchetype(0);
+}
+
+Entity World::Create() {
+    Entity e;
+    if (!freeIndices.empty()) {
+        e.index = freeIndices.back();
+        freeIndices.pop_back();
+    }
+    else {
+        e.index = static_cast<uint32_t>(locations.size());
+        locations.push_back({ DEAD, 0, 0 });
+    }
+    Location& location = locations[e.index];
+    e.generation = location.generation;
+    location.archetype = 0;
+    location.row = static_cast<uint32_t>(archetypes[0].entities.size());
+    archetypes[0].entities.push_back(e);
+    return e;
+}
+
+void World::Destroy(Entity e) {
+    if (!IsAlive(e)) return;
+    Location& location = locations[e.index];
+    RemoveRow(archetypes[location.archetype], location.row);
+    location.archetype = DEAD;
+    location.generation++;
+    freeIndices.push_back(e.index);
+}
+
+bool World::IsAlive(Entity e) const {
+    return e.index < locations.size() && locations[e.index].archetype != DEAD
+        && locations[e.index].generation == e.generation;
+}
+
+void World::Clear() {
+    for (Archetype& archetype : archetypes) {
+        archetype.entities.clear();
+        for (Column& column : archetype.columns) column.data.clear();
+    }
+    freeIndices.clear();
+    for (uint32_t i = static_cast<uint32_t>(locations.size()); i-- > 0;) {
+        if (locations[i].archetype != DEAD) {
+            locations[i].archetype = DEAD;
+            locations[i].generation++;
+        }
+        freeIndices.push_back(i);
+    }
+    queued.clear();
+}
+
+void World::ApplyQueued() {
+    for (const QueuedChange& change : queued) {
+        if (change.component < 0) Destroy(change.entity);
+        else RemoveComponent(change.entity, change.component);
+    }
+    queued.clear();
+}
+
+int World::FindOrCreateArchetype(ComponentMask mask) {
+    // A battle has a handful of archetypes, so a scan beats a map
+    for (size_t i = 0; i < archetypes.size(); ++i) {
+        if (archetypes[i].mask == mask) return static_cast<int>(i);
+    }
+
+    Archetype archetype;
+    archetype.mask = mask;
+    for (int id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+        archetype.columnOf[id] = -1;
+        archetype.addEdge[id] = -1;
+        archetype.removeEdge[id] = -1;
+        if ((mask >> id) & 1) {
+            archetype.columnOf[id] = static_cast<int8_t>(archetype.columns.size());
+            archetype.columns.push_back({ id, EcsDetail::ComponentSize(id), {} });
+        }
+    }
+    archetypes.push_back(std::move(archetype));
+    return static_cast<int>(archetypes.size()) - 1;
+}
+
+int World::Neighbour(int from, int id, bool adding) {
+    int32_t& edge = adding ? archetypes[from].addEdge[id] : archetypes[from].removeEdge[id];
+    if (edge >= 0) return edge;
+    int to = FindOrCreateArchetype(archetypes[from].mask ^ (ComponentMask(1) << id));
+    // FindOrCreateArchetype may have grown the array; look the edge up again
+    (adding ? archetypes[from].addEdge[id] : archetypes[from].removeEdge[id]) = to;
+    return to;
+}
+
+// Copies the components both archetypes have; new ones are left zeroed for the caller
+void World::MoveEntity(Entity e, int to) {
+    Location& location = locations[e.index];
+    Archetype& source = archetypes[location.archetype];
+    Archetype& target = archetypes[to];
+
+    uint32_t row = static_cast<uint32_t>(target.entities.size());
+    target.entities.push_back(e);
+    for (Column& column : target.columns) {
+        column.data.resize(column.data.size() + column.size);
+        if (source.columnOf[column.id] >= 0) {
+            std::memcpy(target.Row(column.id, row), source.Row(column.id, location.row), column.size);
+        }
+    }
+    RemoveRow(source, location.row);
+    location.archetype = static_cast<uint32_t>(to);
+    location.row = row;
+}
+
+// Fills the hole with the last row so the arrays stay dense
+void World::RemoveRow(Archetype& archetype, uint32_t row) {
+    uint32_t last = static_cast<uint32_t>(archetype.entities.size()) - 1;
+    if (row != last) {
+        for (Column& column : archetype.columns) {
+            std::memcpy(archetype.Row(column.id, row), archetype.Row(column.id, last), column.size);
+        }
+        archetype.entities[row] = archetype.entities[last];
+        locations[archetype.entities[row].index].row = row;
+    }
+    archetype.entities.pop_back();
+    for (Column& column : archetype.columns) column.data.resize(column.data.size() - column.size);
+}
+
+void World::RemoveComponent(Entity e, int id) {
+    if (!IsAlive(e)) return;
+    uint32_t at = locations[e.index].archetype;
+    if (!((archetypes[at].mask >> id) & 1)) return;
+    MoveEntity(e, Neighbour(at, id, false));
+}
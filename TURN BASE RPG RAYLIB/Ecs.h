@@ -0,0 +1,176 @@
+// Ecs.h
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A small archetype entity-component system. Entities with the same set of
+// components share an archetype, which keeps one dense array per component;
+// Each<...>() walks only the archetypes holding every requested component.
+// Adding or removing a component moves the entity to the neighbouring
+// archetype, found through a per-archetype edge cache after the first time.
+//
+// Components are plain data (trivially copyable), so moves are memcpy and
+// nothing needs destroying. Don't add, remove or destroy inside Each; queue
+// it with QueueRemove/QueueDestroy and call ApplyQueued afterwards.
+
+struct Entity {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+const Entity NO_ENTITY = {};
+
+using ComponentMask = uint64_t;
+const int MAX_COMPONENT_TYPES = 64;
+
+namespace EcsDetail {
+    int RegisterComponent(uint32_t size);
+    uint32_t ComponentSize(int id);
+}
+
+// Ids are handed out on first use, so they differ between runs; never save them
+template <typename T>
+int ComponentId() {
+    static_assert(std::is_trivially_copyable<T>::value, "components must be plain data");
+    static const int id = EcsDetail::RegisterComponent(static_cast<uint32_t>(sizeof(T)));
+    return id;
+}
+
+class World {
+public:
+    World();
+
+    Entity Create();
+    void Destroy(Entity e);
+    bool IsAlive(Entity e) const;
+    // Destroys every entity; archetypes stay around for reuse
+    void Clear();
+    int EntityCount() const { return static_cast<int>(locations.size() - freeIndices.size()); }
+    int ArchetypeCount() const { return static_cast<int>(archetypes.size()); }
+
+    // Adds the component, or overwrites it if the entity has one already;
+    // nullptr (and nothing written) if the entity is gone
+    template <typename T>
+    T* Add(Entity e, const T& value = T());
+    template <typename T>
+    void Remove(Entity e) { RemoveComponent(e, ComponentId<T>()); }
+    template <typename T>
+    bool Has(Entity e) const { return (MaskOf(e) >> ComponentId<T>()) & 1; }
+    // nullptr if the entity doesn't have one
+    template <typename T>
+    T* Get(Entity e);
+    template <typename T>
+    const T* Get(Entity e) const { return const_cast<World*>(this)->Get<T>(e); }
+
+    // fn(Entity, Ts&...) for every entity that has all of Ts
+    template <typename... Ts, typename Fn>
+    void Each(Fn&& fn);
+
+    template <typename T>
+    void QueueRemove(Entity e) { queued.push_back({ e, ComponentId<T>() }); }
+    void QueueDestroy(Entity e) { queued.push_back({ e, -1 }); }
+    void ApplyQueued();
+
+private:
+    struct Column {
+        int id;
+        uint32_t size;
+        std::vector<unsigned char> data;
+    };
+
+    struct Archetype {
+        ComponentMask mask = 0;
+        std::vector<Entity> entities;
+        std::vector<Column> columns;  // in component id order
+        int8_t columnOf[MAX_COMPONENT_TYPES];
+        int32_t addEdge[MAX_COMPONENT_TYPES];     // archetype with one more component, -1 until known
+        int32_t removeEdge[MAX_COMPONENT_TYPES];
+
+        void* Row(int id, uint32_t row) {
+            Column& column = columns[columnOf[id]];
+            return column.data.data() + static_cast<size_t>(row) * column.size;
+        }
+    };
+
+    struct Location {
+        uint32_t archetype;  // DEAD when the index is free
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    struct QueuedChange {
+        Entity entity;
+        int component;  // -1 destroys the entity
+    };
+
+    static const uint32_t DEAD = ~0u;
+
+    ComponentMask MaskOf(Entity e) const { return IsAlive(e) ? archetypes[locations[e.index].archetype].mask : 0; }
+    int FindOrCreateArchetype(ComponentMask mask);
+    int Neighbour(int from, int id, bool adding);
+    void MoveEntity(Entity e, int to);
+    void RemoveRow(Archetype& archetype, uint32_t row);
+    void RemoveComponent(Entity e, int id);
+
+    template <typename... Ts, typename Fn, size_t... I>
+    static void EachIn(Archetype& archetype, const int* ids, Fn& fn, std::index_sequence<I...>);
+
+    std::vector<Archetype> archetypes;  // [0] holds entities without components
+    std::vector<Location> locations;
+    std::vector<uint32_t> freeIndices;
+    std::vector<QueuedChange> queued;
+};
+
+template <typename T>
+T* World::Add(Entity e, const T& value) {
+    int id = ComponentId<T>();
+    // A stale handle's slot may belong to another entity by now
+    if (!IsAlive(e)) return nullptr;
+    uint32_t at = locations[e.index].archetype;
+    if (!((archetypes[at].mask >> id) & 1)) {
+        MoveEntity(e, Neighbour(at, id, true));
+    }
+    const Location& location = locations[e.index];
+    return new (archetypes[location.archetype].Row(id, location.row)) T(value);
+}
+
+template <typename T>
+T* World::Get(Entity e) {
+    int id = ComponentId<T>();
+    if (!IsAlive(e)) return nullptr;
+    const Location& location = locations[e.index];
+    Archetype& archetype = archetypes[location.archetype];
+    if (!((archetype.mask >> id) & 1)) return nullptr;
+    return static_cast<T*>(archetype.Row(id, location.row));
+}
+
+template <typename... Ts, typename Fn, size_t... I>
+void World::EachIn(Archetype& archetype, const int* ids, Fn& fn, std::index_sequence<I...>) {
+    std::tuple<Ts*...> columns(static_cast<Ts*>(archetype.Row(ids[I], 0))...);
+    const Entity* entities = archetype.entities.data();
+    size_t count = archetype.entities.size();
+    for (size_t row = 0; row < count; ++row) {
+        fn(entities[row], std::get<I>(columns)[row]...);
+    }
+}
+
+template <typename... Ts, typename Fn>
+void World::Each(Fn&& fn) {
+    static_assert(sizeof...(Ts) > 0, "Each needs at least one component");
+    const int ids[] = { ComponentId<Ts>()... };
+    ComponentMask required = 0;
+    for (int id : ids) required |= ComponentMask(1) << id;
+
+    for (Archetype& archetype : archetypes) {
+        if ((archetype.mask & required) != required || archetype.entities.empty()) continue;
+        EachIn<Ts...>(archetype, ids, fn, std::index_sequence_for<Ts...>());
+    }
+}
@@ -0,0 +1,82 @@
+#include "Encounters.h"
+#include "Content.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+EncounterTables& Encounters() {
+    static EncounterTables tables;
+    return tables;
+}
+
+// Vose's construction: columns under the average are topped up from the
+// columns above it, so each column holds at most two outcomes
+void AliasTable::Build(const std::vector<int32_t>& weights) {
+    int n = static_cast<int>(weights.size());
+    threshold.assign(n, COIN_SIDES);
+    alias.resize(n);
+    for (int i = 0; i < n; ++i) alias[i] = i;
+
+    double total = 0.0;
+    for (int32_t w : weights) total += w;
+    if (n == 0 || total <= 0.0) return;
+
+    std::vector<double> scaled(n);
+    std::vector<int> small, large;
+    for (int i = 0; i < n; ++i) {
+        scaled[i] = weights[i] * n / total;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() && !large.empty()) {
+        int s = small.back();
+        small.pop_back();
+        int l = large.back();
+        threshold[s] = static_cast<int32_t>(std::lround(scaled[s] * COIN_SIDES));
+        alias[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Whatever is left is 1.0 give or take rounding and keeps its own column
+}
+
+void EncounterTables::Rebuild() {
+    PROFILE_ZONE("RebuildEncounterTables");
+    MEMORY_SCOPE(Battle);
+    const ContentDatabase& content = Content();
+    tables.clear();
+    for (int i = 0; i < content.EncounterCount(); ++i) {
+        const EncounterDef& row = content.Encounter(i);
+        auto it = std::find_if(tables.begin(), tables.end(), [&](const Table& t) {
+            return t.minLevel == row.minPlayerLevel && t.maxLevel == row.maxPlayerLevel && std::strcmp(t.area, row.area) == 0;
+        });
+        if (it == tables.end()) {
+            tables.push_back({ row.area, row.minPlayerLevel, row.maxPlayerLevel, {}, {} });
+            it = tables.end() - 1;
+        }
+        it->rows.push_back(&row);
+    }
+
+    std::vector<int32_t> weights;
+    for (Table& table : tables) {
+        weights.clear();
+        for (const EncounterDef* row : table.rows) weights.push_back(row->weight);
+        table.alias.Build(weights);
+    }
+    builtGeneration = content.Generation();
+}
+
+const EncounterTables::Table* EncounterTables::Find(const char* area, int playerLevel) {
+    if (builtGeneration != Content().Generation()) Rebuild();
+    // One table per area and band, so a handful at most
+    for (const Table& table : tables) {
+        if (playerLevel >= table.minLevel && playerLevel <= table.maxLevel && std::strcmp(table.area, area) == 0) {
+            return &table;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,69 @@
+// Encounters.h
+#pragma once
+#include "ContentFormat.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Walker's alias method: picks column i with probability weight[i] / total from
+// one uniform column and one coin flip, however many columns there are.
+class AliasTable {
+public:
+    // RAND_MAX is at least 32767, so one rand() call covers the coin
+    static constexpr int COIN_SIDES = 32768;
+
+    void Build(const std::vector<int32_t>& weights);
+
+    int Size() const { return static_cast<int>(threshold.size()); }
+
+    // column in [0, Size()), coin in [0, COIN_SIDES)
+    int Pick(int column, int coin) const { return coin < threshold[column] ? column : alias[column]; }
+
+private:
+    std::vector<int32_t> threshold; // coins below this keep the column
+    std::vector<int32_t> alias;
+};
+
+// Content's encounter rows grouped into one alias table per area and level band.
+// The tables are rebuilt only when Content swaps in new rows.
+class EncounterTables {
+public:
+    // Row for a battle in area, or nullptr if no band there covers playerLevel.
+    // random(min, max) is inclusive, like Game::GetRandom. A no-repeat row whose
+    // enemy is lastEnemy is drawn again, a few times at most.
+    template <typename Random>
+    const EncounterDef* Roll(const char* area, int playerLevel, const std::string& lastEnemy, Random&& random);
+
+private:
+    static const int MAX_REDRAWS = 8;
+
+    struct Table {
+        const char* area;
+        int minLevel;
+        int maxLevel;
+        std::vector<const EncounterDef*> rows;
+        AliasTable alias;
+    };
+
+    const Table* Find(const char* area, int playerLevel);
+    void Rebuild();
+
+    std::vector<Table> tables;
+    unsigned builtGeneration = ~0u;
+};
+
+EncounterTables& Encounters();
+
+template <typename Random>
+const EncounterDef* EncounterTables::Roll(const char* area, int playerLevel, const std::string& lastEnemy, Random&& random) {
+    const Table* table = Find(area, playerLevel);
+    if (!table) return nullptr;
+
+    const EncounterDef* row = nullptr;
+    for (int draw = 0; draw < MAX_REDRAWS; ++draw) {
+        int column = random(0, table->alias.Size() - 1);
+        row = table->rows[table->alias.Pick(column, random(0, AliasTable::COIN_SIDES - 1))];
+        if (!(row->flags & ENCOUNTER_NO_REPEAT) || lastEnemy != row->enemy) break;
+    }
+    return row;
+}
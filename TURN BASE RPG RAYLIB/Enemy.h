@@ -10,4 +10,6 @@ public:
     virtual int GetMaxHP() const = 0;
     virtual int GetAttack() const = 0;
     virtual int GetDefense() const = 0;
+    virtual int GetExpReward() const = 0;
+    virtual int GetCoinReward() const = 0;
 };
@@ -0,0 +1,255 @@
+#include "FlightRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+// Kept apart from the raylib code: windows.h clashes with raylib.h names
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace {
+
+const char* const CRASH_PATH = "flight_crash.bin";
+const char* const HITCH_PATH = "flight_hitch.bin";
+// One dump per burst of slow frames, the first shows how it started
+const uint64_t HITCH_COOLDOWN_NS = 10000000000ull;
+// Records a dump copies onto the stack at a time
+const uint32_t DUMP_CHUNK = 64;
+static_assert(FLIGHT_CAPACITY % DUMP_CHUNK == 0, "dumps copy whole chunks");
+
+FlightRecord ring[FLIGHT_CAPACITY];
+std::atomic<uint32_t> recorded{ 0 };
+std::atomic<uint32_t> threadsSeen{ 0 };
+thread_local uint8_t threadNumber = 0;
+
+int64_t startTime = 0;
+uint64_t startTicks = 0;
+uint64_t startNs = 0;
+
+// Main thread only
+double hitchThresholdMs = 0.0;
+uint64_t lastFrameNs = 0;
+uint64_t lastHitchNs = 0;
+
+uint64_t SteadyNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// The time stamp counter where there is one: a handful of cycles against a
+// clock call's tens of nanoseconds. Dumps carry what it takes to convert.
+uint64_t Ticks() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return SteadyNs();
+#endif
+}
+
+// The reading half of Record: the sequence, the fields, then the sequence
+// again. A slot rewritten while it was copied comes out half written.
+void ReadSlot(const FlightRecord& slot, FlightRecord& copy) {
+    uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+    copy.ticks = slot.ticks;
+    copy.kind = slot.kind;
+    copy.thread = slot.thread;
+    copy.reserved = slot.reserved;
+    copy.a = slot.a;
+    copy.b = slot.b;
+    std::memcpy(copy.text, slot.text, sizeof(copy.text));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) sequence = 0;
+    copy.sequence.store(sequence, std::memory_order_relaxed);
+}
+
+#if defined(_WIN32)
+using DumpFile = HANDLE;
+const DumpFile NO_DUMP_FILE = INVALID_HANDLE_VALUE;
+
+DumpFile OpenDump(const char* path) {
+    return CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+}
+
+bool WriteDump(DumpFile file, const void* data, size_t size) {
+    DWORD written = 0;
+    return WriteFile(file, data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+}
+
+void CloseDump(DumpFile file) {
+    CloseHandle(file);
+}
+#else
+using DumpFile = int;
+const DumpFile NO_DUMP_FILE = -1;
+
+DumpFile OpenDump(const char* path) {
+    return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+bool WriteDump(DumpFile file, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = write(file, bytes + done, size - done);
+        if (n <= 0) return false;
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void CloseDump(DumpFile file) {
+    close(file);
+}
+#endif
+
+#if defined(_WIN32)
+LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS* info) {
+    int32_t code = static_cast<int32_t>(info->ExceptionRecord->ExceptionCode);
+    FlightRecorder::Record(FlightEvent::Crash, code);
+    FlightRecorder::Dump(CRASH_PATH, code);
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+
+// abort() never reaches the exception filter; the handler was reset before this ran
+void OnAbort(int signal) {
+    FlightRecorder::Record(FlightEvent::Crash, signal);
+    FlightRecorder::Dump(CRASH_PATH, signal);
+}
+
+void InstallCrashHandlers() {
+    SetUnhandledExceptionFilter(OnUnhandledException);
+    std::signal(SIGABRT, OnAbort);
+}
+#else
+void OnCrashSignal(int signal) {
+    FlightRecorder::Record(FlightEvent::Crash, signal);
+    FlightRecorder::Dump(CRASH_PATH, signal);
+    // SA_RESETHAND put the default action back: die the way we would have
+    raise(signal);
+}
+
+void InstallCrashHandlers() {
+    struct sigaction action = {};
+    action.sa_handler = OnCrashSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND | SA_NODEFER;
+    for (int signal : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT }) sigaction(signal, &action, nullptr);
+}
+#endif
+
+} // namespace
+
+const char* FlightEventName(FlightEvent kind) {
+    switch (kind) {
+    case FlightEvent::Start: return "Start";
+    case FlightEvent::ScreenEnter: return "ScreenEnter";
+    case FlightEvent::ScreenLeave: return "ScreenLeave";
+    case FlightEvent::Action: return "Action";
+    case FlightEvent::Item: return "Item";
+    case FlightEvent::Frame: return "Frame";
+    case FlightEvent::Hitch: return "Hitch";
+    case FlightEvent::Save: return "Save";
+    case FlightEvent::Load: return "Load";
+    case FlightEvent::AssetLoad: return "AssetLoad";
+    case FlightEvent::Crash: return "Crash";
+    default: return "?";
+    }
+}
+
+void FlightRecorder::Install(double thresholdMs) {
+    startTime = static_cast<int64_t>(std::time(nullptr));
+    startTicks = Ticks();
+    startNs = SteadyNs();
+    hitchThresholdMs = thresholdMs;
+    InstallCrashHandlers();
+    Record(FlightEvent::Start, static_cast<int32_t>(thresholdMs));
+}
+
+void FlightRecorder::Record(FlightEvent kind, int32_t a, int32_t b, const char* text) {
+    uint32_t sequence = recorded.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (threadNumber == 0) threadNumber = static_cast<uint8_t>(threadsSeen.fetch_add(1, std::memory_order_relaxed) + 1);
+
+    // A dump taken while this is half written sees sequence 0 and skips the
+    // slot; the fence keeps the new fields from showing before that 0 does
+    FlightRecord& record = ring[(sequence - 1) & (FLIGHT_CAPACITY - 1)];
+    record.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.ticks = Ticks();
+    record.kind = static_cast<uint8_t>(kind);
+    record.thread = threadNumber;
+    record.a = a;
+    record.b = b;
+    size_t length = text ? std::strlen(text) : 0;
+    size_t skip = length >= FLIGHT_TEXT ? length - (FLIGHT_TEXT - 1) : 0;
+    if (length > 0) std::memcpy(record.text, text + skip, length - skip);
+    record.text[length - skip] = '\0';
+    record.sequence.store(sequence, std::memory_order_release);
+}
+
+void FlightRecorder::OnFrameEnd() {
+    uint64_t now = SteadyNs();
+    if (lastFrameNs == 0) {
+        lastFrameNs = now;
+        return;
+    }
+    uint64_t frameNs = now - lastFrameNs;
+    lastFrameNs = now;
+    int32_t frameUs = static_cast<int32_t>(std::min<uint64_t>(frameNs / 1000, INT32_MAX));
+    Record(FlightEvent::Frame, frameUs);
+
+    if (hitchThresholdMs <= 0.0 || frameNs < hitchThresholdMs * 1e6) return;
+    if (lastHitchNs != 0 && now - lastHitchNs < HITCH_COOLDOWN_NS) return;
+    lastHitchNs = now;
+    Record(FlightEvent::Hitch, frameUs, static_cast<int32_t>(hitchThresholdMs));
+    if (Dump(HITCH_PATH, 0)) {
+        std::cout << "[Flight] Frame took " << frameUs / 1000.0 << " ms, wrote " << HITCH_PATH << std::endl;
+    }
+}
+
+FlightFileScope::FlightFileScope(FlightEvent kind, const char* path) : kind(kind), path(path), start(SteadyNs()) {}
+
+FlightFileScope::~FlightFileScope() {
+    uint64_t us = (SteadyNs() - start) / 1000;
+    FlightRecorder::Record(kind, static_cast<int32_t>(std::min<uint64_t>(us, INT32_MAX)), ok ? 1 : 0, path);
+}
+
+bool FlightRecorder::Dump(const char* path, int32_t crash) {
+    FlightDumpHeader header = {};
+    header.magic = FLIGHT_MAGIC;
+    header.version = FLIGHT_VERSION;
+    header.recordSize = sizeof(FlightRecord);
+    header.capacity = FLIGHT_CAPACITY;
+    header.next = recorded.load(std::memory_order_acquire);
+    header.crash = crash;
+    header.startTime = startTime;
+    header.startTicks = startTicks;
+    header.startNs = startNs;
+    header.dumpTicks = Ticks();
+    header.dumpNs = SteadyNs();
+
+    DumpFile file = OpenDump(path);
+    if (file == NO_DUMP_FILE) return false;
+    bool ok = WriteDump(file, &header, sizeof(header));
+    // Other threads may still be recording: each slot is copied out with
+    // ReadSlot rather than written from the ring as it stands
+    FlightRecord chunk[DUMP_CHUNK];
+    for (uint32_t first = 0; first < FLIGHT_CAPACITY && ok; first += DUMP_CHUNK) {
+        for (uint32_t i = 0; i < DUMP_CHUNK; ++i) ReadSlot(ring[first + i], chunk[i]);
+        ok = WriteDump(file, chunk, sizeof(chunk));
+    }
+    CloseDump(file);
+    return ok;
+}
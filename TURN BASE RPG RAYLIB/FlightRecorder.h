@@ -0,0 +1,108 @@
+// FlightRecorder.h
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Always-on record of the last FLIGHT_CAPACITY things the game did: screens
+// entered and left, battle actions, items, frame times, saves and loads, and
+// asset loads. Unlike the profiler it is in every build, so a kiosk that
+// crashes or hitches leaves a record behind.
+//
+// Recording claims a slot with one atomic add and fills it in; no locks, no
+// allocation. A slot's sequence is 0 while it is filled in and is stored with
+// release ordering once it is; dumps read it with acquire ordering before and
+// after copying the slot, and write 0 if it changed. The ring is written to
+// disk:
+//   flight_crash.bin  from the crash handler (a fatal signal, or an unhandled
+//                     exception on Windows), then the game dies as it would have
+//   flight_hitch.bin  after a frame slower than the hitch threshold
+// FlightDecoder prints either as a timeline.
+//
+// Dump layout: FlightDumpHeader, then all FLIGHT_CAPACITY records in ring
+// order. A slot holds one of the last FLIGHT_CAPACITY records when its
+// sequence is nonzero and next - sequence < FLIGHT_CAPACITY (mod 2^32).
+
+const uint32_t FLIGHT_MAGIC = 0x46475052;  // "RPGF"
+const uint32_t FLIGHT_VERSION = 1;
+const uint32_t FLIGHT_CAPACITY = 8192;     // must be a power of two
+const int FLIGHT_TEXT = 24;                // including the terminator; longer text keeps its end
+
+enum class FlightEvent : uint8_t {
+    Start,        // a: the hitch threshold in ms
+    ScreenEnter,  // text: ScreenScope name
+    ScreenLeave,  // text: ScreenScope name
+    Action,       // a: action index, text: its name
+    Item,         // text: item used
+    Frame,        // a: frame time in microseconds
+    Hitch,        // a: frame time in microseconds, b: the threshold in ms
+    Save,         // a: microseconds taken, b: 1 if it worked, text: file
+    Load,         // a: microseconds taken, b: 1 if it worked, text: file
+    AssetLoad,    // text: file, logged before loading so a crash in it names it
+    Crash,        // a: signal number or exception code
+    Count
+};
+
+const char* FlightEventName(FlightEvent kind);
+
+struct FlightRecord {
+    uint64_t ticks;                    // FlightDumpHeader converts these to time
+    std::atomic<uint32_t> sequence;    // 1-based; 0 while the slot is being written
+    uint8_t kind;                      // FlightEvent
+    uint8_t thread;                    // 1 for the first thread to record, usually main
+    uint16_t reserved;
+    int32_t a;
+    int32_t b;
+    char text[FLIGHT_TEXT];
+};
+static_assert(sizeof(FlightRecord) == 48, "FlightRecord is written to disk as is");
+
+struct FlightDumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t capacity;
+    uint32_t next;       // records so far (mod 2^32), also the newest one's sequence
+    int32_t crash;       // signal or exception code, 0 for a hitch dump
+    int64_t startTime;   // wall clock at Install, seconds since the epoch
+    // Two (ticks, steady nanoseconds) pairs, at Install and at the dump
+    uint64_t startTicks;
+    uint64_t startNs;
+    uint64_t dumpTicks;
+    uint64_t dumpNs;
+};
+
+namespace FlightRecorder {
+    // Starts the clock and installs the crash handlers
+    void Install(double hitchThresholdMs);
+
+    // text is copied, it may be a temporary
+    void Record(FlightEvent kind, int32_t a = 0, int32_t b = 0, const char* text = nullptr);
+
+    // Called once per frame by EndFrame: logs the frame time, dumps on a hitch
+    void OnFrameEnd();
+
+    // Also safe inside a signal handler: no allocation, no locks, no stdio
+    bool Dump(const char* path, int32_t crash);
+}
+
+// Records a Save or Load of path when it goes out of scope, with the time
+// taken; set ok once the file is written or read
+//
+//   FlightFileScope flight(FlightEvent::Save, SAVE_PATH);
+//   ...
+//   return flight.ok = CommitTempFile(SAVE_PATH);
+class FlightFileScope {
+public:
+    FlightFileScope(FlightEvent kind, const char* path);
+    ~FlightFileScope();
+
+    FlightFileScope(const FlightFileScope&) = delete;
+    FlightFileScope& operator=(const FlightFileScope&) = delete;
+
+    bool ok = false;
+
+private:
+    FlightEvent kind;
+    const char* path;
+    uint64_t start;
+};
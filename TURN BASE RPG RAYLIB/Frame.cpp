@@ -0,0 +1,50 @@
+#include "Frame.h"
+#include "raylib.h"
+#include "Content.h"
+#include "FrameArena.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include "PerfOverlay.h"
+#include "RenderQueue.h"
+#include "Input.h"
+#include "ScreenTimings.h"
+#include "FlightRecorder.h"
+
+void BeginFrame() {
+    PerfOverlay::OnBeginFrame();
+    Input::OnDrawBegin();
+    Gfx().BeginFrame();
+}
+
+void EndFrame() {
+    // Sends the screen's draws to raylib before the overlay samples its batch
+    GfxQueue().Flush();
+    // Drawn last so it sits on top of whatever the screen drew
+    PerfOverlay::OnEndFrame();
+    {
+        PROFILE_ZONE("EndDrawing");
+        Gfx().EndFrame();
+    }
+    Input::OnFrameSwapped();
+    // raylib polled events inside EndDrawing; everything after this sees the new frame's input
+    Input::NewFrame();
+    ScreenTimings::OnFrameEnd(GfxQueue().LastFrame().submittedBatches, GfxQueue().LastFrame().batches);
+    PerfOverlay::OnFrameSwapped();
+    // Text handed to DrawText has been consumed by now
+    FrameArena::Reset();
+    PROFILE_FRAME_MARK();
+    FlightRecorder::OnFrameEnd();
+    MemoryTracker::EndFrame();
+
+    if (Input::IsKeyPressed(KEY_F11)) PerfOverlay::Toggle();
+    // F9 prints the busiest allocation call sites to the console
+    if (Input::IsKeyPressed(KEY_F9)) MemoryTracker::DumpTopCallSites(10);
+
+#ifdef RPG_PROFILER
+    // F10 records the next two seconds into trace_capture_N.json
+    if (Input::IsKeyPressed(KEY_F10)) Profiler::RequestCapture(120);
+#endif
+
+    // Between frames nothing holds on to content rows, so tables can be swapped here
+    Content().PollHotReload();
+}
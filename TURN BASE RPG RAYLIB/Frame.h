@@ -0,0 +1,8 @@
+// Frame.h
+#pragma once
+
+// Every screen loop brackets its drawing with these instead of calling
+// BeginDrawing/EndDrawing directly, so per-frame services also run inside
+// the nested Show* loops.
+void BeginFrame();
+void EndFrame();
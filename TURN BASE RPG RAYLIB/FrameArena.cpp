@@ -0,0 +1,47 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+const size_t ARENA_SIZE = 64 * 1024;
+
+alignas(std::max_align_t) unsigned char arena[ARENA_SIZE];
+size_t used = 0;
+size_t highWater = 0;
+
+} // namespace
+
+void* FrameArena::Allocate(size_t size, size_t align) {
+    size_t start = (used + align - 1) & ~(align - 1);
+    if (start + size > ARENA_SIZE) return nullptr;
+    used = start + size;
+    highWater = std::max(highWater, used);
+    return arena + start;
+}
+
+char* FrameArena::BeginText(size_t& capacity) {
+    capacity = ARENA_SIZE - used;
+    return reinterpret_cast<char*>(arena + used);
+}
+
+void FrameArena::CommitText(size_t length) {
+    used = std::min(used + length, ARENA_SIZE);
+    highWater = std::max(highWater, used);
+}
+
+void FrameArena::Reset() {
+    used = 0;
+}
+
+size_t FrameArena::BytesUsed() {
+    return used;
+}
+
+size_t FrameArena::HighWater() {
+    return highWater;
+}
+
+size_t FrameArena::Capacity() {
+    return ARENA_SIZE;
+}
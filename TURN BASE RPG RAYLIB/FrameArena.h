@@ -0,0 +1,66 @@
+// FrameArena.h
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+// Linear scratch memory for the main thread that lives for one frame.
+// EndFrame resets it, so anything taken from it is only valid until then.
+namespace FrameArena {
+    // nullptr when the frame has used up the arena
+    void* Allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    // Text is written straight into the free space; Commit claims what was used
+    char* BeginText(size_t& capacity);
+    void CommitText(size_t length);
+
+    void Reset();
+
+    size_t BytesUsed();
+    size_t HighWater(); // most bytes any frame has used
+    size_t Capacity();
+}
+
+// Appends pieces without touching the heap; integers go through std::to_chars.
+// Text that does not fit is cut short.
+class FrameTextWriter {
+public:
+    FrameTextWriter() : begin(FrameArena::BeginText(capacity)) {}
+
+    void Append(const char* text) {
+        while (*text && length + 1 < capacity) begin[length++] = *text++;
+    }
+    void Append(const std::string& text) { Append(text.c_str()); }
+    void Append(char c) {
+        if (length + 1 < capacity) begin[length++] = c;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value>>
+    void Append(T value) {
+        if (length + 1 >= capacity) return;
+        auto result = std::to_chars(begin + length, begin + capacity - 1, value);
+        if (result.ec == std::errc()) length = result.ptr - begin;
+    }
+
+    const char* Finish() {
+        if (capacity == 0) return "";
+        begin[length] = '\0';
+        FrameArena::CommitText(length + 1);
+        return begin;
+    }
+
+private:
+    size_t capacity = 0;
+    size_t length = 0;
+    char* begin;
+};
+
+// Concatenates its arguments into frame memory:
+//   DrawText(FrameText("HP: ", player.currentHP, "/", player.maxHP), 20, 20, 20, LIME);
+template <typename... Args>
+const char* FrameText(const Args&... args) {
+    FrameTextWriter writer;
+    (writer.Append(args), ...);
+    return writer.Finish();
+}
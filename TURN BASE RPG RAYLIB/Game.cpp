@@ -1,6 +1,8 @@
 ﻿#include "raylib.h"
 #include "Game.h"
 #include <cstdlib>
+#include <cmath>
+#include <cstring>
 #include <ctime>
 #include <iostream>
 #include <fstream>
@@ -12,6 +14,16 @@
 #include "PaladinFactory.h"
 #include "WitchFactory.h"
 #include "Enemy.h"
+#include "Content.h"
+#include "Encounters.h"
+#include "Frame.h"
+#include "FrameArena.h"
+#include "Renderer.h"
+#include "Input.h"
+#include "ScreenTimings.h"
+#include "Profiler.h"
+#include "MemoryTracker.h"
+#include "FlightRecorder.h"
 
 
 #ifdef DARKRED
@@ -43,38 +55,61 @@ Game::Game(int screenW, int screenH)
     : screenWidth(screenW), screenHeight(screenH),
     running(true), state(GameState::MainMenu),
     playerCoins(0), selectedAction(0),
-    skillCooldownTurns(0),
-    showAttackEffect(false), attackEffectFrame(0),
-    isPlayerTurn(true), isBlocking(false), skillOnCooldown(false)
+    isPlayerTurn(true)
 {
-    characterTexture = LoadTexture("assets/character.png");
-    archerTexture = LoadTexture("assets/archer.png");
-    warriorTexture = LoadTexture("assets/warrior.png");
-    paladinTexture = LoadTexture("assets/paladin.png");
-    witchTexture = LoadTexture("assets/witch.png");
-    battleBgTexture = LoadTexture("assets/battle_bg.png"); // Make sure this file exists
-    enemyTexture = { 0 };
-
-    availableSkills = {
-        { "Blazing Strike", "A powerful fire attack.)", 50, false },
-        { "Frost Guard", "Reduces damage for 2 turns.", 40, false },
-        { "Thunder Dash", "Quick attack, always goes first.", 60, false }
-    };
+    {
+        PROFILE_ZONE("LoadTextures");
+        MEMORY_SCOPE(Assets);
+        auto load = [](const char* path) {
+            FlightRecorder::Record(FlightEvent::AssetLoad, 0, 0, path);
+            return Gfx().LoadTexture(path);
+        };
+        characterTexture = load("assets/character.png");
+        archerTexture = load("assets/archer.png");
+        warriorTexture = load("assets/warrior.png");
+        paladinTexture = load("assets/paladin.png");
+        witchTexture = load("assets/witch.png");
+        battleBgTexture = load("assets/battle_bg.png"); // Make sure this file exists
+        enemyTexture = { 0 };
+    }
+    for (const Texture2D* texture : { &characterTexture, &archerTexture, &warriorTexture,
+                                      &paladinTexture, &witchTexture, &battleBgTexture }) {
+        MemoryTracker::OnTextureLoaded(*texture);
+    }
+
+    RefreshSkillsFromContent();
 
-    srand(static_cast<unsigned int>(time(nullptr)));
+    // Comes from the input recording during replays so battles repeat exactly
+    srand(Input::RandomSeed());
     InitPlayer();   // Set default values
+    playerEntity = battleWorld.Create();
+    battleWorld.Add(playerEntity, Fighter{ &player });
+    journal.Open();
     LoadGame();     // Overwrite with saved values if available
+    battleStats.Open(STATS_PATH);
+    resumeBattle = ReadBattleSnapshot(BATTLE_PATH, suspendedBattle);
+}
+
+Game::~Game() {
+    FinishCompaction();
+    journal.Close();
+    battleStats.Close();
 }
 
 
 
 void Game::Unload() {
-    UnloadTexture(characterTexture);
-    UnloadTexture(archerTexture);
-    UnloadTexture(warriorTexture);
-    UnloadTexture(paladinTexture);
-    UnloadTexture(witchTexture);
-    UnloadTexture(battleBgTexture);
+    for (const Texture2D* texture : { &characterTexture, &archerTexture, &warriorTexture,
+                                      &paladinTexture, &witchTexture, &battleBgTexture }) {
+        MemoryTracker::OnTextureUnloaded(*texture);
+    }
+    Gfx().UnloadTexture(characterTexture);
+    Gfx().UnloadTexture(archerTexture);
+    Gfx().UnloadTexture(warriorTexture);
+    Gfx().UnloadTexture(paladinTexture);
+    Gfx().UnloadTexture(witchTexture);
+    Gfx().UnloadTexture(battleBgTexture);
+    battleLayers.Unload();
 }
 
 bool Game::IsRunning() const {
@@ -89,12 +124,14 @@ void Game::RemoveObserver(NotificationObserver* observer) {
 }
 
 void Game::ShowNotification(const std::string& msg) {
+    PROFILE_ZONE("ShowNotification");
+    MEMORY_SCOPE(UI);
     std::cout << "[Notification] " << msg << std::endl;
     for (auto* obs : observers) {
         obs->OnNotify(msg);
     }
     // Add to battle log if in battle
-    if (state == GameState::Battle) {
+    if (state == GameState::Battle || state == GameState::Duel) {
         battleLog.push_back(msg);
         if (battleLog.size() > BATTLE_LOG_MAX_LINES) {
             battleLog.erase(battleLog.begin()); // Remove the oldest line
@@ -109,30 +146,30 @@ std::string Game::GetPlayerName() const {
     return player.name;
 }
 std::string Game::EnterPlayerName() {
+    ScreenScope screen("EnterName");
     std::string name = "";
-    bool done = false;
-
-    while (!done && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Enter your name:", 100, 100, 24, DARKGREEN);
-        DrawRectangle(100, 140, 400, 40, LIGHTGRAY);
-        DrawText(name.c_str(), 110, 150, 20, BLACK);
-        DrawText("Press ENTER to continue", 100, 200, 20, GRAY);
-        EndDrawing();
-
-        int key = GetCharPressed();
+
+    while (!Gfx().ShouldClose()) {
+        int key = Input::GetCharPressed();
         if (key >= 32 && key <= 125 && name.length() < 16) {
             name += static_cast<char>(key);
         }
 
-        if (IsKeyPressed(KEY_BACKSPACE) && !name.empty()) {
+        if (Input::IsKeyPressed(KEY_BACKSPACE) && !name.empty()) {
             name.pop_back();
         }
 
-        if (IsKeyPressed(KEY_ENTER) && !name.empty()) {
-            done = true;
+        if (Input::IsKeyPressed(KEY_ENTER) && !name.empty()) {
+            break;
         }
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Enter your name:", 100, 100, 24, DARKGREEN);
+        Gfx().DrawRectangle(100, 140, 400, 40, LIGHTGRAY);
+        Gfx().DrawText(name.c_str(), 110, 150, 20, BLACK);
+        Gfx().DrawText("Press ENTER to continue", 100, 200, 20, GRAY);
+        EndFrame();
     }
 
     return name;
@@ -154,52 +191,57 @@ void Game::InitPlayer() {
 }
 
 
-struct ShopItem {
-    std::string name;
-    std::string description;
-    int price;
-};
-
-const ShopItem shopItems[] = {
-    { "Potion", "Restores 20 HP", 10 },
-    { "Hi-Potion", "Restores 50 HP", 25 },
-    { "Elixir", "Fully restores HP", 50 },
-    { "Antidote", "Cures poison", 15 },
-    { "Attack Up", "Boosts attack for next battle", 30 },
-    { "Defense Up", "Boosts defense for next battle", 30 },
-    { "Revive", "Revives you with 50% HP if defeated", 60 },
-    { "Speed Boots", "Increases speed for next battle", 35 },
-    { "Magic Water", "Restores skill cooldown instantly", 40 }
-};
-const int shopItemCount = sizeof(shopItems) / sizeof(shopItems[0]);
+// Rebuilds the skill shop list from the content tables, keeping ownership
+void Game::RefreshSkillsFromContent() {
+    std::vector<Skill> skills;
+    for (int i = 0; i < Content().SkillCount(); ++i) {
+        const SkillDef& def = Content().Skill(i);
+        bool owned = std::any_of(playerSkills.begin(), playerSkills.end(),
+            [&](const Skill& skill) { return skill.name == def.name; });
+        skills.push_back({ def.name, def.description, def.price, owned });
+    }
+    availableSkills = skills;
+    contentGeneration = Content().Generation();
+}
 
 
 
 
 void Game::InitEnemy() {
-    enemyType = static_cast<EnemyType>(GetRandom(1, 2));
-    enemyLevel = std::max(1, player.level - 1 + GetRandom(0, 2));
+    PROFILE_ZONE("InitEnemy");
+    MEMORY_SCOPE(Battle);
+    // Content/encounters.txt decides who shows up and how strong
+    const EncounterDef* encounter = Encounters().Roll("Colosseum", player.level, lastEncounterEnemy,
+        [this](int min, int max) { return GetRandom(min, max); });
+    enemyType = EnemyType::Warrior;
+    enemyLevel = player.level;
+    if (encounter) {
+        // An enemy without a factory below fights as a Warrior
+        const char* names[] = { "Archer", "Warrior", "Paladin", "Witch" };
+        for (int i = 0; i < 4; ++i) {
+            if (std::strcmp(encounter->enemy, names[i]) == 0) enemyType = static_cast<EnemyType>(i);
+        }
+        enemyLevel = std::max(1, player.level + encounter->levelOffset);
+        lastEncounterEnemy = encounter->enemy;
+    }
 
     EnemyFactory* factory = nullptr;
 
     switch (enemyType) {
     case EnemyType::Archer:
         factory = new ArcherFactory();
-        enemyTexture = archerTexture;
         break;
     case EnemyType::Warrior:
         factory = new WarriorFactory();
-        enemyTexture = warriorTexture;
         break;
     case EnemyType::Paladin:
         factory = new PaladinFactory();
-        enemyTexture = paladinTexture;
         break;
     case EnemyType::Witch:
         factory = new WitchFactory();
-        enemyTexture = witchTexture;
         break;
     }
+    enemyTexture = EnemyTextureFor(enemyType);
 
     Enemy* generated = factory->CreateEnemy(enemyLevel);
 
@@ -210,15 +252,35 @@ void Game::InitEnemy() {
     enemy.defense = generated->GetDefense();
     enemy.level = enemyLevel;
 
-    baseEnemyExp = 20 + (enemyLevel * 5);
-    baseEnemyCoins = 5 + (enemyLevel * 2);
+    baseEnemyExp = generated->GetExpReward();
+    baseEnemyCoins = generated->GetCoinReward();
+
+    ResetEnemyEntity();
 
     delete generated;
     delete factory;
 }
 
+// A fresh entity, so nothing the last enemy had carries over
+void Game::ResetEnemyEntity() {
+    battleWorld.Destroy(enemyEntity);
+    enemyEntity = battleWorld.Create();
+    battleWorld.Add(enemyEntity, Fighter{ &enemy });
+}
+
+Texture2D Game::EnemyTextureFor(EnemyType type) const {
+    switch (type) {
+    case EnemyType::Archer: return archerTexture;
+    case EnemyType::Paladin: return paladinTexture;
+    case EnemyType::Witch: return witchTexture;
+    default: return warriorTexture;
+    }
+}
+
 
 void Game::ShowTownSquare() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("TownSquare");
     state = GameState::TownSquare;
     Rectangle colosseumBtn = { 20, 120, 300, 40 };
     Rectangle marketBtn = { 20, 180, 300, 40 };
@@ -226,42 +288,16 @@ void Game::ShowTownSquare() {
     Rectangle trainingBtn = { 20, 300, 300, 40 };
     Rectangle exitBtn = { (float)(screenWidth - 220), (float)(screenHeight - 80), 200, 50 };
 
-    while (state == GameState::TownSquare && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("[Aetherion - TOWN SQUARE]", 20, 20, 30, DARKBLUE);
-
-        Vector2 mousePos = GetMousePosition();
-
-        // Draw buttons
-        Color colColor = CheckCollisionPointRec(mousePos, colosseumBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(colosseumBtn, colColor);
-        DrawText("1. Colosseum (Battle Arena)", colosseumBtn.x + 10, colosseumBtn.y + 10, 20, BLACK);
-
-        Color marketColor = CheckCollisionPointRec(mousePos, marketBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(marketBtn, marketColor);
-        DrawText("2. Market (Shop)", marketBtn.x + 10, marketBtn.y + 10, 20, BLACK);
-
-        Color tavernColor = CheckCollisionPointRec(mousePos, tavernBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(tavernBtn, tavernColor);
-        DrawText("3. Tavern (Heal/Save)", tavernBtn.x + 10, tavernBtn.y + 10, 20, BLACK);
-
-        Color trainColor = CheckCollisionPointRec(mousePos, trainingBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(trainingBtn, trainColor);
-        DrawText("4. Training Ground (Coming Soon)", trainingBtn.x + 10, trainingBtn.y + 10, 20, DARKGRAY);
-
-        Color exitColor = CheckCollisionPointRec(mousePos, exitBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(exitBtn, exitColor);
-        DrawText("Exit to Main Menu", exitBtn.x + 20, exitBtn.y + 15, 24, BLACK);
+    while (true) {
+        // Input before anything is drawn, so this frame already shows what it did
+        Vector2 mousePos = Input::GetMousePosition();
 
-        if (IsKeyPressed(KEY_F12)) {
+        if (Input::IsKeyPressed(KEY_F12)) {
             ShowDeveloperMenu();
         }
 
-        EndDrawing();
-
         // Mouse input
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             if (CheckCollisionPointRec(mousePos, colosseumBtn)) {
                 ShowColosseum();
             }
@@ -282,19 +318,49 @@ void Game::ShowTownSquare() {
         }
 
         // Keyboard input
-        if (IsKeyPressed(KEY_ONE)) ShowColosseum();
-        else if (IsKeyPressed(KEY_TWO)) ShowMarket();
-        else if (IsKeyPressed(KEY_THREE)) ShowTavern();
-        else if (IsKeyPressed(KEY_FOUR)) ShowTrainingGround();
-        else if (IsKeyPressed(KEY_ESCAPE)) {
+        if (Input::IsKeyPressed(KEY_ONE)) ShowColosseum();
+        else if (Input::IsKeyPressed(KEY_TWO)) ShowMarket();
+        else if (Input::IsKeyPressed(KEY_THREE)) ShowTavern();
+        else if (Input::IsKeyPressed(KEY_FOUR)) ShowTrainingGround();
+        else if (Input::IsKeyPressed(KEY_ESCAPE)) {
             running = false;
             state = GameState::MainMenu;
             break;
         }
+        if (state != GameState::TownSquare || Gfx().ShouldClose()) break;
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("[Aetherion - TOWN SQUARE]", 20, 20, 30, DARKBLUE);
+
+        // Draw buttons
+        Color colColor = CheckCollisionPointRec(mousePos, colosseumBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(colosseumBtn, colColor);
+        Gfx().DrawText("1. Colosseum (Battle Arena)", colosseumBtn.x + 10, colosseumBtn.y + 10, 20, BLACK);
+
+        Color marketColor = CheckCollisionPointRec(mousePos, marketBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(marketBtn, marketColor);
+        Gfx().DrawText("2. Market (Shop)", marketBtn.x + 10, marketBtn.y + 10, 20, BLACK);
+
+        Color tavernColor = CheckCollisionPointRec(mousePos, tavernBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(tavernBtn, tavernColor);
+        Gfx().DrawText("3. Tavern (Heal/Save)", tavernBtn.x + 10, tavernBtn.y + 10, 20, BLACK);
+
+        Color trainColor = CheckCollisionPointRec(mousePos, trainingBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(trainingBtn, trainColor);
+        Gfx().DrawText("4. Training Ground", trainingBtn.x + 10, trainingBtn.y + 10, 20, BLACK);
+
+        Color exitColor = CheckCollisionPointRec(mousePos, exitBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(exitBtn, exitColor);
+        Gfx().DrawText("Exit to Main Menu", exitBtn.x + 20, exitBtn.y + 15, 24, BLACK);
+
+        EndFrame();
     }
 }
 
 void Game::ShowDeveloperMenu() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("DeveloperMenu");
     bool editing = true;
     int selected = 0;
     const int fieldCount = 8;
@@ -318,125 +384,129 @@ void Game::ShowDeveloperMenu() {
         "EXP",
         "EXP To Level"
     };
+    int coinsBefore = playerCoins;
+
+    while (editing && !Gfx().ShouldClose()) {
+        if (Input::IsKeyPressed(KEY_DOWN)) selected = (selected + 1) % fieldCount;
+        if (Input::IsKeyPressed(KEY_UP)) selected = (selected + fieldCount - 1) % fieldCount;
+        if (Input::IsKeyPressed(KEY_RIGHT)) (*fields[selected]) += 1;
+        if (Input::IsKeyPressed(KEY_LEFT)) (*fields[selected]) -= 1;
+        if (Input::IsKeyPressed(KEY_ESCAPE)) break;
 
-    while (editing && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(DARKGRAY);
-        DrawText("Developer Menu - Edit Player Values", 40, 40, 28, GOLD);
-        DrawText("Use UP/DOWN to select, LEFT/RIGHT to change, ESC to exit", 40, 80, 20, LIGHTGRAY);
+        BeginFrame();
+        Gfx().ClearBackground(DARKGRAY);
+        Gfx().DrawText("Developer Menu - Edit Player Values", 40, 40, 28, GOLD);
+        Gfx().DrawText("Use UP/DOWN to select, LEFT/RIGHT to change, ESC to exit", 40, 80, 20, LIGHTGRAY);
 
         int y = 130;
         for (int i = 0; i < fieldCount; ++i) {
             Color color = (i == selected) ? YELLOW : WHITE;
             char buf[128];
             snprintf(buf, sizeof(buf), "%s: %d", labels[i], *fields[i]);
-            DrawText(buf, 60, y, 24, color);
+            Gfx().DrawText(buf, 60, y, 24, color);
             y += 36;
         }
 
-        EndDrawing();
+        EndFrame();
+    }
 
-        if (IsKeyPressed(KEY_DOWN)) selected = (selected + 1) % fieldCount;
-        if (IsKeyPressed(KEY_UP)) selected = (selected + fieldCount - 1) % fieldCount;
-        if (IsKeyPressed(KEY_RIGHT)) (*fields[selected]) += 1;
-        if (IsKeyPressed(KEY_LEFT)) (*fields[selected]) -= 1;
-        if (IsKeyPressed(KEY_ESCAPE)) editing = false;
+    int coinsDelta = playerCoins - coinsBefore;
+    if (coinsDelta != 0) {
+        playerCoins = coinsBefore;
+        AddCoins(coinsDelta);
     }
+    JournalStats();
 }
 
 
 void Game::ShowColosseum() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("Colosseum");
     state = GameState::Colosseum;
     Rectangle quickBtn = { 20, 120, 300, 40 };
     Rectangle survivalBtn = { 20, 180, 300, 40 };
     Rectangle backBtn = { 20, 240, 300, 40 };
+    Rectangle duelBtn = { 20, 300, 300, 40 };
 
-    while (state == GameState::Colosseum && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Colosseum (Battle Arena)", 20, 20, 30, DARKRED);
-
-        Vector2 mousePos = GetMousePosition();
-
-        Color quickColor = CheckCollisionPointRec(mousePos, quickBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(quickBtn, quickColor);
-        DrawText("1. Quick Battle", quickBtn.x + 10, quickBtn.y + 10, 20, BLACK);
-
-        Color survivalColor = CheckCollisionPointRec(mousePos, survivalBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(survivalBtn, survivalColor);
-        DrawText("2. Survival Mode (Coming Soon)", survivalBtn.x + 10, survivalBtn.y + 10, 20, DARKGRAY);
-
-        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(backBtn, backColor);
-        DrawText("3. Back to Town", backBtn.x + 10, backBtn.y + 10, 20, BLACK);
-
-        EndDrawing();
+    while (true) {
+        Vector2 mousePos = Input::GetMousePosition();
 
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             if (CheckCollisionPointRec(mousePos, quickBtn)) {
                 InitEnemy();
-                skillCooldownTurns = 0;
                 state = GameState::Battle;
                 StartBattle();
                 return;
             }
             else if (CheckCollisionPointRec(mousePos, survivalBtn)) {
-                ShowNotification("Survival Mode coming soon!");
+                StartSurvival();
+                return;
+            }
+            else if (CheckCollisionPointRec(mousePos, duelBtn)) {
+                ShowDuelLobby();
             }
             else if (CheckCollisionPointRec(mousePos, backBtn)) {
                 ShowTownSquare();
                 return;
             }
         }
-        if (IsKeyPressed(KEY_ONE)) {
+        if (Input::IsKeyPressed(KEY_ONE)) {
             InitEnemy();
-            skillCooldownTurns = 0;
             state = GameState::Battle;
             StartBattle();
             return;
         }
-        else if (IsKeyPressed(KEY_TWO)) {
-            ShowNotification("Survival Mode coming soon!");
+        else if (Input::IsKeyPressed(KEY_TWO)) {
+            StartSurvival();
+            return;
         }
-        else if (IsKeyPressed(KEY_THREE) || IsKeyPressed(KEY_ESCAPE)) {
+        else if (Input::IsKeyPressed(KEY_THREE) || Input::IsKeyPressed(KEY_ESCAPE)) {
             ShowTownSquare();
             return;
         }
+        else if (Input::IsKeyPressed(KEY_FOUR)) {
+            ShowDuelLobby();
+        }
+        if (state != GameState::Colosseum || Gfx().ShouldClose()) break;
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Colosseum (Battle Arena)", 20, 20, 30, DARKRED);
+
+        Color quickColor = CheckCollisionPointRec(mousePos, quickBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(quickBtn, quickColor);
+        Gfx().DrawText("1. Quick Battle", quickBtn.x + 10, quickBtn.y + 10, 20, BLACK);
+
+        Color survivalColor = CheckCollisionPointRec(mousePos, survivalBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(survivalBtn, survivalColor);
+        Gfx().DrawText("2. Survival Mode", survivalBtn.x + 10, survivalBtn.y + 10, 20, BLACK);
+
+        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(backBtn, backColor);
+        Gfx().DrawText("3. Back to Town", backBtn.x + 10, backBtn.y + 10, 20, BLACK);
+
+        // After Back so the older entries keep their numbers (and recordings keep working)
+        Color duelColor = CheckCollisionPointRec(mousePos, duelBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(duelBtn, duelColor);
+        Gfx().DrawText("4. PvP Duel", duelBtn.x + 10, duelBtn.y + 10, 20, BLACK);
+
+        EndFrame();
     }
 }
 
 void Game::ShowMarket() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("Market");
     state = GameState::Market;
     Rectangle shopBtn = { 20, 120, 300, 40 };
     Rectangle skillShopBtn = { 20, 180, 300, 40 };
     Rectangle backBtn = { 20, 240, 300, 40 };
 
-    while (state == GameState::Market && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Market (Shop)", 20, 20, 30, DARKGOLD);
-
-        Vector2 mousePos = GetMousePosition();
-
-        // Shop button
-        Color shopColor = CheckCollisionPointRec(mousePos, shopBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(shopBtn, shopColor);
-        DrawText("1. Shop", shopBtn.x + 10, shopBtn.y + 10, 20, BLACK);
-
-        // Skill Shop button
-        Color skillColor = CheckCollisionPointRec(mousePos, skillShopBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(skillShopBtn, skillColor);
-        DrawText("2. Arcane Skill Emporium", skillShopBtn.x + 10, skillShopBtn.y + 10, 20, DARKMAGENTA);
-
-        // Back to Town button
-        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : LIGHTGRAY;
-        DrawRectangleRec(backBtn, backColor);
-        DrawText("3. Back to Town", backBtn.x + 10, backBtn.y + 10, 20, BLACK);
-
-        EndDrawing();
+    while (true) {
+        Vector2 mousePos = Input::GetMousePosition();
 
         // Handle input
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             if (CheckCollisionPointRec(mousePos, shopBtn)) {
                 ShowShop();
             }
@@ -449,20 +519,44 @@ void Game::ShowMarket() {
             }
         }
 
-        if (IsKeyPressed(KEY_ONE)) {
+        if (Input::IsKeyPressed(KEY_ONE)) {
             ShowShop();
         }
-        else if (IsKeyPressed(KEY_TWO)) {
+        else if (Input::IsKeyPressed(KEY_TWO)) {
             ShowSkillShop();
         }
-        else if (IsKeyPressed(KEY_THREE) || IsKeyPressed(KEY_ESCAPE)) {
+        else if (Input::IsKeyPressed(KEY_THREE) || Input::IsKeyPressed(KEY_ESCAPE)) {
             ShowTownSquare();
             return;
         }
+        if (state != GameState::Market || Gfx().ShouldClose()) break;
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Market (Shop)", 20, 20, 30, DARKGOLD);
+
+        // Shop button
+        Color shopColor = CheckCollisionPointRec(mousePos, shopBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(shopBtn, shopColor);
+        Gfx().DrawText("1. Shop", shopBtn.x + 10, shopBtn.y + 10, 20, BLACK);
+
+        // Skill Shop button
+        Color skillColor = CheckCollisionPointRec(mousePos, skillShopBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(skillShopBtn, skillColor);
+        Gfx().DrawText("2. Arcane Skill Emporium", skillShopBtn.x + 10, skillShopBtn.y + 10, 20, DARKMAGENTA);
+
+        // Back to Town button
+        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(backBtn, backColor);
+        Gfx().DrawText("3. Back to Town", backBtn.x + 10, backBtn.y + 10, 20, BLACK);
+
+        EndFrame();
     }
 }
 
 void Game::ShowTavern() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("Tavern");
     state = GameState::Tavern;
     Rectangle restBtn = { 20, 120, 300, 40 };
     Rectangle saveBtn = { 20, 180, 300, 40 };
@@ -470,32 +564,15 @@ void Game::ShowTavern() {
     Rectangle cottageBtn = { 20, 300, 300, 40 };
     Rectangle backBtn = { 20, 360, 300, 40 };
 
-    while (state == GameState::Tavern && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Tavern", 20, 20, 30, DARKGREEN);
-
-        Vector2 mousePos = GetMousePosition();
-
-        auto drawButton = [&](Rectangle rect, const char* text) {
-            Color btnColor = CheckCollisionPointRec(mousePos, rect) ? GRAY : LIGHTGRAY;
-            DrawRectangleRec(rect, btnColor);
-            DrawText(text, rect.x + 10, rect.y + 10, 20, BLACK);
-            };
-
-        drawButton(restBtn, "1. Rest (Heal HP) - 45 coins");
-        drawButton(saveBtn, "2. Save Game");
-        drawButton(loadBtn, "3. Load Game");
-        drawButton(cottageBtn, "4. Cottage (View Stats & Inventory)");
-        drawButton(backBtn, "5. Back to Town");
-
-        EndDrawing();
+    while (true) {
+        Vector2 mousePos = Input::GetMousePosition();
 
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             if (CheckCollisionPointRec(mousePos, restBtn)) {
                 if (playerCoins >= 45) {
-                    playerCoins -= 45;
+                    AddCoins(-45);
                     player.currentHP = player.maxHP;
+                    JournalStats();
                     ShowNotification("You are fully healed!");
                 }
                 else {
@@ -520,36 +597,58 @@ void Game::ShowTavern() {
         }
 
         // Keyboard shortcuts
-        if (IsKeyPressed(KEY_ONE)) {
+        if (Input::IsKeyPressed(KEY_ONE)) {
             if (playerCoins >= 45) {
-                playerCoins -= 45;
+                AddCoins(-45);
                 player.currentHP = player.maxHP;
+                JournalStats();
                 ShowNotification("You are fully healed!");
             }
             else {
                 ShowNotification("Not enough coins to rest!");
             }
         }
-        else if (IsKeyPressed(KEY_TWO)) {
+        else if (Input::IsKeyPressed(KEY_TWO)) {
             SaveGame();
             ShowNotification("Game Saved!");
         }
-        else if (IsKeyPressed(KEY_THREE)) {
+        else if (Input::IsKeyPressed(KEY_THREE)) {
             LoadGame();
             ShowNotification("Game Loaded!");
         }
-        else if (IsKeyPressed(KEY_FOUR)) {
+        else if (Input::IsKeyPressed(KEY_FOUR)) {
             ShowPlayerStatsAndInventory();
         }
-        else if (IsKeyPressed(KEY_FIVE) || IsKeyPressed(KEY_ESCAPE)) {
+        else if (Input::IsKeyPressed(KEY_FIVE) || Input::IsKeyPressed(KEY_ESCAPE)) {
             ShowTownSquare();
             return;
         }
+        if (state != GameState::Tavern || Gfx().ShouldClose()) break;
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Tavern", 20, 20, 30, DARKGREEN);
+
+        auto drawButton = [&](Rectangle rect, const char* text) {
+            Color btnColor = CheckCollisionPointRec(mousePos, rect) ? GRAY : LIGHTGRAY;
+            Gfx().DrawRectangleRec(rect, btnColor);
+            Gfx().DrawText(text, rect.x + 10, rect.y + 10, 20, BLACK);
+            };
+
+        drawButton(restBtn, "1. Rest (Heal HP) - 45 coins");
+        drawButton(saveBtn, "2. Save Game");
+        drawButton(loadBtn, "3. Load Game");
+        drawButton(cottageBtn, "4. Cottage (View Stats & Inventory)");
+        drawButton(backBtn, "5. Back to Town");
+
+        EndFrame();
     }
 }
 
 void Game::ShowPlayerStatsAndInventory() {
-    enum class SubMenu { Stats, Inventory, Skills };
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("Cottage");
+    enum class SubMenu { Stats, Inventory, Skills, Records };
     SubMenu currentMenu = SubMenu::Stats;
 
     bool viewing = true;
@@ -557,6 +656,15 @@ void Game::ShowPlayerStatsAndInventory() {
     int selectedSkillIndex = 0;
     Rectangle renameBtn = { 300, 300, 160, 30 };
 
+    // Battle Records, queried again only when the period or the enemy changes
+    const int recordsRows = 5;
+    const int64_t monthSeconds = 30 * 24 * 60 * 60;
+    bool recordsLastMonth = false;
+    int recordsSelected = 0;
+    bool recordsDirty = true;
+    std::vector<StatGroup> recordsByEnemy;
+    std::vector<StatGroup> recordsByLevel;
+
     // Track which skill is selected for battle
     int equippedSkillIndex = -1;
     for (size_t i = 0; i < playerSkills.size(); ++i) {
@@ -566,59 +674,154 @@ void Game::ShowPlayerStatsAndInventory() {
         }
     }
 
-    while (viewing && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+    Rectangle backRect = { 20, static_cast<float>(screenHeight - 50), 180, 35 };
+
+    while (viewing && !Gfx().ShouldClose()) {
+        Vector2 mousePos = Input::GetMousePosition();
+        bool clicked = Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+
+        if (currentMenu == SubMenu::Stats) {
+            if (clicked && CheckCollisionPointRec(mousePos, renameBtn)) {
+                std::string newName = EnterPlayerName();
+                if (!newName.empty() && newName != player.name) {
+                    SetPlayerName(newName);
+                    SaveGame();
+                    ShowNotification("Nama berhasil diubah!");
+                }
+            }
+        }
+        else if (currentMenu == SubMenu::Inventory) {
+            for (size_t i = 0; i < inventory.size(); ++i) {
+                Rectangle itemRect = { 60.0f, 120.0f + i * 35.0f, 600.0f, 30.0f };
+                if (!CheckCollisionPointRec(mousePos, itemRect)) continue;
+                selectedItemIndex = (int)i;
+                if (clicked) UseItem(i);
+                break;
+            }
+
+            if (Input::IsKeyPressed(KEY_DOWN) && !inventory.empty()) {
+                selectedItemIndex = (selectedItemIndex + 1) % inventory.size();
+            }
+            else if (Input::IsKeyPressed(KEY_UP) && !inventory.empty()) {
+                selectedItemIndex = (selectedItemIndex + inventory.size() - 1) % inventory.size();
+            }
+            else if (Input::IsKeyPressed(KEY_ENTER) && !inventory.empty()) {
+                UseItem(selectedItemIndex);
+            }
+        }
+        else if (currentMenu == SubMenu::Skills && !playerSkills.empty()) {
+            for (size_t i = 0; i < playerSkills.size(); ++i) {
+                Rectangle skillRect = { 60.0f, 120.0f + i * 35.0f, 600.0f, 30.0f };
+                if (!CheckCollisionPointRec(mousePos, skillRect)) continue;
+                selectedSkillIndex = (int)i;
+                if (clicked) {
+                    equippedSkillIndex = (int)i;
+                    ShowNotification("Equipped skill: " + playerSkills[i].name);
+                }
+                break;
+            }
+
+            if (Input::IsKeyPressed(KEY_DOWN)) {
+                selectedSkillIndex = (selectedSkillIndex + 1) % playerSkills.size();
+            }
+            else if (Input::IsKeyPressed(KEY_UP)) {
+                selectedSkillIndex = (selectedSkillIndex + playerSkills.size() - 1) % playerSkills.size();
+            }
+            else if (Input::IsKeyPressed(KEY_ENTER)) {
+                equippedSkillIndex = selectedSkillIndex;
+                ShowNotification("Equipped skill: " + playerSkills[equippedSkillIndex].name);
+            }
+        }
+        else if (currentMenu == SubMenu::Records) {
+            int first = std::max(0, recordsSelected - (recordsRows - 1));
+            int last = std::min((int)recordsByEnemy.size(), first + recordsRows);
+            for (int i = first; i < last; ++i) {
+                Rectangle rowRect = { 60.0f, 138.0f + (i - first) * 26.0f, 640.0f, 24.0f };
+                if (clicked && i != recordsSelected && CheckCollisionPointRec(mousePos, rowRect)) {
+                    recordsSelected = i;
+                    recordsDirty = true;
+                }
+            }
+
+            if (Input::IsKeyPressed(KEY_DOWN) && recordsSelected + 1 < (int)recordsByEnemy.size()) {
+                recordsSelected++;
+                recordsDirty = true;
+            }
+            else if (Input::IsKeyPressed(KEY_UP) && recordsSelected > 0) {
+                recordsSelected--;
+                recordsDirty = true;
+            }
+            else if (Input::IsKeyPressed(KEY_P)) {
+                recordsLastMonth = !recordsLastMonth;
+                recordsDirty = true;
+            }
+        }
+
+        if (clicked && CheckCollisionPointRec(mousePos, backRect)) {
+            viewing = false;
+        }
+        if (Input::IsKeyPressed(KEY_TAB)) {
+            // Cycle through Stats -> Inventory -> Skills -> Records
+            if (currentMenu == SubMenu::Stats) currentMenu = SubMenu::Inventory;
+            else if (currentMenu == SubMenu::Inventory) currentMenu = SubMenu::Skills;
+            else if (currentMenu == SubMenu::Skills) currentMenu = SubMenu::Records;
+            else currentMenu = SubMenu::Stats;
+        }
+        else if (Input::IsKeyPressed(KEY_ESCAPE)) {
+            viewing = false;
+        }
+        if (!viewing) break;
 
-        DrawText("Cottage", 20, 20, 30, DARKGREEN);
-        DrawText("[TAB] Switch Menu", 600, 20, 20, GRAY);
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
 
-        Vector2 mousePos = GetMousePosition();
+        Gfx().DrawText("Cottage", 20, 20, 30, DARKGREEN);
+        Gfx().DrawText("[TAB] Switch Menu", 600, 20, 20, GRAY);
 
         Rectangle panel = { 40, 60, 700, 350 };
-        DrawRectangleRec(panel, CLITERAL(Color){240, 240, 240, 255});
-        DrawRectangleLinesEx(panel, 2, DARKGREEN);
+        Gfx().DrawRectangleRec(panel, CLITERAL(Color){240, 240, 240, 255});
+        Gfx().DrawRectangleLinesEx(panel, 2, DARKGREEN);
 
         if (currentMenu == SubMenu::Stats) {
-            DrawText("Player Stats", 60, 80, 25, DARKGREEN);
+            Gfx().DrawText("Player Stats", 60, 80, 25, DARKGREEN);
 
             // Character Image
-            DrawTextureEx(characterTexture, Vector2{ 25, 110 }, 0.0f, 0.1f, WHITE);
+            Gfx().DrawTextureEx(characterTexture, Vector2{ 25, 110 }, 0.0f, 0.1f, WHITE);
 
             // Player Name
-            DrawText(player.name.c_str(), 300, 100, 25, BLACK);
+            Gfx().DrawText(player.name.c_str(), 300, 100, 25, BLACK);
 
             // HP Text & Bar
-            DrawText(("HP: " + std::to_string(player.currentHP) + "/" + std::to_string(player.maxHP)).c_str(), 300, 140, 20, BLACK);
+            Gfx().DrawText(FrameText("HP: ", player.currentHP, "/", player.maxHP), 300, 140, 20, BLACK);
             float hpPercent = (float)player.currentHP / player.maxHP;
             Rectangle hpBarBack = { 440, 140, 200, 20 };
             Rectangle hpBarFill = { 440, 140, 200 * hpPercent, 20 };
-            DrawRectangleRec(hpBarBack, GRAY);
-            DrawRectangleRec(hpBarFill, DARKRED);
-            DrawRectangleLinesEx(hpBarBack, 1, BLACK);
+            Gfx().DrawRectangleRec(hpBarBack, GRAY);
+            Gfx().DrawRectangleRec(hpBarFill, DARKRED);
+            Gfx().DrawRectangleLinesEx(hpBarBack, 1, BLACK);
 
             // ATK & DEF
-            DrawText(("ATK: " + std::to_string(player.attack)).c_str(), 300, 170, 20, BLACK);
-            DrawText(("DEF: " + std::to_string(player.defense)).c_str(), 300, 200, 20, BLACK);
+            Gfx().DrawText(FrameText("ATK: ", player.attack), 300, 170, 20, BLACK);
+            Gfx().DrawText(FrameText("DEF: ", player.defense), 300, 200, 20, BLACK);
 
             // EXP Text & Bar
-            DrawText(("EXP: " + std::to_string(player.exp) + "/" + std::to_string(player.expToLevel)).c_str(), 300, 230, 20, BLACK);
+            Gfx().DrawText(FrameText("EXP: ", player.exp, "/", player.expToLevel), 300, 230, 20, BLACK);
             float expPercent = (float)player.exp / player.expToLevel;
             Rectangle expBarBack = { 440, 230, 200, 20 };
             Rectangle expBarFill = { 440, 230, 200 * expPercent, 20 };
-            DrawRectangleRec(expBarBack, GRAY);
-            DrawRectangleRec(expBarFill, DARKGREEN);
-            DrawRectangleLinesEx(expBarBack, 1, BLACK);
+            Gfx().DrawRectangleRec(expBarBack, GRAY);
+            Gfx().DrawRectangleRec(expBarFill, DARKGREEN);
+            Gfx().DrawRectangleLinesEx(expBarBack, 1, BLACK);
 
-            DrawText(("Coins: " + std::to_string(playerCoins)).c_str(), 300, 260, 20, BLACK);
+            Gfx().DrawText(FrameText("Coins: ", playerCoins), 300, 260, 20, BLACK);
             // change name button
             Color renameColor = CheckCollisionPointRec(mousePos, renameBtn) ? GRAY : DARKGOLD;
-            DrawRectangleRec(renameBtn, renameColor);
-            DrawRectangleLinesEx(renameBtn, 1, DARKGREEN);
-            DrawText("Ganti Nama", (int)renameBtn.x + 20, (int)renameBtn.y + 7, 20, WHITE);
+            Gfx().DrawRectangleRec(renameBtn, renameColor);
+            Gfx().DrawRectangleLinesEx(renameBtn, 1, DARKGREEN);
+            Gfx().DrawText("Ganti Nama", (int)renameBtn.x + 20, (int)renameBtn.y + 7, 20, WHITE);
         }
         else if (currentMenu == SubMenu::Inventory) {
-            DrawText("Inventory (Click or Press ENTER to use)", 60, 80, 25, DARKGREEN);
+            Gfx().DrawText("Inventory (Click or Press ENTER to use)", 60, 80, 25, DARKGREEN);
 
             int y = 120;
             int itemHeight = 30;
@@ -626,123 +829,162 @@ void Game::ShowPlayerStatsAndInventory() {
                 Rectangle itemRect = { 60.0f, (float)y, 600.0f, (float)itemHeight };
                 bool isHover = CheckCollisionPointRec(mousePos, itemRect);
                 Color bgColor = (i == selectedItemIndex || isHover) ? DARKGOLD : CLITERAL(Color) { 220, 220, 220, 255 };
-                DrawRectangleRec(itemRect, bgColor);
-                DrawRectangleLinesEx(itemRect, 1, DARKGREEN);
-                DrawText((inventory[i].name + " x" + std::to_string(inventory[i].quantity)).c_str(), 70, y + 5, 20, BLACK);
-
-                if (isHover) selectedItemIndex = (int)i;
-                if (isHover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    UseItem(i);
-                }
+                Gfx().DrawRectangleRec(itemRect, bgColor);
+                Gfx().DrawRectangleLinesEx(itemRect, 1, DARKGREEN);
+                Gfx().DrawText(FrameText(inventory[i].name, " x", inventory[i].quantity), 70, y + 5, 20, BLACK);
 
                 y += itemHeight + 5;
             }
-
-            if (IsKeyPressed(KEY_DOWN)) {
-                selectedItemIndex = (selectedItemIndex + 1) % inventory.size();
-            }
-            else if (IsKeyPressed(KEY_UP)) {
-                selectedItemIndex = (selectedItemIndex + inventory.size() - 1) % inventory.size();
-            }
-            else if (IsKeyPressed(KEY_ENTER) && !inventory.empty()) {
-                UseItem(selectedItemIndex);
-            }
         }
         else if (currentMenu == SubMenu::Skills) {
-            DrawText("Skills (Select to Equip for Battle)", 60, 80, 25, DARKMAGENTA);
+            Gfx().DrawText("Skills (Select to Equip for Battle)", 60, 80, 25, DARKMAGENTA);
 
             int y = 120;
             int skillHeight = 30;
             if (playerSkills.empty()) {
-                DrawText("You don't own any skills yet.", 70, y, 20, DARKGRAY);
+                Gfx().DrawText("You don't own any skills yet.", 70, y, 20, DARKGRAY);
             }
             else {
                 for (size_t i = 0; i < playerSkills.size(); ++i) {
                     Rectangle skillRect = { 60.0f, (float)y, 600.0f, (float)skillHeight };
                     bool isHover = CheckCollisionPointRec(mousePos, skillRect);
                     Color bgColor = (i == selectedSkillIndex || isHover) ? DARKGOLD : CLITERAL(Color) { 220, 220, 220, 255 };
-                    DrawRectangleRec(skillRect, bgColor);
-                    DrawRectangleLinesEx(skillRect, 1, DARKMAGENTA);
+                    Gfx().DrawRectangleRec(skillRect, bgColor);
+                    Gfx().DrawRectangleLinesEx(skillRect, 1, DARKMAGENTA);
 
-                    std::string skillText = playerSkills[i].name + " - " + playerSkills[i].description;
-                    if ((int)i == equippedSkillIndex) skillText += " [EQUIPPED]";
-                    DrawText(skillText.c_str(), 70, y + 5, 20, BLACK);
-
-                    if (isHover) selectedSkillIndex = (int)i;
-                    if (isHover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                        equippedSkillIndex = (int)i;
-                        ShowNotification("Equipped skill: " + playerSkills[i].name);
-                    }
+                    const char* equipped = (int)i == equippedSkillIndex ? " [EQUIPPED]" : "";
+                    Gfx().DrawText(FrameText(playerSkills[i].name, " - ", playerSkills[i].description, equipped), 70, y + 5, 20, BLACK);
 
                     y += skillHeight + 5;
                 }
-
-                if (IsKeyPressed(KEY_DOWN)) {
-                    selectedSkillIndex = (selectedSkillIndex + 1) % playerSkills.size();
-                }
-                else if (IsKeyPressed(KEY_UP)) {
-                    selectedSkillIndex = (selectedSkillIndex + playerSkills.size() - 1) % playerSkills.size();
-                }
-                else if (IsKeyPressed(KEY_ENTER)) {
-                    equippedSkillIndex = selectedSkillIndex;
-                    ShowNotification("Equipped skill: " + playerSkills[equippedSkillIndex].name);
-                }
             }
         }
+        else if (currentMenu == SubMenu::Records) {
+            if (recordsDirty) {
+                StatsQuery byEnemy;
+                if (recordsLastMonth) byEnemy.Where(StatColumn::Time, static_cast<int64_t>(std::time(nullptr)) - monthSeconds, INT64_MAX);
+                byEnemy.groupBy = StatColumn::Enemy;
+                byEnemy.sum = StatColumn::Turns;
+                recordsByEnemy = battleStats.Query(byEnemy);
+                recordsSelected = std::max(0, std::min(recordsSelected, (int)recordsByEnemy.size() - 1));
+
+                recordsByLevel.clear();
+                if (!recordsByEnemy.empty()) {
+                    int64_t enemyId = recordsByEnemy[recordsSelected].key;
+                    StatsQuery byLevel = byEnemy;
+                    byLevel.Where(StatColumn::Enemy, enemyId, enemyId);
+                    byLevel.groupBy = StatColumn::PlayerLevel;
+                    recordsByLevel = battleStats.Query(byLevel);
+                }
+                recordsDirty = false;
+            }
 
-        Rectangle backRect = { 20, static_cast<float>(screenHeight - 50), 180, 35 };
-        Color backColor = CheckCollisionPointRec(mousePos, backRect) ? GRAY : DARKGOLD;
-        DrawRectangleRec(backRect, backColor);
-        DrawRectangleLinesEx(backRect, 2, DARKGREEN);
-        DrawText("Back to Tavern", (int)backRect.x + 10, (int)backRect.y + 8, 20, WHITE);
+            Gfx().DrawText("Battle Records", 60, 80, 25, MAROON);
+            Gfx().DrawText(recordsLastMonth ? "[P] Last 30 days" : "[P] All time", 520, 85, 20, GRAY);
 
-        EndDrawing();
+            if (recordsByEnemy.empty()) {
+                Gfx().DrawText("No battles recorded yet.", 70, 120, 20, DARKGRAY);
+            }
+            else {
+                Gfx().DrawText("Enemy", 70, 115, 20, DARKGRAY);
+                Gfx().DrawText("Battles", 250, 115, 20, DARKGRAY);
+                Gfx().DrawText("Win %", 380, 115, 20, DARKGRAY);
+                Gfx().DrawText("Avg turns", 500, 115, 20, DARKGRAY);
+
+                // Enough rows to keep the selection in view
+                int first = std::max(0, recordsSelected - (recordsRows - 1));
+                int last = std::min((int)recordsByEnemy.size(), first + recordsRows);
+                int y = 140;
+                for (int i = first; i < last; ++i, y += 26) {
+                    const StatGroup& row = recordsByEnemy[i];
+                    Rectangle rowRect = { 60.0f, (float)y - 2.0f, 640.0f, 24.0f };
+                    if (i == recordsSelected) Gfx().DrawRectangleRec(rowRect, DARKGOLD);
+                    int turnsTenths = (int)(row.sum * 10 / row.battles);
+                    Gfx().DrawText(battleStats.EnemyName((int)row.key).c_str(), 70, y, 20, BLACK);
+                    Gfx().DrawText(FrameText(row.battles), 250, y, 20, BLACK);
+                    Gfx().DrawText(FrameText(row.wins * 100 / row.battles, "%"), 380, y, 20, BLACK);
+                    Gfx().DrawText(FrameText(turnsTenths / 10, ".", turnsTenths % 10), 500, y, 20, BLACK);
+                }
 
-        if (CheckCollisionPointRec(mousePos, backRect) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            viewing = false;
-        }
-        if (CheckCollisionPointRec(mousePos, renameBtn) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            std::string newName = EnterPlayerName();
-            if (!newName.empty() && newName != player.name) {
-                SetPlayerName(newName);
-                SaveGame();
-                ShowNotification("Nama berhasil diubah!");
+                // Win rate at each player level against the selected enemy
+                Gfx().DrawText(FrameText("Win rate by level vs ", battleStats.EnemyName((int)recordsByEnemy[recordsSelected].key)),
+                    70, 280, 20, DARKGREEN);
+                const int barMaxHeight = 70;
+                const int barBottom = 385;
+                int shown = std::min((int)recordsByLevel.size(), 20);
+                int x = 70;
+                for (int i = (int)recordsByLevel.size() - shown; i < (int)recordsByLevel.size(); ++i, x += 31) {
+                    const StatGroup& level = recordsByLevel[i];
+                    int height = (int)(barMaxHeight * level.wins / level.battles);
+                    Gfx().DrawRectangle(x, barBottom - barMaxHeight, 24, barMaxHeight, LIGHTGRAY);
+                    Gfx().DrawRectangle(x, barBottom - height, 24, height, DARKGREEN);
+                    Gfx().DrawText(FrameText("L", level.key), x, barBottom + 4, 10, BLACK);
+                }
             }
         }
 
-        if (IsKeyPressed(KEY_TAB)) {
-            // Cycle through Stats -> Inventory -> Skills
-            if (currentMenu == SubMenu::Stats) currentMenu = SubMenu::Inventory;
-            else if (currentMenu == SubMenu::Inventory) currentMenu = SubMenu::Skills;
-            else currentMenu = SubMenu::Stats;
-        }
-        else if (IsKeyPressed(KEY_ESCAPE)) {
-            viewing = false;
-        }
+        Color backColor = CheckCollisionPointRec(mousePos, backRect) ? GRAY : DARKGOLD;
+        Gfx().DrawRectangleRec(backRect, backColor);
+        Gfx().DrawRectangleLinesEx(backRect, 2, DARKGREEN);
+        Gfx().DrawText("Back to Tavern", (int)backRect.x + 10, (int)backRect.y + 8, 20, WHITE);
+
+        EndFrame();
     }
 
     // At the end of ShowPlayerStatsAndInventory()
     if (equippedSkillIndex >= 0 && equippedSkillIndex < (int)playerSkills.size()) {
         this->equippedSkillIndex = equippedSkillIndex;
+        JournalStats();
     }
 }
 
 void Game::ShowTrainingGround() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("TrainingGround");
     state = GameState::TrainingGround;
-    while (state == GameState::TrainingGround && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Training Ground (Coming Soon)", 20, 20, 30, DARKGRAY);
-        DrawText("Press any key or click to return to Town.", 20, 80, 20, DARKGRAY);
-        EndDrawing();
-
-        if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_ENTER) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    Rectangle practiceBtn = { 20, 120, 300, 40 };
+    Rectangle backBtn = { 20, 180, 300, 40 };
+
+    while (state == GameState::TrainingGround && !Gfx().ShouldClose()) {
+        Vector2 mousePos = Input::GetMousePosition();
+
+        if (Input::IsKeyPressed(KEY_ONE) ||
+            (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, practiceBtn))) {
+            StartPracticeBattle();
+            return;
+        }
+        if (Input::IsKeyPressed(KEY_TWO) || Input::IsKeyPressed(KEY_ESCAPE) ||
+            (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, backBtn))) {
             ShowTownSquare();
             return;
         }
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Training Ground", 20, 20, 30, DARKGRAY);
+        Gfx().DrawText("Practice battles give no rewards and cost nothing. Press U to undo a turn.", 20, 70, 20, DARKGRAY);
+
+        Color practiceColor = CheckCollisionPointRec(mousePos, practiceBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(practiceBtn, practiceColor);
+        Gfx().DrawText("1. Practice Battle", practiceBtn.x + 10, practiceBtn.y + 10, 20, BLACK);
+
+        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(backBtn, backColor);
+        Gfx().DrawText("2. Back to Town", backBtn.x + 10, backBtn.y + 10, 20, BLACK);
+
+        EndFrame();
     }
 }
 
+// A normal battle except for what it leaves behind: HP and statuses go back to
+// how they were, nothing is won or lost and boosts aren't used up
+void Game::StartPracticeBattle() {
+    InitEnemy();
+    practiceBattle = true;
+    StartBattle();
+    practiceBattle = false;
+}
+
 
 
 void Game::UseItem(size_t index) {
@@ -752,8 +994,7 @@ void Game::UseItem(size_t index) {
 
     if (item.name == "Potion") {
         if (player.currentHP < player.maxHP) {
-            player.currentHP += 20;
-            if (player.currentHP > player.maxHP) player.currentHP = player.maxHP;
+            HealPlayer(20);
             used = true;
             ShowNotification("You used a Potion!");
         }
@@ -763,8 +1004,7 @@ void Game::UseItem(size_t index) {
     }
     else if (item.name == "Hi-Potion") {
         if (player.currentHP < player.maxHP) {
-            player.currentHP += 50;
-            if (player.currentHP > player.maxHP) player.currentHP = player.maxHP;
+            HealPlayer(50);
             used = true;
             ShowNotification("You used a Hi-Potion!");
         }
@@ -774,7 +1014,7 @@ void Game::UseItem(size_t index) {
     }
     else if (item.name == "Elixir") {
         if (player.currentHP < player.maxHP) {
-            player.currentHP = player.maxHP;
+            HealPlayer(player.maxHP);
             used = true;
             ShowNotification("You used an Elixir!");
         }
@@ -783,19 +1023,26 @@ void Game::UseItem(size_t index) {
         }
     }
     else if (item.name == "Antidote") {
-        // Implement poison status if you have it, for now just show notification
-        used = true;
-        ShowNotification("You used an Antidote! (No poison implemented)");
+        if (battleWorld.Has<Poisoned>(playerEntity)) {
+            RemoveStatus(playerEntity, StatusKind::Poison);
+            used = true;
+            ShowNotification("You used an Antidote! Poison cured.");
+        }
+        else {
+            ShowNotification("You are not poisoned!");
+        }
     }
+    // Boosts last until the end of the next battle to finish, so they stack
+    // and one used mid-fight counts for that fight
     else if (item.name == "Attack Up") {
-        player.attack += 5;
+        ApplyStatus(playerEntity, StatusKind::AttackUp, 1, 5);
         used = true;
-        ShowNotification("Attack increased for next battle!");
+        ShowNotification("Attack +5 until the end of your next battle!");
     }
     else if (item.name == "Defense Up") {
-        player.defense += 5;
+        ApplyStatus(playerEntity, StatusKind::DefenseUp, 1, 5);
         used = true;
-        ShowNotification("Defense increased for next battle!");
+        ShowNotification("Defense +5 until the end of your next battle!");
     }
     else if (item.name == "Revive") {
         if (player.currentHP <= 0) {
@@ -808,13 +1055,18 @@ void Game::UseItem(size_t index) {
         }
     }
     else if (item.name == "Speed Boots") {
-        used = true;
-        ShowNotification("Speed increased for next battle! (Effect not implemented)");
+        if (state == GameState::Battle) {
+            ShowNotification("Put them on before a battle!");
+        }
+        else {
+            statuses.Apply(playerEntity, StatusKind::Haste, 1);
+            used = true;
+            ShowNotification("You'll be half again as fast in your next battle!");
+        }
     }
     else if (item.name == "Magic Water") {
-        if (skillOnCooldown) {
-            skillOnCooldown = false;
-            skillCooldownTurns = 0;
+        if (SkillOnCooldown()) {
+            RemoveStatus(playerEntity, StatusKind::SkillCooldown);
             used = true;
             ShowNotification("Skill cooldown reset!");
         }
@@ -824,189 +1076,180 @@ void Game::UseItem(size_t index) {
     }
 
     if (used) {
+        std::string itemName = item.name;
+        FlightRecorder::Record(FlightEvent::Item, 0, 0, itemName.c_str());
         item.quantity--;
         if (item.quantity <= 0) {
             inventory.erase(inventory.begin() + index);
         }
+        if (state == GameState::Battle) {
+            RecordBattleEvent({ BattleEventKind::ItemUsed, BattleSide::Player, StatusKind::Count, 0, 0 });
+            battleTally.items++;
+        }
+        JournalItem(itemName);
+        JournalStats();
     }
 }
 
 
+void Game::BuyShopItem(int index) {
+    if (index < 0 || index >= Content().ShopItemCount()) return;
+    const ShopItemDef& shopItem = Content().ShopItem(index);
+    if (playerCoins < shopItem.price) {
+        ShowNotification("Not enough coins!");
+        return;
+    }
+
+    bool found = false;
+    for (auto& item : inventory) {
+        if (item.name == shopItem.name) {
+            item.quantity++;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        inventory.push_back({ shopItem.name, shopItem.description, 1 });
+    }
+    AddCoins(-shopItem.price);
+    JournalItem(shopItem.name);
+    ShowNotification("Bought " + std::string(shopItem.name) + "!");
+}
+
 void Game::ShowShop() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("Shop");
     state = GameState::Shop;
     int selected = 0;
     int itemsPerPage = 5;
     int currentPage = 0;
-    int totalPages = (shopItemCount + itemsPerPage - 1) / itemsPerPage;
     Rectangle backBtn = { 20.0f, static_cast<float>(screenHeight) - 80.0f, 150.0f, 40.0f };
     Rectangle prevBtn = { 200.0f, static_cast<float>(screenHeight) - 80.0f, 120.0f, 40.0f };
     Rectangle nextBtn = { 340.0f, static_cast<float>(screenHeight) - 80.0f, 100.0f, 40.0f };
 
-    double shopEnterTime = GetTime();
-
-    while (state == GameState::Shop && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        DrawText("Shop", 20, 20, 30, DARKPURPLE);
-        std::string coinsText = "Coins: " + std::to_string(playerCoins);
-        DrawText(coinsText.c_str(), 20, 60, 20, DARKGREEN);
+    double shopEnterTime = Input::GetTime();
 
-        int y = 100;
+    while (state == GameState::Shop && !Gfx().ShouldClose()) {
+        // Stock can change under us when content is hot reloaded
+        int shopItemCount = Content().ShopItemCount();
+        int totalPages = std::max(1, (shopItemCount + itemsPerPage - 1) / itemsPerPage);
+        currentPage = std::min(currentPage, totalPages - 1);
         int itemHeight = 40;
-        Vector2 mousePos = GetMousePosition();
+        Vector2 mousePos = Input::GetMousePosition();
+        bool clicked = Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+        bool canBuy = Input::GetTime() - shopEnterTime > 1.0;
 
         int startIdx = currentPage * itemsPerPage;
         int endIdx = std::min(startIdx + itemsPerPage, shopItemCount);
 
         for (int i = startIdx; i < endIdx; ++i) {
-            int displayIdx = i - startIdx;
-            Rectangle itemRect = { 20.0f, (float)y, 500.0f, (float)itemHeight };
-            bool isHover = CheckCollisionPointRec(mousePos, itemRect);
-            Color clr = (displayIdx == selected || isHover) ? GOLD : BLACK;
-            std::string itemText = shopItems[i].name + " (" + std::to_string(shopItems[i].price) + " coins) - " + shopItems[i].description;
-            DrawText(itemText.c_str(), 20, y, 20, clr);
-
-            if (isHover) selected = displayIdx;
-
-            if (isHover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && (GetTime() - shopEnterTime > 1.0)) {
-                if (playerCoins >= shopItems[i].price) {
-                    bool found = false;
-                    for (auto& item : inventory) {
-                        if (item.name == shopItems[i].name) {
-                            item.quantity++;
-                            found = true;
-                            break;
-                        }
-                    }
-                    if (!found) {
-                        inventory.push_back({ shopItems[i].name, shopItems[i].description, 1 });
-                    }
-                    playerCoins -= shopItems[i].price;
-                    ShowNotification("Bought " + shopItems[i].name + "!");
-                }
-                else {
-                    ShowNotification("Not enough coins!");
-                }
-            }
-            y += itemHeight;
-        }
-
-        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : DARKGRAY;
-        DrawRectangleRec(backBtn, backColor);
-        DrawText("Back", (int)backBtn.x + 10, (int)backBtn.y + 10, 20, WHITE);
-
-        Color nextColor = (currentPage < totalPages - 1 && CheckCollisionPointRec(mousePos, nextBtn)) ? GRAY : DARKGRAY;
-        DrawRectangleRec(nextBtn, nextColor);
-        DrawText("Next", (int)nextBtn.x + 10, (int)nextBtn.y + 10, 20, WHITE);
-
-        Color prevColor = (currentPage > 0 && CheckCollisionPointRec(mousePos, prevBtn)) ? GRAY : DARKGRAY;
-        DrawRectangleRec(prevBtn, prevColor);
-        DrawText("Previous", (int)prevBtn.x + 10, (int)prevBtn.y + 10, 20, WHITE);
-
-        std::string pageText = "Page " + std::to_string(currentPage + 1) + " / " + std::to_string(totalPages);
-        DrawText(pageText.c_str(), 480, screenHeight - 70, 20, DARKGRAY);
-
-        DrawText("Buy: Enter | Back: ESC or Button", 20, screenHeight - 120, 20, DARKGRAY);
-
-        if (GetTime() - shopEnterTime <= 1.0) {
-            DrawText("Please wait...", 350, 60, 20, RED);
+            Rectangle itemRect = { 20.0f, 100.0f + (i - startIdx) * itemHeight, 500.0f, (float)itemHeight };
+            if (!CheckCollisionPointRec(mousePos, itemRect)) continue;
+            selected = i - startIdx;
+            if (clicked && canBuy) BuyShopItem(i);
+            break;
         }
 
-        EndDrawing();
-
-        if (IsKeyPressed(KEY_DOWN)) {
+        if (Input::IsKeyPressed(KEY_DOWN) && endIdx > startIdx) {
             selected = (selected + 1) % (endIdx - startIdx);
         }
-        if (IsKeyPressed(KEY_UP)) {
+        if (Input::IsKeyPressed(KEY_UP) && endIdx > startIdx) {
             selected = (selected + (endIdx - startIdx) - 1) % (endIdx - startIdx);
         }
-        if (IsKeyPressed(KEY_ENTER) && (GetTime() - shopEnterTime > 1.0)) {
-            int i = startIdx + selected;
-            if (playerCoins >= shopItems[i].price) {
-                bool found = false;
-                for (auto& item : inventory) {
-                    if (item.name == shopItems[i].name) {
-                        item.quantity++;
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    inventory.push_back({ shopItems[i].name, shopItems[i].description, 1 });
-                }
-                playerCoins -= shopItems[i].price;
-                ShowNotification("Bought " + shopItems[i].name + "!");
-            }
-            else {
-                ShowNotification("Not enough coins!");
-            }
+        if (Input::IsKeyPressed(KEY_ENTER) && canBuy) {
+            BuyShopItem(startIdx + selected);
         }
-        if (currentPage < totalPages - 1 && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, nextBtn)) {
+        if (currentPage < totalPages - 1 && clicked && CheckCollisionPointRec(mousePos, nextBtn)) {
             currentPage++;
             selected = 0;
         }
-        if (currentPage > 0 && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, prevBtn)) {
+        if (currentPage > 0 && clicked && CheckCollisionPointRec(mousePos, prevBtn)) {
             currentPage--;
             selected = 0;
         }
-        if (IsKeyPressed(KEY_RIGHT) && currentPage < totalPages - 1) {
+        if (Input::IsKeyPressed(KEY_RIGHT) && currentPage < totalPages - 1) {
             currentPage++;
             selected = 0;
         }
-        if (IsKeyPressed(KEY_LEFT) && currentPage > 0) {
+        if (Input::IsKeyPressed(KEY_LEFT) && currentPage > 0) {
             currentPage--;
             selected = 0;
         }
-        if (IsKeyPressed(KEY_ESCAPE) ||
-            (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, backBtn))) {
+        if (Input::IsKeyPressed(KEY_ESCAPE) || (clicked && CheckCollisionPointRec(mousePos, backBtn))) {
             state = GameState::Market;
             return;
         }
-    }
-}
 
-void Game::ShowSkillShop() {
-    int selected = 0;
-    Rectangle backBtn = { 20.0f, static_cast<float>(screenHeight) - 80.0f, 150.0f, 40.0f };
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
 
-    while (!WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Arcane Skill Emporium", 20, 20, 30, DARKMAGENTA);
-        DrawText(("Coins: " + std::to_string(playerCoins)).c_str(), 20, 60, 20, DARKGREEN);
+        Gfx().DrawText("Shop", 20, 20, 30, DARKPURPLE);
+        Gfx().DrawText(FrameText("Coins: ", playerCoins), 20, 60, 20, DARKGREEN);
 
         int y = 100;
-        for (size_t i = 0; i < availableSkills.size(); ++i) {
-            Color color = (i == selected) ? GOLD : BLACK;
-            std::string skillText = availableSkills[i].name + " (" +
-                std::to_string(availableSkills[i].price) + " coins) - " +
-                availableSkills[i].description +
-                (availableSkills[i].owned ? " [Owned]" : "");
-            DrawText(skillText.c_str(), 40, y, 22, color);
-            y += 40;
+        startIdx = currentPage * itemsPerPage;
+        endIdx = std::min(startIdx + itemsPerPage, shopItemCount);
+
+        for (int i = startIdx; i < endIdx; ++i) {
+            int displayIdx = i - startIdx;
+            Rectangle itemRect = { 20.0f, (float)y, 500.0f, (float)itemHeight };
+            bool isHover = CheckCollisionPointRec(mousePos, itemRect);
+            Color clr = (displayIdx == selected || isHover) ? GOLD : BLACK;
+            const ShopItemDef& shopItem = Content().ShopItem(i);
+            Gfx().DrawText(FrameText(shopItem.name, " (", shopItem.price, " coins) - ", shopItem.description), 20, y, 20, clr);
+            y += itemHeight;
         }
 
-        // Draw Back button
-        Vector2 mousePos = GetMousePosition();
         Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : DARKGRAY;
-        DrawRectangleRec(backBtn, backColor);
-        DrawText("Back", (int)backBtn.x + 10, (int)backBtn.y + 10, 20, WHITE);
+        Gfx().DrawRectangleRec(backBtn, backColor);
+        Gfx().DrawText("Back", (int)backBtn.x + 10, (int)backBtn.y + 10, 20, WHITE);
+
+        Color nextColor = (currentPage < totalPages - 1 && CheckCollisionPointRec(mousePos, nextBtn)) ? GRAY : DARKGRAY;
+        Gfx().DrawRectangleRec(nextBtn, nextColor);
+        Gfx().DrawText("Next", (int)nextBtn.x + 10, (int)nextBtn.y + 10, 20, WHITE);
+
+        Color prevColor = (currentPage > 0 && CheckCollisionPointRec(mousePos, prevBtn)) ? GRAY : DARKGRAY;
+        Gfx().DrawRectangleRec(prevBtn, prevColor);
+        Gfx().DrawText("Previous", (int)prevBtn.x + 10, (int)prevBtn.y + 10, 20, WHITE);
 
-        DrawText("Buy: Enter | Back: ESC or Button", 20, y + 20, 20, DARKGRAY);
-        EndDrawing();
+        Gfx().DrawText(FrameText("Page ", currentPage + 1, " / ", totalPages), 480, screenHeight - 70, 20, DARKGRAY);
 
-        if (IsKeyPressed(KEY_DOWN)) selected = (selected + 1) % availableSkills.size();
-        if (IsKeyPressed(KEY_UP)) selected = (selected + availableSkills.size() - 1) % availableSkills.size();
-        if (IsKeyPressed(KEY_ENTER)) {
+        Gfx().DrawText("Buy: Enter | Back: ESC or Button", 20, screenHeight - 120, 20, DARKGRAY);
+
+        if (!canBuy) {
+            Gfx().DrawText("Please wait...", 350, 60, 20, RED);
+        }
+
+        EndFrame();
+    }
+}
+
+void Game::ShowSkillShop() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("SkillShop");
+    int selected = 0;
+    Rectangle backBtn = { 20.0f, static_cast<float>(screenHeight) - 80.0f, 150.0f, 40.0f };
+
+    while (!Gfx().ShouldClose()) {
+        if (contentGeneration != Content().Generation()) {
+            RefreshSkillsFromContent();
+            selected = std::min(selected, std::max(0, (int)availableSkills.size() - 1));
+        }
+
+        Vector2 mousePos = Input::GetMousePosition();
+        int skillCount = (int)availableSkills.size();
+        if (Input::IsKeyPressed(KEY_DOWN) && skillCount > 0) selected = (selected + 1) % skillCount;
+        if (Input::IsKeyPressed(KEY_UP) && skillCount > 0) selected = (selected + skillCount - 1) % skillCount;
+        if (Input::IsKeyPressed(KEY_ENTER) && skillCount > 0) {
             Skill& skill = availableSkills[selected];
             if (skill.owned) {
                 ShowNotification("You already own this skill!");
             }
             else if (playerCoins >= skill.price) {
-                playerCoins -= skill.price;
+                AddCoins(-skill.price);
                 skill.owned = true;
                 playerSkills.push_back(skill);
+                JournalSkill(skill.name);
                 ShowNotification("You bought " + skill.name + "!");
             }
             else {
@@ -1014,121 +1257,233 @@ void Game::ShowSkillShop() {
             }
         }
         // Back with ESC or button
-        if (IsKeyPressed(KEY_ESCAPE) ||
-            (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, backBtn))) {
+        if (Input::IsKeyPressed(KEY_ESCAPE) ||
+            (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, backBtn))) {
             break;
         }
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Arcane Skill Emporium", 20, 20, 30, DARKMAGENTA);
+        Gfx().DrawText(FrameText("Coins: ", playerCoins), 20, 60, 20, DARKGREEN);
+
+        int y = 100;
+        for (size_t i = 0; i < availableSkills.size(); ++i) {
+            Color color = (i == selected) ? GOLD : BLACK;
+            const char* owned = availableSkills[i].owned ? " [Owned]" : "";
+            Gfx().DrawText(FrameText(availableSkills[i].name, " (", availableSkills[i].price, " coins) - ",
+                availableSkills[i].description, owned), 40, y, 22, color);
+            y += 40;
+        }
+
+        // Draw Back button
+        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : DARKGRAY;
+        Gfx().DrawRectangleRec(backBtn, backColor);
+        Gfx().DrawText("Back", (int)backBtn.x + 10, (int)backBtn.y + 10, 20, WHITE);
+
+        Gfx().DrawText("Buy: Enter | Back: ESC or Button", 20, y + 20, 20, DARKGRAY);
+        EndFrame();
     }
 }
 
 void Game::ShowSkillsMenu() {
-    bool viewing = true;
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("SkillsMenu");
     int selectedSkillIndex = 0;
     Rectangle backRect = { 20, static_cast<float>(screenHeight - 50), 180, 35 };
 
-    while (viewing && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-
-        DrawText("Skills (Select to Equip for Battle)", 60, 40, 28, DARKMAGENTA);
-
-        Vector2 mousePos = GetMousePosition();
-
-        int y = 100;
+    while (!Gfx().ShouldClose()) {
+        Vector2 mousePos = Input::GetMousePosition();
         int skillHeight = 35;
-        if (playerSkills.empty()) {
-            DrawText("You don't own any skills yet.", 70, y, 22, DARKGRAY);
-        }
-        else {
-            for (size_t i = 0; i < playerSkills.size(); ++i) {
-                Rectangle skillRect = { 60.0f, (float)y, 600.0f, (float)skillHeight };
-                bool isHover = CheckCollisionPointRec(mousePos, skillRect);
-                Color bgColor = (i == selectedSkillIndex || isHover) ? DARKGOLD : CLITERAL(Color) { 220, 220, 220, 255 };
-                DrawRectangleRec(skillRect, bgColor);
-                DrawRectangleLinesEx(skillRect, 1, DARKMAGENTA);
-
-                std::string skillText = playerSkills[i].name + " - " + playerSkills[i].description;
-                if ((int)i == equippedSkillIndex) skillText += " [EQUIPPED]";
-                DrawText(skillText.c_str(), 70, y + 7, 20, BLACK);
 
-                if (isHover) selectedSkillIndex = (int)i;
-                if (isHover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (!playerSkills.empty()) {
+            for (size_t i = 0; i < playerSkills.size(); ++i) {
+                Rectangle skillRect = { 60.0f, 100.0f + i * (skillHeight + 8.0f), 600.0f, (float)skillHeight };
+                if (!CheckCollisionPointRec(mousePos, skillRect)) continue;
+                selectedSkillIndex = (int)i;
+                if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
                     equippedSkillIndex = (int)i;
                     ShowNotification("Equipped skill: " + playerSkills[i].name);
                 }
-
-                y += skillHeight + 8;
+                break;
             }
 
             // Keyboard navigation
-            if (IsKeyPressed(KEY_DOWN)) {
+            if (Input::IsKeyPressed(KEY_DOWN)) {
                 selectedSkillIndex = (selectedSkillIndex + 1) % playerSkills.size();
             }
-            else if (IsKeyPressed(KEY_UP)) {
+            else if (Input::IsKeyPressed(KEY_UP)) {
                 selectedSkillIndex = (selectedSkillIndex + playerSkills.size() - 1) % playerSkills.size();
             }
-            else if (IsKeyPressed(KEY_ENTER)) {
+            else if (Input::IsKeyPressed(KEY_ENTER)) {
                 equippedSkillIndex = selectedSkillIndex;
                 ShowNotification("Equipped skill: " + playerSkills[equippedSkillIndex].name);
             }
         }
 
-        // Draw Back button
-        Color backColor = CheckCollisionPointRec(mousePos, backRect) ? GRAY : DARKGOLD;
-        DrawRectangleRec(backRect, backColor);
-        DrawRectangleLinesEx(backRect, 2, DARKGREEN);
-        DrawText("Back", (int)backRect.x + 10, (int)backRect.y + 8, 20, WHITE);
+        if (CheckCollisionPointRec(mousePos, backRect) && Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            break;
+        }
+        if (Input::IsKeyPressed(KEY_ESCAPE)) {
+            break;
+        }
 
-        EndDrawing();
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
 
-        if (CheckCollisionPointRec(mousePos, backRect) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            viewing = false;
+        Gfx().DrawText("Skills (Select to Equip for Battle)", 60, 40, 28, DARKMAGENTA);
+
+        int y = 100;
+        if (playerSkills.empty()) {
+            Gfx().DrawText("You don't own any skills yet.", 70, y, 22, DARKGRAY);
         }
-        if (IsKeyPressed(KEY_ESCAPE)) {
-            viewing = false;
+        else {
+            for (size_t i = 0; i < playerSkills.size(); ++i) {
+                Rectangle skillRect = { 60.0f, (float)y, 600.0f, (float)skillHeight };
+                bool isHover = CheckCollisionPointRec(mousePos, skillRect);
+                Color bgColor = (i == selectedSkillIndex || isHover) ? DARKGOLD : CLITERAL(Color) { 220, 220, 220, 255 };
+                Gfx().DrawRectangleRec(skillRect, bgColor);
+                Gfx().DrawRectangleLinesEx(skillRect, 1, DARKMAGENTA);
+
+                const char* equipped = (int)i == equippedSkillIndex ? " [EQUIPPED]" : "";
+                Gfx().DrawText(FrameText(playerSkills[i].name, " - ", playerSkills[i].description, equipped), 70, y + 7, 20, BLACK);
+
+                y += skillHeight + 8;
+            }
         }
+
+        // Draw Back button
+        Color backColor = CheckCollisionPointRec(mousePos, backRect) ? GRAY : DARKGOLD;
+        Gfx().DrawRectangleRec(backRect, backColor);
+        Gfx().DrawRectangleLinesEx(backRect, 2, DARKGREEN);
+        Gfx().DrawText("Back", (int)backRect.x + 10, (int)backRect.y + 8, 20, WHITE);
+
+        EndFrame();
     }
+    JournalStats();
 }
 
 void Game::StartBattle() {
+    MEMORY_SCOPE(Battle);
     state = GameState::Battle;
     selectedAction = 0;
-    attackEffectFrame = 0;
-    showAttackEffect = false;
+    animations.Clear();
     isPlayerTurn = true;
-    isBlocking = false;
-    skillCooldownTurns = 0; // Reset cooldown saat mulai battle
-    skillOnCooldown = false;
+    playerActionRank = RANK_NORMAL;
+    statuses.Remove(playerEntity, StatusKind::Blocking);
+    statuses.Remove(playerEntity, StatusKind::SkillCooldown); // Reset cooldown saat mulai battle
+    battleLog.clear();
+    ResetInitiative();
+    BeginBattleEvents();
+    turnSnapshots.Clear();
+    haveQuickSave = false;
+    battleTally = BattleRecord();
+    battleTally.enemy = enemy.name;
+    battleTally.enemyLevel = enemy.level;
+    if (battleWorld.Has<Hasted>(playerEntity)) {
+        ShowNotification("Speed Boots: you're half again as fast!");
+    }
+    StartPlayerTurn();
+    RunBattle();
+}
+
+// The battle the game was closed in, from battle.sav
+void Game::ResumeBattle() {
+    MEMORY_SCOPE(Battle);
+    if (!resumeBattle) return;
+    resumeBattle = false;
+    std::remove(BATTLE_PATH); // a crash from here on doesn't bring it back twice
+    state = GameState::Battle;
+    selectedAction = 0;
+    animations.Clear();
     battleLog.clear();
+    ResetEnemyEntity();
+    RestoreSnapshot(suspendedBattle);
+    BeginBattleEvents();
+    turnSnapshots.Clear();
+    haveQuickSave = false;
+    BattleSnapshot snapshot;
+    TakeSnapshot(snapshot);
+    turnSnapshots.Push(snapshot);
+    // Counted from here: what was done before the game closed isn't kept
+    battleTally = BattleRecord();
+    battleTally.enemy = enemy.name;
+    battleTally.enemyLevel = enemy.level;
+    ShowNotification("Battle resumed.");
+    RunBattle();
+}
 
-    while (state == GameState::Battle && !WindowShouldClose()) {
+void Game::RunBattle() {
+    MEMORY_SCOPE(Battle);
+    ScreenScope screen("Battle");
+    BattleState start = battleEvents.State();
+    RefreshWinChance();
+
+    while (state == GameState::Battle && !Gfx().ShouldClose()) {
+        animClock.Advance(Input::GetFrameTime());
         UpdateBattle();
+        animations.EaseTo(ANIM_PLAYER_HP, (float)player.currentHP / player.maxHP, 0.4f, animClock.Now());
+        animations.EaseTo(ANIM_ENEMY_HP, (float)enemy.currentHP / enemy.maxHP, 0.4f, animClock.Now());
+        animations.Update(animClock.Now());
 
-        BeginDrawing();
-        ClearBackground(BEIGE);
+        BeginFrame();
+        Gfx().ClearBackground(BEIGE);
         DrawBattle();
-        DrawAttackEffect();
-        EndDrawing();
+        animations.Draw(screenWidth, screenHeight);
+        EndFrame();
+    }
+
+    if (practiceBattle) {
+        RestoreBattleState(start);
+    }
+    else if (state == GameState::Battle) {
+        // Closed mid-fight: ResumeBattle picks it up on the next start, boosts and all
+        BattleSnapshot snapshot;
+        TakeSnapshot(snapshot);
+        WriteBattleSnapshot(BATTLE_PATH, snapshot);
     }
+    else {
+        statusEvents.clear();
+        statuses.EndBattle(statusEvents);
+        ReportStatusEvents();
+    }
+
+    // Persist HP/EXP/level changes from the fight
+    JournalStats();
 }
 
 void Game::UpdateBattle() {
+    PROFILE_ZONE("UpdateBattle");
+    MEMORY_SCOPE(Battle);
     const char* actions[5] = { "Attack", "Skill", "Block", "Item", "Run" };
-    Vector2 mousePos = GetMousePosition();
+    Vector2 mousePos = Input::GetMousePosition();
+
+    if (practiceBattle && isPlayerTurn && Input::IsKeyPressed(KEY_U)) {
+        UndoLastTurn();
+    }
+    if (Input::IsKeyPressed(KEY_F5)) {
+        TakeSnapshot(quickSave);
+        haveQuickSave = true;
+        ShowNotification("Quicksaved.");
+    }
+    else if (Input::IsKeyPressed(KEY_F8)) {
+        QuickLoad();
+    }
 
-    // Keyboard navigation
-    if (IsKeyPressed(KEY_DOWN)) {
+    // Keyboard navigation, skipping Skill while it is on cooldown or none is equipped
+    bool canUseSkill = !SkillOnCooldown() && equippedSkillIndex >= 0 && equippedSkillIndex < (int)playerSkills.size();
+    if (Input::IsKeyPressed(KEY_DOWN)) {
         do {
             selectedAction = (selectedAction + 1) % 5;
-        } while (selectedAction == 1 && skillOnCooldown); // Skip Skill if on cooldown
+        } while (selectedAction == 1 && !canUseSkill);
     }
-    else if (IsKeyPressed(KEY_UP)) {
+    else if (Input::IsKeyPressed(KEY_UP)) {
         do {
             selectedAction = (selectedAction + 4) % 5;
-        } while (selectedAction == 1 && skillOnCooldown); // Skip Skill if on cooldown
+        } while (selectedAction == 1 && !canUseSkill);
     }
-    else if (IsKeyPressed(KEY_ENTER)) {
-        if (isPlayerTurn && !(selectedAction == 1 && skillOnCooldown)) {
+    else if (Input::IsKeyPressed(KEY_ENTER)) {
+        if (isPlayerTurn && !(selectedAction == 1 && SkillOnCooldown())) {
             PerformPlayerAction(selectedAction);
             CheckBattleResult();
             if (state != GameState::Battle)
@@ -1141,11 +1496,11 @@ void Game::UpdateBattle() {
 
     // Mouse click support for action selection
     for (int i = 0; i < 5; i++) {
-        Rectangle actionRect = { 20.0f, static_cast<float>(screenHeight - 150 + i * 30), MeasureText(actions[i], 20), 30.0f };
+        Rectangle actionRect = { 20.0f, static_cast<float>(screenHeight - 150 + i * 30), Gfx().MeasureText(actions[i], 20), 30.0f };
         if (CheckCollisionPointRec(mousePos, actionRect)) {
-            if (!(i == 1 && skillOnCooldown)) { // Only allow hover/select if not disabled
+            if (!(i == 1 && SkillOnCooldown())) { // Only allow hover/select if not disabled
                 selectedAction = i;
-                if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && isPlayerTurn) {
+                if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && isPlayerTurn) {
                     PerformPlayerAction(selectedAction);
                     CheckBattleResult();
                     if (state != GameState::Battle)
@@ -1158,54 +1513,52 @@ void Game::UpdateBattle() {
     }
 
     if (!isPlayerTurn && state == GameState::Battle) {
-        if (!skipEnemyTurn) {
+        // The enemy goes until the player's wait runs out again: not at all
+        // after an item, once at even speeds, less often against a hasted player
+        TakeTurn(BattleSide::Player, playerActionRank);
+        while (initiative.Next() != static_cast<int>(BattleSide::Player)) {
             EnemyAttack();
             CheckBattleResult();
             if (state != GameState::Battle)
                 return;
+            TakeTurn(BattleSide::Enemy, RANK_NORMAL);
 
-            // === Turunkan cooldown player skill ===
-            if (skillOnCooldown) {
-                skillCooldownTurns--;
-                if (skillCooldownTurns <= 0) {
-                    skillOnCooldown = false;
-                    ShowNotification("Skill ready to use!");
-                }
-            }
-
-            // === Turunkan cooldown musuh skill ===
-            if (enemySkillCooldown > 0) {
-                enemySkillCooldown--;
-            }
+            // === Akhir giliran: poison, block, cooldown ===
+            RecordBattleEvent({ BattleEventKind::TurnEnded, BattleSide::Player, StatusKind::Count, 0, 0 });
+            statusEvents.clear();
+            statuses.EndTurn(statusEvents);
+            ReportStatusEvents();
+            CheckBattleResult();
+            if (state != GameState::Battle)
+                return;
         }
         isPlayerTurn = true;
-        skipEnemyTurn = false;
-    }
-    bool canUseSkill = !skillOnCooldown && equippedSkillIndex >= 0 && equippedSkillIndex < (int)playerSkills.size();
-    if (IsKeyPressed(KEY_DOWN)) {
-        do {
-            selectedAction = (selectedAction + 1) % 5;
-        } while (selectedAction == 1 && !canUseSkill);
+        StartPlayerTurn();
+        RefreshWinChance();
     }
-    else if (IsKeyPressed(KEY_UP)) {
-        do {
-            selectedAction = (selectedAction + 4) % 5;
-        } while (selectedAction == 1 && !canUseSkill);
-    }
-
+}
 
 
-    if (showAttackEffect) {
-        attackEffectFrame++;
-        if (attackEffectFrame > 30) {
-            showAttackEffect = false;
-            attackEffectFrame = 0;
-        }
-    }
+// area grown to take in text drawn at (x, y)
+static Rectangle CoverText(Rectangle area, const char* text, int x, int y, int fontSize) {
+    float right = std::max(area.x + area.width, (float)(x + Gfx().MeasureText(text, fontSize) + 1));
+    float bottom = std::max(area.y + area.height, (float)(y + fontSize));
+    area.x = std::min(area.x, (float)x);
+    area.y = std::min(area.y, (float)y);
+    area.width = right - area.x;
+    area.height = bottom - area.y;
+    return area;
 }
 
+static int64_t ColorKey(Color color) {
+    return (int64_t)color.r << 24 | color.g << 16 | color.b << 8 | color.a;
+}
 
+// Everything but the attack effect is cached in battleLayers and drawn again
+// only when what it shows changes; most frames this is one quad.
 void Game::DrawBattle() {
+    PROFILE_ZONE("DrawBattle");
+    MEMORY_SCOPE(UI);
 
     float desiredHeight = 200.0f; // Target height in pixels for both textures
     float scale = desiredHeight / 3000.0f; // 3000 is the original texture height
@@ -1219,47 +1572,119 @@ void Game::DrawBattle() {
     float enemyX = (float)screenWidth - 60.0f - desiredHeight; // 60px from right, width = desiredHeight
     float enemyY = (float)screenHeight / 2.0f - desiredHeight / 2.0f;
 
-    DrawTexture(battleBgTexture, -120, -500, WHITE);
+    // Background and both sprites, over what RunBattle clears to
+    LayerStamp backdrop;
+    backdrop.Add(battleBgTexture.id).Add(characterTexture.id).Add(enemyTexture.id);
+    if (battleLayers.BackdropDirty(backdrop.hash)) {
+        battleLayers.BeginBackdrop(backdrop.hash);
+        Gfx().ClearBackground(BEIGE);
+        Gfx().DrawTexture(battleBgTexture, -120, -500, WHITE);
 
-    // Draw player texture
-    DrawTextureEx(characterTexture, Vector2{ playerX, playerY }, 0.0f, scale, WHITE);
+        // Draw player texture
+        Gfx().DrawTextureEx(characterTexture, Vector2{ playerX, playerY }, 0.0f, scale, WHITE);
 
-    // Draw enemy texture
-    DrawTextureEx(enemyTexture, Vector2{ enemyX, enemyY }, 0.0f, scale, WHITE);
+        // Draw enemy texture
+        Gfx().DrawTextureEx(enemyTexture, Vector2{ enemyX, enemyY }, 0.0f, scale, WHITE);
+        battleLayers.EndBackdrop();
+    }
 
     // Player Info Background
     int playerInfoWidth = 320;
     int playerInfoHeight = infoFontSize * 3 + infoPadding * 4;
-    DrawRectangle(10, 10, playerInfoWidth, playerInfoHeight, Fade(BLACK, 0.4f));
-
-    // Player Name & Level
-    std::string playerLvl = player.name + " - Lvl " + std::to_string(player.level);
-    DrawText(playerLvl.c_str(), 20, 20, infoFontSize, SKYBLUE);
-
-    // Player HP
-    std::string playerHP = "HP: " + std::to_string(player.currentHP) + "/" + std::to_string(player.maxHP);
-    DrawText(playerHP.c_str(), 20, 20 + infoFontSize + infoPadding, infoFontSize, LIME);
+    LayerStamp playerStamp;
+    playerStamp.Add(player.name).Add(player.level).Add(player.currentHP).Add(player.maxHP)
+        .Add(player.exp).Add(player.expToLevel);
+    if (battleLayers.PanelDirty(PANEL_PLAYER, playerStamp.hash)) {
+        const char* nameText = FrameText(player.name, " - Lvl ", player.level);
+        const char* hpText = FrameText("HP: ", player.currentHP, "/", player.maxHP);
+        const char* expText = FrameText("EXP: ", player.exp, "/", player.expToLevel);
+        Rectangle area = { 10.0f, 10.0f, (float)playerInfoWidth, (float)playerInfoHeight };
+        area = CoverText(area, nameText, 20, 20, infoFontSize);
+        area = CoverText(area, hpText, 20, 20 + infoFontSize + infoPadding, infoFontSize);
+        area = CoverText(area, expText, 20, 20 + (infoFontSize + infoPadding) * 2, infoFontSize);
+
+        battleLayers.BeginPanel(PANEL_PLAYER, playerStamp.hash, area);
+        Gfx().DrawRectangle(10, 10, playerInfoWidth, playerInfoHeight, Fade(BLACK, 0.4f));
+
+        // Player Name & Level
+        Gfx().DrawText(nameText, 20, 20, infoFontSize, SKYBLUE);
+
+        // Player HP
+        Gfx().DrawText(hpText, 20, 20 + infoFontSize + infoPadding, infoFontSize, LIME);
+
+        // Player EXP
+        Gfx().DrawText(expText, 20, 20 + (infoFontSize + infoPadding) * 2, infoFontSize, GREEN);
+        battleLayers.EndPanel();
+    }
 
-    // Player EXP
-    std::string expText = "EXP: " + std::to_string(player.exp) + "/" + std::to_string(player.expToLevel);
-    DrawText(expText.c_str(), 20, 20 + (infoFontSize + infoPadding) * 2, infoFontSize, GREEN);
+    // Turn order from now on, if the highlighted action is the one taken
+    const int TURN_PREVIEW = 6;
+    int order[TURN_PREVIEW];
+    int orderCount = initiative.Preview(order, TURN_PREVIEW, ActionRank(selectedAction));
+    LayerStamp turnStamp;
+    turnStamp.Add(practiceBattle).Add(enemy.name).Add(orderCount);
+    for (int i = 0; i < orderCount; ++i) turnStamp.Add(order[i]);
+    if (battleLayers.PanelDirty(PANEL_TURNS, turnStamp.hash)) {
+        const char* hint = practiceBattle ? "U: undo  F5/F8: quicksave/load" : "F5: quicksave  F8: quickload";
+        int orderY = 20 + playerInfoHeight + 26;
+        Rectangle area = CoverText(Rectangle{ 20.0f, (float)(20 + playerInfoHeight), 0.0f, 0.0f },
+            hint, 20, 20 + playerInfoHeight, 20);
+        int orderX = 20;
+        area = CoverText(area, "Turns:", orderX, orderY, 20);
+        orderX += Gfx().MeasureText("Turns:", 20) + 10;
+        for (int i = 0; i < orderCount; ++i) {
+            const char* name = order[i] == static_cast<int>(BattleSide::Player) ? "You" : enemy.name.c_str();
+            area = CoverText(area, name, orderX, orderY, 20);
+            orderX += Gfx().MeasureText(name, 20) + 12;
+        }
+
+        battleLayers.BeginPanel(PANEL_TURNS, turnStamp.hash, area);
+        Gfx().DrawText(hint, 20, 20 + playerInfoHeight, 20, GOLD);
+
+        orderX = 20;
+        Gfx().DrawText("Turns:", orderX, orderY, 20, DARKGRAY);
+        orderX += Gfx().MeasureText("Turns:", 20) + 10;
+        for (int i = 0; i < orderCount; ++i) {
+            bool mine = order[i] == static_cast<int>(BattleSide::Player);
+            const char* name = mine ? "You" : enemy.name.c_str();
+            Gfx().DrawText(name, orderX, orderY, 20, mine ? SKYBLUE : ORANGE);
+            orderX += Gfx().MeasureText(name, 20) + 12;
+        }
+        battleLayers.EndPanel();
+    }
 
     // Enemy Info Background
     int enemyInfoWidth = 320;
-    int enemyInfoHeight = infoFontSize * 2 + infoPadding * 3;
+    int enemyInfoHeight = infoFontSize * 3 + infoPadding * 4;
     int enemyInfoX = screenWidth - enemyInfoWidth - 10;
-    DrawRectangle(enemyInfoX, 10, enemyInfoWidth, enemyInfoHeight, Fade(BLACK, 0.4f));
-
-    // Enemy Name & Level
-    std::string enemyLvl = enemy.name + " Lvl " + std::to_string(enemy.level);
-    DrawText(enemyLvl.c_str(), enemyInfoX + 10, 20, infoFontSize, ORANGE);
-
-    // Enemy HP
-    std::string enemyHP = "HP: " + std::to_string(enemy.currentHP) + "/" + std::to_string(enemy.maxHP);
-    DrawText(enemyHP.c_str(), enemyInfoX + 10, 20 + infoFontSize + infoPadding, infoFontSize, LIME);
+    // Chance the player wins from here, attacking and using the skill when ready
+    int winPercent = static_cast<int>(winOdds.winChance * 100.0 + 0.5);
+    LayerStamp enemyStamp;
+    enemyStamp.Add(enemy.name).Add(enemy.level).Add(enemy.currentHP).Add(enemy.maxHP).Add(winPercent);
+    if (battleLayers.PanelDirty(PANEL_ENEMY, enemyStamp.hash)) {
+        const char* nameText = FrameText(enemy.name, " Lvl ", enemy.level);
+        const char* hpText = FrameText("HP: ", enemy.currentHP, "/", enemy.maxHP);
+        const char* winText = FrameText("Win chance: ", winPercent, "%");
+        Rectangle area = { (float)enemyInfoX, 10.0f, (float)enemyInfoWidth, (float)enemyInfoHeight };
+        area = CoverText(area, nameText, enemyInfoX + 10, 20, infoFontSize);
+        area = CoverText(area, hpText, enemyInfoX + 10, 20 + infoFontSize + infoPadding, infoFontSize);
+        area = CoverText(area, winText, enemyInfoX + 10, 20 + (infoFontSize + infoPadding) * 2, infoFontSize);
+
+        battleLayers.BeginPanel(PANEL_ENEMY, enemyStamp.hash, area);
+        Gfx().DrawRectangle(enemyInfoX, 10, enemyInfoWidth, enemyInfoHeight, Fade(BLACK, 0.4f));
+
+        // Enemy Name & Level
+        Gfx().DrawText(nameText, enemyInfoX + 10, 20, infoFontSize, ORANGE);
+
+        // Enemy HP
+        Gfx().DrawText(hpText, enemyInfoX + 10, 20 + infoFontSize + infoPadding, infoFontSize, LIME);
+
+        Gfx().DrawText(winText, enemyInfoX + 10, 20 + (infoFontSize + infoPadding) * 2, infoFontSize, GOLD);
+        battleLayers.EndPanel();
+    }
 
     const char* actions[5] = { "Attack", "Skill", "Block", "Item", "Run" };
-    Vector2 mousePos = GetMousePosition();
+    Vector2 mousePos = Input::GetMousePosition();
 
     // Draw battle log (bottom right)
     int logFontSize = 16;               // Sedikit lebih besar agar lebih mudah dibaca
@@ -1268,71 +1693,106 @@ void Game::DrawBattle() {
     int logBoxHeight = BATTLE_LOG_MAX_LINES * logLineHeight + 30;
     int logBoxX = screenWidth - logBoxWidth - 20;
     int logBoxY = screenHeight - logBoxHeight - 20;
-
-    // Draw background box
-    DrawRectangle(logBoxX, logBoxY, logBoxWidth, logBoxHeight, Fade(DARKGRAY, 0.7f));
-
-    // Draw log title
-    DrawText("Battle Log", logBoxX + 10, logBoxY + 4, logFontSize, GOLD);
-
-    // Draw log lines
-    int y = logBoxY + 8 + logLineHeight;
-    for (const auto& line : battleLog) {
-        DrawText(line.c_str(), logBoxX + 10, y, logFontSize, WHITE);
-        y += logLineHeight;
+    LayerStamp logStamp;
+    for (const auto& line : battleLog) logStamp.Add(line);
+    if (battleLayers.PanelDirty(PANEL_LOG, logStamp.hash)) {
+        Rectangle area = { (float)logBoxX, (float)logBoxY, (float)logBoxWidth, (float)logBoxHeight };
+        area = CoverText(area, "Battle Log", logBoxX + 10, logBoxY + 4, logFontSize);
+        int y = logBoxY + 8 + logLineHeight;
+        for (const auto& line : battleLog) {
+            area = CoverText(area, line.c_str(), logBoxX + 10, y, logFontSize);
+            y += logLineHeight;
+        }
+
+        battleLayers.BeginPanel(PANEL_LOG, logStamp.hash, area);
+        // Draw background box
+        Gfx().DrawRectangle(logBoxX, logBoxY, logBoxWidth, logBoxHeight, Fade(DARKGRAY, 0.7f));
+
+        // Draw log title
+        Gfx().DrawText("Battle Log", logBoxX + 10, logBoxY + 4, logFontSize, GOLD);
+
+        // Draw log lines
+        y = logBoxY + 8 + logLineHeight;
+        for (const auto& line : battleLog) {
+            Gfx().DrawText(line.c_str(), logBoxX + 10, y, logFontSize, WHITE);
+            y += logLineHeight;
+        }
+        battleLayers.EndPanel();
     }
 
-    // Draw action box background
-    int actionBoxX = 10;
-    int actionBoxY = screenHeight - 160;
-    int actionBoxWidth = 180;
-    int actionBoxHeight = 5 * 30 + 20;
-    DrawRectangle(actionBoxX, actionBoxY, actionBoxWidth, actionBoxHeight, Fade(DARKGRAY, 0.7f));
-
-    // Draw action buttons
+    // Action colors first, the action panel's stamp is made from them. Hovering
+    // already selected in UpdateBattle
+    Color actionColors[5];
+    bool skillDisabled = SkillOnCooldown();
     for (int i = 0; i < 5; i++) {
         int actionY = screenHeight - 150 + i * 30;
-        Color clr;
         bool isSkill = (i == 1);
-        bool disabled = isSkill && skillOnCooldown;
+        bool disabled = isSkill && skillDisabled;
 
         // Highlight if selected and not disabled, or mouse hover and not disabled
-        Rectangle actionRect = { 20.0f, (float)actionY, MeasureText(actions[i], 20), 30.0f };
+        Rectangle actionRect = { 20.0f, (float)actionY, (float)Gfx().MeasureText(actions[i], 20), 30.0f };
         bool isMouseHover = CheckCollisionPointRec(mousePos, actionRect);
 
         if (disabled) {
-            clr = GRAY;
+            actionColors[i] = GRAY;
         }
         else if (isMouseHover) {
-            clr = GOLD;
-            selectedAction = i;
+            actionColors[i] = GOLD;
         }
         else {
-            clr = (i == selectedAction) ? DARKGOLD : BLACK;
+            actionColors[i] = (i == selectedAction) ? DARKGOLD : BLACK;
         }
+    }
 
-        DrawText(actions[i], (int)actionRect.x, (int)actionRect.y, 20, clr);
+    // Draw action box background
+    int actionBoxX = 10;
+    int actionBoxY = screenHeight - 160;
+    int actionBoxWidth = 180;
+    int actionBoxHeight = 5 * 30 + 20;
+    int cooldownTurns = skillDisabled ? SkillCooldownTurns() : 0;
+    LayerStamp actionStamp;
+    actionStamp.Add(skillDisabled).Add(cooldownTurns);
+    for (Color color : actionColors) actionStamp.Add(ColorKey(color));
+    if (battleLayers.PanelDirty(PANEL_ACTIONS, actionStamp.hash)) {
+        const char* cooldownText = FrameText(" (", cooldownTurns, ")");
+        int cooldownX = 20 + Gfx().MeasureText("Skill", 20) + 10;
+        int cooldownY = screenHeight - 150 + 30;
+        Rectangle area = { (float)actionBoxX, (float)actionBoxY, (float)actionBoxWidth, (float)actionBoxHeight };
+        for (int i = 0; i < 5; i++) area = CoverText(area, actions[i], 20, screenHeight - 150 + i * 30, 20);
+        if (skillDisabled) area = CoverText(area, cooldownText, cooldownX, cooldownY, 20);
+
+        battleLayers.BeginPanel(PANEL_ACTIONS, actionStamp.hash, area);
+        Gfx().DrawRectangle(actionBoxX, actionBoxY, actionBoxWidth, actionBoxHeight, Fade(DARKGRAY, 0.7f));
+
+        // Draw action buttons
+        for (int i = 0; i < 5; i++) {
+            Gfx().DrawText(actions[i], 20, screenHeight - 150 + i * 30, 20, actionColors[i]);
+        }
 
         // Draw cooldown info next to Skill
-        if (isSkill && skillOnCooldown) {
-            std::string cooldownText = " (" + std::to_string(skillCooldownTurns) + ")";
-            int actionX = 20 + MeasureText("Skill", 20) + 10;
-            DrawText(cooldownText.c_str(), actionX, actionY, 20, DARKRED);
+        if (skillDisabled) {
+            Gfx().DrawText(cooldownText, cooldownX, cooldownY, 20, DARKRED);
         }
+        battleLayers.EndPanel();
     }
 
-
-
-    if (skillOnCooldown) {
-        int skillIdx = 1;
-        int actionY = screenHeight - 150 + skillIdx * 30;
-        int actionX = 20 + MeasureText("Skill", 20) + 10;
-        std::string cooldownText = " (" + std::to_string(skillCooldownTurns) + ")";
-        DrawText(cooldownText.c_str(), actionX, actionY, 20, DARKRED);
-    }
+    battleLayers.Draw();
+
+    // HP bars across the sprites, below the turn order, easing toward the HP
+    // in the panels; they move while the panels stay cached
+    const float barWidth = 160.0f;
+    float barY = (float)screenHeight / 2.0f - 25.0f;
+    float playerShare = animations.Value(ANIM_PLAYER_HP, (float)player.currentHP / player.maxHP);
+    float enemyShare = animations.Value(ANIM_ENEMY_HP, (float)enemy.currentHP / enemy.maxHP);
+    Gfx().DrawRectangleRec({ playerX + 20.0f, barY, barWidth, 8.0f }, Fade(BLACK, 0.5f));
+    Gfx().DrawRectangleRec({ playerX + 20.0f, barY, barWidth * playerShare, 8.0f }, LIME);
+    Gfx().DrawRectangleRec({ enemyX + 20.0f, barY, barWidth, 8.0f }, Fade(BLACK, 0.5f));
+    Gfx().DrawRectangleRec({ enemyX + 20.0f, barY, barWidth * enemyShare, 8.0f }, LIME);
 }
 
 void Game::ShowBattleItemMenu() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("BattleItems");
     if (inventory.empty()) {
         ShowNotification("You have no items!");
         return;
@@ -1346,199 +1806,229 @@ void Game::ShowBattleItemMenu() {
     Rectangle prevBtn = { 200.0f, static_cast<float>(screenHeight) - 80.0f, 120.0f, 40.0f };
     Rectangle nextBtn = { 340.0f, static_cast<float>(screenHeight) - 80.0f, 100.0f, 40.0f };
 
-    while (!WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Choose an item:", 20, 20, 24, DARKBLUE);
-
-        int y = 60;
+    while (!Gfx().ShouldClose()) {
         int itemHeight = 40;
-        Vector2 mousePos = GetMousePosition();
+        Vector2 mousePos = Input::GetMousePosition();
 
         int startIdx = currentPage * itemsPerPage;
         int endIdx = std::min(startIdx + itemsPerPage, (int)inventory.size());
 
-        // Draw items for current page
         for (int i = startIdx; i < endIdx; ++i) {
-            int displayIdx = i - startIdx;
-            Rectangle itemRect = { 20.0f, (float)y, 500.0f, (float)itemHeight };
-            bool isHover = CheckCollisionPointRec(mousePos, itemRect);
-            Color clr = (displayIdx == selected || isHover) ? GOLD : BLACK;
-            std::string itemText = inventory[i].name + " x" + std::to_string(inventory[i].quantity) + " - " + inventory[i].description;
-            DrawText(itemText.c_str(), 20, y, 20, clr);
-
-            if (isHover) selected = displayIdx;
+            Rectangle itemRect = { 20.0f, 60.0f + (i - startIdx) * itemHeight, 500.0f, (float)itemHeight };
+            if (!CheckCollisionPointRec(mousePos, itemRect)) continue;
+            selected = i - startIdx;
 
             // Mouse click to use item
-            if (isHover && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
                 UseItem(i);
-                EndDrawing();
                 return;
             }
-            y += itemHeight;
+            break;
         }
 
-        // Draw Back button
-        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : DARKGRAY;
-        DrawRectangleRec(backBtn, backColor);
-        DrawText("Back", (int)backBtn.x + 10, (int)backBtn.y + 10, 20, WHITE);
-
-        // Draw Next button
-        Color nextColor = (currentPage < totalPages - 1 && CheckCollisionPointRec(mousePos, nextBtn)) ? GRAY : DARKGRAY;
-        DrawRectangleRec(nextBtn, nextColor);
-        DrawText("Next", (int)nextBtn.x + 10, (int)nextBtn.y + 10, 20, WHITE);
-
-        // Draw Previous button
-        Color prevColor = (currentPage > 0 && CheckCollisionPointRec(mousePos, prevBtn)) ? GRAY : DARKGRAY;
-        DrawRectangleRec(prevBtn, prevColor);
-        DrawText("Previous", (int)prevBtn.x + 10, (int)prevBtn.y + 10, 20, WHITE);
-
-        // Page indicator
-        std::string pageText = "Page " + std::to_string(currentPage + 1) + " / " + std::to_string(totalPages);
-        DrawText(pageText.c_str(), 480, screenHeight - 70, 20, DARKGRAY);
-
-        DrawText("Use: Enter/Click | Back: ESC or Button", 20, screenHeight - 120, 20, DARKGRAY);
-
-        EndDrawing();
-
         // Keyboard navigation
-        if (IsKeyPressed(KEY_DOWN)) {
+        if (Input::IsKeyPressed(KEY_DOWN)) {
             selected = (selected + 1) % (endIdx - startIdx);
         }
-        if (IsKeyPressed(KEY_UP)) {
+        if (Input::IsKeyPressed(KEY_UP)) {
             selected = (selected + (endIdx - startIdx) - 1) % (endIdx - startIdx);
         }
-        if (IsKeyPressed(KEY_ENTER)) {
+        if (Input::IsKeyPressed(KEY_ENTER)) {
             UseItem(startIdx + selected);
             return;
         }
         // Next/Previous page with mouse
-        if (currentPage < totalPages - 1 && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, nextBtn)) {
+        if (currentPage < totalPages - 1 && Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, nextBtn)) {
             currentPage++;
             selected = 0;
         }
-        if (currentPage > 0 && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, prevBtn)) {
+        if (currentPage > 0 && Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, prevBtn)) {
             currentPage--;
             selected = 0;
         }
         // Next/Previous page with keyboard
-        if (IsKeyPressed(KEY_RIGHT) && currentPage < totalPages - 1) {
+        if (Input::IsKeyPressed(KEY_RIGHT) && currentPage < totalPages - 1) {
             currentPage++;
             selected = 0;
         }
-        if (IsKeyPressed(KEY_LEFT) && currentPage > 0) {
+        if (Input::IsKeyPressed(KEY_LEFT) && currentPage > 0) {
             currentPage--;
             selected = 0;
         }
         // Back button or ESC
-        if (IsKeyPressed(KEY_ESCAPE) ||
-            (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, backBtn))) {
+        if (Input::IsKeyPressed(KEY_ESCAPE) ||
+            (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mousePos, backBtn))) {
             break;
         }
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Choose an item:", 20, 20, 24, DARKBLUE);
+
+        int y = 60;
+        startIdx = currentPage * itemsPerPage;
+        endIdx = std::min(startIdx + itemsPerPage, (int)inventory.size());
+
+        // Draw items for current page
+        for (int i = startIdx; i < endIdx; ++i) {
+            int displayIdx = i - startIdx;
+            Rectangle itemRect = { 20.0f, (float)y, 500.0f, (float)itemHeight };
+            bool isHover = CheckCollisionPointRec(mousePos, itemRect);
+            Color clr = (displayIdx == selected || isHover) ? GOLD : BLACK;
+            Gfx().DrawText(FrameText(inventory[i].name, " x", inventory[i].quantity, " - ", inventory[i].description), 20, y, 20, clr);
+            y += itemHeight;
+        }
+
+        // Draw Back button
+        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : DARKGRAY;
+        Gfx().DrawRectangleRec(backBtn, backColor);
+        Gfx().DrawText("Back", (int)backBtn.x + 10, (int)backBtn.y + 10, 20, WHITE);
+
+        // Draw Next button
+        Color nextColor = (currentPage < totalPages - 1 && CheckCollisionPointRec(mousePos, nextBtn)) ? GRAY : DARKGRAY;
+        Gfx().DrawRectangleRec(nextBtn, nextColor);
+        Gfx().DrawText("Next", (int)nextBtn.x + 10, (int)nextBtn.y + 10, 20, WHITE);
+
+        // Draw Previous button
+        Color prevColor = (currentPage > 0 && CheckCollisionPointRec(mousePos, prevBtn)) ? GRAY : DARKGRAY;
+        Gfx().DrawRectangleRec(prevBtn, prevColor);
+        Gfx().DrawText("Previous", (int)prevBtn.x + 10, (int)prevBtn.y + 10, 20, WHITE);
+
+        // Page indicator
+        Gfx().DrawText(FrameText("Page ", currentPage + 1, " / ", totalPages), 480, screenHeight - 70, 20, DARKGRAY);
+
+        Gfx().DrawText("Use: Enter/Click | Back: ESC or Button", 20, screenHeight - 120, 20, DARKGRAY);
+
+        EndFrame();
     }
 }
 
 
-void Game::DrawAttackEffect() {
-    if (showAttackEffect) {
-        int alpha = 255 - (attackEffectFrame * 8);
-        DrawText("Attack!", screenWidth / 2 - 50, screenHeight / 2, 40, Fade(RED, alpha / 255.0f));
-    }
+void Game::PlayAttackEffect() {
+    animations.Text("Attack!", Vector2{ screenWidth / 2.0f - 50.0f, screenHeight / 2.0f }, 40, RED, animClock.Now(), 0.5f,
+        0.0f, Ease::Linear);
+}
+
+// A damage number rising over whoever took it, with a red flash when that is
+// the player. Hits in the same turn queue up behind each other.
+void Game::PlayHit(Vector2 over, int amount, bool onPlayer) {
+    double start = std::max(animClock.Now(), nextHitAt);
+    nextHitAt = start + 0.25;
+    animations.Text(FrameText("-", amount), over, 30, onPlayer ? RED : ORANGE, start, 0.8f, 30.0f);
+    if (onPlayer) animations.Flash(RED, 0.3f, start, 0.3f);
 }
 
 
 void Game::ShowVictoryScreen(int expGain, int coinGain, const std::string& enemyName) {
-    // Prepare strings and font sizes
-    std::string title = "Victory!";
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("Victory");
+    // Prepare font sizes, the text is built into frame memory each frame
+    const char* title = "Victory!";
     int titleFontSize = 40;
-    std::string msg = "You defeated the " + enemyName + "!";
     int msgFontSize = 28;
-    std::string reward = "You get " + std::to_string(expGain) + " EXP and " + std::to_string(coinGain) + " coins.";
     int rewardFontSize = 24;
-    std::string prompt = "Press Enter to return to Arena";
+    const char* prompt = "Press Enter to return to Arena";
     int promptFontSize = 22;
 
     // Calculate Y positions
     int y = 100;
     int spacing = 20;
 
-    while (!WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(DARKGREEN);
+    while (!Gfx().ShouldClose()) {
+        if (Input::IsKeyPressed(KEY_ENTER) || Input::IsKeyPressed(KEY_SPACE)) break;
+
+        BeginFrame();
+        Gfx().ClearBackground(DARKGREEN);
+        const char* msg = FrameText("You defeated the ", enemyName, "!");
+        const char* reward = FrameText("You get ", expGain, " EXP and ", coinGain, " coins.");
 
         // Centered Title
-        int titleWidth = MeasureText(title.c_str(), titleFontSize);
-        DrawText(title.c_str(), this->screenWidth / 2 - titleWidth / 2, y, titleFontSize, GOLD);
+        int titleWidth = Gfx().MeasureText(title, titleFontSize);
+        Gfx().DrawText(title, this->screenWidth / 2 - titleWidth / 2, y, titleFontSize, GOLD);
 
         // Centered Message
-        int msgWidth = MeasureText(msg.c_str(), msgFontSize);
-        DrawText(msg.c_str(), this->screenWidth / 2 - msgWidth / 2, y + titleFontSize + spacing, msgFontSize, WHITE);
+        int msgWidth = Gfx().MeasureText(msg, msgFontSize);
+        Gfx().DrawText(msg, this->screenWidth / 2 - msgWidth / 2, y + titleFontSize + spacing, msgFontSize, WHITE);
 
         // Centered Reward
-        int rewardWidth = MeasureText(reward.c_str(), rewardFontSize);
-        DrawText(reward.c_str(), this->screenWidth / 2 - rewardWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing, rewardFontSize, YELLOW);
+        int rewardWidth = Gfx().MeasureText(reward, rewardFontSize);
+        Gfx().DrawText(reward, this->screenWidth / 2 - rewardWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing, rewardFontSize, YELLOW);
 
         // Centered Prompt
-        int promptWidth = MeasureText(prompt.c_str(), promptFontSize);
-        DrawText(prompt.c_str(), this->screenWidth / 2 - promptWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing + rewardFontSize + spacing, promptFontSize, LIGHTGRAY);
+        int promptWidth = Gfx().MeasureText(prompt, promptFontSize);
+        Gfx().DrawText(prompt, this->screenWidth / 2 - promptWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing + rewardFontSize + spacing, promptFontSize, LIGHTGRAY);
 
-        EndDrawing();
-
-        if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE)) break;
+        EndFrame();
     }
 }
 
 void Game::ShowDefeatScreen() {
-    std::string title = "Defeat!";
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("Defeat");
+    const char* title = "Defeat!";
     int titleFontSize = 40;
-    std::string msg = "You have been defeated!";
+    const char* msg = "You have been defeated!";
     int msgFontSize = 28;
-    std::string penalty = "You lost 5 coins.";
+    const char* penalty = "You lost 5 coins.";
     int penaltyFontSize = 24;
-    std::string prompt = "Press Enter to return to Arena";
+    const char* prompt = "Press Enter to return to Arena";
     int promptFontSize = 22;
 
     int y = 100;
     int spacing = 20;
 
-    while (!WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(DARKRED);
+    while (!Gfx().ShouldClose()) {
+        if (Input::IsKeyPressed(KEY_ENTER) || Input::IsKeyPressed(KEY_SPACE)) break;
+
+        BeginFrame();
+        Gfx().ClearBackground(DARKRED);
 
         // Centered Title
-        int titleWidth = MeasureText(title.c_str(), titleFontSize);
-        DrawText(title.c_str(), this->screenWidth / 2 - titleWidth / 2, y, titleFontSize, RED);
+        int titleWidth = Gfx().MeasureText(title, titleFontSize);
+        Gfx().DrawText(title, this->screenWidth / 2 - titleWidth / 2, y, titleFontSize, RED);
 
         // Centered Message
-        int msgWidth = MeasureText(msg.c_str(), msgFontSize);
-        DrawText(msg.c_str(), this->screenWidth / 2 - msgWidth / 2, y + titleFontSize + spacing, msgFontSize, WHITE);
+        int msgWidth = Gfx().MeasureText(msg, msgFontSize);
+        Gfx().DrawText(msg, this->screenWidth / 2 - msgWidth / 2, y + titleFontSize + spacing, msgFontSize, WHITE);
 
         // Centered Penalty
-        int penaltyWidth = MeasureText(penalty.c_str(), penaltyFontSize);
-        DrawText(penalty.c_str(), this->screenWidth / 2 - penaltyWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing, penaltyFontSize, YELLOW);
+        int penaltyWidth = Gfx().MeasureText(penalty, penaltyFontSize);
+        Gfx().DrawText(penalty, this->screenWidth / 2 - penaltyWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing, penaltyFontSize, YELLOW);
 
         // Centered Prompt
-        int promptWidth = MeasureText(prompt.c_str(), promptFontSize);
-        DrawText(prompt.c_str(), this->screenWidth / 2 - promptWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing + penaltyFontSize + spacing, promptFontSize, LIGHTGRAY);
+        int promptWidth = Gfx().MeasureText(prompt, promptFontSize);
+        Gfx().DrawText(prompt, this->screenWidth / 2 - promptWidth / 2, y + titleFontSize + spacing + msgFontSize + spacing + penaltyFontSize + spacing, promptFontSize, LIGHTGRAY);
 
-        EndDrawing();
-
-        if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE)) break;
+        EndFrame();
     }
 }
 
+// One row in battle_stats.dat per battle or survival wave, practice aside
+void Game::RecordBattleStats(BattleOutcome outcome, int coins, int exp) {
+    if (practiceBattle) return;
+    battleTally.time = static_cast<int64_t>(std::time(nullptr));
+    battleTally.playerLevel = player.level;
+    battleTally.outcome = outcome;
+    battleTally.coins = coins;
+    battleTally.exp = exp;
+    battleStats.Append(battleTally);
+}
+
 void Game::PerformPlayerAction(int actionIndex) {
-    ApplyPoisonDamageIfNeeded(); // ← tambahkan di awal
+    MEMORY_SCOPE(Battle);
     Command* cmd = nullptr;
-
+    playerActionRank = ActionRank(actionIndex);
+    const char* names[5] = { "Attack", "Skill", "Block", "Item", "Run" };
+    if (actionIndex >= 0 && actionIndex < 5) FlightRecorder::Record(FlightEvent::Action, actionIndex, 0, names[actionIndex]);
 
     switch (actionIndex) {
     case 0: // Attack
         cmd = new AttackCommand();
+        battleTally.attacks++;
         break;
 
     case 1: // Skill
-        if (skillOnCooldown) {
+        if (SkillOnCooldown()) {
             ShowNotification("Skill on cooldown!");
             return;
         }
@@ -1547,19 +2037,19 @@ void Game::PerformPlayerAction(int actionIndex) {
             return;
         }
         UseEquippedSkill();
-        skillOnCooldown = true;
-        skillCooldownTurns = 3;
+        ApplyStatus(playerEntity, StatusKind::SkillCooldown, 3);
+        battleTally.skills++;
         isPlayerTurn = false;
         return;
 
 
     case 2: // Block
         cmd = new BlockCommand();
+        battleTally.blocks++;
         break;
 
     case 3: // Item
         ShowBattleItemMenu();
-        skipEnemyTurn = true; // Prevent enemy turn
         return;
 
     case 4: // Run
@@ -1575,55 +2065,69 @@ void Game::PerformPlayerAction(int actionIndex) {
 }
 
 void Game::PlayerAttack() {
-    int damage = player.attack - enemy.defense;
-    if (enemyBlocking) damage /= 4; // Reduce damage if enemy is blocking
+    int damage = EffectiveAttack(battleWorld, playerEntity) - EffectiveDefense(battleWorld, enemyEntity);
+    if (battleWorld.Has<Blocking>(enemyEntity)) damage /= 4; // Reduce damage if enemy is blocking
     if (damage < 1) damage = 1;
-    enemy.currentHP -= damage;
+    DealDamage(BattleSide::Enemy, damage);
     ShowNotification(" You attacks enemy for " + std::to_string(damage) + " damage!");
 
 }
 
+// Until the end of the turn, so it meets the enemy's reply
+void Game::PlayerBlock() {
+    ApplyStatus(playerEntity, StatusKind::Blocking, 1);
+    ShowNotification("You block incoming attack!");
+}
+
+void Game::FleeBattle() {
+    ShowNotification("You fled from battle.");
+    RecordBattleStats(BattleOutcome::Fled, 0, 0);
+    state = GameState::Arena;
+}
+
 void Game::PlayerSkill() {
-    int damage = (player.attack * 2) - enemy.defense;
-    if (enemyBlocking) damage /= 4; // Reduce damage if enemy is blocking
+    int damage = (EffectiveAttack(battleWorld, playerEntity) * 2) - EffectiveDefense(battleWorld, enemyEntity);
+    if (battleWorld.Has<Blocking>(enemyEntity)) damage /= 4; // Reduce damage if enemy is blocking
     if (damage < 1) damage = 1;
-    enemy.currentHP -= damage;
+    DealDamage(BattleSide::Enemy, damage);
     ShowNotification("You uses skill for " + std::to_string(damage) + " damage!");
-    showAttackEffect = true;
+    PlayAttackEffect();
 }
 
 void Game::UseEquippedSkill() {
     if (equippedSkillIndex < 0 || equippedSkillIndex >= (int)playerSkills.size()) return;
     const Skill& skill = playerSkills[equippedSkillIndex];
+    int attack = EffectiveAttack(battleWorld, playerEntity);
+    int defense = EffectiveDefense(battleWorld, enemyEntity);
+    bool enemyBlocking = battleWorld.Has<Blocking>(enemyEntity);
 
     if (skill.name == "Blazing Strike") {
-        int damage = (player.attack * 2) - enemy.defense + 5;
+        int damage = (attack * 2) - defense + 5;
         if (enemyBlocking) damage /= 4;
         if (damage < 1) damage = 1;
-        enemy.currentHP -= damage;
+        DealDamage(BattleSide::Enemy, damage);
         ShowNotification("You unleash Blazing Strike for " + std::to_string(damage) + " fire damage!");
     }
     else if (skill.name == "Frost Guard") {
-        // Example: Reduce damage for 2 turns (implement your own logic)
-        isBlocking = true;
+        ApplyStatus(playerEntity, StatusKind::Blocking, 2);
         ShowNotification("You use Frost Guard! Incoming damage reduced for 2 turns.");
     }
     else if (skill.name == "Thunder Dash") {
-        int damage = (player.attack * 1.5) - enemy.defense + 3;
+        int damage = (attack * 1.5) - defense + 3;
         if (enemyBlocking) damage /= 4;
         if (damage < 1) damage = 1;
-        enemy.currentHP -= damage;
+        DealDamage(BattleSide::Enemy, damage);
         ShowNotification("You dash with thunder for " + std::to_string(damage) + " damage!");
     }
     else {
         // Default fallback
-        int damage = (player.attack * 2) - enemy.defense;
+        int damage = (attack * 2) - defense;
         if (enemyBlocking) damage /= 4;
         if (damage < 1) damage = 1;
-        enemy.currentHP -= damage;
+        DealDamage(BattleSide::Enemy, damage);
         ShowNotification("You use your skill for " + std::to_string(damage) + " damage!");
     }
-    showAttackEffect = true;
+    PlayAttackEffect();
 }
 
 
@@ -1646,7 +2150,7 @@ EnemyAction Game::ChooseEnemyAction() const {
     if (lastEnemyAction == EnemyAction::Block) scoreBlock -= 6;
 
     // === Cek cooldown skill ===
-    if (enemySkillCooldown > 0) {
+    if (battleWorld.Has<SkillCooldown>(enemyEntity)) {
         scoreSkill = -100; // abaikan opsi skill
     }
     else {
@@ -1662,7 +2166,7 @@ EnemyAction Game::ChooseEnemyAction() const {
             if (lastEnemyAction == EnemyAction::Block) scoreSkill += 12;
             break;
         case EnemyType::Witch:
-            if (!playerPoisoned) scoreSkill += 15;
+            if (!battleWorld.Has<Poisoned>(playerEntity)) scoreSkill += 15;
             break;
         }
     }
@@ -1679,78 +2183,143 @@ EnemyAction Game::ChooseEnemyAction() const {
 }
 
 
-void Game::ApplyPoisonDamageIfNeeded() {
-    if (playerPoisoned) {
-        int poisonDmg = std::max(1, player.maxHP * 5 / 100);
-        player.currentHP -= poisonDmg;
-        ShowNotification("Poison deals " + std::to_string(poisonDmg) + " damage!");
-        poisonTurns--;
-        if (poisonTurns <= 0) {
-            playerPoisoned = false;
+// Takes poison damage off and puts what happened to the player in the battle log
+void Game::ReportStatusEvents() {
+    for (const StatusEvent& event : statusEvents) {
+        if (event.kind == StatusEventKind::PoisonDamage) DealDamage(SideOf(event.entity), event.amount);
+        if (event.entity != playerEntity) continue;
+        switch (event.kind) {
+        case StatusEventKind::PoisonDamage:
+            ShowNotification("Poison deals " + std::to_string(event.amount) + " damage!");
+            break;
+        case StatusEventKind::PoisonCured:
             ShowNotification("You are no longer poisoned!");
+            break;
+        case StatusEventKind::SkillReady:
+            ShowNotification("Skill ready to use!");
+            break;
+        case StatusEventKind::BuffExpired:
+            ShowNotification("A +" + std::to_string(event.amount) + " boost wore off.");
+            break;
         }
     }
 }
 
+bool Game::SkillOnCooldown() const {
+    return battleWorld.Has<SkillCooldown>(playerEntity);
+}
+
+int Game::SkillCooldownTurns() const {
+    return statuses.Remaining(playerEntity, StatusKind::SkillCooldown);
+}
+
+
+// Asks BattleOdds about the fight as it stands; a lookup unless something changed
+void Game::RefreshWinChance() {
+    PROFILE_ZONE("RefreshWinChance");
+    SimSkill skill = SimSkill::None;
+    if (equippedSkillIndex >= 0 && equippedSkillIndex < (int)playerSkills.size()) {
+        // Same names UseEquippedSkill looks for
+        const std::string& name = playerSkills[equippedSkillIndex].name;
+        if (name == "Blazing Strike") skill = SimSkill::BlazingStrike;
+        else if (name == "Frost Guard") skill = SimSkill::FrostGuard;
+        else if (name == "Thunder Dash") skill = SimSkill::ThunderDash;
+        else skill = SimSkill::Strike;
+    }
+
+    SimMatchup matchup = {
+        { player.maxHP, EffectiveAttack(battleWorld, playerEntity), EffectiveDefense(battleWorld, playerEntity),
+            initiative.SpeedOf(static_cast<int>(BattleSide::Player)) },
+        { enemy.maxHP, EffectiveAttack(battleWorld, enemyEntity), EffectiveDefense(battleWorld, enemyEntity),
+            initiative.SpeedOf(static_cast<int>(BattleSide::Enemy)) },
+        static_cast<SimEnemyKind>(enemyType),
+        skill
+    };
+    SimBattleState current;
+    current.playerHP = player.currentHP;
+    current.enemyHP = enemy.currentHP;
+    current.playerBlockTurns = statuses.Remaining(playerEntity, StatusKind::Blocking);
+    current.enemyBlockTurns = statuses.Remaining(enemyEntity, StatusKind::Blocking);
+    current.enemyBlockedLast = lastEnemyAction == EnemyAction::Block;
+    current.enemySkillCooldown = statuses.Remaining(enemyEntity, StatusKind::SkillCooldown);
+    current.poisonTurns = statuses.Remaining(playerEntity, StatusKind::Poison);
+    current.playerSkillCooldown = SkillCooldownTurns();
+    current.enemyWait = initiative.TimeOf(static_cast<int>(BattleSide::Enemy)) - initiative.TimeOf(static_cast<int>(BattleSide::Player));
+    winOdds = battleOdds.Solve(matchup, current);
+}
 
 void Game::EnemyAttack() {
+    PROFILE_ZONE("EnemyAttack");
+    MEMORY_SCOPE(Battle);
     if (enemy.currentHP <= 0) return;
 
 
     EnemyAction action = ChooseEnemyAction(); // Pilih aksi via AI
+    int attack = EffectiveAttack(battleWorld, enemyEntity);
+    int defense = EffectiveDefense(battleWorld, playerEntity);
     int damage = 0;
 
     switch (action) {
     case EnemyAction::Attack:
-        damage = enemy.attack - player.defense;
-        if (isBlocking) damage /= 4;
-        player.currentHP -= std::max(1, damage);
+        damage = attack - defense;
+        if (battleWorld.Has<Blocking>(playerEntity)) damage /= 4;
+        DealDamage(BattleSide::Player, std::max(1, damage));
         ShowNotification(enemy.name + " attacks for " + std::to_string(damage) + " damage!");
         break;
 
     case EnemyAction::Block:
-        enemyBlocking = true;
+        // Enemies act last in a turn, so the block has to outlast one turn end to meet the player's next attack
+        ApplyStatus(enemyEntity, StatusKind::Blocking, 2);
         ShowNotification(enemy.name + " is blocking!");
         break;
 
     case EnemyAction::Skill:
-        enemySkillCooldown = 3;
+        ApplyStatus(enemyEntity, StatusKind::SkillCooldown, 3);
         if (enemyType == EnemyType::Paladin) {
-            damage = (enemy.attack * 1.5) - player.defense;
-            player.currentHP -= std::max(1, damage);
+            damage = (attack * 1.5) - defense;
+            DealDamage(BattleSide::Player, std::max(1, damage));
             ShowNotification(enemy.name + " uses Holy Strike for " + std::to_string(damage) + " damage!");
         }
         else if (enemyType == EnemyType::Archer) {
-            damage = (enemy.attack * 2) - player.defense;
-            player.currentHP -= std::max(1, damage);
+            damage = (attack * 2) - defense;
+            DealDamage(BattleSide::Player, std::max(1, damage));
             ShowNotification(enemy.name + " uses Double Shot for " + std::to_string(damage) + " damage!");
         }
         else if (enemyType == EnemyType::Warrior) {
-            damage = (enemy.attack * 2) - player.defense;
-            player.currentHP -= std::max(1, damage);
+            damage = (attack * 2) - defense;
+            DealDamage(BattleSide::Player, std::max(1, damage));
             ShowNotification(enemy.name + " uses Power Strike for " + std::to_string(damage) + " damage!");
         }
         else if (enemyType == EnemyType::Witch) {
-            playerPoisoned = true;
-            poisonTurns = 3;
+            ApplyStatus(playerEntity, StatusKind::Poison, 3);
             ShowNotification(enemy.name + " uses Poison! You are poisoned for 3 turns.");
         }
         break;
     }
 
     lastEnemyAction = action;
-    showAttackEffect = true;
+    RecordBattleEvent({ BattleEventKind::EnemyActed, BattleSide::Enemy, StatusKind::Count, static_cast<int32_t>(action), 0 });
+    PlayAttackEffect();
 }
 
 void Game::CheckBattleResult() {
+    MEMORY_SCOPE(Battle);
     // Pastikan HP tidak negatif
     player.currentHP = std::max(0, player.currentHP);
     enemy.currentHP = std::max(0, enemy.currentHP);
 
+    if (practiceBattle && (player.currentHP == 0 || enemy.currentHP == 0)) {
+        ShowNotification(player.currentHP == 0 ? "Practice over: you were beaten." : "Practice over: you won!");
+        state = GameState::Arena;
+        return;
+    }
+
     // Player kalah
     if (player.currentHP == 0) {
         ShowNotification("You have been defeated! Lose 5 coins.");
-        playerCoins = std::max(0, playerCoins - 5);
+        int coinLoss = std::min(5, playerCoins);
+        AddCoins(-coinLoss);
+        RecordBattleStats(BattleOutcome::Lost, -coinLoss, 0);
         ShowDefeatScreen(); // Show defeat scene
         player.currentHP = player.maxHP;  // Reset HP
         state = GameState::Arena;        // Return to arena
@@ -1762,53 +2331,819 @@ void Game::CheckBattleResult() {
     if (enemy.currentHP == 0) {
         int expGain = baseEnemyExp;
         int coinGain = baseEnemyCoins;
-        playerCoins += coinGain;
+        AddCoins(coinGain);
         player.exp += expGain;
+        RecordBattleStats(BattleOutcome::Won, coinGain, expGain);
         ShowVictoryScreen(expGain, coinGain, enemy.name);
+        ApplyLevelUps();
+        ShowVictoryScreen(expGain, coinGain, enemy.name);
+        state = GameState::Arena;
+        enemyLevel++; // Tingkatkan level enemy berikutnya
+    }
+}
+
+void Game::ApplyLevelUps() {
+    while (player.exp >= player.expToLevel) {
+        player.level++;
+        player.exp -= player.expToLevel;
+        player.expToLevel = static_cast<int>(player.expToLevel * 1.2f);
+        player.maxHP += 10;
+        player.attack += 2;
+        player.defense += 1;
+        ShowNotification("Level up! Now level " + std::to_string(player.level));
+    }
+}
+
+// The battle as it stands becomes the start of battleEvents
+void Game::BeginBattleEvents() {
+    BattleState start = {};
+    const Entity entities[2] = { playerEntity, enemyEntity };
+    start.hp[0] = player.currentHP;
+    start.hp[1] = enemy.currentHP;
+    start.maxHP[0] = player.maxHP;
+    start.maxHP[1] = enemy.maxHP;
+    start.lastEnemyAction = static_cast<uint8_t>(lastEnemyAction);
+    for (int side = 0; side < 2; ++side) {
+        for (int kind = 0; kind < STATUS_KIND_COUNT; ++kind) {
+            start.statusLeft[side][kind] = statuses.Remaining(entities[side], static_cast<StatusKind>(kind));
+        }
+        start.nextAction[side] = initiative.TimeOf(side);
+    }
+    battleEvents.Begin(start);
+}
+
+// HP only changes here during a battle, so the Characters always match the fold
+void Game::RecordBattleEvent(const BattleEvent& event) {
+    battleEvents.Append(event);
+    player.currentHP = battleEvents.State().hp[static_cast<int>(BattleSide::Player)];
+    enemy.currentHP = battleEvents.State().hp[static_cast<int>(BattleSide::Enemy)];
+}
 
-        // Level up player
-        while (player.exp >= player.expToLevel) {
-            player.level++;
-            player.exp -= player.expToLevel;
-            player.expToLevel = static_cast<int>(player.expToLevel * 1.2f);
-            player.maxHP += 10;
-            player.attack += 2;
-            player.defense += 1;
-            ShowNotification("Level up! Now level " + std::to_string(player.level));
+void Game::DealDamage(BattleSide side, int amount) {
+    RecordBattleEvent({ BattleEventKind::Damage, side, StatusKind::Count, amount, 0 });
+    // On the sprites DrawBattle puts at either side, rising to their HP bars
+    bool onPlayer = side == BattleSide::Player;
+    float x = onPlayer ? 120.0f : screenWidth - 180.0f;
+    PlayHit(Vector2{ x, screenHeight / 2.0f + 10.0f }, amount, onPlayer);
+}
+
+void Game::HealPlayer(int amount) {
+    if (state == GameState::Battle) {
+        RecordBattleEvent({ BattleEventKind::Heal, BattleSide::Player, StatusKind::Count, amount, 0 });
+    }
+    else {
+        player.currentHP = std::min(player.maxHP, player.currentHP + amount);
+    }
+}
+
+void Game::ApplyStatus(Entity target, StatusKind kind, int duration, int amount) {
+    statuses.Apply(target, kind, duration, amount);
+    if (state == GameState::Battle) {
+        RecordBattleEvent({ BattleEventKind::StatusApplied, SideOf(target), kind, amount, duration });
+    }
+}
+
+void Game::RemoveStatus(Entity target, StatusKind kind) {
+    statuses.Remove(target, kind);
+    if (state == GameState::Battle) {
+        RecordBattleEvent({ BattleEventKind::StatusRemoved, SideOf(target), kind, 0, 0 });
+    }
+}
+
+BattleSide Game::SideOf(Entity e) const {
+    return e == playerEntity ? BattleSide::Player : BattleSide::Enemy;
+}
+
+// Also where the rewind ring gets the start of each turn
+void Game::StartPlayerTurn() {
+    battleTally.turns++;
+    RecordBattleEvent({ BattleEventKind::TurnStarted, BattleSide::Player, StatusKind::Count, battleEvents.State().turn + 1, 0 });
+    BattleSnapshot snapshot;
+    TakeSnapshot(snapshot);
+    turnSnapshots.Push(snapshot);
+}
+
+// Both fighters ready now, at the speeds they have now
+void Game::ResetInitiative() {
+    initiative.Clear();
+    initiative.Add(EffectiveSpeed(battleWorld, playerEntity));
+    initiative.Add(EffectiveSpeed(battleWorld, enemyEntity));
+}
+
+// side has acted and waits for its next turn
+void Game::TakeTurn(BattleSide side, int rank) {
+    initiative.Act(rank);
+    RecordBattleEvent({ BattleEventKind::Scheduled, side, StatusKind::Count, initiative.TimeOf(static_cast<int>(side)), 0 });
+}
+
+// How soon an action lets the player go again
+int Game::ActionRank(int actionIndex) const {
+    if (actionIndex == 3) return RANK_FREE; // items don't use up the turn
+    bool skillEquipped = equippedSkillIndex >= 0 && equippedSkillIndex < (int)playerSkills.size();
+    if (actionIndex == 1 && skillEquipped && playerSkills[equippedSkillIndex].name == "Thunder Dash") {
+        return RANK_QUICK; // always goes first
+    }
+    return RANK_NORMAL;
+}
+
+// Puts HP, the turn-counted statuses and the initiative times back as saved
+// has them. Boosts and haste count battles, so nothing in a battle changes
+// them except items.
+void Game::RestoreBattleState(const BattleState& saved) {
+    const Entity entities[2] = { playerEntity, enemyEntity };
+    player.currentHP = saved.hp[0];
+    enemy.currentHP = saved.hp[1];
+    lastEnemyAction = static_cast<EnemyAction>(saved.lastEnemyAction);
+    for (int side = 0; side < 2; ++side) {
+        for (int kind = 0; kind < STATUS_KIND_COUNT; ++kind) {
+            StatusKind statusKind = static_cast<StatusKind>(kind);
+            int left = saved.statusLeft[side][kind];
+            if (CountsBattles(statusKind) || statuses.Remaining(entities[side], statusKind) == left) continue;
+            statuses.Remove(entities[side], statusKind);
+            if (left > 0) statuses.Apply(entities[side], statusKind, left);
+        }
+        initiative.SetTime(side, saved.nextAction[side]);
+    }
+}
+
+// Practice battles only: back to the start of the previous turn. The rewind
+// ring has it unless the last 64 turns were undone; then the events are refolded.
+void Game::UndoLastTurn() {
+    size_t point = battleEvents.UndoPoint();
+    if (point == BattleEventStore::NO_UNDO) {
+        ShowNotification("Nothing to undo since the start or the last item.");
+        return;
+    }
+    size_t total = battleEvents.Total() - battleEvents.Count() + point;
+    DropSnapshotsAfter(total);
+    if (turnSnapshots.Count() > 0 && turnSnapshots.Peek()->eventTotal == total) {
+        RestoreSnapshot(*turnSnapshots.Peek());
+        battleEvents.Rewind(total, turnSnapshots.Peek()->state);
+    }
+    else {
+        battleEvents.Truncate(point);
+        RestoreBattleState(battleEvents.State());
+        isPlayerTurn = true;
+        BattleSnapshot snapshot;
+        TakeSnapshot(snapshot);
+        turnSnapshots.Push(snapshot);
+    }
+    RefreshWinChance();
+    ShowNotification(FrameText("Back to turn ", battleEvents.State().turn, "."));
+}
+
+// Forgets turns and the quicksave from events being taken back
+void Game::DropSnapshotsAfter(size_t eventTotal) {
+    while (turnSnapshots.Count() > 0 && turnSnapshots.Peek()->eventTotal > eventTotal) turnSnapshots.Pop();
+    if (haveQuickSave && quickSave.eventTotal > eventTotal) haveQuickSave = false;
+}
+
+void Game::QuickLoad() {
+    if (!haveQuickSave) {
+        ShowNotification("No quicksave in this battle.");
+        return;
+    }
+    DropSnapshotsAfter(quickSave.eventTotal);
+    RestoreSnapshot(quickSave);
+    battleEvents.Rewind(quickSave.eventTotal, quickSave.state);
+    RefreshWinChance();
+    ShowNotification("Quickloaded.");
+}
+
+// Zeroed first so two snapshots of the same battle are the same bytes
+void Game::TakeSnapshot(BattleSnapshot& out) const {
+    std::memset(&out, 0, sizeof(out));
+    out.playerMaxHP = player.maxHP;
+    out.playerAttack = player.attack;
+    out.playerDefense = player.defense;
+    out.playerLevel = player.level;
+    out.playerExp = player.exp;
+    out.playerExpToLevel = player.expToLevel;
+
+    enemy.name.copy(out.enemyName, sizeof(out.enemyName) - 1);
+    out.enemyMaxHP = enemy.maxHP;
+    out.enemyAttack = enemy.attack;
+    out.enemyDefense = enemy.defense;
+    out.enemyLevel = enemy.level;
+    out.enemyType = static_cast<uint8_t>(enemyType);
+    out.nextEnemyLevel = enemyLevel;
+    out.expReward = baseEnemyExp;
+    out.coinReward = baseEnemyCoins;
+
+    out.isPlayerTurn = isPlayerTurn;
+    out.state = battleEvents.State();
+    const Entity entities[2] = { playerEntity, enemyEntity };
+    for (int side = 0; side < 2; ++side) {
+        const AttackBuff* attackBuff = battleWorld.Get<AttackBuff>(entities[side]);
+        const DefenseBuff* defenseBuff = battleWorld.Get<DefenseBuff>(entities[side]);
+        out.attackBoost[side] = attackBuff ? attackBuff->amount : 0;
+        out.defenseBoost[side] = defenseBuff ? defenseBuff->amount : 0;
+    }
+    out.eventTotal = battleEvents.Total();
+}
+
+// Leaves battleEvents to the caller. Boosts come back as one stack each.
+void Game::RestoreSnapshot(const BattleSnapshot& snapshot) {
+    PROFILE_ZONE("RestoreSnapshot");
+    player.maxHP = snapshot.playerMaxHP;
+    player.attack = snapshot.playerAttack;
+    player.defense = snapshot.playerDefense;
+    player.level = snapshot.playerLevel;
+    player.exp = snapshot.playerExp;
+    player.expToLevel = snapshot.playerExpToLevel;
+
+    enemy.name.assign(snapshot.enemyName, strnlen(snapshot.enemyName, sizeof(snapshot.enemyName)));
+    enemy.maxHP = snapshot.enemyMaxHP;
+    enemy.attack = snapshot.enemyAttack;
+    enemy.defense = snapshot.enemyDefense;
+    enemy.level = snapshot.enemyLevel;
+    enemyType = static_cast<EnemyType>(snapshot.enemyType);
+    enemyTexture = EnemyTextureFor(enemyType);
+    enemyLevel = snapshot.nextEnemyLevel;
+    baseEnemyExp = snapshot.expReward;
+    baseEnemyCoins = snapshot.coinReward;
+
+    isPlayerTurn = snapshot.isPlayerTurn != 0;
+
+    // Haste first: the initiative speeds come from it
+    const Entity entities[2] = { playerEntity, enemyEntity };
+    for (int side = 0; side < 2; ++side) {
+        for (int kind = 0; kind < STATUS_KIND_COUNT; ++kind) {
+            StatusKind statusKind = static_cast<StatusKind>(kind);
+            if (!CountsBattles(statusKind)) continue;
+            int amount = 0;
+            if (statusKind == StatusKind::AttackUp) amount = snapshot.attackBoost[side];
+            if (statusKind == StatusKind::DefenseUp) amount = snapshot.defenseBoost[side];
+            int left = snapshot.state.statusLeft[side][kind];
+            if (statuses.Remaining(entities[side], statusKind) == left && BoostOf(entities[side], statusKind) == amount) continue;
+            statuses.Remove(entities[side], statusKind);
+            if (left > 0) statuses.Apply(entities[side], statusKind, left, amount);
         }
+    }
+    ResetInitiative();
+    RestoreBattleState(snapshot.state);
+}
 
-        ShowVictoryScreen(expGain, coinGain, enemy.name);
+int Game::BoostOf(Entity e, StatusKind kind) const {
+    if (kind == StatusKind::AttackUp) {
+        const AttackBuff* buff = battleWorld.Get<AttackBuff>(e);
+        return buff ? buff->amount : 0;
+    }
+    if (kind == StatusKind::DefenseUp) {
+        const DefenseBuff* buff = battleWorld.Get<DefenseBuff>(e);
+        return buff ? buff->amount : 0;
+    }
+    return 0;
+}
+
+void Game::StartSurvival() {
+    MEMORY_SCOPE(Battle);
+    ScreenScope screen("Survival");
+    state = GameState::Battle;
+    selectedAction = 0;
+    animations.Clear();
+    battleLog.clear();
+    groupRng = SimRng((static_cast<uint64_t>(rand()) << 32) | static_cast<uint64_t>(rand()));
+    survivalWave = 1;
+    InitEnemyForSurvival(survivalWave);
+
+    while (state == GameState::Battle && !Gfx().ShouldClose()) {
+        animClock.Advance(Input::GetFrameTime());
+        UpdateGroupBattle();
+        for (int i = 1; i < group.Count(); ++i) {
+            animations.EaseTo(ANIM_GROUP_HP + i, (float)group.hp[i] / group.maxHp[i], 0.4f, animClock.Now());
+        }
+        animations.Update(animClock.Now());
+
+        BeginFrame();
+        Gfx().ClearBackground(BEIGE);
+        DrawGroupBattle();
+        animations.Draw(screenWidth, screenHeight);
+        EndFrame();
+    }
+
+    // The whole run counts as one battle for boosts
+    statusEvents.clear();
+    statuses.EndBattle(statusEvents);
+    ReportStatusEvents();
+
+    JournalStats();
+}
+
+// Wave N brings N enemies from the Colosseum encounter table
+void Game::InitEnemyForSurvival(int wave) {
+    PROFILE_ZONE("InitEnemyForSurvival");
+    MEMORY_SCOPE(Battle);
+    int count = std::min(SURVIVAL_MAX_ENEMIES, wave);
+    group.Clear();
+    group.Reserve(count + 1);
+    group.Add(Team::Allies, COMBATANT_HERO,
+        { player.maxHP, EffectiveAttack(battleWorld, playerEntity), EffectiveDefense(battleWorld, playerEntity) }, player.level);
+    group.hp[0] = player.currentHP;
+
+    waveExp = 0;
+    waveCoins = 0;
+    battleTally = BattleRecord();
+    battleTally.enemy = "Survival";
+    battleTally.enemyLevel = wave;
+    for (int i = 0; i < count; ++i) {
+        InitEnemy();
+        group.Add(Team::Enemies, static_cast<uint8_t>(enemyType), { enemy.maxHP, enemy.attack, enemy.defense }, enemy.level);
+        waveExp += baseEnemyExp;
+        waveCoins += baseEnemyCoins;
+    }
+    groupTarget = group.NextLiving(Team::Enemies, 0, 1);
+    ShowNotification(FrameText("Wave ", wave, "! Enemies: ", count));
+}
+
+void Game::UpdateGroupBattle() {
+    PROFILE_ZONE("UpdateGroupBattle");
+    MEMORY_SCOPE(Battle);
+    const int actionCount = 4;
+    const char* actions[actionCount] = { "Attack", "Skill", "Block", "Run" };
+    Vector2 mousePos = Input::GetMousePosition();
+    bool act = false;
+
+    if (Input::IsKeyPressed(KEY_DOWN)) selectedAction = (selectedAction + 1) % actionCount;
+    else if (Input::IsKeyPressed(KEY_UP)) selectedAction = (selectedAction + actionCount - 1) % actionCount;
+    else if (Input::IsKeyPressed(KEY_RIGHT)) groupTarget = group.NextLiving(Team::Enemies, groupTarget, 1);
+    else if (Input::IsKeyPressed(KEY_LEFT)) groupTarget = group.NextLiving(Team::Enemies, groupTarget, -1);
+    else if (Input::IsKeyPressed(KEY_ENTER)) act = true;
+
+    for (int i = 0; i < actionCount; i++) {
+        Rectangle actionRect = { 20.0f, static_cast<float>(screenHeight - 150 + i * 30), Gfx().MeasureText(actions[i], 20), 30.0f };
+        if (CheckCollisionPointRec(mousePos, actionRect)) {
+            selectedAction = i;
+            act = act || Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+        }
+    }
+    // Clicking an enemy targets it
+    if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        for (int i = 1; i < group.Count(); ++i) {
+            if (group.Alive(i) && CheckCollisionPointRec(mousePos, GroupSlotRect(i))) groupTarget = i;
+        }
+    }
+
+    if (!act) return;
+    FlightRecorder::Record(FlightEvent::Action, selectedAction, 0, actions[selectedAction]);
+
+    if (selectedAction == 3) {
+        ShowNotification(FrameText("You leave the arena after wave ", survivalWave, "."));
+        RecordBattleStats(BattleOutcome::Fled, 0, 0);
+        player.currentHP = std::max(1, group.hp[0]);
         state = GameState::Arena;
-        enemyLevel++; // Tingkatkan level enemy berikutnya
+        return;
+    }
+    if (selectedAction == 1 && group.skillCooldown[0] > 0) {
+        ShowNotification("Skill on cooldown!");
+        return;
+    }
+
+    // Player first, then the whole wave
+    groupEvents.clear();
+    battleTally.turns++;
+    if (group.StartTurn(0)) {
+        switch (selectedAction) {
+        case 0: groupEvents.push_back(group.Attack(0, groupTarget)); battleTally.attacks++; break;
+        case 1: groupEvents.push_back(group.Skill(0, groupTarget)); battleTally.skills++; break;
+        default: groupEvents.push_back(group.Block(0)); battleTally.blocks++; break;
+        }
+        if (selectedAction != 2) PlayAttackEffect();
+    }
+    size_t playerEvents = groupEvents.size();
+    if (group.Alive(0)) group.TeamTurn(Team::Enemies, groupRng, -1, &groupEvents);
+    group.EndRound();
+
+    // One line for the player's action and one for the wave's, however big it is
+    if (playerEvents > 0) {
+        const CombatEvent& e = groupEvents[0];
+        if (e.action == CombatAction::Block) ShowNotification("You block incoming attack!");
+        else if (e.action == CombatAction::Skill) ShowNotification(FrameText("Your sweep hits every enemy for ", e.damage, " total damage!"));
+        else ShowNotification(FrameText("You attack for ", e.damage, " damage!"));
+    }
+    int enemyDamage = 0;
+    int attackers = 0;
+    for (size_t i = playerEvents; i < groupEvents.size(); ++i) {
+        if (groupEvents[i].target == 0) {
+            enemyDamage += groupEvents[i].damage;
+            attackers++;
+        }
+    }
+    if (attackers == 1) ShowNotification(FrameText("Enemy hits you for ", enemyDamage, " damage!"));
+    else if (attackers > 1) ShowNotification(FrameText(attackers, " enemies hit you for ", enemyDamage, " damage!"));
+
+    // The player's hit over its target (a sweep's over the first slot), then the wave's over the player
+    if (playerEvents > 0 && groupEvents[0].damage > 0) {
+        Rectangle slot = GroupSlotRect(groupEvents[0].target > 0 ? groupEvents[0].target : 1);
+        PlayHit(Vector2{ slot.x, slot.y - 10.0f }, groupEvents[0].damage, false);
+    }
+    if (enemyDamage > 0) PlayHit(Vector2{ 120.0f, screenHeight / 2.0f + 10.0f }, enemyDamage, true);
+
+    player.currentHP = group.hp[0];
+    if (!group.Alive(0)) {
+        ShowNotification("You have been defeated! Lose 5 coins.");
+        int coinLoss = std::min(5, playerCoins);
+        AddCoins(-coinLoss);
+        RecordBattleStats(BattleOutcome::Lost, -coinLoss, 0);
+        ShowDefeatScreen();
+        player.currentHP = player.maxHP;
+        state = GameState::Arena;
+        return;
+    }
+
+    if (group.LivingCount(Team::Enemies) == 0) {
+        AddCoins(waveCoins);
+        player.exp += waveExp;
+        RecordBattleStats(BattleOutcome::Won, waveCoins, waveExp);
+        ShowVictoryScreen(waveExp, waveCoins, FrameText("wave ", survivalWave));
+        ApplyLevelUps();
+        int cooldown = group.skillCooldown[0];
+        InitEnemyForSurvival(++survivalWave);
+        group.skillCooldown[0] = static_cast<uint8_t>(cooldown);
+        return;
     }
+    if (!group.Alive(groupTarget)) groupTarget = group.NextLiving(Team::Enemies, groupTarget, 1);
 }
 
-void Game::SaveGame() {
-    std::ofstream out("save.dat", std::ios::binary);
-    if (!out) return;
+// Enemies fill a grid right of the player, shrinking to fit the wave
+Rectangle Game::GroupSlotRect(int index) const {
+    const float areaX = 340.0f;
+    const float areaY = 130.0f;
+    const float areaWidth = static_cast<float>(screenWidth) - areaX - 20.0f;
+    const float areaHeight = static_cast<float>(screenHeight) - areaY - 170.0f;
+    int enemies = std::max(1, group.Count() - 1);
+    int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(enemies * areaWidth / areaHeight))));
+    int rows = (enemies + columns - 1) / columns;
+    float cell = std::min(std::min(areaWidth / columns, areaHeight / rows), 120.0f);
+    int slot = index - 1;
+    return { areaX + (slot % columns) * cell, areaY + (slot / columns) * cell, cell, cell };
+}
+
+void Game::DrawGroupBattle() {
+    PROFILE_ZONE("DrawGroupBattle");
+    MEMORY_SCOPE(UI);
+    int infoFontSize = 28;
+    int infoPadding = 10;
+
+    Gfx().DrawTexture(battleBgTexture, -120, -500, WHITE);
+
+    float desiredHeight = 200.0f;
+    float playerY = (float)screenHeight / 2.0f - desiredHeight / 2.0f;
+    Gfx().DrawTextureEx(characterTexture, Vector2{ 60.0f, playerY }, 0.0f, desiredHeight / 3000.0f, WHITE);
+
+    // Player Info
+    int playerInfoWidth = 320;
+    int playerInfoHeight = infoFontSize * 3 + infoPadding * 4;
+    Gfx().DrawRectangle(10, 10, playerInfoWidth, playerInfoHeight, Fade(BLACK, 0.4f));
+    Gfx().DrawText(FrameText(player.name, " - Lvl ", player.level), 20, 20, infoFontSize, SKYBLUE);
+    Gfx().DrawText(FrameText("HP: ", group.hp[0], "/", group.maxHp[0]), 20, 20 + infoFontSize + infoPadding, infoFontSize, LIME);
+    Gfx().DrawText(FrameText("Wave ", survivalWave, "  Left: ", group.LivingCount(Team::Enemies)), 20, 20 + (infoFontSize + infoPadding) * 2, infoFontSize, ORANGE);
+
+    // Enemies: sprite, HP bar, and a frame around the target
+    const Texture2D* textures[] = { &archerTexture, &warriorTexture, &paladinTexture, &witchTexture };
+    for (int i = 1; i < group.Count(); ++i) {
+        if (!group.Alive(i)) continue;
+        Rectangle slot = GroupSlotRect(i);
+        const Texture2D& texture = *textures[std::min<int>(group.kind[i], 3)];
+        Color tint = (group.status[i] & STATUS_BLOCKING) ? SKYBLUE : WHITE;
+        Gfx().DrawTextureEx(texture, Vector2{ slot.x + 2.0f, slot.y }, 0.0f, (slot.height - 6.0f) / 3000.0f, tint);
+        float share = animations.Value(ANIM_GROUP_HP + i, static_cast<float>(group.hp[i]) / group.maxHp[i]);
+        Gfx().DrawRectangleRec({ slot.x + 2.0f, slot.y + slot.height - 5.0f, (slot.width - 4.0f) * share, 3.0f },
+            (group.status[i] & STATUS_POISONED) ? PURPLE : LIME);
+        if (i == groupTarget) Gfx().DrawRectangleLinesEx(slot, 2.0f, GOLD);
+    }
+
+    // Battle log
+    int logFontSize = 16;
+    int logLineHeight = 22;
+    int logBoxWidth = 300;
+    int logBoxHeight = BATTLE_LOG_MAX_LINES * logLineHeight + 30;
+    int logBoxX = screenWidth - logBoxWidth - 20;
+    int logBoxY = screenHeight - logBoxHeight - 20;
+    Gfx().DrawRectangle(logBoxX, logBoxY, logBoxWidth, logBoxHeight, Fade(DARKGRAY, 0.7f));
+    Gfx().DrawText("Battle Log", logBoxX + 10, logBoxY + 4, logFontSize, GOLD);
+    int y = logBoxY + 8 + logLineHeight;
+    for (const auto& line : battleLog) {
+        Gfx().DrawText(line.c_str(), logBoxX + 10, y, logFontSize, WHITE);
+        y += logLineHeight;
+    }
+
+    // Actions
+    const char* actions[4] = { "Attack", "Skill", "Block", "Run" };
+    Gfx().DrawRectangle(10, screenHeight - 160, 180, 4 * 30 + 20, Fade(DARKGRAY, 0.7f));
+    for (int i = 0; i < 4; i++) {
+        int actionY = screenHeight - 150 + i * 30;
+        bool disabled = i == 1 && group.skillCooldown[0] > 0;
+        Color clr = disabled ? GRAY : (i == selectedAction ? DARKGOLD : BLACK);
+        Gfx().DrawText(actions[i], 20, actionY, 20, clr);
+        if (disabled) {
+            Gfx().DrawText(FrameText(" (", (int)group.skillCooldown[0], ")"), 20 + Gfx().MeasureText("Skill", 20) + 10, actionY, 20, DARKRED);
+        }
+    }
+}
+
+// Milliseconds on the game clock, for the duel session's resends and timeout
+static uint32_t DuelClock() {
+    return static_cast<uint32_t>(Input::GetTime() * 1000.0);
+}
+
+void Game::ShowDuelLobby() {
+    MEMORY_SCOPE(UI);
+    ScreenScope screen("DuelLobby");
+    state = GameState::Duel;
+    Rectangle hostBtn = { 20, 120, 300, 40 };
+    Rectangle joinBtn = { 20, 180, 300, 40 };
+    Rectangle addressBox = { 340, 180, 280, 40 };
+    Rectangle backBtn = { 20, 240, 300, 40 };
+
+    while (state == GameState::Duel && !Gfx().ShouldClose()) {
+        Vector2 mousePos = Input::GetMousePosition();
+
+        // Digits, dots and a colon only, so H and J stay free for the buttons
+        for (int key = Input::GetCharPressed(); key != 0; key = Input::GetCharPressed()) {
+            bool addressChar = (key >= '0' && key <= '9') || key == '.' || key == ':';
+            if (addressChar && duelAddress.length() < 21) duelAddress += static_cast<char>(key);
+        }
+        if (Input::IsKeyPressed(KEY_BACKSPACE) && !duelAddress.empty()) duelAddress.pop_back();
 
+        bool host = Input::IsKeyPressed(KEY_H);
+        bool join = Input::IsKeyPressed(KEY_J);
+        bool back = Input::IsKeyPressed(KEY_ESCAPE);
+        if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            host = host || CheckCollisionPointRec(mousePos, hostBtn);
+            join = join || CheckCollisionPointRec(mousePos, joinBtn);
+            back = back || CheckCollisionPointRec(mousePos, backBtn);
+        }
+
+        if (host) {
+            StartDuel(true, { 0, DUEL_DEFAULT_PORT });
+        }
+        else if (join) {
+            NetAddress address;
+            if (ParseNetAddress(duelAddress.c_str(), DUEL_DEFAULT_PORT, address)) StartDuel(false, address);
+            else ShowNotification(FrameText("Not an address: ", duelAddress));
+        }
+        else if (back) {
+            break;
+        }
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("PvP Duel", 20, 20, 30, DARKRED);
+        Gfx().DrawText("Two heroes at full HP over the network. Nothing is won or lost.", 20, 70, 20, GRAY);
+
+        Color hostColor = CheckCollisionPointRec(mousePos, hostBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(hostBtn, hostColor);
+        Gfx().DrawText(FrameText("H. Host on port ", DUEL_DEFAULT_PORT), hostBtn.x + 10, hostBtn.y + 10, 20, BLACK);
+
+        Color joinColor = CheckCollisionPointRec(mousePos, joinBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(joinBtn, joinColor);
+        Gfx().DrawText("J. Join the host at", joinBtn.x + 10, joinBtn.y + 10, 20, BLACK);
+        Gfx().DrawRectangleRec(addressBox, WHITE);
+        Gfx().DrawRectangleLinesEx(addressBox, 1.0f, DARKGRAY);
+        Gfx().DrawText(duelAddress.c_str(), addressBox.x + 10, addressBox.y + 10, 20, BLACK);
+        Gfx().DrawText("Type the host's address", addressBox.x, addressBox.y + 46, 16, GRAY);
+
+        Color backColor = CheckCollisionPointRec(mousePos, backBtn) ? GRAY : LIGHTGRAY;
+        Gfx().DrawRectangleRec(backBtn, backColor);
+        Gfx().DrawText("ESC. Back to Colosseum", backBtn.x + 10, backBtn.y + 10, 20, BLACK);
+
+        EndFrame();
+    }
+    state = GameState::Colosseum;
+}
+
+void Game::StartDuel(bool host, const NetAddress& address) {
+    MEMORY_SCOPE(Battle);
+    ScreenScope screen("Duel");
+    bool opened = host ? duelLink.Host(address.port) : duelLink.Join(address);
+    if (!opened) {
+        ShowNotification(host ? FrameText("Cannot listen on port ", address.port) : std::string("Cannot open a network socket"));
+        return;
+    }
+
+    SimStats mine = { player.maxHP, EffectiveAttack(battleWorld, playerEntity), EffectiveDefense(battleWorld, playerEntity) };
+    duel.Start(duelLink, host ? 0 : 1, mine, DuelClock());
+    selectedAction = 0;
+    battleLog.clear();
+    duelShownTurn = 0;
+    duelRollbacks = 0;
+    duelLoggedTurn = 0;
+    duelHitTime = -1.0;
+
+    bool inDuel = true;
+    while (inDuel && !Gfx().ShouldClose()) {
+        animClock.Advance(Input::GetFrameTime());
+        inDuel = UpdateDuel();
+
+        BeginFrame();
+        Gfx().ClearBackground(BEIGE);
+        DrawDuel();
+        EndFrame();
+    }
+    duelLink.Close();
+}
+
+bool Game::UpdateDuel() {
+    PROFILE_ZONE("UpdateDuel");
+    MEMORY_SCOPE(Battle);
+    const int actionCount = 3;
+    const char* actions[actionCount] = { "Attack", "Skill", "Block" };
+    const CombatAction combatActions[actionCount] = { CombatAction::Attack, CombatAction::Skill, CombatAction::Block };
+
+    duel.Update(DuelClock());
+
+    // A new turn on screen, or the last ones played again with the opponent's real action
+    const DuelState& shown = duel.Shown();
+    if (shown.turn != duelShownTurn || duel.Stats().rollbacks != duelRollbacks) {
+        if (shown.turn > 0) duelHitTime = animClock.Now();
+        duelShownTurn = shown.turn;
+        duelRollbacks = duel.Stats().rollbacks;
+    }
+    // Only confirmed turns go in the log; the shown ones may still change
+    if (duel.ConfirmedTurns() > duelLoggedTurn) {
+        duelLoggedTurn = duel.ConfirmedTurns();
+        const DuelFighter& mine = duel.Confirmed().fighters[duel.Seat()];
+        const DuelFighter& theirs = duel.Confirmed().fighters[1 - duel.Seat()];
+        const char* names[actionCount] = { "Attack", "Block", "Skill" };  // CombatAction order
+        ShowNotification(FrameText("Turn ", duelLoggedTurn, ": ", names[mine.lastAction], " ", mine.lastDamage,
+            " vs ", names[theirs.lastAction], " ", theirs.lastDamage));
+    }
+
+    if (Input::IsKeyPressed(KEY_ESCAPE)) return false;
+    NetplayPhase phase = duel.Phase();
+    if (phase != NetplayPhase::Playing) {
+        // Leaving before the peer has our last action would leave it waiting
+        bool settled = phase != NetplayPhase::Finished || duel.PeerCaughtUp();
+        return !(settled && phase != NetplayPhase::Connecting && Input::IsKeyPressed(KEY_ENTER));
+    }
+
+    Vector2 mousePos = Input::GetMousePosition();
+    bool act = false;
+    if (Input::IsKeyPressed(KEY_DOWN)) selectedAction = (selectedAction + 1) % actionCount;
+    else if (Input::IsKeyPressed(KEY_UP)) selectedAction = (selectedAction + actionCount - 1) % actionCount;
+    else if (Input::IsKeyPressed(KEY_ENTER)) act = true;
+    for (int i = 0; i < actionCount; i++) {
+        Rectangle actionRect = { 20.0f, static_cast<float>(screenHeight - 150 + i * 30), Gfx().MeasureText(actions[i], 20), 30.0f };
+        if (CheckCollisionPointRec(mousePos, actionRect)) {
+            selectedAction = i;
+            act = act || Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+        }
+    }
+    if (!act) return true;
+
+    if (selectedAction == 1 && shown.fighters[duel.Seat()].skillCooldown > 0) {
+        ShowNotification("Skill on cooldown!");
+    }
+    else if (!duel.CanAct()) {
+        ShowNotification("Waiting for your opponent...");
+    }
+    else {
+        FlightRecorder::Record(FlightEvent::Action, selectedAction, 0, actions[selectedAction]);
+        duel.Act(combatActions[selectedAction], DuelClock());
+    }
+    return true;
+}
+
+void Game::DrawDuel() {
+    PROFILE_ZONE("DrawDuel");
+    MEMORY_SCOPE(UI);
+    int infoFontSize = 28;
+    int infoPadding = 10;
+    int seat = duel.Seat();
+    const DuelState& shown = duel.Shown();
+    const DuelFighter& mine = shown.fighters[seat];
+    const DuelFighter& theirs = shown.fighters[1 - seat];
+    bool started = duel.Phase() != NetplayPhase::Connecting;
+
+    Gfx().DrawTexture(battleBgTexture, -120, -500, WHITE);
+
+    // Two heroes; the opponent's in a different light
+    float desiredHeight = 200.0f;
+    float heroY = (float)screenHeight / 2.0f - desiredHeight / 2.0f;
+    Vector2 myPos = { 60.0f, heroY };
+    Vector2 theirPos = { (float)screenWidth - 260.0f, heroY };
+    Gfx().DrawTextureEx(characterTexture, myPos, 0.0f, desiredHeight / 3000.0f,
+        mine.lastAction == static_cast<uint8_t>(CombatAction::Block) && shown.turn > 0 ? SKYBLUE : WHITE);
+    if (started) {
+        Gfx().DrawTextureEx(characterTexture, theirPos, 0.0f, desiredHeight / 3000.0f,
+            theirs.lastAction == static_cast<uint8_t>(CombatAction::Block) && shown.turn > 0 ? SKYBLUE : ORANGE);
+    }
+
+    // Damage taken last turn floats up over each hero for a moment
+    float hitAge = static_cast<float>(animClock.Now() - duelHitTime);
+    if (duelHitTime >= 0.0 && hitAge < 0.8f) {
+        int rise = static_cast<int>(hitAge * 50.0f);
+        Gfx().DrawText(FrameText("-", theirs.lastDamage), (int)myPos.x + 60, (int)heroY - 30 - rise, 30, RED);
+        Gfx().DrawText(FrameText("-", mine.lastDamage), (int)theirPos.x + 60, (int)heroY - 30 - rise, 30, RED);
+    }
+
+    // Both players' info
+    int infoWidth = 320;
+    int infoHeight = infoFontSize * 3 + infoPadding * 4;
+    Gfx().DrawRectangle(10, 10, infoWidth, infoHeight, Fade(BLACK, 0.4f));
+    Gfx().DrawText(FrameText(player.name, " - Lvl ", player.level), 20, 20, infoFontSize, SKYBLUE);
+    if (started) {
+        Gfx().DrawText(FrameText("HP: ", mine.hp, "/", mine.maxHp), 20, 20 + infoFontSize + infoPadding, infoFontSize, LIME);
+        Gfx().DrawText(FrameText("ATK ", mine.attack, "  DEF ", mine.defense), 20, 20 + (infoFontSize + infoPadding) * 2, infoFontSize, WHITE);
+        int theirX = screenWidth - infoWidth - 10;
+        Gfx().DrawRectangle(theirX, 10, infoWidth, infoHeight, Fade(BLACK, 0.4f));
+        Gfx().DrawText("Opponent", theirX + 10, 20, infoFontSize, ORANGE);
+        Gfx().DrawText(FrameText("HP: ", theirs.hp, "/", theirs.maxHp), theirX + 10, 20 + infoFontSize + infoPadding, infoFontSize, LIME);
+        Gfx().DrawText(FrameText("ATK ", theirs.attack, "  DEF ", theirs.defense), theirX + 10, 20 + (infoFontSize + infoPadding) * 2, infoFontSize, WHITE);
+    }
+
+    // What the duel is waiting on
+    const char* status = "";
+    Color statusColor = DARKGRAY;
+    switch (duel.Phase()) {
+    case NetplayPhase::Connecting:
+        status = seat == 0 ? FrameText("Waiting for a challenger on port ", DUEL_DEFAULT_PORT, "...")
+                           : FrameText("Calling ", duelAddress, "...");
+        break;
+    case NetplayPhase::Playing:
+        status = duel.CanAct() ? FrameText("Turn ", shown.turn + 1, ": choose your action") : "Waiting for your opponent...";
+        break;
+    case NetplayPhase::Finished: {
+        DuelResult won = seat == 0 ? DuelResult::FirstWon : DuelResult::SecondWon;
+        DuelResult result = duel.Confirmed().result;
+        status = result == won ? "You win the duel!" : (result == DuelResult::Draw ? "A draw!" : "You lose the duel.");
+        statusColor = result == won ? DARKGREEN : DARKRED;
+        break;
+    }
+    case NetplayPhase::Desynced:
+        status = FrameText("Out of sync at turn ", duel.DesyncTurn(), ": duel stopped");
+        statusColor = RED;
+        break;
+    case NetplayPhase::Disconnected:
+        status = "Connection lost";
+        statusColor = RED;
+        break;
+    }
+    int statusY = 20 + infoHeight + 10;
+    Gfx().DrawText(status, screenWidth / 2 - Gfx().MeasureText(status, 24) / 2, statusY, 24, statusColor);
+    if (duel.Phase() != NetplayPhase::Playing && duel.Phase() != NetplayPhase::Connecting) {
+        const char* prompt = duel.Phase() == NetplayPhase::Finished && !duel.PeerCaughtUp() ? "Finishing..." : "Press ENTER to leave";
+        Gfx().DrawText(prompt, screenWidth / 2 - Gfx().MeasureText(prompt, 20) / 2, statusY + 30, 20, DARKGRAY);
+    }
+    const NetplayStats& net = duel.Stats();
+    Gfx().DrawText(FrameText("Rollbacks: ", net.rollbacks, "  Sent: ", net.bytesSent, " B  Received: ", net.bytesReceived, " B"),
+        10, screenHeight - 16, 12, DARKGRAY);
+
+    // Battle log
+    int logFontSize = 16;
+    int logLineHeight = 22;
+    int logBoxWidth = 300;
+    int logBoxHeight = BATTLE_LOG_MAX_LINES * logLineHeight + 30;
+    int logBoxX = screenWidth - logBoxWidth - 20;
+    int logBoxY = screenHeight - logBoxHeight - 20;
+    Gfx().DrawRectangle(logBoxX, logBoxY, logBoxWidth, logBoxHeight, Fade(DARKGRAY, 0.7f));
+    Gfx().DrawText("Battle Log", logBoxX + 10, logBoxY + 4, logFontSize, GOLD);
+    int y = logBoxY + 8 + logLineHeight;
+    for (const auto& line : battleLog) {
+        Gfx().DrawText(line.c_str(), logBoxX + 10, y, logFontSize, WHITE);
+        y += logLineHeight;
+    }
+
+    // Actions
+    if (duel.Phase() != NetplayPhase::Playing) return;
+    const char* actions[3] = { "Attack", "Skill", "Block" };
+    Gfx().DrawRectangle(10, screenHeight - 160, 180, 3 * 30 + 20, Fade(DARKGRAY, 0.7f));
+    for (int i = 0; i < 3; i++) {
+        int actionY = screenHeight - 150 + i * 30;
+        bool disabled = (i == 1 && mine.skillCooldown > 0) || !duel.CanAct();
+        Color clr = disabled ? GRAY : (i == selectedAction ? DARKGOLD : BLACK);
+        Gfx().DrawText(actions[i], 20, actionY, 20, clr);
+        if (i == 1 && mine.skillCooldown > 0) {
+            Gfx().DrawText(FrameText(" (", (int)mine.skillCooldown, ")"), 20 + Gfx().MeasureText("Skill", 20) + 10, actionY, 20, DARKRED);
+        }
+    }
+}
+
+
+static void WriteSnapshot(std::ofstream& out, const SaveSnapshot& snap) {
     // Save player name length and name
-    size_t nameLen = player.name.size();
+    size_t nameLen = snap.player.name.size();
     out.write(reinterpret_cast<const char*>(&nameLen), sizeof(size_t));
-    out.write(player.name.c_str(), nameLen);
+    out.write(snap.player.name.c_str(), nameLen);
 
     // Save player stats
-    out.write(reinterpret_cast<const char*>(&player.maxHP), sizeof(int));
-    out.write(reinterpret_cast<const char*>(&player.currentHP), sizeof(int));
-    out.write(reinterpret_cast<const char*>(&player.attack), sizeof(int));
-    out.write(reinterpret_cast<const char*>(&player.defense), sizeof(int));
-    out.write(reinterpret_cast<const char*>(&player.level), sizeof(int));
-    out.write(reinterpret_cast<const char*>(&playerCoins), sizeof(int));
-    out.write(reinterpret_cast<const char*>(&player.exp), sizeof(int));
-    out.write(reinterpret_cast<const char*>(&player.expToLevel), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.player.maxHP), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.player.currentHP), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.player.attack), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.player.defense), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.player.level), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.coins), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.player.exp), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.player.expToLevel), sizeof(int));
 
     // Save equipped skill index
-    out.write(reinterpret_cast<const char*>(&equippedSkillIndex), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&snap.equippedSkillIndex), sizeof(int));
 
     // Save player skills
-    size_t skillCount = playerSkills.size();
+    size_t skillCount = snap.skills.size();
     out.write(reinterpret_cast<const char*>(&skillCount), sizeof(size_t));
-    for (const auto& skill : playerSkills) {
+    for (const auto& skill : snap.skills) {
         size_t nameLen = skill.name.size();
         size_t descLen = skill.description.size();
         out.write(reinterpret_cast<const char*>(&nameLen), sizeof(size_t));
@@ -1820,9 +3155,9 @@ void Game::SaveGame() {
     }
 
     // Save inventory
-    size_t invSize = inventory.size();
+    size_t invSize = snap.inventory.size();
     out.write(reinterpret_cast<const char*>(&invSize), sizeof(size_t));
-    for (const auto& item : inventory) {
+    for (const auto& item : snap.inventory) {
         size_t nameLen = item.name.size();
         size_t descLen = item.description.size();
         out.write(reinterpret_cast<const char*>(&nameLen), sizeof(size_t));
@@ -1832,66 +3167,236 @@ void Game::SaveGame() {
         out.write(reinterpret_cast<const char*>(&item.quantity), sizeof(int));
     }
 
-    out.close();
+    // Last journal record already contained in this file
+    out.write(reinterpret_cast<const char*>(&snap.journalSeq), sizeof(uint32_t));
+}
+
+// Writes to save.dat.tmp first so a crash never leaves a half-written save
+static bool WriteSnapshotFile(const SaveSnapshot& snap) {
+    PROFILE_ZONE("WriteSnapshotFile");
+    MEMORY_SCOPE(Save);
+    FlightFileScope flight(FlightEvent::Save, SAVE_PATH);
+    {
+        std::ofstream out(std::string(SAVE_PATH) + ".tmp", std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        WriteSnapshot(out, snap);
+        out.flush();
+        if (!out) return false;
+    }
+    return flight.ok = CommitTempFile(SAVE_PATH);
+}
+
+SaveSnapshot Game::MakeSnapshot() const {
+    SaveSnapshot snap;
+    snap.player = player;
+    snap.coins = playerCoins;
+    snap.equippedSkillIndex = equippedSkillIndex;
+    snap.skills = playerSkills;
+    snap.inventory = inventory;
+    snap.journalSeq = journal.LastSeq();
+    return snap;
+}
+
+void Game::AddCoins(int delta) {
+    MEMORY_SCOPE(Save);
+    playerCoins += delta;
+    int32_t values[1] = { delta };
+    journal.Append(JournalOp::CoinsDelta, values, 1);
+    MaybeCompactJournal();
+}
+
+void Game::JournalItem(const std::string& name) {
+    MEMORY_SCOPE(Save);
+    int32_t values[1] = { 0 };
+    for (const auto& item : inventory) {
+        if (item.name == name) {
+            values[0] = item.quantity;
+            break;
+        }
+    }
+    journal.Append(JournalOp::ItemQuantity, values, 1, name);
+    MaybeCompactJournal();
+}
+
+void Game::JournalSkill(const std::string& name) {
+    MEMORY_SCOPE(Save);
+    journal.Append(JournalOp::SkillBought, nullptr, 0, name);
+    MaybeCompactJournal();
+}
+
+void Game::JournalStats() {
+    MEMORY_SCOPE(Save);
+    int32_t values[8] = {
+        player.maxHP, player.currentHP, player.attack, player.defense,
+        player.level, player.exp, player.expToLevel, equippedSkillIndex
+    };
+    journal.Append(JournalOp::Stats, values, 8);
+    MaybeCompactJournal();
+}
+
+void Game::ApplyJournalRecord(const JournalRecord& rec) {
+    std::string key(rec.key, std::find(rec.key, rec.key + sizeof(rec.key), '\0'));
+
+    switch (static_cast<JournalOp>(rec.op)) {
+    case JournalOp::CoinsDelta:
+        playerCoins += rec.values[0];
+        break;
+
+    case JournalOp::ItemQuantity: {
+        auto it = std::find_if(inventory.begin(), inventory.end(),
+            [&](const Item& item) { return item.name == key; });
+        if (rec.values[0] <= 0) {
+            if (it != inventory.end()) inventory.erase(it);
+        }
+        else if (it != inventory.end()) {
+            it->quantity = rec.values[0];
+        }
+        else {
+            const ShopItemDef* def = Content().FindShopItem(key);
+            inventory.push_back({ key, def ? def->description : "", rec.values[0] });
+        }
+        break;
+    }
+
+    case JournalOp::SkillBought: {
+        bool alreadyOwned = std::any_of(playerSkills.begin(), playerSkills.end(),
+            [&](const Skill& skill) { return skill.name == key; });
+        for (auto& skill : availableSkills) {
+            if (skill.name == key) {
+                skill.owned = true;
+                if (!alreadyOwned) playerSkills.push_back(skill);
+            }
+        }
+        break;
+    }
+
+    case JournalOp::Stats:
+        player.maxHP = rec.values[0];
+        player.currentHP = rec.values[1];
+        player.attack = rec.values[2];
+        player.defense = rec.values[3];
+        player.level = rec.values[4];
+        player.exp = rec.values[5];
+        player.expToLevel = rec.values[6];
+        equippedSkillIndex = rec.values[7];
+        break;
+    }
+}
+
+void Game::MaybeCompactJournal() {
+    MEMORY_SCOPE(Save);
+    if (compactionThread.joinable()) {
+        if (compactionDone) FinishCompaction();
+        return;
+    }
+    if (journal.RecordCount() < JOURNAL_COMPACT_THRESHOLD) return;
+
+    // Copy the state here, the worker only touches its own snapshot
+    SaveSnapshot snap = MakeSnapshot();
+    compactionSeq = snap.journalSeq;
+    compactionDone = false;
+    compactionThread = std::thread([this, snap]() {
+        PROFILE_THREAD_NAME("Journal compaction");
+        MEMORY_SCOPE(Save);
+        compactionOk = WriteSnapshotFile(snap);
+        compactionDone = true;
+    });
+}
+
+void Game::FinishCompaction() {
+    MEMORY_SCOPE(Save);
+    if (!compactionThread.joinable()) return;
+    compactionThread.join();
+    if (compactionOk) {
+        journal.Compact(compactionSeq);
+    }
+}
+
+void Game::SaveGame() {
+    PROFILE_ZONE("SaveGame");
+    MEMORY_SCOPE(Save);
+    FinishCompaction();
+    SaveSnapshot snap = MakeSnapshot();
+    if (WriteSnapshotFile(snap)) {
+        journal.Compact(snap.journalSeq);
+    }
 }
 
 void Game::LoadGame() {
-    std::ifstream in("save.dat", std::ios::binary);
-    if (!in) return;
-
-    // Load player name length and name
-    size_t nameLen = 0;
-    in.read(reinterpret_cast<char*>(&nameLen), sizeof(size_t));
-    player.name.resize(nameLen);
-    in.read(&player.name[0], nameLen);
-
-    // Load player stats
-    in.read(reinterpret_cast<char*>(&player.maxHP), sizeof(int));
-    in.read(reinterpret_cast<char*>(&player.currentHP), sizeof(int));
-    in.read(reinterpret_cast<char*>(&player.attack), sizeof(int));
-    in.read(reinterpret_cast<char*>(&player.defense), sizeof(int));
-    in.read(reinterpret_cast<char*>(&player.level), sizeof(int));
-    in.read(reinterpret_cast<char*>(&playerCoins), sizeof(int));
-    in.read(reinterpret_cast<char*>(&player.exp), sizeof(int));
-    in.read(reinterpret_cast<char*>(&player.expToLevel), sizeof(int));
-
-    // Load equipped skill index
-    in.read(reinterpret_cast<char*>(&equippedSkillIndex), sizeof(int));
-
-    // Load player skills
-    size_t skillCount = 0;
-    in.read(reinterpret_cast<char*>(&skillCount), sizeof(size_t));
-    playerSkills.clear();
-    for (size_t i = 0; i < skillCount; ++i) {
-        Skill skill;
-        size_t nameLen = 0, descLen = 0;
-        in.read(reinterpret_cast<char*>(&nameLen), sizeof(size_t));
-        skill.name.resize(nameLen);
-        in.read(&skill.name[0], nameLen);
-        in.read(reinterpret_cast<char*>(&descLen), sizeof(size_t));
-        skill.description.resize(descLen);
-        in.read(&skill.description[0], descLen);
-        in.read(reinterpret_cast<char*>(&skill.price), sizeof(int));
-        in.read(reinterpret_cast<char*>(&skill.owned), sizeof(bool));
-        playerSkills.push_back(skill);
-    }
-
-    // Load inventory
-    size_t invSize = 0;
-    in.read(reinterpret_cast<char*>(&invSize), sizeof(size_t));
-    inventory.clear();
-    for (size_t i = 0; i < invSize; ++i) {
-        Item item;
-        size_t nameLen = 0, descLen = 0;
+    PROFILE_ZONE("LoadGame");
+    MEMORY_SCOPE(Save);
+    FinishCompaction();
+    RecoverTempFile(SAVE_PATH);
+    FlightFileScope flight(FlightEvent::Load, SAVE_PATH);
+
+    uint32_t snapshotSeq = 0;
+    std::ifstream in(SAVE_PATH, std::ios::binary);
+    if (in) {
+        flight.ok = true;
+        // Load player name length and name
+        size_t nameLen = 0;
         in.read(reinterpret_cast<char*>(&nameLen), sizeof(size_t));
-        item.name.resize(nameLen);
-        in.read(&item.name[0], nameLen);
-        in.read(reinterpret_cast<char*>(&descLen), sizeof(size_t));
-        item.description.resize(descLen);
-        in.read(&item.description[0], descLen);
-        in.read(reinterpret_cast<char*>(&item.quantity), sizeof(int));
-        inventory.push_back(item);
+        player.name.resize(nameLen);
+        in.read(&player.name[0], nameLen);
+
+        // Load player stats
+        in.read(reinterpret_cast<char*>(&player.maxHP), sizeof(int));
+        in.read(reinterpret_cast<char*>(&player.currentHP), sizeof(int));
+        in.read(reinterpret_cast<char*>(&player.attack), sizeof(int));
+        in.read(reinterpret_cast<char*>(&player.defense), sizeof(int));
+        in.read(reinterpret_cast<char*>(&player.level), sizeof(int));
+        in.read(reinterpret_cast<char*>(&playerCoins), sizeof(int));
+        in.read(reinterpret_cast<char*>(&player.exp), sizeof(int));
+        in.read(reinterpret_cast<char*>(&player.expToLevel), sizeof(int));
+
+        // Load equipped skill index
+        in.read(reinterpret_cast<char*>(&equippedSkillIndex), sizeof(int));
+
+        // Load player skills
+        size_t skillCount = 0;
+        in.read(reinterpret_cast<char*>(&skillCount), sizeof(size_t));
+        playerSkills.clear();
+        for (size_t i = 0; i < skillCount; ++i) {
+            Skill skill;
+            size_t nameLen = 0, descLen = 0;
+            in.read(reinterpret_cast<char*>(&nameLen), sizeof(size_t));
+            skill.name.resize(nameLen);
+            in.read(&skill.name[0], nameLen);
+            in.read(reinterpret_cast<char*>(&descLen), sizeof(size_t));
+            skill.description.resize(descLen);
+            in.read(&skill.description[0], descLen);
+            in.read(reinterpret_cast<char*>(&skill.price), sizeof(int));
+            in.read(reinterpret_cast<char*>(&skill.owned), sizeof(bool));
+            playerSkills.push_back(skill);
+        }
+
+        // Load inventory
+        size_t invSize = 0;
+        in.read(reinterpret_cast<char*>(&invSize), sizeof(size_t));
+        inventory.clear();
+        for (size_t i = 0; i < invSize; ++i) {
+            Item item;
+            size_t nameLen = 0, descLen = 0;
+            in.read(reinterpret_cast<char*>(&nameLen), sizeof(size_t));
+            item.name.resize(nameLen);
+            in.read(&item.name[0], nameLen);
+            in.read(reinterpret_cast<char*>(&descLen), sizeof(size_t));
+            item.description.resize(descLen);
+            in.read(&item.description[0], descLen);
+            in.read(reinterpret_cast<char*>(&item.quantity), sizeof(int));
+            inventory.push_back(item);
+        }
+
+        // Older saves have no journal sequence, treat them as seq 0
+        if (!in.read(reinterpret_cast<char*>(&snapshotSeq), sizeof(uint32_t))) {
+            snapshotSeq = 0;
+        }
+        in.close();
     }
-    in.close();
-}
 
+    // Replay everything that happened after the snapshot was written
+    for (const auto& rec : journal.ReadAfter(snapshotSeq)) {
+        ApplyJournalRecord(rec);
+    }
+    journal.EnsureSeqAfter(snapshotSeq);
+}
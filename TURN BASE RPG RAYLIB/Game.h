@@ -6,8 +6,21 @@
 #include <vector>
 #include <deque>
 #include <functional>
+#include <thread>
+#include <atomic>
 #include "NotificationObserver.h"
 #include "Command.h"
+#include "SaveJournal.h"
+#include "BattleSim.h"
+#include "BattleStatus.h"
+#include "BattleEvents.h"
+#include "BattleSnapshot.h"
+#include "BattleStats.h"
+#include "Combatants.h"
+#include "Initiative.h"
+#include "Netplay.h"
+#include "LayerCache.h"
+#include "Animation.h"
 
 // Enums
 enum class GameState {
@@ -21,6 +34,7 @@ enum class GameState {
     Shop,
     Battle,
     Arena,
+    Duel,
     Exit,
 };
 
@@ -48,6 +62,7 @@ struct Character{
     int level;
     int exp;
     int expToLevel;
+    int speed = NORMAL_SPEED;  // not saved: every fighter starts at normal speed
 };
 
 struct Skill {
@@ -63,10 +78,26 @@ struct Item {
     int quantity;
 };
 
+// Save files, relative to the working directory
+const char* const SAVE_PATH = "save.dat";
+const char* const JOURNAL_PATH = "save.journal";
+const char* const STATS_PATH = "battle_stats.dat";
+
+// Everything persisted in save.dat, copied out so it can be written off the main thread
+struct SaveSnapshot {
+    Character player;
+    int coins;
+    int equippedSkillIndex;
+    std::vector<Skill> skills;
+    std::vector<Item> inventory;
+    uint32_t journalSeq; // last journal record folded into this snapshot
+};
+
 // Game class
 class Game {
 public:
     Game(int screenWidth, int screenHeight);
+    ~Game();
 
     // Main game screens
     void ShowTownSquare();
@@ -74,6 +105,7 @@ public:
     void ShowMarket();
     void ShowTavern();
     void ShowTrainingGround();
+    void StartPracticeBattle();
     void ShowShop();
     void ShowInventory();
     void ShowSkillShop();
@@ -87,10 +119,18 @@ public:
 
     // Battle
     void StartBattle();
+    // The battle the game was closed in, if there is one
+    bool HasSuspendedBattle() const { return resumeBattle; }
+    void ResumeBattle();
+    void StartSurvival();
+    void ShowDuelLobby();
+    void StartDuel(bool host, const NetAddress& address);
     void UseItem(size_t index);
     void UseEquippedSkill();
     void PlayerAttack();
     void PlayerSkill();
+    void PlayerBlock();
+    void FleeBattle();
     void PerformPlayerAction(int actionIndex);
 
     // Game state
@@ -109,7 +149,6 @@ public:
     void RemoveObserver(NotificationObserver* observer);
 
     // Exposed for commands
-    bool isBlocking;
     GameState state;
 
     // Battle log
@@ -117,26 +156,82 @@ public:
     std::vector<std::string> battleLog;
 
 private:
+    friend class GameBench; // Bench/GameBench.cpp
+
     // Initialization
     void InitPlayer();
     void InitEnemy();
     void InitEnemyForSurvival(int wave);
+    void ResetEnemyEntity();
+    Texture2D EnemyTextureFor(EnemyType type) const;
 
     // Enemy AI
     EnemyAction ChooseEnemyAction() const;
     int GetRandom(int min, int max) const;
 
     // Battle logic
+    void RunBattle();
     void UpdateBattle();
     void DrawBattle();
-    void DrawAttackEffect();
+    void PlayAttackEffect();
+    void PlayHit(Vector2 over, int amount, bool onPlayer);
     void EnemyAttack();
     void CheckBattleResult();
-    void ApplyPoisonDamageIfNeeded();
+    void ReportStatusEvents();
+    bool SkillOnCooldown() const;
+    int SkillCooldownTurns() const;
+    void RefreshWinChance();
+    void ApplyLevelUps();
+
+    // Battle events: every HP and status change in StartBattle's battles goes through these
+    void BeginBattleEvents();
+    void RecordBattleEvent(const BattleEvent& event);
+    void DealDamage(BattleSide side, int amount);
+    void HealPlayer(int amount);  // recorded in battle, direct outside
+    void ApplyStatus(Entity target, StatusKind kind, int duration, int amount = 0);
+    void RemoveStatus(Entity target, StatusKind kind);
+    BattleSide SideOf(Entity e) const;
+    void StartPlayerTurn();
+
+    // Turn order (Initiative.h)
+    void ResetInitiative();
+    void TakeTurn(BattleSide side, int rank);
+    int ActionRank(int actionIndex) const;
+    void RestoreBattleState(const BattleState& saved);
+    void UndoLastTurn();
+
+    // Snapshots (BattleSnapshot.h): quicksave, the rewind ring and battle.sav
+    void TakeSnapshot(BattleSnapshot& out) const;
+    void RestoreSnapshot(const BattleSnapshot& snapshot);
+    int BoostOf(Entity e, StatusKind kind) const;
+    void DropSnapshotsAfter(size_t eventTotal);
+    void QuickLoad();
+
+    // Survival Mode
+    void UpdateGroupBattle();
+    void DrawGroupBattle();
+    Rectangle GroupSlotRect(int index) const;
+
+    // PvP duel; false once the player leaves
+    bool UpdateDuel();
+    void DrawDuel();
 
     // Battle results
     void ShowVictoryScreen(int expGain, int coinGain, const std::string& enemyName);
     void ShowDefeatScreen();
+    void RecordBattleStats(BattleOutcome outcome, int coins, int exp);
+
+    // Save journal
+    SaveSnapshot MakeSnapshot() const;
+    void AddCoins(int delta);
+    void JournalItem(const std::string& name);
+    void JournalSkill(const std::string& name);
+    void JournalStats();
+    void ApplyJournalRecord(const JournalRecord& rec);
+    void MaybeCompactJournal();
+    void FinishCompaction();
+    void BuyShopItem(int index);
+    void RefreshSkillsFromContent();
 
     // Members
     int screenWidth;
@@ -150,6 +245,7 @@ private:
     std::vector<Item> inventory;
     std::vector<Skill> availableSkills;
     std::vector<Skill> playerSkills;
+    unsigned contentGeneration = 0;
 
 
     // In class Game (private section)
@@ -161,34 +257,91 @@ private:
     Texture2D enemyTexture;
     Texture2D battleBgTexture;
 
+    // DrawBattle's background, sprites and panels, drawn again only when they change
+    enum BattlePanel { PANEL_PLAYER, PANEL_TURNS, PANEL_ENEMY, PANEL_LOG, PANEL_ACTIONS, BATTLE_PANELS };
+    LayerCache battleLayers{ BATTLE_PANELS };
 
     int equippedSkillIndex = -1;
     int enemyLevel;
+    std::string lastEncounterEnemy; // for no-repeat encounter rows
     int baseEnemyExp;
     int baseEnemyCoins;
-    bool enemyBlocking = false;
     EnemyAction lastEnemyAction = EnemyAction::Attack;
-    int enemySkillCooldown = 0;
 
-    bool playerPoisoned = false;
-    int poisonTurns = 0;
+    // Blocking, poison, cooldowns and buffs live on these entities (BattleStatus.h).
+    // The player's is kept for the session; each new enemy gets a new one.
+    World battleWorld;
+    StatusEngine statuses{ battleWorld };
+    Entity playerEntity;
+    Entity enemyEntity;
+    std::vector<StatusEvent> statusEvents;
+
+    BattleEventStore battleEvents;
+    bool practiceBattle = false;  // Training Ground: undo allowed, nothing kept
+
+    // Every finished battle, for the Cottage's Battle Records page. The tally
+    // counts the battle in progress and becomes its row.
+    BattleStats battleStats;
+    BattleRecord battleTally;
+
+    SnapshotRing turnSnapshots;  // start of each of the last 64 turns
+    BattleSnapshot quickSave;
+    bool haveQuickSave = false;
+    BattleSnapshot suspendedBattle;
+    bool resumeBattle = false;
+
+    // Survival Mode: the player in slot 0 against a wave of enemies
+    static constexpr int SURVIVAL_MAX_ENEMIES = 60;
+    CombatantPool group;
+    SimRng groupRng{ 1 };
+    std::vector<CombatEvent> groupEvents;
+    int survivalWave = 0;
+    int groupTarget = -1;
+    int waveExp = 0;
+    int waveCoins = 0;
+
+    // PvP duel (Netplay.h). Drawn from duel.Shown(), so the opponent's late
+    // action can redo the turns already on screen.
+    UdpLink duelLink;
+    DuelSession duel;
+    std::string duelAddress = "127.0.0.1";
+    int duelShownTurn = 0;
+    uint32_t duelRollbacks = 0;
+    int duelLoggedTurn = 0;
+    double duelHitTime = -1.0;  // animClock time the last turn shown started its hit numbers
+
+    // Exact odds from the current turn on, shown in DrawBattle
+    BattleOdds battleOdds;
+    SimOdds winOdds = { 0.0, 0.0 };
 
     int playerCoins = 0;
     int selectedAction = 0;
 
-    int skillCooldownTurns = 0;
-    bool skillOnCooldown = false;
-
     std::string notificationText;
     int notificationTimer = 0;
 
-    bool showAttackEffect = false;
-    int attackEffectFrame = 0;
+    // The attack text, damage numbers, flashes and eased HP bars (Animation.h).
+    // The clock only runs in the battle loops, so it stands still on the
+    // screens they open.
+    enum AnimKey : uint16_t { ANIM_PLAYER_HP, ANIM_ENEMY_HP, ANIM_GROUP_HP };  // ANIM_GROUP_HP + slot
+    GameClock animClock;
+    AnimationPool animations;
+    double nextHitAt = 0.0;  // hits in one turn show one after another
 
     bool isPlayerTurn = true;
-    bool skipEnemyTurn = false;
+    // Actor numbers are BattleSide values; TimeOf each is in the battle events too
+    Initiative initiative;
+    int playerActionRank = RANK_NORMAL;  // of the action that just ended the player's turn
 
     std::vector<NotificationObserver*> observers;
+
+    // Journal is folded into save.dat once it holds this many records
+    static const size_t JOURNAL_COMPACT_THRESHOLD = 256;
+    SaveJournal journal{ JOURNAL_PATH };
+    std::thread compactionThread;
+    std::atomic<bool> compactionDone{ false };
+    bool compactionOk = false;
+    uint32_t compactionSeq = 0;
 };
 
 #endif // GAME_H
@@ -0,0 +1,126 @@
+#include "Initiative.h"
+
+void Initiative::Clear() {
+    heap.clear();
+    slot.clear();
+    speed.clear();
+}
+
+void Initiative::Reserve(int count) {
+    heap.reserve(count);
+    slot.reserve(count);
+    speed.reserve(count);
+}
+
+int Initiative::Add(int actorSpeed) {
+    int actor = static_cast<int>(slot.size());
+    speed.push_back(std::max(MIN_SPEED, actorSpeed));
+    slot.push_back(static_cast<int>(heap.size()));
+    heap.push_back({ Now(), actor });
+    SiftUp(slot[actor]);
+    return actor;
+}
+
+void Initiative::Remove(int actor) {
+    if (!Contains(actor)) return;
+    int index = slot[actor];
+    Entry last = heap.back();
+    heap.pop_back();
+    slot[actor] = -1;
+    if (index < static_cast<int>(heap.size())) {
+        Place(index, last);
+        Fix(index);
+    }
+}
+
+void Initiative::Act(int rank) {
+    if (heap.empty()) return;
+    heap[0].time += ActionDelay(speed[heap[0].actor], rank);
+    SiftDown(0);
+}
+
+void Initiative::SetSpeed(int actor, int newSpeed) {
+    if (!Contains(actor)) return;
+    newSpeed = std::max(MIN_SPEED, newSpeed);
+    Entry& entry = heap[slot[actor]];
+    int64_t left = static_cast<int64_t>(entry.time) - Now();
+    entry.time = Now() + static_cast<int32_t>(left * speed[actor] / newSpeed);
+    speed[actor] = newSpeed;
+    Fix(slot[actor]);
+}
+
+void Initiative::SetTime(int actor, int32_t at) {
+    if (!Contains(actor)) return;
+    heap[slot[actor]].time = at;
+    Fix(slot[actor]);
+}
+
+// Best-first over the heap: a popped entry brings in its two heap children
+// and its own following turn, so nothing below the first count entries is read
+int Initiative::Preview(int* out, int count, int firstRank) const {
+    struct Candidate {
+        Entry entry;
+        int index;  // in heap, or -1 for a turn after the one there
+    };
+    // std::push_heap builds a max-heap, so "less" is "acts later"
+    auto later = [](const Candidate& a, const Candidate& b) { return Before(b.entry, a.entry); };
+
+    count = std::min(count, PREVIEW_MAX);
+    Candidate open[3 * PREVIEW_MAX + 1];
+    int openCount = 0;
+    if (!heap.empty()) open[openCount++] = { heap[0], 0 };
+
+    int written = 0;
+    while (written < count && openCount > 0) {
+        std::pop_heap(open, open + openCount, later);
+        Candidate next = open[--openCount];
+        int actor = next.entry.actor;
+        out[written++] = actor;
+
+        int rank = (next.index == 0) ? firstRank : RANK_NORMAL;
+        open[openCount++] = { { next.entry.time + ActionDelay(speed[actor], rank), actor }, -1 };
+        std::push_heap(open, open + openCount, later);
+        if (next.index < 0) continue;
+        for (int child = 2 * next.index + 1; child <= 2 * next.index + 2 && child < static_cast<int>(heap.size()); ++child) {
+            open[openCount++] = { heap[child], child };
+            std::push_heap(open, open + openCount, later);
+        }
+    }
+    return written;
+}
+
+void Initiative::Place(int index, const Entry& entry) {
+    heap[index] = entry;
+    slot[entry.actor] = index;
+}
+
+void Initiative::SiftUp(int index) {
+    Entry entry = heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!Before(entry, heap[parent])) break;
+        Place(index, heap[parent]);
+        index = parent;
+    }
+    Place(index, entry);
+}
+
+void Initiative::SiftDown(int index) {
+    Entry entry = heap[index];
+    int size = static_cast<int>(heap.size());
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= size) break;
+        if (child + 1 < size && Before(heap[child + 1], heap[child])) child++;
+        if (!Before(heap[child], entry)) break;
+        Place(index, heap[child]);
+        index = child;
+    }
+    Place(index, entry);
+}
+
+// After the entry at index moved either way
+void Initiative::Fix(int index) {
+    if (index > 0 && Before(heap[index], heap[(index - 1) / 2])) SiftUp(index);
+    else SiftDown(index);
+}
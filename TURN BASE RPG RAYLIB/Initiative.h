@@ -0,0 +1,81 @@
+// Initiative.h
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Charge-time turn order. After acting, an actor waits a delay set by its
+// speed and by the rank of what it did, and whoever's wait runs out first
+// goes next; ties go to the actor added first. Actors sit in a binary heap
+// keyed by their next action time, with each actor's heap position kept, so
+// taking a turn, changing a speed or dropping an actor is O(log n).
+//
+// There is no separate clock: Now() is the time of the next actor, and the
+// times themselves are plain numbers that can be saved and put back.
+
+const int NORMAL_SPEED = 100;
+const int MIN_SPEED = 25;
+const int32_t NORMAL_DELAY = 120;  // ticks between turns at NORMAL_SPEED
+
+// Ranks: a percentage of a normal action's delay
+const int RANK_NORMAL = 100;
+const int RANK_QUICK = 50;  // priority skills; the next turn comes twice as soon
+const int RANK_FREE = 0;    // the same actor goes again
+
+inline int32_t ActionDelay(int speed, int rank) {
+    if (rank <= 0) return 0;
+    return std::max<int32_t>(1, NORMAL_DELAY * rank / std::max(MIN_SPEED, speed));
+}
+
+class Initiative {
+public:
+    static constexpr int NONE = -1;
+    static constexpr int PREVIEW_MAX = 16;
+
+    void Clear();
+    void Reserve(int count);
+
+    // Ready at Now() (0 when empty); actors are numbered from 0 in the order added
+    int Add(int speed);
+    // Out of the order for good, e.g. fallen; the number isn't reused until Clear
+    void Remove(int actor);
+
+    int Count() const { return static_cast<int>(heap.size()); }
+    bool Contains(int actor) const { return actor >= 0 && actor < static_cast<int>(slot.size()) && slot[actor] >= 0; }
+    // Who acts next; NONE when nobody is left
+    int Next() const { return heap.empty() ? NONE : heap[0].actor; }
+    int32_t Now() const { return heap.empty() ? 0 : heap[0].time; }
+    int32_t TimeOf(int actor) const { return heap[slot[actor]].time; }
+    int SpeedOf(int actor) const { return speed[actor]; }
+
+    // Next() takes its turn: it waits ActionDelay(speed, rank) from now
+    void Act(int rank = RANK_NORMAL);
+    // Haste and slow. The wait left is stretched or shrunk in proportion, so
+    // a change halfway to a turn keeps the half already waited.
+    void SetSpeed(int actor, int newSpeed);
+    // For snapshots and undo
+    void SetTime(int actor, int32_t at);
+
+    // The next count actors, Next() first, as if nobody changes speed and
+    // everyone acts at RANK_NORMAL except Next(), which acts at firstRank.
+    // Walks only the top of the heap: O(count log count) for any number of
+    // actors. count is capped at PREVIEW_MAX; returns how many were written.
+    int Preview(int* out, int count, int firstRank = RANK_NORMAL) const;
+
+private:
+    // The time sits in the heap itself, so sifting reads nothing else
+    struct Entry {
+        int32_t time;  // of the actor's next action
+        int32_t actor;
+    };
+
+    static bool Before(const Entry& a, const Entry& b) { return a.time < b.time || (a.time == b.time && a.actor < b.actor); }
+    void Place(int index, const Entry& entry);
+    void SiftUp(int index);
+    void SiftDown(int index);
+    void Fix(int index);
+
+    std::vector<Entry> heap;
+    std::vector<int> slot;  // heap index by actor; -1 once removed
+    std::vector<int32_t> speed;
+};
@@ -0,0 +1,155 @@
+#include "Input.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+namespace {
+
+LiveInput liveInput;
+InputProvider* provider = &liveInput;
+
+InputFrame current;
+int charsRead = 0;
+double gameClock = 0.0;
+
+// Latency probe: input handled this frame waits for the swap that shows it
+struct PendingLatency {
+    double polledAt;
+    int frames;
+    int swapsLeft;
+};
+InputLatency latency;
+PendingLatency pending[2];
+int pendingCount = 0;
+bool handledThisFrame = false;
+bool drawing = false;
+
+double NowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A query saw input: it shows in this frame's swap unless drawing has begun
+void Handled() {
+    if (handledThisFrame || pendingCount == 2) return;
+    handledThisFrame = true;
+    int frames = drawing ? 2 : 1;
+    pending[pendingCount++] = { current.polledAt, frames, frames };
+}
+
+} // namespace
+
+void LiveInput::NextFrame(InputFrame& frame) {
+    frame = InputFrame();
+
+    double now = NowSeconds();
+    frame.frameTime = lastFrameEnd > 0.0 ? (float)(now - lastFrameEnd) : 0.0f;
+    lastFrameEnd = now;
+
+    // Headless runs have no window to poll
+    if (!IsWindowReady()) return;
+
+    // Drains raylib's queues; they are refilled by the next EndDrawing anyway
+    for (int key = ::GetKeyPressed(); key != 0; key = ::GetKeyPressed()) {
+        if (frame.keyCount < InputFrame::MAX_KEYS) frame.keys[frame.keyCount++] = (uint16_t)key;
+    }
+    for (int ch = ::GetCharPressed(); ch != 0; ch = ::GetCharPressed()) {
+        if (frame.charCount < InputFrame::MAX_CHARS) frame.chars[frame.charCount++] = (uint32_t)ch;
+    }
+    for (int button = 0; button < InputFrame::MOUSE_BUTTONS; ++button) {
+        if (::IsMouseButtonPressed(button)) frame.mouseButtons |= (uint8_t)(1 << button);
+    }
+    frame.mouse = ::GetMousePosition();
+}
+
+unsigned LiveInput::RandomSeed() {
+    return static_cast<unsigned>(time(nullptr));
+}
+
+void Input::NewFrame() {
+    provider->NextFrame(current);
+    current.polledAt = NowSeconds();
+    charsRead = 0;
+    gameClock += current.frameTime;
+    handledThisFrame = false;
+}
+
+void Input::Spend() {
+    current.keyCount = 0;
+    current.charCount = 0;
+    current.mouseButtons = 0;
+    charsRead = 0;
+}
+
+void Input::OnDrawBegin() {
+    drawing = true;
+}
+
+void Input::OnFrameSwapped() {
+    drawing = false;
+    double now = NowSeconds();
+    int kept = 0;
+    for (int i = 0; i < pendingCount; ++i) {
+        PendingLatency& p = pending[i];
+        if (--p.swapsLeft > 0) {
+            pending[kept++] = p;
+            continue;
+        }
+        double ms = (now - p.polledAt) * 1000.0;
+        latency.events++;
+        if (p.frames > 1) latency.late++;
+        latency.lastMs = ms;
+        latency.lastFrames = p.frames;
+        latency.maxMs = std::max(latency.maxMs, ms);
+        latency.totalMs += ms;
+    }
+    pendingCount = kept;
+}
+
+const InputLatency& Input::Latency() {
+    return latency;
+}
+
+void Input::SetProvider(InputProvider* newProvider) {
+    provider = newProvider ? newProvider : &liveInput;
+}
+
+bool Input::IsKeyPressed(int key) {
+    for (int i = 0; i < current.keyCount; ++i) {
+        if (current.keys[i] != key) continue;
+        Handled();
+        return true;
+    }
+    return false;
+}
+
+bool Input::IsMouseButtonPressed(int button) {
+    if (button < 0 || button >= InputFrame::MOUSE_BUTTONS || (current.mouseButtons & (1 << button)) == 0) return false;
+    Handled();
+    return true;
+}
+
+Vector2 Input::GetMousePosition() {
+    return current.mouse;
+}
+
+int Input::GetCharPressed() {
+    if (charsRead >= current.charCount) return 0;
+    Handled();
+    return (int)current.chars[charsRead++];
+}
+
+double Input::GetTime() {
+    return gameClock;
+}
+
+float Input::GetFrameTime() {
+    return current.frameTime;
+}
+
+unsigned Input::RandomSeed() {
+    return provider->RandomSeed();
+}
+
+const InputFrame& Input::CurrentFrame() {
+    return current;
+}
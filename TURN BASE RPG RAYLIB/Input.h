@@ -0,0 +1,94 @@
+// Input.h
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+
+// Game code reads input through Input:: instead of raylib, so a frame's input
+// can come from the keyboard/mouse, a recording, or both at once (recording
+// while playing). Method names follow raylib's.
+//
+// Everything a provider hands out is sampled once per frame in EndFrame and
+// stays the same until the next one, no matter how often it is queried.
+
+// Input seen during one frame
+struct InputFrame {
+    static const int MAX_KEYS = 16;
+    static const int MAX_CHARS = 16;
+    static const int MOUSE_BUTTONS = 3; // left, right, middle
+
+    uint16_t keys[MAX_KEYS];   // pressed this frame
+    uint8_t keyCount = 0;
+    uint32_t chars[MAX_CHARS]; // unicode codepoints typed this frame, in order
+    uint8_t charCount = 0;
+    uint8_t mouseButtons = 0;  // bit per button pressed this frame
+    Vector2 mouse = { 0.0f, 0.0f };
+    float frameTime = 0.0f;    // seconds since the previous frame
+    double polledAt = 0.0;     // steady clock seconds when it was sampled; not recorded
+};
+
+// Time from a frame's input being sampled to the swap of the first frame drawn
+// after the game acted on it: the frame itself when it was handled before
+// drawing began, one more when it was handled while drawing. Measured once per
+// frame in which a key, button or character query came back true.
+struct InputLatency {
+    uint64_t events = 0;
+    uint64_t late = 0;       // took two swaps to show
+    double lastMs = 0.0;
+    double maxMs = 0.0;
+    double totalMs = 0.0;
+    int lastFrames = 0;      // swaps from the poll to the one that showed it
+};
+
+class InputProvider {
+public:
+    virtual ~InputProvider() = default;
+
+    // Fills in the input for the frame that just ended
+    virtual void NextFrame(InputFrame& frame) = 0;
+
+    // Seed for rand(). The one thing besides input that makes two runs differ.
+    virtual unsigned RandomSeed() = 0;
+};
+
+// Reads the real keyboard and mouse, with the wall clock
+class LiveInput : public InputProvider {
+public:
+    void NextFrame(InputFrame& frame) override;
+    unsigned RandomSeed() override;
+
+private:
+    double lastFrameEnd = 0.0;
+};
+
+namespace Input {
+    // Samples the next frame from the current provider, called by EndFrame
+    void NewFrame();
+
+    // Drops this frame's presses and typed characters; the mouse stays where
+    // it is. Called when a screen is entered or left, so the press that did it
+    // is not handled again by the next screen.
+    void Spend();
+
+    // Latency probe, driven by BeginFrame/EndFrame: drawing has started, and
+    // the frame has been swapped to the screen
+    void OnDrawBegin();
+    void OnFrameSwapped();
+    const InputLatency& Latency();
+
+    // Defaults to LiveInput; nullptr goes back to it
+    void SetProvider(InputProvider* provider);
+
+    bool IsKeyPressed(int key);
+    bool IsMouseButtonPressed(int button);
+    Vector2 GetMousePosition();
+    // Pops the next typed character, 0 when there are none left this frame
+    int GetCharPressed();
+
+    // Game clock: the sum of frame times, so it follows the provider's clock
+    double GetTime();
+    float GetFrameTime();
+
+    unsigned RandomSeed();
+
+    const InputFrame& CurrentFrame();
+}
@@ -0,0 +1,254 @@
+#include "InputRecording.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+static const char* const BACKUP_SUFFIX = ".replay-backup";
+static const char* const ABSENT_SUFFIX = ".replay-absent";
+
+static bool ReadWholeFile(const std::string& path, std::string& bytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+template <typename T>
+static void WriteValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool ReadValue(const uint8_t* data, size_t size, size_t& cursor, T& value) {
+    if (size - cursor < sizeof(T)) return false;
+    std::memcpy(&value, data + cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+// Decodes one frame record; false if the data ends in the middle of it
+static bool DecodeFrame(const uint8_t* data, size_t size, size_t& cursor, InputFrame& frame, Vector2& lastMouse) {
+    uint8_t flags = 0;
+    if (!ReadValue(data, size, cursor, flags)) return false;
+
+    frame = InputFrame();
+    if (flags & FRAME_MOUSE) {
+        int16_t x = 0, y = 0;
+        if (!ReadValue(data, size, cursor, x) || !ReadValue(data, size, cursor, y)) return false;
+        lastMouse = { (float)x, (float)y };
+    }
+    frame.mouse = lastMouse;
+    if ((flags & FRAME_BUTTONS) && !ReadValue(data, size, cursor, frame.mouseButtons)) return false;
+    if (flags & FRAME_KEYS) {
+        if (!ReadValue(data, size, cursor, frame.keyCount) || frame.keyCount > InputFrame::MAX_KEYS) return false;
+        for (int i = 0; i < frame.keyCount; ++i) {
+            if (!ReadValue(data, size, cursor, frame.keys[i])) return false;
+        }
+    }
+    if (flags & FRAME_CHARS) {
+        if (!ReadValue(data, size, cursor, frame.charCount) || frame.charCount > InputFrame::MAX_CHARS) return false;
+        for (int i = 0; i < frame.charCount; ++i) {
+            if (!ReadValue(data, size, cursor, frame.chars[i])) return false;
+        }
+    }
+    return true;
+}
+
+bool InputRecorder::Open(const std::string& path, const std::vector<std::string>& capturedFiles, uint32_t fps) {
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "[Input] Cannot write " << path << std::endl;
+        return false;
+    }
+
+    frameTime = 1.0f / (float)fps;
+    seed = source.RandomSeed();
+    InputRecordingHeader header = { INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION, fps, seed, (uint32_t)capturedFiles.size() };
+    WriteValue(out, header);
+
+    for (const std::string& file : capturedFiles) {
+        std::string bytes;
+        bool present = ReadWholeFile(file, bytes);
+        WriteValue(out, (uint16_t)file.size());
+        out.write(file.data(), file.size());
+        WriteValue(out, present ? (uint32_t)bytes.size() : INPUT_FILE_ABSENT);
+        out.write(bytes.data(), bytes.size());
+    }
+    std::cout << "[Input] Recording to " << path << std::endl;
+    return true;
+}
+
+void InputRecorder::Close() {
+    if (!out.is_open()) return;
+    out.close();
+    std::cout << "[Input] Recorded " << frames << " frames" << std::endl;
+}
+
+void InputRecorder::NextFrame(InputFrame& frame) {
+    source.NextFrame(frame);
+    frame.frameTime = frameTime;
+    frames++;
+    if (!out.is_open()) return;
+
+    // Positions are whole pixels in every screen we have
+    int16_t x = (int16_t)frame.mouse.x;
+    int16_t y = (int16_t)frame.mouse.y;
+    frame.mouse = { (float)x, (float)y };
+    bool mouseMoved = frames == 1 || frame.mouse.x != lastMouse.x || frame.mouse.y != lastMouse.y;
+    lastMouse = frame.mouse;
+
+    uint8_t flags = (mouseMoved ? FRAME_MOUSE : 0) | (frame.mouseButtons ? FRAME_BUTTONS : 0) |
+        (frame.keyCount ? FRAME_KEYS : 0) | (frame.charCount ? FRAME_CHARS : 0);
+    WriteValue(out, flags);
+    if (flags & FRAME_MOUSE) {
+        WriteValue(out, x);
+        WriteValue(out, y);
+    }
+    if (flags & FRAME_BUTTONS) WriteValue(out, frame.mouseButtons);
+    if (flags & FRAME_KEYS) {
+        WriteValue(out, frame.keyCount);
+        out.write(reinterpret_cast<const char*>(frame.keys), frame.keyCount * sizeof(frame.keys[0]));
+    }
+    if (flags & FRAME_CHARS) {
+        WriteValue(out, frame.charCount);
+        out.write(reinterpret_cast<const char*>(frame.chars), frame.charCount * sizeof(frame.chars[0]));
+    }
+}
+
+unsigned InputRecorder::RandomSeed() {
+    return seed + seedsHandedOut++;
+}
+
+bool InputPlayback::Load(const std::string& path) {
+    std::string bytes;
+    if (!ReadWholeFile(path, bytes)) {
+        std::cerr << "[Input] Cannot read " << path << std::endl;
+        return false;
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.data());
+    size_t size = bytes.size();
+    size_t cursor = 0;
+
+    if (!ReadValue(data, size, cursor, header) || header.magic != INPUT_RECORDING_MAGIC ||
+        header.version != INPUT_RECORDING_VERSION || header.fps == 0) {
+        std::cerr << "[Input] " << path << " is not an input recording" << std::endl;
+        return false;
+    }
+
+    recordedFiles.clear();
+    for (uint32_t i = 0; i < header.fileCount; ++i) {
+        CapturedFile file;
+        uint16_t pathLength = 0;
+        uint32_t fileSize = 0;
+        if (!ReadValue(data, size, cursor, pathLength) || size - cursor < pathLength) return false;
+        file.path.assign(bytes, cursor, pathLength);
+        cursor += pathLength;
+        if (!ReadValue(data, size, cursor, fileSize)) return false;
+        file.present = fileSize != INPUT_FILE_ABSENT;
+        if (file.present) {
+            if (size - cursor < fileSize) return false;
+            file.bytes.assign(bytes, cursor, fileSize);
+            cursor += fileSize;
+        }
+        recordedFiles.push_back(file);
+    }
+
+    // Count frames up front; a torn last frame (crash while recording) is dropped
+    frameData.assign(data + cursor, data + size);
+    size_t scan = 0;
+    size_t validEnd = 0;
+    InputFrame frame;
+    Vector2 mouse = { 0.0f, 0.0f };
+    frameCount = 0;
+    while (scan < frameData.size() && DecodeFrame(frameData.data(), frameData.size(), scan, frame, mouse)) {
+        validEnd = scan;
+        frameCount++;
+    }
+    frameData.resize(validEnd);
+
+    cursor = 0;
+    framesPlayed = 0;
+    seedsHandedOut = 0;
+    lastMouse = { 0.0f, 0.0f };
+    std::cout << "[Input] Playing " << path << ": " << frameCount << " frames at " << header.fps << " fps" << std::endl;
+    return true;
+}
+
+bool InputPlayback::InstallFiles(const std::vector<std::string>& gameFiles) {
+    // Recordings are shared around; one must not be able to write anywhere else
+    for (const CapturedFile& file : recordedFiles) {
+        if (std::find(gameFiles.begin(), gameFiles.end(), file.path) == gameFiles.end()) {
+            std::cerr << "[Input] Recording carries " << file.path << ", which is not a save file" << std::endl;
+            return false;
+        }
+    }
+    for (const std::string& path : gameFiles) {
+        bool recorded = false;
+        for (const CapturedFile& file : recordedFiles) recorded = recorded || file.path == path;
+        if (!recorded) recordedFiles.push_back({ path, false, "" });
+    }
+
+    // Anything an earlier replay left behind goes back first, or it would be
+    // backed up in place of the player's files
+    RecoverFiles(gameFiles);
+
+    installedPaths.clear();
+    bool ok = true;
+    for (const CapturedFile& recorded : recordedFiles) {
+        // The backup is on disk before the file is touched, so a crash at any
+        // point leaves RecoverFiles something to put back
+        bool backedUp = std::ifstream(recorded.path, std::ios::binary)
+            ? std::rename(recorded.path.c_str(), (recorded.path + BACKUP_SUFFIX).c_str()) == 0
+            : static_cast<bool>(std::ofstream(recorded.path + ABSENT_SUFFIX, std::ios::binary | std::ios::trunc));
+        if (!backedUp) {
+            std::cerr << "[Input] Cannot back up " << recorded.path << std::endl;
+            ok = false;
+            break;
+        }
+        installedPaths.push_back(recorded.path);
+
+        if (recorded.present) {
+            std::ofstream out(recorded.path, std::ios::binary | std::ios::trunc);
+            out.write(recorded.bytes.data(), recorded.bytes.size());
+            ok = ok && out.good();
+        }
+    }
+    if (!ok) RestoreFiles();
+    return ok;
+}
+
+void InputPlayback::RestoreFiles() {
+    RecoverFiles(installedPaths);
+    installedPaths.clear();
+}
+
+void InputPlayback::RecoverFiles(const std::vector<std::string>& gameFiles) {
+    for (const std::string& path : gameFiles) {
+        std::string backup = path + BACKUP_SUFFIX;
+        std::string absent = path + ABSENT_SUFFIX;
+        if (std::ifstream(backup, std::ios::binary)) {
+            std::remove(path.c_str());
+            std::rename(backup.c_str(), path.c_str());
+        }
+        else if (std::ifstream(absent, std::ios::binary)) {
+            std::remove(path.c_str());
+            std::remove(absent.c_str());
+        }
+    }
+}
+
+void InputPlayback::NextFrame(InputFrame& frame) {
+    if (Finished()) {
+        fallback.NextFrame(frame);
+        return;
+    }
+    DecodeFrame(frameData.data(), frameData.size(), cursor, frame, lastMouse);
+    frame.frameTime = 1.0f / (float)header.fps;
+    framesPlayed++;
+}
+
+unsigned InputPlayback::RandomSeed() {
+    return header.seed + seedsHandedOut++;
+}
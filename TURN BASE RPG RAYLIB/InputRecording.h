@@ -0,0 +1,109 @@
+// InputRecording.h
+#pragma once
+#include "Input.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Input recordings (*.rpgi) replay a play session frame for frame.
+//
+// Both recording and playback run the game on a fixed frame clock and seed
+// rand() from the file, and the save files present when recording started are
+// stored in the file too. Playing it back therefore walks through exactly the
+// same screens and battles, which makes it usable as a performance scenario.
+//
+// Layout: InputRecordingHeader, the captured files (uint16 path length, path,
+// uint32 size or INPUT_FILE_ABSENT, bytes), then one record per frame: a flags
+// byte followed only by the parts present that frame. An idle frame is 1 byte.
+
+const uint32_t INPUT_RECORDING_MAGIC = 0x49475052; // "RPGI"
+const uint32_t INPUT_RECORDING_VERSION = 1;
+const uint32_t INPUT_FILE_ABSENT = 0xFFFFFFFFu;
+
+struct InputRecordingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fps;       // frame clock; every frame advances time by 1 / fps
+    uint32_t seed;      // RandomSeed() returns seed, seed + 1, ...
+    uint32_t fileCount;
+};
+
+enum InputFrameFlags : uint8_t {
+    FRAME_MOUSE = 1,   // int16 x, int16 y (only when the mouse moved)
+    FRAME_BUTTONS = 2, // uint8 pressed mask
+    FRAME_KEYS = 4,    // uint8 count, uint16 keys
+    FRAME_CHARS = 8    // uint8 count, uint32 codepoints
+};
+
+// Passes another provider's input through and writes it to a file
+class InputRecorder : public InputProvider {
+public:
+    explicit InputRecorder(InputProvider& source) : source(source) {}
+    ~InputRecorder() override { Close(); }
+
+    // capturedFiles are copied into the recording as they are right now
+    bool Open(const std::string& path, const std::vector<std::string>& capturedFiles, uint32_t fps);
+    void Close();
+
+    void NextFrame(InputFrame& frame) override;
+    unsigned RandomSeed() override;
+
+    uint64_t FrameCount() const { return frames; }
+
+private:
+    InputProvider& source;
+    std::ofstream out;
+    float frameTime = 0.0f;
+    uint32_t seed = 0;
+    uint32_t seedsHandedOut = 0;
+    Vector2 lastMouse = { 0.0f, 0.0f };
+    uint64_t frames = 0;
+};
+
+// Feeds a recording back frame by frame. Once it runs out, input comes from
+// the fallback provider so a windowed replay can be played on from there.
+class InputPlayback : public InputProvider {
+public:
+    explicit InputPlayback(InputProvider& fallback) : fallback(fallback) {}
+
+    bool Load(const std::string& path);
+
+    // Swaps the recorded save files in. The player's own are renamed to
+    // "<path>.replay-backup" first (or "<path>.replay-absent" is left behind
+    // when there was none), so they survive the replay being killed. Any of
+    // gameFiles the recording predates is moved aside as well, so the replay
+    // starts without it like the recorded session did. Fails without touching
+    // anything if the recording carries a file that is not one of gameFiles.
+    bool InstallFiles(const std::vector<std::string>& gameFiles);
+    // Puts back what InstallFiles replaced
+    void RestoreFiles();
+    // Puts back what a replay that never got to RestoreFiles replaced; call
+    // at startup before anything reads gameFiles
+    static void RecoverFiles(const std::vector<std::string>& gameFiles);
+
+    void NextFrame(InputFrame& frame) override;
+    unsigned RandomSeed() override;
+
+    uint64_t FrameCount() const { return frameCount; }
+    uint64_t FramesPlayed() const { return framesPlayed; }
+    bool Finished() const { return framesPlayed >= frameCount; }
+
+private:
+    struct CapturedFile {
+        std::string path;
+        bool present = false;
+        std::string bytes;
+    };
+
+    InputProvider& fallback;
+    InputRecordingHeader header = {};
+    std::vector<CapturedFile> recordedFiles;
+    std::vector<std::string> installedPaths;
+    std::vector<uint8_t> frameData;
+    size_t cursor = 0;
+    uint64_t frameCount = 0;
+    uint64_t framesPlayed = 0;
+    uint32_t seedsHandedOut = 0;
+    Vector2 lastMouse = { 0.0f, 0.0f };
+};
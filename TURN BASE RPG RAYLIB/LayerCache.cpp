@@ -0,0 +1,134 @@
+#include "LayerCache.h"
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+uint64_t Mix(uint64_t hash, const char* bytes, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+} // namespace
+
+LayerStamp& LayerStamp::Add(int64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash ^= static_cast<uint64_t>(value >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return *this;
+}
+
+// With the length after it, so "ab" + "c" and "a" + "bc" differ
+LayerStamp& LayerStamp::Add(const std::string& text) {
+    hash = Mix(hash, text.data(), text.size());
+    return Add(static_cast<int64_t>(text.size()));
+}
+
+LayerStamp& LayerStamp::Add(const char* text) {
+    size_t length = std::strlen(text);
+    hash = Mix(hash, text, length);
+    return Add(static_cast<int64_t>(length));
+}
+
+void LayerCache::Unload() {
+    for (RenderTexture2D* target : { &backdrop, &screen }) {
+        if (target->id == 0) continue;
+        MemoryTracker::OnTextureUnloaded(target->texture);
+        Gfx().UnloadRenderTexture(*target);
+        *target = RenderTexture2D{};
+    }
+    Invalidate();
+}
+
+void LayerCache::Invalidate() {
+    backdropDrawn = false;
+    for (Panel& panel : panels) panel = Panel();
+}
+
+bool LayerCache::BackdropDirty(uint64_t stamp) const {
+    return !backdropDrawn || stamp != backdropStamp ||
+        screen.texture.width != Gfx().Width() || screen.texture.height != Gfx().Height();
+}
+
+void LayerCache::BeginBackdrop(uint64_t stamp) {
+    int width = Gfx().Width();
+    int height = Gfx().Height();
+    if (screen.texture.width != width || screen.texture.height != height) {
+        Unload();
+        backdrop = Gfx().LoadRenderTexture(width, height);
+        screen = Gfx().LoadRenderTexture(width, height);
+        MemoryTracker::OnTextureLoaded(backdrop.texture);
+        MemoryTracker::OnTextureLoaded(screen.texture);
+    }
+    backdropStamp = stamp;
+    Gfx().BeginTextureMode(backdrop);
+    Gfx().ClearBackground(BLANK);
+}
+
+void LayerCache::EndBackdrop() {
+    Gfx().EndTextureMode();
+
+    // Every panel was drawn over the old one
+    Gfx().BeginTextureMode(screen);
+    CopyBackdrop(Rectangle{ 0, 0, (float)screen.texture.width, (float)screen.texture.height });
+    Gfx().EndTextureMode();
+    for (Panel& panel : panels) panel = Panel();
+    backdropDrawn = true;
+    redraws++;
+}
+
+bool LayerCache::PanelDirty(int panel, uint64_t stamp) const {
+    return !panels[panel].drawn || panels[panel].stamp != stamp;
+}
+
+void LayerCache::BeginPanel(int index, uint64_t stamp, Rectangle area) {
+    Panel& panel = panels[index];
+
+    // Whole pixels, on screen
+    float x0 = std::max(0.0f, std::floor(area.x));
+    float y0 = std::max(0.0f, std::floor(area.y));
+    float x1 = std::min((float)screen.texture.width, std::ceil(area.x + area.width));
+    float y1 = std::min((float)screen.texture.height, std::ceil(area.y + area.height));
+    area = Rectangle{ x0, y0, std::max(0.0f, x1 - x0), std::max(0.0f, y1 - y0) };
+
+    // What it covered last time goes back to the backdrop as well
+    Rectangle restore = area;
+    if (panel.drawn) {
+        const Rectangle& old = panel.area;
+        restore.x = std::min(area.x, old.x);
+        restore.y = std::min(area.y, old.y);
+        restore.width = std::max(area.x + area.width, old.x + old.width) - restore.x;
+        restore.height = std::max(area.y + area.height, old.y + old.height) - restore.y;
+    }
+
+    Gfx().BeginTextureMode(screen);
+    CopyBackdrop(restore);
+    panel.drawn = true;
+    panel.stamp = stamp;
+    panel.area = area;
+}
+
+void LayerCache::EndPanel() {
+    Gfx().EndTextureMode();
+    redraws++;
+}
+
+void LayerCache::Draw() {
+    float height = (float)screen.texture.height;
+    Gfx().DrawTextureRec(screen.texture, Rectangle{ 0, 0, (float)screen.texture.width, -height }, Vector2{ 0, 0 }, WHITE);
+}
+
+void LayerCache::CopyBackdrop(Rectangle area) {
+    if (area.width <= 0 || area.height <= 0) return;
+    // Render textures are stored bottom-up
+    Rectangle source = { area.x, backdrop.texture.height - area.y - area.height, area.width, -area.height };
+    Gfx().DrawTextureRec(backdrop.texture, source, Vector2{ area.x, area.y }, WHITE);
+}
@@ -0,0 +1,78 @@
+// LayerCache.h
+#pragma once
+#include "Renderer.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// FNV-1a over the values a cached part of the screen is drawn from. When the
+// stamp changes, that part is dirty.
+struct LayerStamp {
+    uint64_t hash = 14695981039346656037ull;
+
+    LayerStamp& Add(int64_t value);
+    LayerStamp& Add(const std::string& text);
+    LayerStamp& Add(const char* text);
+};
+
+// Keeps the parts of a screen that rarely change in two screen-sized render
+// textures, so a frame composites one quad instead of drawing them again:
+//   backdrop  what lies under everything, e.g. the background and sprites;
+//             it has to come out opaque
+//   screen    the backdrop with the panels drawn over it; Draw shows this
+//
+// Each part is drawn again only when its stamp changes. A dirty panel copies
+// the backdrop back over the area it covered and draws itself there; a dirty
+// backdrop (or a new screen size) starts the screen over and redraws every
+// panel. Panels draw in screen coordinates and must not overlap each other.
+//
+//   if (cache.BackdropDirty(stamp)) {
+//       cache.BeginBackdrop(stamp);
+//       ...
+//       cache.EndBackdrop();
+//   }
+//   if (cache.PanelDirty(PANEL, stamp)) {
+//       cache.BeginPanel(PANEL, stamp, area);
+//       ...
+//       cache.EndPanel();
+//   }
+//   cache.Draw();
+class LayerCache {
+public:
+    explicit LayerCache(int panelCount) : panels(panelCount) {}
+
+    // Frees the textures; the next frame draws everything again
+    void Unload();
+    void Invalidate();
+
+    bool BackdropDirty(uint64_t stamp) const;
+    void BeginBackdrop(uint64_t stamp);
+    void EndBackdrop();
+
+    bool PanelDirty(int panel, uint64_t stamp) const;
+    // area covers everything the panel is about to draw
+    void BeginPanel(int panel, uint64_t stamp, Rectangle area);
+    void EndPanel();
+
+    void Draw();
+
+    // Backdrops and panels drawn since the start, for the benchmark
+    int Redraws() const { return redraws; }
+
+private:
+    struct Panel {
+        bool drawn = false;
+        uint64_t stamp = 0;
+        Rectangle area = {};
+    };
+
+    // Copies area of the backdrop to the same place on the current target
+    void CopyBackdrop(Rectangle area);
+
+    RenderTexture2D backdrop = {};
+    RenderTexture2D screen = {};
+    bool backdropDrawn = false;
+    uint64_t backdropStamp = 0;
+    std::vector<Panel> panels;
+    int redraws = 0;
+};
@@ -1,44 +1,49 @@
 #include "MainMenu.h"
+#include "Frame.h"
+#include "Renderer.h"
+#include "Input.h"
+#include "ScreenTimings.h"
 #include "raylib.h"
 #include <iostream>
 
 
 void ShowLoadingScreen(const char* message, int totalSteps = 10) {
-    double loadingStart = GetTime();
+    ScreenScope screen("Loading");
+    double loadingStart = Input::GetTime();
 
-    for (int step = 0; step <= totalSteps && !WindowShouldClose(); ++step) {
-        BeginDrawing();
-        ClearBackground(WHITE); // Set background to white
+    for (int step = 0; step <= totalSteps && !Gfx().ShouldClose(); ++step) {
+        BeginFrame();
+        Gfx().ClearBackground(WHITE); // Set background to white
 
         // Draw loading message
         int fontSize = 30;
-        int textWidth = MeasureText(message, fontSize);
-        DrawText(message, GetScreenWidth() / 2 - textWidth / 2, GetScreenHeight() / 2 - 80, fontSize, BLACK);
+        int textWidth = Gfx().MeasureText(message, fontSize);
+        Gfx().DrawText(message, Gfx().Width() / 2 - textWidth / 2, Gfx().Height() / 2 - 80, fontSize, BLACK);
 
         // Draw animated dots
-        int dotCount = (int)(GetTime() * 2) % 4; // cycles 0-3
-        std::string dots(dotCount, '.');
-        int dotsWidth = MeasureText(dots.c_str(), fontSize);
-        DrawText(dots.c_str(), GetScreenWidth() / 2 + textWidth / 2 + 10, GetScreenHeight() / 2 - 80, fontSize, BLACK);
+        int dotCount = (int)(Input::GetTime() * 2) % 4; // cycles 0-3
+        const char* dots = &"..."[3 - dotCount];
+        int dotsWidth = Gfx().MeasureText(dots, fontSize);
+        Gfx().DrawText(dots, Gfx().Width() / 2 + textWidth / 2 + 10, Gfx().Height() / 2 - 80, fontSize, BLACK);
 
         // Draw progress bar background
         int barWidth = 400;
         int barHeight = 30;
-        int barX = GetScreenWidth() / 2 - barWidth / 2;
-        int barY = GetScreenHeight() / 2;
-        DrawRectangle(barX, barY, barWidth, barHeight, DARKGRAY);
+        int barX = Gfx().Width() / 2 - barWidth / 2;
+        int barY = Gfx().Height() / 2;
+        Gfx().DrawRectangle(barX, barY, barWidth, barHeight, DARKGRAY);
 
         // Draw progress bar fill
         float progress = (float)step / totalSteps;
-        DrawRectangle(barX, barY, (int)(barWidth * progress), barHeight, SKYBLUE);
+        Gfx().DrawRectangle(barX, barY, (int)(barWidth * progress), barHeight, SKYBLUE);
 
         // Draw progress percent
         char percentText[16];
         snprintf(percentText, sizeof(percentText), "%d%%", (int)(progress * 100));
-        int percentWidth = MeasureText(percentText, 20);
-        DrawText(percentText, GetScreenWidth() / 2 - percentWidth / 2, barY + barHeight + 10, 20, BLACK);
+        int percentWidth = Gfx().MeasureText(percentText, 20);
+        Gfx().DrawText(percentText, Gfx().Width() / 2 - percentWidth / 2, barY + barHeight + 10, 20, BLACK);
 
-        EndDrawing();
+        EndFrame();
     }
 }
 
@@ -49,11 +54,11 @@ Button::Button(float x, float y, float w, float h, const char* t)
 
 void Button::Draw() const {
     Color bgColor = hovered ? DARKBLUE : BLUE;
-    DrawRectangleRec(rect, bgColor);
+    Gfx().DrawRectangleRec(rect, bgColor);
 
     int fontSize = 20;
-    int textWidth = MeasureText(text, fontSize);
-    DrawText(text, rect.x + (rect.width - textWidth) / 2, rect.y + (rect.height - fontSize) / 2, fontSize, WHITE);
+    int textWidth = Gfx().MeasureText(text, fontSize);
+    Gfx().DrawText(text, rect.x + (rect.width - textWidth) / 2, rect.y + (rect.height - fontSize) / 2, fontSize, WHITE);
 }
 
 bool Button::IsMouseOver(Vector2 mousePos) const {
@@ -81,56 +86,57 @@ MainMenu::MainMenu(int screenW, int screenH)
 
 
 void MainMenu::ShowCredits() const {
+    ScreenScope screen("Credits");
     // Loop tunggu input dengan drawing aktif
-    while (!WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(BLACK);
-
-        DrawText("Dibuat oleh Muhammad Andra Ramadhani", screenWidth / 2 - 180, screenHeight / 2 - 30, 20, WHITE);
-        DrawText("dan Keyvalle Kirana Tirta", screenWidth / 2 - 120, screenHeight / 2, 20, WHITE);
-        DrawText("Press any key or click to return", screenWidth / 2 - 160, screenHeight / 2 + 40, 20, WHITE);
-
-        EndDrawing();
-
+    while (!Gfx().ShouldClose()) {
         // Jika user tekan tombol apapun atau klik mouse, keluar dari credits
-        if (IsKeyPressed(KEY_ESCAPE) || IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE) ||
-            IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (Input::IsKeyPressed(KEY_ESCAPE) || Input::IsKeyPressed(KEY_ENTER) || Input::IsKeyPressed(KEY_SPACE) ||
+            Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             break;
         }
+
+        BeginFrame();
+        Gfx().ClearBackground(BLACK);
+
+        Gfx().DrawText("Dibuat oleh Muhammad Andra Ramadhani", screenWidth / 2 - 180, screenHeight / 2 - 30, 20, WHITE);
+        Gfx().DrawText("dan Keyvalle Kirana Tirta", screenWidth / 2 - 120, screenHeight / 2, 20, WHITE);
+        Gfx().DrawText("Press any key or click to return", screenWidth / 2 - 160, screenHeight / 2 + 40, 20, WHITE);
+
+        EndFrame();
     }
 }
 
 
 bool MainMenu::Show() {
-    while (!WindowShouldClose()) {
-        Vector2 mousePos = GetMousePosition();
+    ScreenScope screen("MainMenu");
+    while (!Gfx().ShouldClose()) {
+        Vector2 mousePos = Input::GetMousePosition();
 
         btnStart.hovered = btnStart.IsMouseOver(mousePos);
         btnCredit.hovered = btnCredit.IsMouseOver(mousePos);
         btnExit.hovered = btnExit.IsMouseOver(mousePos);
 
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && btnStart.hovered) {
+        if (Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && btnStart.hovered) {
             ShowLoadingScreen("Loading...", 1000); // Show for 1 second
             return true; // Indicate start was pressed
         }
-        else if (btnCredit.hovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        else if (btnCredit.hovered && Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
             ShowCredits();
         }
-        else if (btnExit.hovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            CloseWindow();
-            return false;  // Exit game
+        else if (btnExit.hovered && Input::IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+            return false;  // Exit game, main closes the window
         }
 
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
 
-        DrawText("Turn-Based RPG", screenWidth / 2 - MeasureText("Turn-Based RPG", 40) / 2, 50, 40, DARKBLUE);
+        Gfx().DrawText("Turn-Based RPG", screenWidth / 2 - Gfx().MeasureText("Turn-Based RPG", 40) / 2, 50, 40, DARKBLUE);
 
         btnStart.Draw();
         btnCredit.Draw();
         btnExit.Draw();
 
-        EndDrawing();
+        EndFrame();
     }
     return false;
 }
@@ -0,0 +1,272 @@
+#include "MemoryTracker.h"
+#include "CallStack.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace {
+
+const int TAG_COUNT = static_cast<int>(MemTag::Count);
+
+std::atomic<uint64_t> allocationCount{ 0 };
+std::atomic<int64_t> textureBytes{ 0 };
+
+thread_local MemTag currentTag = MemTag::Untagged;
+
+int64_t TextureSize(const Texture2D& texture) {
+    if (texture.id == 0) return 0;
+    return GetPixelDataSize(texture.width, texture.height, texture.format);
+}
+
+#ifdef RPG_MEMORY_TRACKING
+
+const int SITE_FRAMES = 12;
+const int SITE_TABLE_SIZE = 4096; // power of two
+
+// Stored in front of every block so delete knows what to give back
+struct alignas(16) AllocHeader {
+    uint64_t size;
+    uint8_t tag;
+};
+static_assert(sizeof(AllocHeader) == 16, "header must keep 16-byte alignment");
+
+struct TagCounters {
+    std::atomic<uint64_t> allocations{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<int64_t> live{ 0 };
+    std::atomic<int64_t> peak{ 0 };
+};
+
+struct CallSite {
+    uint64_t hash;
+    void* frames[SITE_FRAMES];
+    int frameCount;
+    uint64_t count;
+    uint64_t bytes;
+};
+
+TagCounters totals[TAG_COUNT];
+TagCounters frame[TAG_COUNT];
+MemoryStats lastFrame[TAG_COUNT];
+
+// Allocation sites, guarded by siteMutex (std::mutex never allocates)
+CallSite sites[SITE_TABLE_SIZE];
+std::mutex siteMutex;
+thread_local bool insideTracker = false;
+
+void RaisePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void RecordSite(uint64_t size) {
+    void* frames[SITE_FRAMES];
+    // Skip RecordSite, TrackedAlloc and operator new itself
+    int count = CaptureCallStack(frames, SITE_FRAMES, 3);
+
+    uint64_t hash = 1469598103934665603ull;
+    for (int i = 0; i < count; ++i) {
+        hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ull;
+    }
+    if (hash == 0) hash = 1;
+
+    std::lock_guard<std::mutex> lock(siteMutex);
+    for (int probe = 0; probe < SITE_TABLE_SIZE; ++probe) {
+        CallSite& site = sites[(hash + probe) & (SITE_TABLE_SIZE - 1)];
+        if (site.hash == 0) {
+            site.hash = hash;
+            std::copy(frames, frames + count, site.frames);
+            site.frameCount = count;
+        }
+        if (site.hash == hash) {
+            site.count++;
+            site.bytes += size;
+            return;
+        }
+    }
+    // Table full: drop the sample, totals are still correct
+}
+
+void* TrackedAlloc(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    AllocHeader* header = static_cast<AllocHeader*>(std::malloc(sizeof(AllocHeader) + size));
+    if (!header) throw std::bad_alloc();
+    header->size = size;
+    header->tag = static_cast<uint8_t>(currentTag);
+
+    int tag = header->tag;
+    for (TagCounters* counters : { &totals[tag], &frame[tag] }) {
+        counters->allocations.fetch_add(1, std::memory_order_relaxed);
+        counters->bytes.fetch_add(size, std::memory_order_relaxed);
+        int64_t live = counters->live.fetch_add((int64_t)size, std::memory_order_relaxed) + (int64_t)size;
+        RaisePeak(counters->peak, live);
+    }
+
+    // Stack capture can allocate on first use (glibc loads libgcc_s); don't recurse
+    if (!insideTracker) {
+        insideTracker = true;
+        RecordSite(size);
+        insideTracker = false;
+    }
+    return header + 1;
+}
+
+void TrackedFree(void* p) {
+    if (!p) return;
+    AllocHeader* header = static_cast<AllocHeader*>(p) - 1;
+    int tag = header->tag;
+    totals[tag].live.fetch_sub((int64_t)header->size, std::memory_order_relaxed);
+    frame[tag].live.fetch_sub((int64_t)header->size, std::memory_order_relaxed);
+    std::free(header);
+}
+
+#else
+
+void* TrackedAlloc(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    void* p = std::malloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void TrackedFree(void* p) {
+    std::free(p);
+}
+
+#endif
+
+} // namespace
+
+uint64_t MemoryTracker::AllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::OnTextureLoaded(const Texture2D& texture) {
+    textureBytes += TextureSize(texture);
+#ifdef RPG_MEMORY_TRACKING
+    // GPU memory is charged to Assets next to its CPU-side allocations
+    int64_t live = totals[(int)MemTag::Assets].live.fetch_add(TextureSize(texture)) + TextureSize(texture);
+    RaisePeak(totals[(int)MemTag::Assets].peak, live);
+#endif
+}
+
+void MemoryTracker::OnTextureUnloaded(const Texture2D& texture) {
+    textureBytes -= TextureSize(texture);
+#ifdef RPG_MEMORY_TRACKING
+    totals[(int)MemTag::Assets].live.fetch_sub(TextureSize(texture));
+#endif
+}
+
+int64_t MemoryTracker::TextureBytes() {
+    return textureBytes.load();
+}
+
+bool MemoryTracker::DetailedTrackingEnabled() {
+#ifdef RPG_MEMORY_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* MemoryTracker::TagName(MemTag tag) {
+    switch (tag) {
+    case MemTag::Untagged: return "untagged";
+    case MemTag::Battle: return "battle";
+    case MemTag::UI: return "ui";
+    case MemTag::Save: return "save";
+    case MemTag::Assets: return "assets";
+    default: return "?";
+    }
+}
+
+MemoryStats MemoryTracker::TagTotals(MemTag tag) {
+    MemoryStats stats;
+#ifdef RPG_MEMORY_TRACKING
+    const TagCounters& counters = totals[(int)tag];
+    stats.allocations = counters.allocations.load();
+    stats.bytesAllocated = counters.bytes.load();
+    stats.liveBytes = counters.live.load();
+    stats.peakBytes = counters.peak.load();
+#else
+    (void)tag;
+#endif
+    return stats;
+}
+
+MemoryStats MemoryTracker::LastFrame(MemTag tag) {
+#ifdef RPG_MEMORY_TRACKING
+    return lastFrame[(int)tag];
+#else
+    (void)tag;
+    return MemoryStats();
+#endif
+}
+
+void MemoryTracker::EndFrame() {
+#ifdef RPG_MEMORY_TRACKING
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        MemoryStats& stats = lastFrame[i];
+        stats.allocations = frame[i].allocations.exchange(0);
+        stats.bytesAllocated = frame[i].bytes.exchange(0);
+        // Per-frame live is the net change this frame; peak is relative to the frame start
+        stats.liveBytes = frame[i].live.exchange(0);
+        stats.peakBytes = frame[i].peak.exchange(0);
+    }
+#endif
+}
+
+void MemoryTracker::DumpTopCallSites(int count) {
+#ifdef RPG_MEMORY_TRACKING
+    // Copy under the lock, then print without it (printing may allocate)
+    static CallSite copy[SITE_TABLE_SIZE];
+    int used = 0;
+    {
+        std::lock_guard<std::mutex> lock(siteMutex);
+        for (const CallSite& site : sites) {
+            if (site.hash != 0) copy[used++] = site;
+        }
+    }
+    count = std::min(count, used);
+    std::partial_sort(copy, copy + count, copy + used,
+        [](const CallSite& a, const CallSite& b) { return a.count > b.count; });
+
+    printf("[Memory] Top %d allocation sites since startup\n", count);
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        MemoryStats stats = TagTotals(static_cast<MemTag>(i));
+        printf("  %-8s %10llu allocs %12llu bytes  live %10lld  peak %10lld\n", TagName(static_cast<MemTag>(i)),
+            (unsigned long long)stats.allocations, (unsigned long long)stats.bytesAllocated,
+            (long long)stats.liveBytes, (long long)stats.peakBytes);
+    }
+    for (int i = 0; i < count; ++i) {
+        printf("#%d: %llu allocations, %llu bytes\n", i + 1,
+            (unsigned long long)copy[i].count, (unsigned long long)copy[i].bytes);
+        PrintCallStack(copy[i].frames, copy[i].frameCount);
+    }
+    fflush(stdout);
+#else
+    (void)count;
+    printf("[Memory] Build with RPG_MEMORY_TRACKING to record allocation sites\n");
+#endif
+}
+
+MemoryScope::MemoryScope(MemTag tag) : previous(currentTag) {
+    currentTag = tag;
+}
+
+MemoryScope::~MemoryScope() {
+    currentTag = previous;
+}
+
+// Global replacements so every allocation in the program is counted
+void* operator new(std::size_t size) { return TrackedAlloc(size); }
+void* operator new[](std::size_t size) { return TrackedAlloc(size); }
+void operator delete(void* p) noexcept { TrackedFree(p); }
+void operator delete[](void* p) noexcept { TrackedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { TrackedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { TrackedFree(p); }
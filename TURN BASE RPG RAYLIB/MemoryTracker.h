@@ -0,0 +1,70 @@
+// MemoryTracker.h
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+
+// Counts heap allocations made through operator new and GPU memory held by textures.
+//
+// Building with RPG_MEMORY_TRACKING adds per-subsystem accounting: code inside
+// MEMORY_SCOPE(Battle) etc. is charged to that tag, bytes/peak are kept per tag
+// and per frame, and F9 prints the call sites that allocate the most.
+
+enum class MemTag : uint8_t {
+    Untagged,
+    Battle,
+    UI,
+    Save,
+    Assets,
+    Count
+};
+
+struct MemoryStats {
+    uint64_t allocations = 0;
+    uint64_t bytesAllocated = 0;
+    int64_t liveBytes = 0;
+    int64_t peakBytes = 0;
+};
+
+namespace MemoryTracker {
+    // Total operator new calls since startup, from every thread
+    uint64_t AllocationCount();
+
+    void OnTextureLoaded(const Texture2D& texture);
+    void OnTextureUnloaded(const Texture2D& texture);
+    int64_t TextureBytes();
+
+    // Everything below reports zeros unless RPG_MEMORY_TRACKING is defined
+    bool DetailedTrackingEnabled();
+    const char* TagName(MemTag tag);
+
+    // Since startup; liveBytes/peakBytes are current and high-water marks
+    MemoryStats TagTotals(MemTag tag);
+    // The last finished frame; peakBytes is the highest live total seen during it
+    MemoryStats LastFrame(MemTag tag);
+
+    // Closes the current frame's counters, called by EndFrame
+    void EndFrame();
+
+    void DumpTopCallSites(int count);
+}
+
+// Charges allocations on this thread to a tag until the scope ends
+class MemoryScope {
+public:
+    explicit MemoryScope(MemTag tag);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemTag previous;
+};
+
+#ifdef RPG_MEMORY_TRACKING
+#define MEMORY_SCOPE_CONCAT_INNER(a, b) a##b
+#define MEMORY_SCOPE_CONCAT(a, b) MEMORY_SCOPE_CONCAT_INNER(a, b)
+#define MEMORY_SCOPE(tag) MemoryScope MEMORY_SCOPE_CONCAT(memoryScope, __LINE__)(MemTag::tag)
+#else
+#define MEMORY_SCOPE(tag) ((void)0)
+#endif
@@ -0,0 +1,257 @@
+#include "Netplay.h"
+#include <algorithm>
+
+static_assert(DUEL_MAX_TURNS < 256, "input packets carry turn numbers in a byte");
+
+namespace {
+
+const uint8_t NETPLAY_VERSION = 1;
+
+// Hello: kind, version, seat, heard (the sender has our hello), then the
+// sender's max HP, attack and defense as 32-bit little-endian
+const uint8_t PACKET_HELLO = 'H';
+const int HELLO_SIZE = 16;
+
+// Inputs: kind, ack (remote actions held), first (turn of the first action),
+// count, the actions at two bits each, then the turn and checksum of the
+// sender's latest confirmed state
+const uint8_t PACKET_INPUTS = 'I';
+const int INPUTS_HEADER = 4;
+const int INPUTS_TRAILER = 5;
+
+void Put32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[i] = static_cast<uint8_t>(value >> (i * 8));
+}
+
+uint32_t Get32(const uint8_t* in) {
+    return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+} // namespace
+
+bool UdpLink::Host(uint16_t port) {
+    hasPeer = false;
+    return socket.Open(port);
+}
+
+bool UdpLink::Join(const NetAddress& host) {
+    peer = host;
+    hasPeer = socket.Open(0);
+    return hasPeer;
+}
+
+void UdpLink::Close() {
+    socket.Close();
+    hasPeer = false;
+}
+
+void UdpLink::Send(const uint8_t* data, int size) {
+    if (hasPeer) socket.SendTo(peer, data, size);
+}
+
+int UdpLink::Receive(uint8_t* data, int capacity) {
+    NetAddress from;
+    int size;
+    while ((size = socket.ReceiveFrom(from, data, capacity)) >= 0) {
+        if (!hasPeer) {
+            peer = from;
+            hasPeer = true;
+        }
+        if (from == peer) return size;
+    }
+    return -1;
+}
+
+void DuelSession::Start(DatagramLink& sessionLink, int sessionSeat, const SimStats& mine, uint32_t nowMs) {
+    *this = DuelSession();
+    link = &sessionLink;
+    seat = sessionSeat;
+    seatStats[seat] = mine;
+    inputs[0].reserve(DUEL_MAX_TURNS);
+    inputs[1].reserve(DUEL_MAX_TURNS);
+    lastReceiveMs = nowMs;
+    SendHello(nowMs);
+}
+
+void DuelSession::Update(uint32_t nowMs) {
+    if (!link || phase == NetplayPhase::Desynced || phase == NetplayPhase::Disconnected) return;
+
+    uint8_t packet[MAX_PACKET];
+    int size;
+    while ((size = link->Receive(packet, MAX_PACKET)) >= 0) {
+        stats.packetsReceived++;
+        stats.bytesReceived += size;
+        lastReceiveMs = nowMs;
+        if (size > 0 && packet[0] == PACKET_HELLO) ReadHello(packet, size);
+        else if (size > 0 && packet[0] == PACKET_INPUTS) ReadInputs(packet, size);
+        if (phase == NetplayPhase::Desynced || phase == NetplayPhase::Disconnected) return;
+    }
+
+    uint32_t quiet = nowMs - lastSendMs;
+    if (phase == NetplayPhase::Connecting) {
+        if (quiet >= RESEND_MS) SendHello(nowMs);
+        return;
+    }
+    if (phase == NetplayPhase::Playing && nowMs - lastReceiveMs > TIMEOUT_MS) {
+        phase = NetplayPhase::Disconnected;
+        return;
+    }
+    bool owed = replyOwed || !PeerCaughtUp() || !peerHeardUs;
+    if (quiet >= KEEPALIVE_MS || (owed && quiet >= RESEND_MS)) {
+        // Until something of ours is seen to arrive, the peer may still be waiting for our hello
+        if (!peerHeardUs) SendHello(nowMs);
+        SendInputs(nowMs);
+    }
+}
+
+bool DuelSession::CanAct() const {
+    return phase == NetplayPhase::Playing && shown.result == DuelResult::Ongoing &&
+        LocalTurns() < confirmedTurns + MAX_PREDICTION;
+}
+
+void DuelSession::Act(CombatAction action, uint32_t nowMs) {
+    if (!CanAct()) return;
+    inputs[seat].push_back(static_cast<uint8_t>(action));
+    int turn = LocalTurns() - 1;
+    StepDuel(shown, InputAt(0, turn), InputAt(1, turn));
+    AdvanceConfirmed();
+    SendInputs(nowMs);
+}
+
+void DuelSession::InjectDesync() {
+    confirmed.fighters[seat].attack++;
+    Resimulate();
+}
+
+// Known, or else the opponent's last action again (attack before they have one)
+CombatAction DuelSession::InputAt(int side, int turn) const {
+    const std::vector<uint8_t>& known = inputs[side];
+    if (turn < static_cast<int>(known.size())) return static_cast<CombatAction>(known[turn]);
+    return known.empty() ? CombatAction::Attack : static_cast<CombatAction>(known.back());
+}
+
+void DuelSession::Resimulate() {
+    shown = confirmed;
+    for (int turn = confirmedTurns; turn < LocalTurns(); ++turn) {
+        StepDuel(shown, InputAt(0, turn), InputAt(1, turn));
+    }
+}
+
+void DuelSession::AdvanceConfirmed() {
+    int known = static_cast<int>(std::min(inputs[0].size(), inputs[1].size()));
+    while (confirmedTurns < known) {
+        StepDuel(confirmed, InputAt(0, confirmedTurns), InputAt(1, confirmedTurns));
+        confirmedTurns++;
+        Checksum& entry = history[confirmedTurns % CHECKSUM_HISTORY];
+        entry.turn = confirmedTurns;
+        entry.value = DuelChecksum(confirmed);
+        if (pendingPeerCheck.turn == confirmedTurns) {
+            CheckPeerChecksum(pendingPeerCheck.turn, pendingPeerCheck.value);
+            pendingPeerCheck.turn = -1;
+        }
+    }
+    if (phase == NetplayPhase::Playing && confirmed.result != DuelResult::Ongoing) phase = NetplayPhase::Finished;
+}
+
+void DuelSession::CheckPeerChecksum(int turn, uint32_t checksum) {
+    if (turn > confirmedTurns) {
+        if (turn > pendingPeerCheck.turn) pendingPeerCheck = { turn, checksum };
+        return;
+    }
+    // Older than the history: already compared through a later packet
+    const Checksum& mine = history[turn % CHECKSUM_HISTORY];
+    if (mine.turn != turn || mine.value == checksum) return;
+    phase = NetplayPhase::Desynced;
+    desyncTurn = turn;
+}
+
+void DuelSession::Send(const uint8_t* data, int size, uint32_t nowMs) {
+    link->Send(data, size);
+    stats.packetsSent++;
+    stats.bytesSent += size;
+    lastSendMs = nowMs;
+}
+
+void DuelSession::SendHello(uint32_t nowMs) {
+    const SimStats& mine = seatStats[seat];
+    uint8_t packet[HELLO_SIZE];
+    packet[0] = PACKET_HELLO;
+    packet[1] = NETPLAY_VERSION;
+    packet[2] = static_cast<uint8_t>(seat);
+    packet[3] = phase == NetplayPhase::Connecting ? 0 : 1;
+    Put32(packet + 4, static_cast<uint32_t>(mine.maxHP));
+    Put32(packet + 8, static_cast<uint32_t>(mine.attack));
+    Put32(packet + 12, static_cast<uint32_t>(mine.defense));
+    Send(packet, HELLO_SIZE, nowMs);
+}
+
+void DuelSession::SendInputs(uint32_t nowMs) {
+    int count = std::min(LocalTurns() - peerAck, MAX_PACKET_INPUTS);
+    uint8_t packet[MAX_PACKET] = {};
+    packet[0] = PACKET_INPUTS;
+    packet[1] = static_cast<uint8_t>(inputs[1 - seat].size());
+    packet[2] = static_cast<uint8_t>(peerAck);
+    packet[3] = static_cast<uint8_t>(count);
+    for (int i = 0; i < count; ++i) {
+        packet[INPUTS_HEADER + i / 4] |= static_cast<uint8_t>(inputs[seat][peerAck + i] << ((i % 4) * 2));
+    }
+    int size = INPUTS_HEADER + (count + 3) / 4;
+    packet[size] = static_cast<uint8_t>(confirmedTurns);
+    Put32(packet + size + 1, history[confirmedTurns % CHECKSUM_HISTORY].value);
+    Send(packet, size + INPUTS_TRAILER, nowMs);
+    replyOwed = false;
+}
+
+void DuelSession::ReadHello(const uint8_t* data, int size) {
+    if (size != HELLO_SIZE) return;
+    int peerSeat = data[2];
+    if (data[1] != NETPLAY_VERSION || peerSeat != 1 - seat) {
+        phase = NetplayPhase::Disconnected;
+        return;
+    }
+    if (data[3]) peerHeardUs = true;
+    if (phase != NetplayPhase::Connecting) return;
+
+    seatStats[peerSeat].maxHP = static_cast<int32_t>(Get32(data + 4));
+    seatStats[peerSeat].attack = static_cast<int32_t>(Get32(data + 8));
+    seatStats[peerSeat].defense = static_cast<int32_t>(Get32(data + 12));
+    confirmed = StartDuel(seatStats[0], seatStats[1]);
+    shown = confirmed;
+    history[0] = { 0, DuelChecksum(confirmed) };
+    phase = NetplayPhase::Playing;
+    replyOwed = true;
+}
+
+void DuelSession::ReadInputs(const uint8_t* data, int size) {
+    if (size < INPUTS_HEADER + INPUTS_TRAILER || phase == NetplayPhase::Connecting) return;
+    int count = data[3];
+    int actionBytes = (count + 3) / 4;
+    if (count > MAX_PACKET_INPUTS || size != INPUTS_HEADER + actionBytes + INPUTS_TRAILER) return;
+    peerHeardUs = true;
+    peerAck = std::max(peerAck, std::min<int>(data[1], LocalTurns()));
+
+    // Everything shown past the known actions assumed this one
+    std::vector<uint8_t>& remote = inputs[1 - seat];
+    CombatAction predicted = InputAt(1 - seat, static_cast<int>(remote.size()));
+    int mispredictedFrom = -1;
+    int first = data[2];
+    for (int i = 0; i < count; ++i) {
+        int turn = first + i;
+        if (turn < static_cast<int>(remote.size())) continue;
+        if (turn > static_cast<int>(remote.size()) || turn >= DUEL_MAX_TURNS) break;
+        uint8_t action = (data[INPUTS_HEADER + i / 4] >> ((i % 4) * 2)) & 3;
+        if (action > static_cast<uint8_t>(CombatAction::Skill)) break;
+        remote.push_back(action);
+        replyOwed = true;
+        if (turn < LocalTurns() && mispredictedFrom < 0 && static_cast<CombatAction>(action) != predicted) mispredictedFrom = turn;
+    }
+
+    AdvanceConfirmed();
+    if (mispredictedFrom >= 0) {
+        stats.rollbacks++;
+        stats.resimulatedTurns += LocalTurns() - mispredictedFrom;
+        Resimulate();
+    }
+    const uint8_t* trailer = data + INPUTS_HEADER + actionBytes;
+    CheckPeerChecksum(trailer[0], Get32(trailer + 1));
+}
@@ -0,0 +1,145 @@
+// Netplay.h
+#pragma once
+#include "Duel.h"
+#include "UdpSocket.h"
+#include <cstdint>
+#include <vector>
+
+// Lockstep PvP over UDP. Each side sends only its own action per turn and
+// runs the duel (Duel.h) itself; the two copies stay equal because the rules
+// are deterministic and both see the same actions.
+//
+// Waiting a round trip before showing a turn would feel slow, so a turn is
+// played the moment the local player picks, with the opponent predicted to
+// repeat their last action. When their real action comes in and differs,
+// the shown state is rolled back to the last turn both actions were known
+// for and played forward again. Only confirmed turns are checksummed: every
+// packet carries the checksum of the latest, and a peer that disagrees
+// stops the duel as desynced.
+//
+// Packets are a few bytes: every input packet repeats the actions the peer
+// hasn't acknowledged yet (two bits each), so a lost one costs nothing but
+// the wait for the next. Turn numbers fit a byte because of DUEL_MAX_TURNS.
+
+const uint16_t DUEL_DEFAULT_PORT = 47047;
+
+// Where packets go; a UDP socket in the game, a lossy one in DuelHarness
+class DatagramLink {
+public:
+    virtual ~DatagramLink() = default;
+    virtual void Send(const uint8_t* data, int size) = 0;
+    // Size of the next datagram from the peer, or -1 when none is waiting
+    virtual int Receive(uint8_t* data, int capacity) = 0;
+};
+
+class UdpLink : public DatagramLink {
+public:
+    // The peer is whoever writes first
+    bool Host(uint16_t port);
+    // From a free local port
+    bool Join(const NetAddress& host);
+    void Close();
+
+    bool HasPeer() const { return hasPeer; }
+    uint16_t LocalPort() const { return socket.LocalPort(); }
+
+    // Dropped until there is a peer
+    void Send(const uint8_t* data, int size) override;
+    // Datagrams from anyone but the peer are skipped
+    int Receive(uint8_t* data, int capacity) override;
+
+private:
+    UdpSocket socket;
+    NetAddress peer;
+    bool hasPeer = false;
+};
+
+enum class NetplayPhase : uint8_t {
+    Connecting,    // waiting for the peer's hello
+    Playing,
+    Finished,      // the confirmed duel has a result
+    Desynced,      // checksums differed
+    Disconnected   // silence for TIMEOUT_MS, or a peer that doesn't fit
+};
+
+struct NetplayStats {
+    uint32_t packetsSent = 0;
+    uint32_t packetsReceived = 0;
+    uint32_t bytesSent = 0;
+    uint32_t bytesReceived = 0;
+    uint32_t rollbacks = 0;         // remote actions that weren't the predicted one
+    uint32_t resimulatedTurns = 0;  // turns played again because of them
+};
+
+class DuelSession {
+public:
+    static constexpr int MAX_PREDICTION = 2;     // turns the local side may play ahead of the confirmed ones
+    static constexpr int MAX_PACKET_INPUTS = 8;
+    static constexpr int MAX_PACKET = 32;
+    static constexpr uint32_t RESEND_MS = 50;    // while the peer is missing actions or owed an ack
+    static constexpr uint32_t KEEPALIVE_MS = 250;
+    static constexpr uint32_t TIMEOUT_MS = 5000;
+
+    // Seat 0 is the host's. The link must outlive the session.
+    void Start(DatagramLink& link, int seat, const SimStats& mine, uint32_t nowMs);
+    // Reads what arrived, then sends what is due
+    void Update(uint32_t nowMs);
+
+    bool CanAct() const;
+    // The local action for the next turn; played and sent at once
+    void Act(CombatAction action, uint32_t nowMs);
+
+    NetplayPhase Phase() const { return phase; }
+    int Seat() const { return seat; }
+    // Every local action played, the opponent's predicted where not yet known
+    const DuelState& Shown() const { return shown; }
+    const DuelState& Confirmed() const { return confirmed; }
+    int LocalTurns() const { return static_cast<int>(inputs[seat].size()); }
+    int ConfirmedTurns() const { return confirmedTurns; }
+    // The peer holds every local action, so leaving can't strand it
+    bool PeerCaughtUp() const { return peerAck >= LocalTurns(); }
+    int DesyncTurn() const { return desyncTurn; }
+    const NetplayStats& Stats() const { return stats; }
+
+    // For DuelHarness: changes this side's confirmed state behind the
+    // checksums' back, as a rules change between builds would
+    void InjectDesync();
+
+private:
+    static constexpr int CHECKSUM_HISTORY = 32;
+
+    CombatAction InputAt(int side, int turn) const;
+    void Resimulate();
+    void AdvanceConfirmed();
+    void CheckPeerChecksum(int turn, uint32_t checksum);
+    void Send(const uint8_t* data, int size, uint32_t nowMs);
+    void SendHello(uint32_t nowMs);
+    void SendInputs(uint32_t nowMs);
+    void ReadHello(const uint8_t* data, int size);
+    void ReadInputs(const uint8_t* data, int size);
+
+    DatagramLink* link = nullptr;
+    int seat = 0;
+    SimStats seatStats[2] = {};
+    NetplayPhase phase = NetplayPhase::Connecting;
+    bool peerHeardUs = false;
+
+    std::vector<uint8_t> inputs[2];  // CombatAction by seat and turn
+    DuelState confirmed = {};
+    DuelState shown = {};
+    int confirmedTurns = 0;
+    int peerAck = 0;  // local actions the peer holds
+
+    struct Checksum {
+        int turn = -1;
+        uint32_t value = 0;
+    };
+    Checksum history[CHECKSUM_HISTORY];  // of confirmed turns, by turn % CHECKSUM_HISTORY
+    Checksum pendingPeerCheck;           // for a turn not confirmed here yet
+    int desyncTurn = -1;
+
+    uint32_t lastSendMs = 0;
+    uint32_t lastReceiveMs = 0;
+    bool replyOwed = false;
+    NetplayStats stats;
+};
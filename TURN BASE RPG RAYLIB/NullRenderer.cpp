@@ -0,0 +1,88 @@
+#include "NullRenderer.h"
+#include "BitmapFont.h"
+
+NullRenderer::NullRenderer(int width, int height, uint64_t maxFrames)
+    : width(width), height(height), maxFrames(maxFrames) {}
+
+void NullRenderer::BeginFrame() {
+    current = DrawCounts();
+}
+
+void NullRenderer::EndFrame() {
+    lastFrame = current;
+    total.clears += current.clears;
+    total.rectangles += current.rectangles;
+    total.rectangleOutlines += current.rectangleOutlines;
+    total.textures += current.textures;
+    total.texts += current.texts;
+    total.glyphs += current.glyphs;
+    total.measures += current.measures;
+    frames++;
+}
+
+bool NullRenderer::ShouldClose() {
+    return maxFrames > 0 && frames >= maxFrames;
+}
+
+Texture2D NullRenderer::LoadTexture(const char* path) {
+    // Only the size is kept, so texture memory still shows up in the stats
+    Texture2D texture = {};
+    Image image = LoadImage(path);
+    if (image.data == nullptr) return texture;
+    texture.id = nextTextureId++;
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.mipmaps = 1;
+    texture.format = image.format;
+    UnloadImage(image);
+    return texture;
+}
+
+void NullRenderer::UnloadTexture(Texture2D) {}
+
+RenderTexture2D NullRenderer::LoadRenderTexture(int width, int height) {
+    RenderTexture2D target = {};
+    target.id = nextTextureId;
+    target.texture.id = nextTextureId++;
+    target.texture.width = width;
+    target.texture.height = height;
+    target.texture.mipmaps = 1;
+    target.texture.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return target;
+}
+
+void NullRenderer::UnloadRenderTexture(RenderTexture2D) {}
+
+void NullRenderer::BeginTextureMode(RenderTexture2D) {}
+
+void NullRenderer::EndTextureMode() {}
+
+void NullRenderer::ClearBackground(Color) {
+    current.clears++;
+}
+
+void NullRenderer::DrawRectangleRec(Rectangle, Color) {
+    current.rectangles++;
+}
+
+void NullRenderer::DrawRectangleLinesEx(Rectangle, float, Color) {
+    current.rectangleOutlines++;
+}
+
+void NullRenderer::DrawTextureEx(Texture2D texture, Vector2, float, float, Color) {
+    if (texture.id != 0) current.textures++;
+}
+
+void NullRenderer::DrawTextureRec(Texture2D texture, Rectangle, Vector2, Color) {
+    if (texture.id != 0) current.textures++;
+}
+
+void NullRenderer::DrawText(const char* text, int, int, int, Color) {
+    current.texts++;
+    while (*text++) current.glyphs++;
+}
+
+int NullRenderer::MeasureText(const char* text, int fontSize) {
+    current.measures++;
+    return BitmapFont::MeasureText(text, fontSize);
+}
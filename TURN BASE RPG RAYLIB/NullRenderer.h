@@ -0,0 +1,61 @@
+// NullRenderer.h
+#pragma once
+#include "Renderer.h"
+#include <cstdint>
+
+struct DrawCounts {
+    uint64_t clears = 0;
+    uint64_t rectangles = 0;
+    uint64_t rectangleOutlines = 0;
+    uint64_t textures = 0;
+    uint64_t texts = 0;
+    uint64_t glyphs = 0;
+    uint64_t measures = 0;
+
+    uint64_t DrawCalls() const { return clears + rectangles + rectangleOutlines + textures + texts; }
+};
+
+// Draws nothing, only counts what would have been drawn. Needs no window or
+// GL context; text is measured with the built-in bitmap font.
+class NullRenderer : public Renderer {
+public:
+    // maxFrames == 0 runs until something else ends the game
+    NullRenderer(int width, int height, uint64_t maxFrames = 0);
+
+    void BeginFrame() override;
+    void EndFrame() override;
+    bool ShouldClose() override;
+
+    int Width() const override { return width; }
+    int Height() const override { return height; }
+
+    Texture2D LoadTexture(const char* path) override;
+    void UnloadTexture(Texture2D texture) override;
+
+    RenderTexture2D LoadRenderTexture(int width, int height) override;
+    void UnloadRenderTexture(RenderTexture2D target) override;
+    void BeginTextureMode(RenderTexture2D target) override;
+    void EndTextureMode() override;
+
+    void ClearBackground(Color color) override;
+    void DrawRectangleRec(Rectangle rect, Color color) override;
+    void DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) override;
+    void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) override;
+    void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) override;
+    void DrawText(const char* text, int x, int y, int fontSize, Color color) override;
+    int MeasureText(const char* text, int fontSize) override;
+
+    uint64_t FrameCount() const { return frames; }
+    const DrawCounts& LastFrame() const { return lastFrame; }
+    const DrawCounts& Total() const { return total; }
+
+private:
+    int width;
+    int height;
+    uint64_t maxFrames;
+    uint64_t frames = 0;
+    unsigned nextTextureId = 1;
+    DrawCounts current;
+    DrawCounts lastFrame;
+    DrawCounts total;
+};
@@ -1,13 +1,17 @@
 // PaladinEnemy.h
 #pragma once
 #include "Enemy.h"
+#include "Content.h"
 
 class PaladinEnemy : public Enemy {
     int level;
+    const EnemyDef& stats;
 public:
-    PaladinEnemy(int lvl) : level(lvl) {}
+    PaladinEnemy(int lvl) : level(lvl), stats(Content().FindEnemy("Paladin")) {}
     std::string GetName() const override { return "Paladin"; }
-    int GetMaxHP() const override { return 90 + (level * 15); }
-    int GetAttack() const override { return 8 + (level * 1); }
-    int GetDefense() const override { return 6 + (level * 2); }
+    int GetMaxHP() const override { return stats.baseHP + (level * stats.hpPerLevel); }
+    int GetAttack() const override { return stats.baseAttack + (level * stats.attackPerLevel); }
+    int GetDefense() const override { return stats.baseDefense + (level * stats.defensePerLevel); }
+    int GetExpReward() const override { return stats.baseExp + (level * stats.expPerLevel); }
+    int GetCoinReward() const override { return stats.baseCoins + (level * stats.coinsPerLevel); }
 };
@@ -0,0 +1,178 @@
+#include "PerfOverlay.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include "MemoryTracker.h"
+#include "FrameArena.h"
+#include "RenderQueue.h"
+#include "Input.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+const int HISTORY = 240;
+const float GRAPH_MAX_MS = 50.0f;
+
+rlRenderBatch batch;
+bool batchLoaded = false;
+bool visible = false;
+
+double frameMs[HISTORY] = {};
+int historyCount = 0;
+int historyHead = 0;
+
+double lastSwapEnd = 0.0;
+double frameBeginTime = 0.0;
+double updateMs = 0.0;
+double drawMs = 0.0;
+double overlayMs = 0.0;
+
+int drawCalls = 0;
+int vertices = 0;
+uint64_t lastAllocCount = 0;
+uint64_t allocsPerFrame = 0;
+
+double NowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// What is queued in the batch right before EndDrawing flushes it.
+// Undercounts only when a frame overflows the batch and rlgl flushes early.
+void SampleBatch() {
+    if (!batchLoaded) return;
+    drawCalls = 0;
+    vertices = 0;
+    for (int i = 0; i < batch.drawCounter; ++i) {
+        if (batch.draws[i].vertexCount == 0) continue;
+        drawCalls++;
+        vertices += batch.draws[i].vertexCount;
+    }
+}
+
+double Percentile(double* sorted, int count, double p) {
+    int index = std::min(count - 1, (int)(p * count));
+    std::nth_element(sorted, sorted + index, sorted + count);
+    return sorted[index];
+}
+
+void DrawPanel() {
+    const int width = 260;
+    const int graphHeight = 40;
+    const int x = Gfx().Width() - width - 10;
+    const int y = 10;
+    const int fontSize = 10;
+    const int lineHeight = 12;
+
+    int lines = MemoryTracker::DetailedTrackingEnabled() ? 11 : 10;
+    Gfx().DrawRectangle(x, y, width, lines * lineHeight + graphHeight + 16, Fade(BLACK, 0.75f));
+
+    double sorted[HISTORY];
+    std::copy(frameMs, frameMs + historyCount, sorted);
+    double p50 = 0, p95 = 0, p99 = 0;
+    if (historyCount > 0) {
+        p50 = Percentile(sorted, historyCount, 0.50);
+        p95 = Percentile(sorted, historyCount, 0.95);
+        p99 = Percentile(sorted, historyCount, 0.99);
+    }
+    double lastMs = historyCount > 0 ? frameMs[(historyHead + HISTORY - 1) % HISTORY] : 0.0;
+
+    char line[96];
+    int ty = y + 6;
+    snprintf(line, sizeof(line), "FPS %d   frame %.2f ms", GetFPS(), lastMs);
+    Gfx().DrawText(line, x + 6, ty, fontSize, WHITE); ty += lineHeight;
+    snprintf(line, sizeof(line), "p50 %.2f  p95 %.2f  p99 %.2f ms", p50, p95, p99);
+    Gfx().DrawText(line, x + 6, ty, fontSize, WHITE); ty += lineHeight;
+    snprintf(line, sizeof(line), "update %.3f ms   draw %.3f ms", updateMs, drawMs);
+    Gfx().DrawText(line, x + 6, ty, fontSize, WHITE); ty += lineHeight;
+    snprintf(line, sizeof(line), "draw calls %d   vertices %d", drawCalls, vertices);
+    Gfx().DrawText(line, x + 6, ty, fontSize, WHITE); ty += lineHeight;
+    const DrawBatchStats& queued = GfxQueue().LastFrame();
+    snprintf(line, sizeof(line), "queue %d draws, %d batches (%d unsorted)", queued.commands, queued.batches, queued.submittedBatches);
+    Gfx().DrawText(line, x + 6, ty, fontSize, WHITE); ty += lineHeight;
+    snprintf(line, sizeof(line), "texture memory %.2f MB   frame arena peak %.1f KB",
+        MemoryTracker::TextureBytes() / (1024.0 * 1024.0), FrameArena::HighWater() / 1024.0);
+    Gfx().DrawText(line, x + 6, ty, fontSize, WHITE); ty += lineHeight;
+    snprintf(line, sizeof(line), "allocations/frame %llu", (unsigned long long)allocsPerFrame);
+    Gfx().DrawText(line, x + 6, ty, fontSize, allocsPerFrame == 0 ? WHITE : YELLOW); ty += lineHeight;
+    const InputLatency& input = Input::Latency();
+    snprintf(line, sizeof(line), "input %.2f ms (%d frame%s)  max %.2f  late %llu", input.lastMs, input.lastFrames,
+        input.lastFrames == 1 ? "" : "s", input.maxMs, (unsigned long long)input.late);
+    Gfx().DrawText(line, x + 6, ty, fontSize, input.lastFrames > 1 ? YELLOW : WHITE); ty += lineHeight;
+    if (MemoryTracker::DetailedTrackingEnabled()) {
+        snprintf(line, sizeof(line), "battle %llu  ui %llu  save %llu  assets %llu",
+            (unsigned long long)MemoryTracker::LastFrame(MemTag::Battle).allocations,
+            (unsigned long long)MemoryTracker::LastFrame(MemTag::UI).allocations,
+            (unsigned long long)MemoryTracker::LastFrame(MemTag::Save).allocations,
+            (unsigned long long)MemoryTracker::LastFrame(MemTag::Assets).allocations);
+        Gfx().DrawText(line, x + 6, ty, fontSize, WHITE); ty += lineHeight;
+    }
+    snprintf(line, sizeof(line), "overlay %.3f ms   [F11]", overlayMs);
+    Gfx().DrawText(line, x + 6, ty, fontSize, GRAY); ty += lineHeight + 4;
+
+    // Frame-time graph, oldest on the left; one 1px bar per frame
+    int graphX = x + (width - HISTORY) / 2;
+    int graphBottom = ty + graphHeight;
+    for (int i = 0; i < historyCount; ++i) {
+        double ms = frameMs[(historyHead + HISTORY - historyCount + i) % HISTORY];
+        int h = (int)(std::min(ms, (double)GRAPH_MAX_MS) / GRAPH_MAX_MS * graphHeight);
+        Color color = ms <= 16.7 ? LIME : (ms <= 33.4 ? YELLOW : RED);
+        Gfx().DrawRectangle(graphX + (HISTORY - historyCount) + i, graphBottom - h, 1, h, color);
+    }
+    int line60 = graphBottom - (int)(16.7f / GRAPH_MAX_MS * graphHeight);
+    int line30 = graphBottom - (int)(33.3f / GRAPH_MAX_MS * graphHeight);
+    Gfx().DrawRectangle(graphX, line60, HISTORY, 1, Fade(WHITE, 0.4f));
+    Gfx().DrawRectangle(graphX, line30, HISTORY, 1, Fade(WHITE, 0.4f));
+}
+
+} // namespace
+
+void PerfOverlay::Init() {
+    batch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
+    rlSetRenderBatchActive(&batch);
+    batchLoaded = true;
+    lastSwapEnd = NowMs();
+    lastAllocCount = MemoryTracker::AllocationCount();
+}
+
+void PerfOverlay::Shutdown() {
+    if (!batchLoaded) return;
+    rlSetRenderBatchActive(nullptr);
+    rlUnloadRenderBatch(batch);
+    batchLoaded = false;
+}
+
+void PerfOverlay::Toggle() {
+    visible = !visible;
+}
+
+bool PerfOverlay::IsVisible() {
+    return visible;
+}
+
+void PerfOverlay::OnBeginFrame() {
+    frameBeginTime = NowMs();
+    updateMs = frameBeginTime - lastSwapEnd;
+}
+
+void PerfOverlay::OnEndFrame() {
+    double drawEnd = NowMs();
+    drawMs = drawEnd - frameBeginTime;
+    SampleBatch();
+
+    if (!visible) return;
+    DrawPanel();
+    overlayMs = NowMs() - drawEnd;
+}
+
+void PerfOverlay::OnFrameSwapped() {
+    double now = NowMs();
+    frameMs[historyHead] = now - lastSwapEnd;
+    historyHead = (historyHead + 1) % HISTORY;
+    historyCount = std::min(historyCount + 1, HISTORY);
+    lastSwapEnd = now;
+
+    uint64_t allocs = MemoryTracker::AllocationCount();
+    allocsPerFrame = allocs - lastAllocCount;
+    lastAllocCount = allocs;
+}
@@ -0,0 +1,20 @@
+// PerfOverlay.h
+#pragma once
+
+// Live performance panel toggled with F11 on any screen: frame-time graph and
+// percentiles, update/draw CPU time, rlgl draw calls and vertices, texture
+// memory and allocations per frame.
+namespace PerfOverlay {
+    // Installs a render batch we can inspect; call right after InitWindow
+    void Init();
+    // Call before CloseWindow
+    void Shutdown();
+
+    void Toggle();
+    bool IsVisible();
+
+    // Driven by BeginFrame/EndFrame
+    void OnBeginFrame();
+    void OnEndFrame();
+    void OnFrameSwapped();
+}
@@ -14,10 +14,10 @@ public:
 
 class BlockCommand : public Command {
 public:
-    void Execute(Game& game) override { game.isBlocking = true; game.ShowNotification("You block incoming attack!"); }
+    void Execute(Game& game) override { game.PlayerBlock(); }
 };
 
 class RunCommand : public Command {
 public:
-    void Execute(Game& game) override { game.ShowNotification("You fled from battle."); game.state = GameState::Arena; }
+    void Execute(Game& game) override { game.FleeBattle(); }
 };
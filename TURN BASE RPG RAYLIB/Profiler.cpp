@@ -0,0 +1,157 @@
+#include "Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint64_t RING_CAPACITY = 1 << 16; // per thread, must be a power of two
+const int FRAME_HISTORY = 256;
+const int HITCH_HISTORY_FRAMES = 30;   // frames before a hitch written to its trace
+const uint64_t HITCH_COOLDOWN_NS = 5000000000ull;
+
+struct ZoneEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Written only by its owning thread; readers use head to know what is valid
+struct ThreadRing {
+    ZoneEvent events[RING_CAPACITY];
+    std::atomic<uint64_t> head{ 0 };
+    std::atomic<bool> inUse{ true };
+    uint32_t tid = 0;
+    const char* threadName = nullptr;
+};
+
+std::mutex registryMutex;
+std::vector<ThreadRing*> rings;
+
+// Hands the ring back when the thread exits so short-lived workers reuse it
+struct RingOwner {
+    ThreadRing* ring = nullptr;
+    ~RingOwner() {
+        if (ring) ring->inUse = false;
+    }
+};
+thread_local RingOwner localRing;
+
+ThreadRing* GetRing() {
+    if (localRing.ring) return localRing.ring;
+
+    // Only taken once per thread, recording itself never locks
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (ThreadRing* ring : rings) {
+        bool expected = false;
+        if (ring->inUse.compare_exchange_strong(expected, true)) {
+            ring->threadName = nullptr;
+            localRing.ring = ring;
+            return ring;
+        }
+    }
+    ThreadRing* ring = new ThreadRing();
+    ring->tid = static_cast<uint32_t>(rings.size() + 1);
+    rings.push_back(ring);
+    localRing.ring = ring;
+    return ring;
+}
+
+void Record(const char* name, uint64_t start, uint64_t end) {
+    ThreadRing* ring = GetRing();
+    uint64_t h = ring->head.load(std::memory_order_relaxed);
+    ring->events[h & (RING_CAPACITY - 1)] = { name, start, end };
+    ring->head.store(h + 1, std::memory_order_release);
+}
+
+// Frame bookkeeping, main thread only
+uint64_t frameStarts[FRAME_HISTORY];
+uint64_t frameIndex = 0;
+int captureFramesLeft = 0;
+uint64_t captureStart = 0;
+double frameBudgetMs = 33.3;
+uint64_t lastHitchDump = 0;
+int traceCounter = 0;
+
+uint64_t processStart = Profiler::NowNs();
+
+void WriteTrace(const char* reason, uint64_t windowStart, uint64_t windowEnd) {
+    std::string path = std::string("trace_") + reason + "_" + std::to_string(++traceCounter) + ".json";
+    std::ofstream out(path);
+    if (!out) return;
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (ThreadRing* ring : rings) {
+        out << (first ? "" : ",\n");
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->tid
+            << ",\"args\":{\"name\":\"" << (ring->threadName ? ring->threadName : "Worker") << "\"}}";
+
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        // Skip the oldest slots, the owner may be overwriting them right now
+        uint64_t oldest = head > RING_CAPACITY - 1024 ? head - (RING_CAPACITY - 1024) : 0;
+        for (uint64_t i = oldest; i < head; ++i) {
+            const ZoneEvent& ev = ring->events[i & (RING_CAPACITY - 1)];
+            if (ev.end < windowStart || ev.start > windowEnd) continue;
+            out << ",\n{\"name\":\"" << ev.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->tid
+                << ",\"ts\":" << (ev.start - processStart) / 1000.0
+                << ",\"dur\":" << (ev.end - ev.start) / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+    std::cout << "[Profiler] Wrote " << path << std::endl;
+}
+
+} // namespace
+
+uint64_t Profiler::NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ProfileZone::~ProfileZone() {
+    Record(name, start, Profiler::NowNs());
+}
+
+void Profiler::SetThreadName(const char* name) {
+    GetRing()->threadName = name;
+}
+
+void Profiler::RequestCapture(int frameCount) {
+    if (captureFramesLeft > 0 || frameCount <= 0) return;
+    captureFramesLeft = frameCount;
+    captureStart = NowNs();
+}
+
+void Profiler::SetFrameBudgetMs(double budgetMs) {
+    frameBudgetMs = budgetMs;
+}
+
+void Profiler::FrameMark() {
+    uint64_t now = NowNs();
+    uint64_t frameStart = frameIndex > 0 ? frameStarts[(frameIndex - 1) % FRAME_HISTORY] : now;
+    frameStarts[frameIndex % FRAME_HISTORY] = now;
+    frameIndex++;
+    if (frameIndex > 1) Record("Frame", frameStart, now);
+
+    if (captureFramesLeft > 0 && --captureFramesLeft == 0) {
+        WriteTrace("capture", captureStart, now);
+    }
+
+    double frameMs = (now - frameStart) / 1e6;
+    if (frameBudgetMs > 0.0 && frameMs > frameBudgetMs && now - lastHitchDump > HITCH_COOLDOWN_NS) {
+        lastHitchDump = now;
+        uint64_t history = frameIndex > HITCH_HISTORY_FRAMES ? HITCH_HISTORY_FRAMES : frameIndex - 1;
+        std::cout << "[Profiler] Frame took " << frameMs << " ms (budget " << frameBudgetMs << " ms)" << std::endl;
+        WriteTrace("hitch", frameStarts[(frameIndex - 1 - history) % FRAME_HISTORY], now);
+    }
+}
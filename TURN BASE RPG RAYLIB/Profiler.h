@@ -0,0 +1,52 @@
+// Profiler.h
+#pragma once
+#include <cstdint>
+
+// Scoped timing zones exported as Chrome trace_event JSON (open in ui.perfetto.dev).
+// Only compiled in when RPG_PROFILER is defined; otherwise the macros expand to nothing.
+//
+//   void Game::DrawBattle() {
+//       PROFILE_ZONE("DrawBattle");
+//       ...
+//
+// Zone names must be string literals, only the pointer is stored.
+
+namespace Profiler {
+    uint64_t NowNs();
+
+    // Called once per frame by EndFrame
+    void FrameMark();
+
+    // Write a trace of the next frameCount frames
+    void RequestCapture(int frameCount);
+
+    // Frames slower than this dump the recent history automatically (0 disables)
+    void SetFrameBudgetMs(double budgetMs);
+
+    void SetThreadName(const char* name);
+}
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name(name), start(Profiler::NowNs()) {}
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#ifdef RPG_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME_MARK() Profiler::FrameMark()
+#define PROFILE_THREAD_NAME(name) Profiler::SetThreadName(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME_MARK() ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,96 @@
+#include "RaylibRenderer.h"
+#include "RenderQueue.h"
+#include "rlgl.h"
+
+void RaylibRenderer::BeginFrame() {
+    ::BeginDrawing();
+}
+
+void RaylibRenderer::EndFrame() {
+    ::EndDrawing();
+}
+
+bool RaylibRenderer::ShouldClose() {
+    return ::WindowShouldClose();
+}
+
+int RaylibRenderer::Width() const {
+    return ::GetScreenWidth();
+}
+
+int RaylibRenderer::Height() const {
+    return ::GetScreenHeight();
+}
+
+Texture2D RaylibRenderer::LoadTexture(const char* path) {
+    return ::LoadTexture(path);
+}
+
+void RaylibRenderer::UnloadTexture(Texture2D texture) {
+    ::UnloadTexture(texture);
+}
+
+RenderTexture2D RaylibRenderer::LoadRenderTexture(int width, int height) {
+    return ::LoadRenderTexture(width, height);
+}
+
+void RaylibRenderer::UnloadRenderTexture(RenderTexture2D target) {
+    ::UnloadRenderTexture(target);
+}
+
+void RaylibRenderer::BeginTextureMode(RenderTexture2D target) {
+    ::BeginTextureMode(target);
+    // Alpha adds up as it does on the window: whatever is drawn over an opaque
+    // backdrop stays opaque, instead of each translucent draw eating into it
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+        RL_FUNC_ADD, RL_FUNC_ADD);
+    ::BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+}
+
+void RaylibRenderer::EndTextureMode() {
+    ::EndBlendMode();
+    ::EndTextureMode();
+}
+
+void RaylibRenderer::ClearBackground(Color color) {
+    ::ClearBackground(color);
+}
+
+void RaylibRenderer::DrawRectangleRec(Rectangle rect, Color color) {
+    ::DrawRectangleRec(rect, color);
+}
+
+void RaylibRenderer::DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) {
+    ::DrawRectangleLinesEx(rect, thickness, color);
+}
+
+void RaylibRenderer::DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) {
+    ::DrawTextureEx(texture, position, rotation, scale, tint);
+}
+
+void RaylibRenderer::DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) {
+    ::DrawTextureRec(texture, source, position, tint);
+}
+
+void RaylibRenderer::DrawText(const char* text, int x, int y, int fontSize, Color color) {
+    ::DrawText(text, x, y, fontSize, color);
+}
+
+int RaylibRenderer::MeasureText(const char* text, int fontSize) {
+    return ::MeasureText(text, fontSize);
+}
+
+static RaylibRenderer windowRenderer;
+static RenderQueue queue(&windowRenderer);
+
+Renderer& Gfx() {
+    return queue;
+}
+
+RenderQueue& GfxQueue() {
+    return queue;
+}
+
+void SetRenderer(Renderer* renderer) {
+    queue.SetTarget(renderer ? renderer : &windowRenderer);
+}
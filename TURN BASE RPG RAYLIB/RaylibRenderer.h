@@ -0,0 +1,30 @@
+// RaylibRenderer.h
+#pragma once
+#include "Renderer.h"
+
+// Draws to the raylib window; InitWindow must have been called
+class RaylibRenderer : public Renderer {
+public:
+    void BeginFrame() override;
+    void EndFrame() override;
+    bool ShouldClose() override;
+
+    int Width() const override;
+    int Height() const override;
+
+    Texture2D LoadTexture(const char* path) override;
+    void UnloadTexture(Texture2D texture) override;
+
+    RenderTexture2D LoadRenderTexture(int width, int height) override;
+    void UnloadRenderTexture(RenderTexture2D target) override;
+    void BeginTextureMode(RenderTexture2D target) override;
+    void EndTextureMode() override;
+
+    void ClearBackground(Color color) override;
+    void DrawRectangleRec(Rectangle rect, Color color) override;
+    void DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) override;
+    void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) override;
+    void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) override;
+    void DrawText(const char* text, int x, int y, int fontSize, Color color) override;
+    int MeasureText(const char* text, int fontSize) override;
+};
@@ -0,0 +1,273 @@
+#include "RenderQueue.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Batch keys for what raylib draws with its own textures; loaded textures use their id
+const uint32_t SHAPES_KEY = 0;
+const uint32_t FONT_KEY = 1;
+const uint32_t FIRST_TEXTURE_KEY = 2;
+
+// Draws outside BeginFrame/EndFrame still get sent before the queue grows without bound
+const size_t MAX_QUEUED = 16384;
+
+bool Overlaps(const Rectangle& a, const Rectangle& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width &&
+        a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+// Cells past the edge of the screen hold everything beyond it
+int CellIndex(float position, float cellSize, int cells) {
+    return std::min(std::max(static_cast<int>(std::floor(position / cellSize)), 0), cells - 1);
+}
+
+// Consecutive commands with the same batch key
+template <typename Key>
+int CountRuns(size_t count, Key key) {
+    int runs = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0 || key(i) != key(i - 1)) runs++;
+    }
+    return runs;
+}
+
+} // namespace
+
+void RenderQueue::SetTarget(Renderer* renderer) {
+    Flush();
+    target = renderer;
+}
+
+void RenderQueue::SetBypass(bool on) {
+    Flush();
+    bypass = on;
+}
+
+void RenderQueue::BeginFrame() {
+    frame = DrawBatchStats();
+    target->BeginFrame();
+}
+
+void RenderQueue::EndFrame() {
+    Flush();
+    lastFrame = frame;
+    target->EndFrame();
+}
+
+void RenderQueue::UnloadTexture(Texture2D texture) {
+    // Queued draws may still use it
+    Flush();
+    target->UnloadTexture(texture);
+}
+
+void RenderQueue::UnloadRenderTexture(RenderTexture2D renderTexture) {
+    Flush();
+    target->UnloadRenderTexture(renderTexture);
+}
+
+// What was queued belongs to the surface it was drawn for
+void RenderQueue::BeginTextureMode(RenderTexture2D renderTexture) {
+    Flush();
+    target->BeginTextureMode(renderTexture);
+}
+
+void RenderQueue::EndTextureMode() {
+    Flush();
+    target->EndTextureMode();
+}
+
+void RenderQueue::ClearBackground(Color color) {
+    Flush();
+    target->ClearBackground(color);
+}
+
+void RenderQueue::DrawRectangleRec(Rectangle rect, Color color) {
+    Command command = {};
+    command.kind = Kind::Rectangle;
+    command.texture = SHAPES_KEY;
+    command.bounds = rect;
+    command.color = color;
+    Push(command);
+}
+
+void RenderQueue::DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) {
+    Command command = {};
+    command.kind = Kind::RectangleLines;
+    command.texture = SHAPES_KEY;
+    command.bounds = rect;
+    command.color = color;
+    command.scale = thickness;
+    Push(command);
+}
+
+void RenderQueue::DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) {
+    Command command = {};
+    command.kind = Kind::Texture;
+    command.texture = FIRST_TEXTURE_KEY + texture.id;
+    command.color = tint;
+    command.image = texture;
+    command.position = position;
+    command.rotation = rotation;
+    command.scale = scale;
+    float width = texture.width * scale;
+    float height = texture.height * scale;
+    if (rotation == 0.0f) {
+        command.bounds = Rectangle{ position.x, position.y, width, height };
+    }
+    else {
+        // Turned about its top-left corner: anywhere within its diagonal of it
+        float reach = std::sqrt(width * width + height * height);
+        command.bounds = Rectangle{ position.x - reach, position.y - reach, reach * 2, reach * 2 };
+    }
+    Push(command);
+}
+
+void RenderQueue::DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) {
+    Command command = {};
+    command.kind = Kind::TextureRec;
+    command.texture = FIRST_TEXTURE_KEY + texture.id;
+    command.color = tint;
+    command.image = texture;
+    command.source = source;
+    command.position = position;
+    command.bounds = Rectangle{ position.x, position.y, std::fabs(source.width), std::fabs(source.height) };
+    Push(command);
+}
+
+void RenderQueue::DrawText(const char* string, int x, int y, int fontSize, Color color) {
+    Command command = {};
+    command.kind = Kind::Text;
+    command.texture = FONT_KEY;
+    command.color = color;
+    command.position = Vector2{ (float)x, (float)y };
+    command.fontSize = fontSize;
+    command.textOffset = static_cast<uint32_t>(text.size());
+    size_t length = std::strlen(string);
+    text.insert(text.end(), string, string + length + 1);
+
+    // Lines are fontSize tall; the gap raylib leaves between them is well under half that
+    int lines = 1 + static_cast<int>(std::count(string, string + length, '\n'));
+    float width = (float)target->MeasureText(string, fontSize) + 1.0f;
+    float height = (float)(lines * fontSize + (lines - 1) * (fontSize / 2 + 1));
+    command.bounds = Rectangle{ (float)x, (float)y, width, height };
+    Push(command);
+}
+
+void RenderQueue::Push(Command& command) {
+    if (!bypass) {
+        Queue(command);
+        return;
+    }
+    if (frame.commands == 0 || command.texture != lastTexture) {
+        frame.submittedBatches++;
+        frame.batches++;
+    }
+    frame.commands++;
+    lastTexture = command.texture;
+    Send(command);
+    text.clear();
+}
+
+void RenderQueue::Queue(Command& command) {
+    if (commands.empty()) {
+        cellWidth = std::max(1.0f, (float)target->Width() / GRID);
+        cellHeight = std::max(1.0f, (float)target->Height() / GRID);
+    }
+    command.sequence = static_cast<uint32_t>(commands.size());
+    command.box = command.bounds;
+    if (command.box.width < 0) {
+        command.box.x += command.box.width;
+        command.box.width = -command.box.width;
+    }
+    if (command.box.height < 0) {
+        command.box.y += command.box.height;
+        command.box.height = -command.box.height;
+    }
+    int x0 = CellIndex(command.box.x, cellWidth, GRID);
+    int x1 = CellIndex(command.box.x + command.box.width, cellWidth, GRID);
+    int y0 = CellIndex(command.box.y, cellHeight, GRID);
+    int y1 = CellIndex(command.box.y + command.box.height, cellHeight, GRID);
+
+    // On top of every earlier draw it overlaps; one layer higher than those
+    // that use another texture
+    int layer = 0;
+    uint32_t tester = command.sequence + 1;
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const Cell& cell = cells[cy * GRID + cx];
+            if (cell.top + 1 <= layer) continue;
+            for (uint32_t index : cell.commands) {
+                if (testedBy[index] == tester) continue;
+                testedBy[index] = tester;
+                const Command& other = commands[index];
+                if (!Overlaps(other.box, command.box)) continue;
+                layer = std::max(layer, other.layer + (other.texture != command.texture ? 1 : 0));
+            }
+        }
+    }
+
+    command.layer = static_cast<uint16_t>(layer);
+    layerCount = std::max(layerCount, layer + 1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            Cell& cell = cells[cy * GRID + cx];
+            cell.commands.push_back(command.sequence);
+            cell.top = std::max(cell.top, layer);
+        }
+    }
+    commands.push_back(command);
+    testedBy.push_back(0);
+
+    if (commands.size() >= MAX_QUEUED) Flush();
+}
+
+void RenderQueue::Flush() {
+    if (commands.empty()) return;
+    PROFILE_ZONE("RenderQueue::Flush");
+
+    frame.commands += static_cast<int>(commands.size());
+    frame.submittedBatches += CountRuns(commands.size(), [&](size_t i) { return commands[i].texture; });
+    frame.layers = std::max(frame.layers, layerCount);
+
+    std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
+        if (a.layer != b.layer) return a.layer < b.layer;
+        if (a.texture != b.texture) return a.texture < b.texture;
+        return a.sequence < b.sequence;
+    });
+    frame.batches += CountRuns(commands.size(), [&](size_t i) { return commands[i].texture; });
+
+    for (const Command& command : commands) Send(command);
+
+    commands.clear();
+    text.clear();
+    testedBy.clear();
+    for (Cell& cell : cells) {
+        cell.commands.clear();
+        cell.top = -1;
+    }
+    layerCount = 0;
+}
+
+void RenderQueue::Send(const Command& command) {
+    switch (command.kind) {
+    case Kind::Rectangle:
+        target->DrawRectangleRec(command.bounds, command.color);
+        break;
+    case Kind::RectangleLines:
+        target->DrawRectangleLinesEx(command.bounds, command.scale, command.color);
+        break;
+    case Kind::Texture:
+        target->DrawTextureEx(command.image, command.position, command.rotation, command.scale, command.color);
+        break;
+    case Kind::TextureRec:
+        target->DrawTextureRec(command.image, command.source, command.position, command.color);
+        break;
+    case Kind::Text:
+        target->DrawText(&text[command.textOffset], (int)command.position.x, (int)command.position.y,
+            command.fontSize, command.color);
+        break;
+    }
+}
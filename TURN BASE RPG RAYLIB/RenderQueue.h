@@ -0,0 +1,118 @@
+// RenderQueue.h
+#pragma once
+#include "Renderer.h"
+#include <cstdint>
+#include <vector>
+
+// What one frame's draws cost in batches. A batch is a run of draws raylib
+// can send in one draw call: consecutive quads with the same texture.
+struct DrawBatchStats {
+    int commands = 0;
+    int submittedBatches = 0;  // in the order the screen drew them
+    int batches = 0;           // after sorting
+    int layers = 0;
+};
+
+// Sits between Gfx() and the renderer. Draws are queued for the frame and
+// sent on in an order that keeps textures together, so the font atlas,
+// sprites and the shape texture stop breaking each other's batches.
+//
+// Each draw gets a layer: the lowest one above everything drawn earlier that
+// it overlaps with another texture. Draws are sent by layer, then texture,
+// then the order they came in, so anything that overlaps still lands on top
+// of what it was drawn over and the picture comes out the same. A coarse
+// grid over the screen keeps the overlap tests to draws nearby.
+//
+// Flushed by EndFrame, by ClearBackground, around render texture switches and
+// when the queue gets very long; anything that needs its pixels earlier calls
+// Flush.
+class RenderQueue : public Renderer {
+public:
+    explicit RenderQueue(Renderer* target) : target(target) {}
+
+    // Flushes first, so nothing queued for the old renderer reaches the new one
+    void SetTarget(Renderer* renderer);
+    Renderer& Target() { return *target; }
+
+    void Flush();
+
+    // Sends draws straight on in the order they come, to compare against
+    void SetBypass(bool on);
+
+    // Summed over every flush of the last finished frame
+    const DrawBatchStats& LastFrame() const { return lastFrame; }
+
+    void BeginFrame() override;
+    void EndFrame() override;
+    bool ShouldClose() override { return target->ShouldClose(); }
+
+    int Width() const override { return target->Width(); }
+    int Height() const override { return target->Height(); }
+
+    Texture2D LoadTexture(const char* path) override { return target->LoadTexture(path); }
+    void UnloadTexture(Texture2D texture) override;
+
+    RenderTexture2D LoadRenderTexture(int width, int height) override { return target->LoadRenderTexture(width, height); }
+    void UnloadRenderTexture(RenderTexture2D renderTexture) override;
+    void BeginTextureMode(RenderTexture2D renderTexture) override;
+    void EndTextureMode() override;
+
+    void ClearBackground(Color color) override;
+    void DrawRectangleRec(Rectangle rect, Color color) override;
+    void DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) override;
+    void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) override;
+    void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) override;
+    void DrawText(const char* text, int x, int y, int fontSize, Color color) override;
+    int MeasureText(const char* text, int fontSize) override { return target->MeasureText(text, fontSize); }
+
+private:
+    enum class Kind : uint8_t { Rectangle, RectangleLines, Texture, TextureRec, Text };
+
+    struct Command {
+        Kind kind;
+        uint16_t layer;
+        uint32_t texture;   // batch key: shapes, font, or a texture id
+        uint32_t sequence;  // order of submission
+        Rectangle bounds;   // what it covers, as the caller gave it
+        Rectangle box;      // the same with a positive size, for overlap tests
+        Color color;
+        // Rectangle/RectangleLines: rect in bounds, thickness in scale
+        // Texture: texture, position, rotation, scale
+        // TextureRec: texture, source, position
+        // Text: offset into text, position, fontSize
+        Texture2D image;
+        Rectangle source;
+        Vector2 position;
+        float rotation;
+        float scale;
+        uint32_t textOffset;
+        int fontSize;
+    };
+
+    void Push(Command& command);
+    void Queue(Command& command);
+    void Send(const Command& command);
+
+    Renderer* target;
+    std::vector<Command> commands;
+    std::vector<char> text;
+    // Queued commands touching each grid cell, and the top layer among them
+    struct Cell {
+        std::vector<uint32_t> commands;
+        int top = -1;
+    };
+    static const int GRID = 16;
+    Cell cells[GRID * GRID];
+    float cellWidth = 1.0f;
+    float cellHeight = 1.0f;
+    std::vector<uint32_t> testedBy;  // per command: 1 + the command that last tested it
+    int layerCount = 0;
+    bool bypass = false;
+    uint32_t lastTexture = 0;  // bypassed: what the last draw used
+
+    DrawBatchStats frame;
+    DrawBatchStats lastFrame;
+};
+
+// The queue Gfx() hands out, in front of whatever SetRenderer installed
+RenderQueue& GfxQueue();
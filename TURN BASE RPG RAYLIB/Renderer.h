@@ -0,0 +1,51 @@
+// Renderer.h
+#pragma once
+#include "raylib.h"
+
+// Everything the game draws goes through Gfx() instead of calling raylib, so
+// the same screens can run on a window, headless (NullRenderer) or into an
+// offscreen image (SoftwareRenderer). Method names follow raylib's.
+// Gfx() is a RenderQueue: draws reach the renderer sorted, when it flushes.
+class Renderer {
+public:
+    virtual ~Renderer() = default;
+
+    virtual void BeginFrame() = 0;
+    virtual void EndFrame() = 0;
+    // True once the window was closed, or a headless run used up its frames
+    virtual bool ShouldClose() = 0;
+
+    virtual int Width() const = 0;
+    virtual int Height() const = 0;
+
+    virtual Texture2D LoadTexture(const char* path) = 0;
+    virtual void UnloadTexture(Texture2D texture) = 0;
+
+    // Offscreen targets: between BeginTextureMode and EndTextureMode draws land
+    // in target instead of the screen. As in raylib its texture is stored
+    // bottom-up, so it is drawn back with a negative source height.
+    virtual RenderTexture2D LoadRenderTexture(int width, int height) = 0;
+    virtual void UnloadRenderTexture(RenderTexture2D target) = 0;
+    virtual void BeginTextureMode(RenderTexture2D target) = 0;
+    virtual void EndTextureMode() = 0;
+
+    virtual void ClearBackground(Color color) = 0;
+    virtual void DrawRectangleRec(Rectangle rect, Color color) = 0;
+    virtual void DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) = 0;
+    virtual void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) = 0;
+    // A negative source width or height flips that way
+    virtual void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) = 0;
+    virtual void DrawText(const char* text, int x, int y, int fontSize, Color color) = 0;
+    virtual int MeasureText(const char* text, int fontSize) = 0;
+
+    void DrawRectangle(int x, int y, int width, int height, Color color) {
+        DrawRectangleRec(Rectangle{ (float)x, (float)y, (float)width, (float)height }, color);
+    }
+    void DrawTexture(Texture2D texture, int x, int y, Color tint) {
+        DrawTextureEx(texture, Vector2{ (float)x, (float)y }, 0.0f, 1.0f, tint);
+    }
+};
+
+// Defaults to the raylib window renderer
+Renderer& Gfx();
+void SetRenderer(Renderer* renderer);
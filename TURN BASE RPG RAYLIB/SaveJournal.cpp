@@ -0,0 +1,148 @@
+#include "SaveJournal.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+uint32_t Crc32(const void* data, size_t size) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint32_t RecordCrc(const JournalRecord& rec) {
+    return Crc32(&rec, offsetof(JournalRecord, crc));
+}
+
+bool CommitTempFile(const std::string& path) {
+    std::string tmpPath = path + ".tmp";
+    // std::rename does not overwrite on Windows
+    std::remove(path.c_str());
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+void RecoverTempFile(const std::string& path) {
+    std::string tmpPath = path + ".tmp";
+    std::ifstream original(path, std::ios::binary);
+    std::ifstream tmp(tmpPath, std::ios::binary);
+    if (!tmp) return;
+    tmp.close();
+
+    if (original) {
+        // Original still there: the temp file was never finished
+        original.close();
+        std::remove(tmpPath.c_str());
+    }
+    else {
+        std::rename(tmpPath.c_str(), path.c_str());
+    }
+}
+
+SaveJournal::SaveJournal(const std::string& path) : path(path) {}
+
+std::vector<JournalRecord> SaveJournal::ReadValid() const {
+    std::vector<JournalRecord> records;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return records;
+
+    JournalRecord rec;
+    uint32_t lastSeq = 0;
+    while (in.read(reinterpret_cast<char*>(&rec), sizeof(rec))) {
+        // Stop at the first torn or out-of-order record, everything after it is unreliable
+        if (rec.crc != RecordCrc(rec) || rec.seq <= lastSeq) break;
+        lastSeq = rec.seq;
+        records.push_back(rec);
+    }
+    return records;
+}
+
+void SaveJournal::Rewrite(const std::vector<JournalRecord>& records) {
+    if (out.is_open()) out.close();
+
+    {
+        std::ofstream tmp(path + ".tmp", std::ios::binary | std::ios::trunc);
+        for (const auto& rec : records) {
+            tmp.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        }
+    }
+    CommitTempFile(path);
+
+    recordCount = records.size();
+    out.open(path, std::ios::binary | std::ios::app);
+}
+
+void SaveJournal::Open() {
+    RecoverTempFile(path);
+
+    std::vector<JournalRecord> records = ReadValid();
+    if (!records.empty()) {
+        nextSeq = records.back().seq + 1;
+    }
+
+    // Drop a torn tail so new records are not appended after garbage
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    std::streamoff fileSize = in ? static_cast<std::streamoff>(in.tellg()) : 0;
+    in.close();
+    if (fileSize != static_cast<std::streamoff>(records.size() * sizeof(JournalRecord))) {
+        Rewrite(records);
+        return;
+    }
+
+    recordCount = records.size();
+    out.open(path, std::ios::binary | std::ios::app);
+}
+
+void SaveJournal::Close() {
+    if (out.is_open()) out.close();
+}
+
+void SaveJournal::Append(JournalOp op, const int32_t* values, int valueCount, const std::string& key) {
+    if (!out.is_open()) return;
+
+    JournalRecord rec;
+    std::memset(&rec, 0, sizeof(rec));
+    rec.seq = nextSeq++;
+    rec.op = static_cast<uint8_t>(op);
+    for (int i = 0; i < valueCount && i < 8; ++i) {
+        rec.values[i] = values[i];
+    }
+    std::memcpy(rec.key, key.c_str(), std::min(key.size(), sizeof(rec.key) - 1));
+    rec.crc = RecordCrc(rec);
+
+    out.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+    out.flush();
+    recordCount++;
+}
+
+std::vector<JournalRecord> SaveJournal::ReadAfter(uint32_t afterSeq) const {
+    std::vector<JournalRecord> records = ReadValid();
+    std::vector<JournalRecord> tail;
+    for (const auto& rec : records) {
+        if (rec.seq > afterSeq) tail.push_back(rec);
+    }
+    return tail;
+}
+
+void SaveJournal::Compact(uint32_t foldedSeq) {
+    Rewrite(ReadAfter(foldedSeq));
+}
+
+void SaveJournal::EnsureSeqAfter(uint32_t seq) {
+    if (nextSeq <= seq) nextSeq = seq + 1;
+}
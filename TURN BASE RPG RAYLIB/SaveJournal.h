@@ -0,0 +1,67 @@
+// SaveJournal.h
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Kind of mutation stored in a journal record
+enum class JournalOp : uint8_t {
+    CoinsDelta = 1,   // values[0] = coins added (negative when spent)
+    ItemQuantity = 2, // key = item name, values[0] = new quantity (0 removes it)
+    SkillBought = 3,  // key = skill name
+    Stats = 4         // values = maxHP, currentHP, attack, defense, level, exp, expToLevel, equippedSkillIndex
+};
+
+// One fixed-size journal entry. The CRC covers every byte before it.
+struct JournalRecord {
+    uint32_t seq;
+    uint8_t op;
+    uint8_t reserved[3];
+    int32_t values[8];
+    char key[32];     // item or skill name, up to 31 characters
+    uint32_t crc;
+};
+static_assert(sizeof(JournalRecord) == 76, "JournalRecord must stay fixed-size");
+
+uint32_t Crc32(const void* data, size_t size);
+
+// Moves a fully written "<path>.tmp" over path. If a crash happened between
+// removing the old file and the rename, RecoverTempFile finishes the move.
+bool CommitTempFile(const std::string& path);
+void RecoverTempFile(const std::string& path);
+
+// Append-only log of save mutations kept next to save.dat.
+// Every record is flushed as soon as it is written, so a crash loses at most
+// the record that was being written (a torn tail fails its CRC and is dropped).
+class SaveJournal {
+public:
+    explicit SaveJournal(const std::string& path);
+
+    // Validates the existing file, drops a torn tail and opens it for appending
+    void Open();
+    void Close();
+
+    void Append(JournalOp op, const int32_t* values, int valueCount, const std::string& key = "");
+
+    // All valid records with seq > afterSeq, in order
+    std::vector<JournalRecord> ReadAfter(uint32_t afterSeq) const;
+
+    // Rewrites the file keeping only records with seq > foldedSeq (already in the snapshot)
+    void Compact(uint32_t foldedSeq);
+
+    // Makes sure new records are numbered after a loaded snapshot
+    void EnsureSeqAfter(uint32_t seq);
+
+    uint32_t LastSeq() const { return nextSeq - 1; }
+    size_t RecordCount() const { return recordCount; }
+
+private:
+    std::vector<JournalRecord> ReadValid() const;
+    void Rewrite(const std::vector<JournalRecord>& records);
+
+    std::string path;
+    std::ofstream out;
+    uint32_t nextSeq = 1;
+    size_t recordCount = 0;
+};
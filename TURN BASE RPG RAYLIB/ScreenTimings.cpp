@@ -0,0 +1,201 @@
+#include "ScreenTimings.h"
+#include "FlightRecorder.h"
+#include "Input.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace {
+
+// Fewer frames than this give percentiles too noisy to call a regression
+const size_t MIN_COMPARABLE_FRAMES = 30;
+// Slowdowns smaller than this are timer noise on frames that are nearly free
+const double MIN_REGRESSION_MS = 0.05;
+
+struct Screen {
+    const char* name;
+    std::vector<float> frameMs;
+    uint64_t submittedBatches;
+    uint64_t batches;
+};
+
+struct Summary {
+    size_t frames = 0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double submittedBatches = 0.0;  // per frame
+    double batches = 0.0;
+};
+
+bool enabled = false;
+const char* currentScreen = "Other";
+std::vector<Screen> screens;
+double lastFrameEnd = 0.0;
+
+double NowMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Screen& FindScreen(const char* name) {
+    for (Screen& screen : screens) {
+        if (screen.name == name || std::strcmp(screen.name, name) == 0) return screen;
+    }
+    screens.push_back({ name, {}, 0, 0 });
+    screens.back().frameMs.reserve(4096);
+    return screens.back();
+}
+
+double Percentile(std::vector<float>& sorted, double p) {
+    size_t index = std::min(sorted.size() - 1, (size_t)(p * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+Summary Summarize(const Screen& screen) {
+    Summary summary;
+    summary.frames = screen.frameMs.size();
+    if (summary.frames == 0) return summary;
+    std::vector<float> sorted = screen.frameMs;
+    summary.p50 = Percentile(sorted, 0.50);
+    summary.p95 = Percentile(sorted, 0.95);
+    summary.p99 = Percentile(sorted, 0.99);
+    summary.max = *std::max_element(sorted.begin(), sorted.end());
+    summary.submittedBatches = (double)screen.submittedBatches / summary.frames;
+    summary.batches = (double)screen.batches / summary.frames;
+    return summary;
+}
+
+// Reads screens back out of a file written by WriteJson
+std::map<std::string, Summary> ReadBaseline(const std::string& path) {
+    std::map<std::string, Summary> baseline;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t namePos = line.find("\"name\": \"");
+        if (namePos == std::string::npos) continue;
+        namePos += 9;
+        size_t nameEnd = line.find('"', namePos);
+        if (nameEnd == std::string::npos) continue;
+
+        auto field = [&](const char* key) {
+            size_t pos = line.find(key);
+            return pos == std::string::npos ? 0.0 : std::atof(line.c_str() + pos + std::strlen(key));
+        };
+        Summary summary;
+        summary.frames = (size_t)field("\"frames\": ");
+        summary.p50 = field("\"p50_ms\": ");
+        summary.p95 = field("\"p95_ms\": ");
+        summary.p99 = field("\"p99_ms\": ");
+        summary.max = field("\"max_ms\": ");
+        baseline[line.substr(namePos, nameEnd - namePos)] = summary;
+    }
+    return baseline;
+}
+
+} // namespace
+
+void ScreenTimings::Enable() {
+    enabled = true;
+}
+
+void ScreenTimings::OnFrameEnd(int submittedBatches, int batches) {
+    if (!enabled) return;
+    double now = NowMs();
+    if (lastFrameEnd > 0.0) {
+        Screen& screen = FindScreen(currentScreen);
+        screen.frameMs.push_back((float)(now - lastFrameEnd));
+        screen.submittedBatches += submittedBatches;
+        screen.batches += batches;
+    }
+    lastFrameEnd = now;
+}
+
+void ScreenTimings::PrintReport() {
+    // Batches per frame: as sent after RenderQueue sorted them, and as they were drawn
+    std::printf("\n%-20s %8s %10s %10s %10s %10s %8s %8s\n", "screen", "frames", "p50 ms", "p95 ms", "p99 ms", "max ms",
+        "batches", "unsorted");
+    for (const Screen& screen : screens) {
+        Summary s = Summarize(screen);
+        std::printf("%-20s %8zu %10.3f %10.3f %10.3f %10.3f %8.1f %8.1f\n", screen.name, s.frames, s.p50, s.p95, s.p99, s.max,
+            s.batches, s.submittedBatches);
+    }
+    std::fflush(stdout);
+}
+
+bool ScreenTimings::WriteJson(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << std::fixed << std::setprecision(4);
+    out << "{\n  \"screens\": [\n";
+    for (size_t i = 0; i < screens.size(); ++i) {
+        Summary s = Summarize(screens[i]);
+        out << "    {\"name\": \"" << screens[i].name << "\", \"frames\": " << s.frames
+            << ", \"p50_ms\": " << s.p50 << ", \"p95_ms\": " << s.p95
+            << ", \"p99_ms\": " << s.p99 << ", \"max_ms\": " << s.max
+            << ", \"batches\": " << s.batches << ", \"batches_unsorted\": " << s.submittedBatches << "}";
+        out << (i + 1 < screens.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return true;
+}
+
+bool ScreenTimings::CompareWithBaseline(const std::string& path, double thresholdPct) {
+    std::map<std::string, Summary> baseline = ReadBaseline(path);
+    if (baseline.empty()) {
+        std::cerr << path << ": no baseline screens found" << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::printf("\n%-20s %12s %12s %8s %12s %12s %8s\n", "screen", "base p50", "p50", "change", "base p95", "p95", "change");
+    for (const Screen& screen : screens) {
+        auto it = baseline.find(screen.name);
+        if (it == baseline.end()) continue;
+
+        Summary s = Summarize(screen);
+        const Summary& base = it->second;
+        double p50Change = base.p50 > 0.0 ? (s.p50 - base.p50) / base.p50 * 100.0 : 0.0;
+        double p95Change = base.p95 > 0.0 ? (s.p95 - base.p95) / base.p95 * 100.0 : 0.0;
+        const char* verdict = "";
+        if (s.frames != base.frames) {
+            // A replay that took a different path isn't measuring the same work
+            verdict = "  DIVERGED";
+            ok = false;
+        }
+        else if (s.frames >= MIN_COMPARABLE_FRAMES &&
+            ((p50Change > thresholdPct && s.p50 - base.p50 > MIN_REGRESSION_MS) ||
+             (p95Change > thresholdPct && s.p95 - base.p95 > MIN_REGRESSION_MS))) {
+            verdict = "  REGRESSION";
+            ok = false;
+        }
+        std::printf("%-20s %12.3f %12.3f %+7.1f%% %12.3f %12.3f %+7.1f%%%s\n", screen.name,
+            base.p50, s.p50, p50Change, base.p95, s.p95, p95Change, verdict);
+    }
+    std::fflush(stdout);
+    return ok;
+}
+
+ScreenScope::ScreenScope(const char* name) : previous(currentScreen) {
+    currentScreen = name;
+    FlightRecorder::Record(FlightEvent::ScreenEnter, 0, 0, name);
+    // The press that opened this screen was handled by the one before it
+    Input::Spend();
+}
+
+ScreenScope::~ScreenScope() {
+    FlightRecorder::Record(FlightEvent::ScreenLeave, 0, 0, currentScreen);
+    currentScreen = previous;
+    // Nor is the one that closed it handled again by the screen underneath
+    Input::Spend();
+}
@@ -0,0 +1,46 @@
+// ScreenTimings.h
+#pragma once
+#include <string>
+
+// Frame times bucketed by the screen that produced them. Mostly useful with a
+// replayed input recording on the null renderer, where two builds go through
+// the same frames and the percentiles can be compared screen by screen.
+//
+//   void Game::ShowShop() {
+//       ScreenScope screen("Shop");
+//       ...
+//
+// Screen names must be string literals, only the pointer is stored.
+
+namespace ScreenTimings {
+    // Nothing is collected until this is called
+    void Enable();
+
+    // Called once per frame by EndFrame, with the draw batches the frame
+    // would have taken in drawing order and the ones it took (RenderQueue.h)
+    void OnFrameEnd(int submittedBatches, int batches);
+
+    // Frames, p50/p95/p99/max and average batches per screen
+    void PrintReport();
+
+    // One screen per line, read back by CompareWithBaseline
+    bool WriteJson(const std::string& path);
+
+    // Prints this run against an earlier WriteJson file; false if any screen's
+    // p50 or p95 got slower by more than thresholdPct, or if a screen ran a
+    // different number of frames (the replay took another path)
+    bool CompareWithBaseline(const std::string& path, double thresholdPct);
+}
+
+// Frames ending inside this scope are charged to name
+class ScreenScope {
+public:
+    explicit ScreenScope(const char* name);
+    ~ScreenScope();
+
+    ScreenScope(const ScreenScope&) = delete;
+    ScreenScope& operator=(const ScreenScope&) = delete;
+
+private:
+    const char* previous;
+};
@@ -0,0 +1,218 @@
+#include "SoftwareRenderer.h"
+#include "BitmapFont.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+SoftwareRenderer::SoftwareRenderer(int width, int height, uint64_t maxFrames)
+    : width(width), height(height), maxFrames(maxFrames), pixels((size_t)width * height, BLACK),
+    surface(pixels.data()), surfaceWidth(width), surfaceHeight(height) {}
+
+SoftwareRenderer::~SoftwareRenderer() {
+    for (auto& entry : textures) {
+        UnloadImage(entry.second);
+    }
+}
+
+void SoftwareRenderer::SetScreenshotInterval(const std::string& directory, int every) {
+    screenshotDir = directory;
+    screenshotEvery = every;
+}
+
+bool SoftwareRenderer::SaveScreenshot(const char* path) const {
+    Image image = {};
+    image.data = const_cast<Color*>(pixels.data());
+    image.width = width;
+    image.height = height;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return ExportImage(image, path);
+}
+
+void SoftwareRenderer::BeginFrame() {}
+
+void SoftwareRenderer::EndFrame() {
+    frames++;
+    if (screenshotEvery > 0 && frames % screenshotEvery == 0) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/frame_%06llu.png", screenshotDir.c_str(), (unsigned long long)frames);
+        SaveScreenshot(path);
+    }
+}
+
+bool SoftwareRenderer::ShouldClose() {
+    return maxFrames > 0 && frames >= maxFrames;
+}
+
+Texture2D SoftwareRenderer::LoadTexture(const char* path) {
+    Texture2D texture = {};
+    Image image = LoadImage(path);
+    if (image.data == nullptr) return texture;
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    texture.id = nextTextureId++;
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.mipmaps = 1;
+    texture.format = image.format;
+    textures[texture.id] = image;
+    return texture;
+}
+
+void SoftwareRenderer::UnloadTexture(Texture2D texture) {
+    auto it = textures.find(texture.id);
+    if (it == textures.end()) return;
+    UnloadImage(it->second);
+    textures.erase(it);
+}
+
+RenderTexture2D SoftwareRenderer::LoadRenderTexture(int width, int height) {
+    RenderTexture2D target = {};
+    Image image = GenImageColor(width, height, BLANK);
+    target.texture.id = nextTextureId++;
+    target.texture.width = width;
+    target.texture.height = height;
+    target.texture.mipmaps = 1;
+    target.texture.format = image.format;
+    target.id = target.texture.id;
+    textures[target.texture.id] = image;
+    return target;
+}
+
+void SoftwareRenderer::UnloadRenderTexture(RenderTexture2D target) {
+    UnloadTexture(target.texture);
+}
+
+void SoftwareRenderer::BeginTextureMode(RenderTexture2D target) {
+    auto it = textures.find(target.texture.id);
+    if (it == textures.end()) return;
+    surface = static_cast<Color*>(it->second.data);
+    surfaceWidth = it->second.width;
+    surfaceHeight = it->second.height;
+    bottomUp = true;
+}
+
+void SoftwareRenderer::EndTextureMode() {
+    surface = pixels.data();
+    surfaceWidth = width;
+    surfaceHeight = height;
+    bottomUp = false;
+}
+
+Color* SoftwareRenderer::Row(int y) {
+    return surface + (size_t)(bottomUp ? surfaceHeight - 1 - y : y) * surfaceWidth;
+}
+
+// Alpha adds up the way RaylibRenderer sets it up, so the screen stays opaque
+void SoftwareRenderer::Blend(Color& dst, Color src) const {
+    if (src.a == 255) {
+        dst = src;
+        return;
+    }
+    int a = src.a;
+    dst.r = (unsigned char)((src.r * a + dst.r * (255 - a)) / 255);
+    dst.g = (unsigned char)((src.g * a + dst.g * (255 - a)) / 255);
+    dst.b = (unsigned char)((src.b * a + dst.b * (255 - a)) / 255);
+    dst.a = (unsigned char)(a + dst.a * (255 - a) / 255);
+}
+
+// Half-open pixel range [x0, x1) x [y0, y1), clipped to the surface
+void SoftwareRenderer::Fill(int x0, int y0, int x1, int y1, Color color) {
+    if (color.a == 0) return;
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, surfaceWidth);
+    y1 = std::min(y1, surfaceHeight);
+    for (int y = y0; y < y1; ++y) {
+        Color* row = Row(y);
+        for (int x = x0; x < x1; ++x) Blend(row[x], color);
+    }
+}
+
+void SoftwareRenderer::ClearBackground(Color color) {
+    // Only render textures keep alpha
+    if (surface == pixels.data()) color.a = 255;
+    std::fill(surface, surface + (size_t)surfaceWidth * surfaceHeight, color);
+}
+
+void SoftwareRenderer::DrawRectangleRec(Rectangle rect, Color color) {
+    Fill((int)std::lround(rect.x), (int)std::lround(rect.y),
+        (int)std::lround(rect.x + rect.width), (int)std::lround(rect.y + rect.height), color);
+}
+
+void SoftwareRenderer::DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) {
+    int x0 = (int)std::lround(rect.x);
+    int y0 = (int)std::lround(rect.y);
+    int x1 = (int)std::lround(rect.x + rect.width);
+    int y1 = (int)std::lround(rect.y + rect.height);
+    int t = std::max(1, (int)std::lround(thickness));
+    Fill(x0, y0, x1, y0 + t, color);
+    Fill(x0, y1 - t, x1, y1, color);
+    Fill(x0, y0 + t, x0 + t, y1 - t, color);
+    Fill(x1 - t, y0 + t, x1, y1 - t, color);
+}
+
+void SoftwareRenderer::DrawTextureEx(Texture2D texture, Vector2 position, float, float scale, Color tint) {
+    auto it = textures.find(texture.id);
+    if (it == textures.end()) return;
+    const Image& image = it->second;
+    Blit(image, Rectangle{ 0, 0, (float)image.width, (float)image.height }, position, scale, tint);
+}
+
+void SoftwareRenderer::DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) {
+    auto it = textures.find(texture.id);
+    if (it == textures.end()) return;
+    Blit(it->second, source, position, 1.0f, tint);
+}
+
+// source is in image rows as stored; a negative width or height mirrors it
+void SoftwareRenderer::Blit(const Image& image, Rectangle source, Vector2 position, float scale, Color tint) {
+    int sourceWidth = (int)std::fabs(source.width);
+    int sourceHeight = (int)std::fabs(source.height);
+    if (scale <= 0.0f || sourceWidth == 0 || sourceHeight == 0) return;
+    const Color* src = static_cast<const Color*>(image.data);
+
+    int x0 = (int)std::floor(position.x);
+    int y0 = (int)std::floor(position.y);
+    int x1 = (int)std::floor(position.x + sourceWidth * scale);
+    int y1 = (int)std::floor(position.y + sourceHeight * scale);
+
+    // Nearest-neighbour sample for every destination pixel that is on the surface
+    for (int y = std::max(y0, 0); y < std::min(y1, surfaceHeight); ++y) {
+        int sy = std::min(sourceHeight - 1, (int)((y - position.y) / scale));
+        if (source.height < 0) sy = sourceHeight - 1 - sy;
+        sy = std::min(std::max(sy + (int)source.y, 0), image.height - 1);
+        Color* row = Row(y);
+        for (int x = std::max(x0, 0); x < std::min(x1, surfaceWidth); ++x) {
+            int sx = std::min(sourceWidth - 1, (int)((x - position.x) / scale));
+            if (source.width < 0) sx = sourceWidth - 1 - sx;
+            sx = std::min(std::max(sx + (int)source.x, 0), image.width - 1);
+            Color c = src[(size_t)sy * image.width + sx];
+            c.r = (unsigned char)(c.r * tint.r / 255);
+            c.g = (unsigned char)(c.g * tint.g / 255);
+            c.b = (unsigned char)(c.b * tint.b / 255);
+            c.a = (unsigned char)(c.a * tint.a / 255);
+            if (c.a != 0) Blend(row[x], c);
+        }
+    }
+}
+
+void SoftwareRenderer::DrawText(const char* text, int x, int y, int fontSize, Color color) {
+    float scale = BitmapFont::Scale(fontSize);
+    for (int i = 0; text[i] != '\0'; ++i) {
+        const uint8_t* glyph = BitmapFont::Glyph(text[i]);
+        float gx = x + i * BitmapFont::ADVANCE * scale;
+        for (int col = 0; col < BitmapFont::GLYPH_WIDTH; ++col) {
+            for (int row = 0; row < BitmapFont::GLYPH_HEIGHT; ++row) {
+                if (!(glyph[col] >> row & 1)) continue;
+                int px = (int)(gx + col * scale);
+                int py = (int)(y + row * scale);
+                Fill(px, py, (int)(gx + (col + 1) * scale), (int)(y + (row + 1) * scale), color);
+            }
+        }
+    }
+}
+
+int SoftwareRenderer::MeasureText(const char* text, int fontSize) {
+    return BitmapFont::MeasureText(text, fontSize);
+}
@@ -0,0 +1,71 @@
+// SoftwareRenderer.h
+#pragma once
+#include "Renderer.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Rasterizes on the CPU into an offscreen RGBA image, no window or GL needed.
+// Used for screenshots of headless runs. Rotation is ignored (the game never
+// rotates sprites) and text uses the built-in bitmap font. Render textures
+// are images too, written bottom-up like GL's.
+class SoftwareRenderer : public Renderer {
+public:
+    // maxFrames == 0 runs until something else ends the game
+    SoftwareRenderer(int width, int height, uint64_t maxFrames = 0);
+    ~SoftwareRenderer() override;
+
+    // Writes <directory>/frame_NNNNNN.png after every `every` frames (0 disables)
+    void SetScreenshotInterval(const std::string& directory, int every);
+    bool SaveScreenshot(const char* path) const;
+
+    void BeginFrame() override;
+    void EndFrame() override;
+    bool ShouldClose() override;
+
+    int Width() const override { return width; }
+    int Height() const override { return height; }
+
+    Texture2D LoadTexture(const char* path) override;
+    void UnloadTexture(Texture2D texture) override;
+
+    RenderTexture2D LoadRenderTexture(int width, int height) override;
+    void UnloadRenderTexture(RenderTexture2D target) override;
+    void BeginTextureMode(RenderTexture2D target) override;
+    void EndTextureMode() override;
+
+    void ClearBackground(Color color) override;
+    void DrawRectangleRec(Rectangle rect, Color color) override;
+    void DrawRectangleLinesEx(Rectangle rect, float thickness, Color color) override;
+    void DrawTextureEx(Texture2D texture, Vector2 position, float rotation, float scale, Color tint) override;
+    void DrawTextureRec(Texture2D texture, Rectangle source, Vector2 position, Color tint) override;
+    void DrawText(const char* text, int x, int y, int fontSize, Color color) override;
+    int MeasureText(const char* text, int fontSize) override;
+
+    uint64_t FrameCount() const { return frames; }
+
+private:
+    void Fill(int x0, int y0, int x1, int y1, Color color);
+    void Blend(Color& dst, Color src) const;
+    void Blit(const Image& image, Rectangle source, Vector2 position, float scale, Color tint);
+    Color* Row(int y);
+
+    int width;
+    int height;
+    uint64_t maxFrames;
+    uint64_t frames = 0;
+    std::vector<Color> pixels;
+
+    // What draws land in: pixels, or a render texture's image
+    Color* surface;
+    int surfaceWidth;
+    int surfaceHeight;
+    bool bottomUp = false;
+
+    unsigned nextTextureId = 1;
+    std::map<unsigned, Image> textures; // RGBA8 copies, keyed by the id handed out
+
+    std::string screenshotDir;
+    int screenshotEvery = 0;
+};
@@ -0,0 +1,90 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel() {
+    for (uint32_t& head : heads) head = NONE;
+}
+
+uint32_t TimerWheel::Schedule(uint32_t due, uint32_t payload) {
+    uint32_t handle;
+    if (!freeNodes.empty()) {
+        handle = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        handle = static_cast<uint32_t>(nodes.size());
+        nodes.push_back({});
+    }
+    nodes[handle].due = due > now ? due : now + 1;
+    nodes[handle].payload = payload;
+    Link(handle);
+    pending++;
+    return handle;
+}
+
+void TimerWheel::Cancel(uint32_t handle) {
+    if (handle >= nodes.size()) return;
+    Node& node = nodes[handle];
+    if (node.state == NodeState::Waiting) {
+        Unlink(handle);
+        Release(handle);
+        pending--;
+    }
+    else if (node.state == NodeState::Firing) {
+        // Part of the batch Step is walking; it gets released there
+        node.state = NodeState::Cancelled;
+        pending--;
+    }
+}
+
+// Lowest level whose current span holds the due time; the top level takes the rest
+void TimerWheel::Link(uint32_t handle) {
+    Node& node = nodes[handle];
+    int level = 0;
+    while (level < LEVELS - 1 && ((node.due ^ now) >> ((level + 1) * SLOT_BITS)) != 0) level++;
+    node.slot = static_cast<uint16_t>(level * SLOTS + ((node.due >> (level * SLOT_BITS)) & (SLOTS - 1)));
+    node.state = NodeState::Waiting;
+    node.prev = NONE;
+    node.next = heads[node.slot];
+    if (node.next != NONE) nodes[node.next].prev = handle;
+    heads[node.slot] = handle;
+}
+
+void TimerWheel::Unlink(uint32_t handle) {
+    Node& node = nodes[handle];
+    if (node.prev != NONE) nodes[node.prev].next = node.next;
+    else heads[node.slot] = node.next;
+    if (node.next != NONE) nodes[node.next].prev = node.prev;
+}
+
+void TimerWheel::Release(uint32_t handle) {
+    nodes[handle].state = NodeState::Free;
+    freeNodes.push_back(handle);
+}
+
+uint32_t TimerWheel::Advance() {
+    now++;
+
+    // Crossing into a new slot of level n pours it into the levels below,
+    // highest level first so its timers can fall more than one level
+    int top = 0;
+    while (top < LEVELS - 1 && (now & ((1u << ((top + 1) * SLOT_BITS)) - 1)) == 0) top++;
+    for (int level = top; level >= 1; --level) {
+        uint32_t slot = level * SLOTS + ((now >> (level * SLOT_BITS)) & (SLOTS - 1));
+        uint32_t handle = heads[slot];
+        heads[slot] = NONE;
+        while (handle != NONE) {
+            uint32_t next = nodes[handle].next;
+            Link(handle);
+            handle = next;
+        }
+    }
+
+    // Everything left in this level 0 slot is due now
+    uint32_t slot = now & (SLOTS - 1);
+    uint32_t due = heads[slot];
+    heads[slot] = NONE;
+    for (uint32_t handle = due; handle != NONE; handle = nodes[handle].next) {
+        nodes[handle].state = NodeState::Firing;
+    }
+    return due;
+}
@@ -0,0 +1,77 @@
+// TimerWheel.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel: four levels of 64 slots on an integer clock. A
+// timer sits in the level whose span reaches its due time and trickles down
+// a level each time the clock crosses into that slot, so a step only touches
+// the timers due on it plus, once every 64 steps, one slot of the next level.
+// Scheduling and cancelling are O(1) and reuse nodes, so a steady stream of
+// timers doesn't allocate. Timers more than 2^24 steps out wait in the top
+// level for another lap.
+class TimerWheel {
+public:
+    static constexpr uint32_t NONE = ~0u;
+
+    TimerWheel();
+
+    uint32_t Now() const { return now; }
+    size_t Pending() const { return pending; }
+
+    // Fires payload at due (at the next step if due has passed). The handle
+    // is good for Cancel until the timer fires or is cancelled.
+    uint32_t Schedule(uint32_t due, uint32_t payload);
+    void Cancel(uint32_t handle);
+
+    // Advances the clock one step and calls fire(payload) for each timer due
+    // then. fire may schedule and cancel timers, even ones due this step that
+    // haven't fired yet; what it schedules is due next step at the earliest.
+    template <typename Fn>
+    void Step(Fn&& fire);
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+
+    enum class NodeState : uint8_t { Free, Waiting, Firing, Cancelled };
+
+    struct Node {
+        uint32_t due;
+        uint32_t payload;
+        uint32_t prev;
+        uint32_t next;
+        uint16_t slot;  // level * SLOTS + index
+        NodeState state;
+    };
+
+    void Link(uint32_t handle);
+    void Unlink(uint32_t handle);
+    void Release(uint32_t handle);
+    uint32_t Advance();  // moves the clock, cascades, detaches the due list
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+    uint32_t heads[LEVELS * SLOTS];
+    uint32_t now = 0;
+    size_t pending = 0;
+};
+
+template <typename Fn>
+void TimerWheel::Step(Fn&& fire) {
+    uint32_t handle = Advance();
+    while (handle != NONE) {
+        // Read before fire() runs; nothing in the batch is released until reached
+        uint32_t next = nodes[handle].next;
+        if (nodes[handle].state == NodeState::Firing) {
+            pending--;
+            nodes[handle].state = NodeState::Cancelled; // a Cancel from inside fire() is now a no-op
+            uint32_t payload = nodes[handle].payload;   // fire() may grow nodes
+            fire(payload);
+        }
+        Release(handle);
+        handle = next;
+    }
+}
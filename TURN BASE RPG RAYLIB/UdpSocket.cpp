@@ -0,0 +1,142 @@
+#include "UdpSocket.h"
+#include <cstdlib>
+#include <cstring>
+
+// Kept apart from the raylib code: windows.h clashes with raylib.h names
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET NativeSocket;
+typedef int AddressLength;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int NativeSocket;
+typedef socklen_t AddressLength;
+#endif
+
+namespace {
+
+#if defined(_WIN32)
+// One WSAStartup for the whole run, on the first socket
+bool StartNetworking() {
+    static bool started = false;
+    if (!started) {
+        WSADATA data;
+        started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+    return started;
+}
+#endif
+
+sockaddr_in ToSockaddr(const NetAddress& address) {
+    sockaddr_in out = {};
+    out.sin_family = AF_INET;
+    out.sin_addr.s_addr = htonl(address.ip);
+    out.sin_port = htons(address.port);
+    return out;
+}
+
+} // namespace
+
+bool ParseNetAddress(const char* text, uint16_t defaultPort, NetAddress& out) {
+    const char* colon = std::strrchr(text, ':');
+    size_t hostLength = colon ? static_cast<size_t>(colon - text) : std::strlen(text);
+    char host[64];
+    if (hostLength == 0 || hostLength >= sizeof(host)) return false;
+    std::memcpy(host, text, hostLength);
+    host[hostLength] = '\0';
+
+    NetAddress parsed;
+    parsed.port = defaultPort;
+    if (colon) {
+        char* end = nullptr;
+        long port = std::strtol(colon + 1, &end, 10);
+        if (end == colon + 1 || *end != '\0' || port <= 0 || port > 65535) return false;
+        parsed.port = static_cast<uint16_t>(port);
+    }
+
+    if (std::strcmp(host, "localhost") == 0) {
+        parsed.ip = LOOPBACK_IP;
+    }
+    else {
+        in_addr ip;
+        if (inet_pton(AF_INET, host, &ip) != 1) return false;
+        parsed.ip = ntohl(ip.s_addr);
+    }
+    out = parsed;
+    return true;
+}
+
+UdpSocket::~UdpSocket() {
+    Close();
+}
+
+bool UdpSocket::Open(uint16_t port) {
+    Close();
+#if defined(_WIN32)
+    if (!StartNetworking()) return false;
+#endif
+    NativeSocket s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#if defined(_WIN32)
+    if (s == INVALID_SOCKET) return false;
+#else
+    if (s < 0) return false;
+#endif
+    handle = static_cast<intptr_t>(s);
+
+    sockaddr_in local = ToSockaddr({ 0, port });
+    bool ok = bind(s, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) == 0;
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ok = ok && ioctlsocket(s, FIONBIO, &nonBlocking) == 0;
+#else
+    ok = ok && fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!ok) Close();
+    return ok;
+}
+
+void UdpSocket::Close() {
+    if (handle == INVALID) return;
+#if defined(_WIN32)
+    closesocket(static_cast<NativeSocket>(handle));
+#else
+    close(static_cast<NativeSocket>(handle));
+#endif
+    handle = INVALID;
+}
+
+uint16_t UdpSocket::LocalPort() const {
+    if (handle == INVALID) return 0;
+    sockaddr_in local = {};
+    AddressLength length = sizeof(local);
+    if (getsockname(static_cast<NativeSocket>(handle), reinterpret_cast<sockaddr*>(&local), &length) != 0) return 0;
+    return ntohs(local.sin_port);
+}
+
+bool UdpSocket::SendTo(const NetAddress& to, const void* data, int size) {
+    if (handle == INVALID) return false;
+    sockaddr_in address = ToSockaddr(to);
+    return sendto(static_cast<NativeSocket>(handle), static_cast<const char*>(data), size, 0,
+        reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == size;
+}
+
+int UdpSocket::ReceiveFrom(NetAddress& from, void* data, int capacity) {
+    if (handle == INVALID) return -1;
+    sockaddr_in address = {};
+    AddressLength length = sizeof(address);
+    int received = static_cast<int>(recvfrom(static_cast<NativeSocket>(handle), static_cast<char*>(data), capacity, 0,
+        reinterpret_cast<sockaddr*>(&address), &length));
+    // Would-block, and on Windows the ICMP "port unreachable" of an earlier send
+    if (received < 0) return -1;
+    from.ip = ntohl(address.sin_addr.s_addr);
+    from.port = ntohs(address.sin_port);
+    return received;
+}
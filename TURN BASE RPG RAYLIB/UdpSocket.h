@@ -0,0 +1,42 @@
+// UdpSocket.h
+#pragma once
+#include <cstdint>
+
+// IPv4 address and port, both in host byte order
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+};
+
+const uint32_t LOOPBACK_IP = 0x7F000001;  // 127.0.0.1
+
+// "a.b.c.d", "a.b.c.d:port" or "localhost[:port]"; defaultPort when none is given
+bool ParseNetAddress(const char* text, uint16_t defaultPort, NetAddress& out);
+
+// A non-blocking UDP socket on every local interface. The Winsock or BSD
+// socket calls stay in UdpSocket.cpp, away from raylib.h, whose names clash
+// with windows.h.
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    ~UdpSocket();
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Port 0 picks a free one; see LocalPort
+    bool Open(uint16_t port);
+    void Close();
+    bool IsOpen() const { return handle != INVALID; }
+    uint16_t LocalPort() const;
+
+    bool SendTo(const NetAddress& to, const void* data, int size);
+    // Bytes read into data, or -1 when nothing is waiting
+    int ReceiveFrom(NetAddress& from, void* data, int capacity);
+
+private:
+    static constexpr intptr_t INVALID = -1;
+    intptr_t handle = INVALID;
+};
@@ -1,13 +1,17 @@
 // WarriorEnemy.h
 #pragma once
 #include "Enemy.h"
+#include "Content.h"
 
 class WarriorEnemy : public Enemy {
     int level;
+    const EnemyDef& stats;
 public:
-    WarriorEnemy(int lvl) : level(lvl) {}
+    WarriorEnemy(int lvl) : level(lvl), stats(Content().FindEnemy("Warrior")) {}
     std::string GetName() const override { return "Warrior"; }
-    int GetMaxHP() const override { return 70 + (level * 12); }
-    int GetAttack() const override { return 12 + (level * 2); }
-    int GetDefense() const override { return 4 + (level * 1); }
+    int GetMaxHP() const override { return stats.baseHP + (level * stats.hpPerLevel); }
+    int GetAttack() const override { return stats.baseAttack + (level * stats.attackPerLevel); }
+    int GetDefense() const override { return stats.baseDefense + (level * stats.defensePerLevel); }
+    int GetExpReward() const override { return stats.baseExp + (level * stats.expPerLevel); }
+    int GetCoinReward() const override { return stats.baseCoins + (level * stats.coinsPerLevel); }
 };
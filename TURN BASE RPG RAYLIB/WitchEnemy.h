@@ -1,13 +1,17 @@
 // WitchEnemy.h
 #pragma once
 #include "Enemy.h"
+#include "Content.h"
 
 class WitchEnemy : public Enemy {
     int level;
+    const EnemyDef& stats;
 public:
-    WitchEnemy(int lvl) : level(lvl) {}
+    WitchEnemy(int lvl) : level(lvl), stats(Content().FindEnemy("Witch")) {}
     std::string GetName() const override { return "Witch"; }
-    int GetMaxHP() const override { return 60 + (level * 8); }
-    int GetAttack() const override { return 9 + (level * 2); }
-    int GetDefense() const override { return 3 + (level * 1); }
+    int GetMaxHP() const override { return stats.baseHP + (level * stats.hpPerLevel); }
+    int GetAttack() const override { return stats.baseAttack + (level * stats.attackPerLevel); }
+    int GetDefense() const override { return stats.baseDefense + (level * stats.defensePerLevel); }
+    int GetExpReward() const override { return stats.baseExp + (level * stats.expPerLevel); }
+    int GetCoinReward() const override { return stats.baseCoins + (level * stats.coinsPerLevel); }
 };
@@ -1,46 +1,62 @@
 ﻿#include "raylib.h"
 #include "MainMenu.h"
+#include "Frame.h"
+#include "FrameArena.h"
+#include "Content.h"
+#include "Profiler.h"
+#include "PerfOverlay.h"
 #include "Game.h"
+#include "Renderer.h"
+#include "Input.h"
+#include "ScreenTimings.h"
+#include "NullRenderer.h"
+#include "SoftwareRenderer.h"
+#include "InputRecording.h"
+#include "FlightRecorder.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
 
 
 std::string EnterPlayerName() {
+    ScreenScope screen("EnterName");
     std::string name = "";
-    bool done = false;
-
-    while (!done && !WindowShouldClose()) {
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
-        DrawText("Enter your name:", 100, 100, 24, DARKGREEN);
-        DrawRectangle(100, 140, 400, 40, LIGHTGRAY);
-        DrawText(name.c_str(), 110, 150, 20, BLACK);
-        DrawText("Press ENTER to continue", 100, 200, 20, GRAY);
-        EndDrawing();
-
-        int key = GetCharPressed();
+
+    while (!Gfx().ShouldClose()) {
+        int key = Input::GetCharPressed();
         if (key >= 32 && key <= 125 && name.length() < 16) {
             name += static_cast<char>(key);
         }
 
-        if (IsKeyPressed(KEY_BACKSPACE) && !name.empty()) {
+        if (Input::IsKeyPressed(KEY_BACKSPACE) && !name.empty()) {
             name.pop_back();
         }
 
-        if (IsKeyPressed(KEY_ENTER) && !name.empty()) {
-            done = true;
+        if (Input::IsKeyPressed(KEY_ENTER) && !name.empty()) {
+            break;
         }
+
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
+        Gfx().DrawText("Enter your name:", 100, 100, 24, DARKGREEN);
+        Gfx().DrawRectangle(100, 140, 400, 40, LIGHTGRAY);
+        Gfx().DrawText(name.c_str(), 110, 150, 20, BLACK);
+        Gfx().DrawText("Press ENTER to continue", 100, 200, 20, GRAY);
+        EndFrame();
     }
 
     return name;
 }
 
 void ShowWelcomeMessage(const std::string& name) {
+    ScreenScope screen("Welcome");
     const float fadeDuration = 1.0f;     // 1 detik fade in & out
     const float holdDuration = 1.5f;     // waktu tampil penuh
     const float totalDuration = fadeDuration * 2 + holdDuration;
 
     float timer = 0.0f;
 
-    while (!WindowShouldClose() && timer < totalDuration) {
+    while (!Gfx().ShouldClose() && timer < totalDuration) {
         float alpha = 1.0f;
 
         if (timer < fadeDuration) {
@@ -50,33 +66,130 @@ void ShowWelcomeMessage(const std::string& name) {
             alpha = 1.0f - (timer - fadeDuration - holdDuration) / fadeDuration; // Fade-out
         }
 
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+        BeginFrame();
+        Gfx().ClearBackground(RAYWHITE);
 
         Color fadeColor = Fade(DARKGREEN, alpha);
-        std::string msg = "Welcome back, " + name + "!";
-        int textWidth = MeasureText(msg.c_str(), 30);
-        DrawText(msg.c_str(), (800 - textWidth) / 2, 200, 30, fadeColor);
+        const char* msg = FrameText("Welcome back, ", name, "!");
+        int textWidth = Gfx().MeasureText(msg, 30);
+        Gfx().DrawText(msg, (800 - textWidth) / 2, 200, 30, fadeColor);
 
-        EndDrawing();
-        timer += GetFrameTime();
+        EndFrame();
+        timer += Input::GetFrameTime();
     }
 }
 
 
 
-int main() {
+// Command line for headless runs (CI throughput and soak tests):
+//   --renderer null|software   draw nothing / draw into an offscreen image instead of a window
+//   --frames N                 stop after N frames
+//   --screenshots DIR N        software renderer: save every Nth frame to DIR
+// Input recordings (see InputRecording.h):
+//   --record FILE              record this session's input
+//   --replay FILE              play a recording back; headless runs stop when it ends
+//   --timings FILE             write per-screen frame-time percentiles as JSON
+//   --baseline FILE            compare them against an earlier --timings file
+// Scenarios/town_shop_battle_tavern.rpgi is the standard run between builds:
+//   --renderer null --replay Scenarios/town_shop_battle_tavern.rpgi --timings timings.json
+struct LaunchOptions {
+    std::string renderer = "raylib";
+    uint64_t frames = 0;
+    std::string screenshotDir;
+    int screenshotEvery = 0;
+    std::string recordPath;
+    std::string replayPath;
+    std::string timingsPath;
+    std::string baselinePath;
+};
+
+static bool ParseLaunchOptions(int argc, char** argv, LaunchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--renderer" && i + 1 < argc) options.renderer = argv[++i];
+        else if (arg == "--frames" && i + 1 < argc) options.frames = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--screenshots" && i + 2 < argc) {
+            options.screenshotDir = argv[++i];
+            options.screenshotEvery = std::atoi(argv[++i]);
+        }
+        else if (arg == "--record" && i + 1 < argc) options.recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc) options.replayPath = argv[++i];
+        else if (arg == "--timings" && i + 1 < argc) options.timingsPath = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) options.baselinePath = argv[++i];
+        else return false;
+    }
+    if (!options.recordPath.empty() && !options.replayPath.empty()) return false;
+    return options.renderer == "raylib" || options.renderer == "null" || options.renderer == "software";
+}
+
+int main(int argc, char** argv) {
     const int screenWidth = 800;
     const int screenHeight = 450;
 
-    InitWindow(screenWidth, screenHeight, "2D Turn-Based RPG");
+    LaunchOptions options;
+    if (!ParseLaunchOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--renderer raylib|null|software] [--frames N] [--screenshots DIR N]"
+            << " [--record FILE | --replay FILE] [--timings FILE] [--baseline FILE]" << std::endl;
+        return 2;
+    }
+
+    // Frames slower than this leave flight_hitch.bin behind
+    FlightRecorder::Install(250.0);
+
+    // Recordings run on a fixed 60 fps clock and carry these files
+    const uint32_t recordingFps = 60;
+    const std::vector<std::string> gameFiles = { SAVE_PATH, JOURNAL_PATH, BATTLE_PATH, STATS_PATH };
+    // The player's saves, if a replay was killed before it could put them back
+    InputPlayback::RecoverFiles(gameFiles);
+    LiveInput liveInput;
+    InputRecorder recorder(liveInput);
+    InputPlayback playback(liveInput);
+    if (!options.replayPath.empty()) {
+        if (!playback.Load(options.replayPath)) return 1;
+        // Headless replays end with the recording
+        if (options.frames == 0 && options.renderer != "raylib") options.frames = playback.FrameCount();
+        if (!playback.InstallFiles(gameFiles)) return 1;
+        Input::SetProvider(&playback);
+    }
+    if (!options.timingsPath.empty() || !options.baselinePath.empty()) {
+        ScreenTimings::Enable();
+    }
+
+    PROFILE_THREAD_NAME("Main");
+    NullRenderer nullRenderer(screenWidth, screenHeight, options.frames);
+    SoftwareRenderer softwareRenderer(options.renderer == "software" ? screenWidth : 0,
+        options.renderer == "software" ? screenHeight : 0, options.frames);
+    bool headless = options.renderer != "raylib";
+    if (options.renderer == "null") {
+        SetRenderer(&nullRenderer);
+    }
+    else if (options.renderer == "software") {
+        softwareRenderer.SetScreenshotInterval(options.screenshotDir, options.screenshotEvery);
+        SetRenderer(&softwareRenderer);
+    }
+    else {
+        InitWindow(screenWidth, screenHeight, "2D Turn-Based RPG");
+        PerfOverlay::Init();
+    }
+    if (!options.recordPath.empty()) {
+        if (!recorder.Open(options.recordPath, gameFiles, recordingFps)) return 1;
+        // Keeps the real frame rate close to the recorded clock
+        if (!headless) SetTargetFPS(recordingFps);
+        Input::SetProvider(&recorder);
+    }
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Built by ContentCompiler from Content/*.txt; defaults are used if it is missing
+    FlightRecorder::Record(FlightEvent::AssetLoad, 0, 0, "assets/content.bin");
+    Content().Load("assets/content.bin");
+    Content().WatchSources("Content", "assets/content.bin");
 
     MainMenu menu(screenWidth, screenHeight);
     Game* game = new Game(screenWidth, screenHeight);
 
     bool running = true;
 
-    while (!WindowShouldClose() && running) {
+    while (!Gfx().ShouldClose() && running) {
         switch (game->state) {
         case GameState::MainMenu: {
             bool startGame = menu.Show();
@@ -95,6 +208,8 @@ int main() {
                 else {
                     ShowWelcomeMessage(game->GetPlayerName());
                 }
+                // Straight back into a battle the game was closed in
+                if (game->HasSuspendedBattle()) game->ResumeBattle();
             }
             break;
         }
@@ -115,6 +230,44 @@ int main() {
 
     game->Unload();  // ✅ pastikan resource dibersihkan
     delete game;
-    CloseWindow();
-    return 0;
+
+    Input::SetProvider(nullptr);
+    recorder.Close();
+    if (!options.replayPath.empty()) {
+        if (!playback.Finished()) {
+            std::cout << "[Input] Stopped after " << playback.FramesPlayed() << " of " << playback.FrameCount() << " frames" << std::endl;
+        }
+        playback.RestoreFiles();
+    }
+
+    bool timingsOk = true;
+    if (!options.timingsPath.empty() || !options.baselinePath.empty()) {
+        ScreenTimings::PrintReport();
+        const InputLatency& latency = Input::Latency();
+        std::cout << "[Input] " << latency.events << " handled, " << latency.late << " a frame late, poll to swap avg "
+            << (latency.events > 0 ? latency.totalMs / latency.events : 0.0) << " ms, max " << latency.maxMs << " ms" << std::endl;
+        if (!options.timingsPath.empty() && !ScreenTimings::WriteJson(options.timingsPath)) {
+            std::cerr << "Cannot write " << options.timingsPath << std::endl;
+        }
+        if (!options.baselinePath.empty()) {
+            timingsOk = ScreenTimings::CompareWithBaseline(options.baselinePath, 10.0);
+        }
+    }
+
+    if (headless) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        uint64_t frames = options.renderer == "null" ? nullRenderer.FrameCount() : softwareRenderer.FrameCount();
+        std::cout << "[Headless] " << frames << " frames in " << seconds << " s ("
+            << (seconds > 0.0 ? frames / seconds : 0.0) << " fps)";
+        if (options.renderer == "null" && frames > 0) {
+            std::cout << ", " << (double)nullRenderer.Total().DrawCalls() / frames << " draw calls/frame";
+        }
+        std::cout << std::endl;
+        SetRenderer(nullptr);
+    }
+    else {
+        PerfOverlay::Shutdown();
+        CloseWindow();
+    }
+    return timingsOk ? 0 : 1;
 }